@@ -0,0 +1,111 @@
+// Bulk CSV import benchmark: stream stations/routes/vehicles CSV files into
+// the managers, compared with one addStation/addRoute call per row. Both
+// results are serialized and must be byte-identical.
+//
+// Build: g++ -std=c++11 -O2 -o bench_bulk_import bench/bench_bulk_import.cpp
+// Run:   ./bench_bulk_import [stations] [routes]     (default: 100000 1000000)
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include "bench_common.h"
+#include "../system/bulk_importer.h"
+#include "../system/snapshot.h"
+
+using namespace std;
+
+static const char *stationsPath = "bench_stations.csv";
+static const char *routesPath = "bench_routes.csv";
+static const char *vehiclesPath = "bench_vehicles.csv";
+
+static void writeFiles(int stationCount, int routeCount, int vehicleCount)
+{
+    BenchRng rng(5);
+    FILE *f = fopen(stationsPath, "w");
+    fprintf(f, "id,name,location\n");
+    for (int id = 1; id <= stationCount; id++)
+        fprintf(f, "%d,Station %d,\"Zone %d, Sector %d\"\n", id, id, id % 50, id % 7);
+    fclose(f);
+
+    f = fopen(routesPath, "w");
+    fprintf(f, "id,start_station_id,end_station_id,distance\n");
+    for (int id = 1; id <= routeCount; id++)
+    {
+        int start = 1 + rng.nextInt(stationCount);
+        int end = start % stationCount + 1 + rng.nextInt(3) % (stationCount - 1);
+        if (end > stationCount)
+            end -= stationCount;
+        fprintf(f, "%d,%d,%d,%d.%d\n", id, start, end, 1 + rng.nextInt(40), rng.nextInt(10));
+    }
+    fclose(f);
+
+    f = fopen(vehiclesPath, "w");
+    fprintf(f, "id,name,capacity\n");
+    for (int id = 1; id <= vehicleCount; id++)
+        fprintf(f, "%d,Bus %d,%d\n", id, id, 20 + rng.nextInt(100));
+    fclose(f);
+}
+
+// Baseline: parse with the same reader, add one row at a time
+static void addPerItem(RouteManager &routes, VehicleManager &vehicles)
+{
+    streambuf *saved = cout.rdbuf(nullptr);
+    CsvReader csv;
+    int id, a, b;
+    double d;
+    csv.open(stationsPath);
+    while (csv.next())
+        if (csv.getInt(0, id))
+            routes.addStation(Station(id, csv.getString(1), csv.getString(2)));
+    csv.open(routesPath);
+    while (csv.next())
+        if (csv.getInt(0, id) && csv.getInt(1, a) && csv.getInt(2, b) && csv.getDouble(3, d))
+            routes.addRoute(Route(id, a, b, d));
+    csv.open(vehiclesPath);
+    while (csv.next())
+        if (csv.getInt(0, id) && csv.getInt(2, a))
+            vehicles.addVehicle(Vehicle(id, csv.getString(1), a));
+    cout.rdbuf(saved);
+}
+
+int main(int argc, char **argv)
+{
+    int stationCount = argc > 1 ? atoi(argv[1]) : 100000;
+    int routeCount = argc > 2 ? atoi(argv[2]) : 1000000;
+    int vehicleCount = 1000;
+    writeFiles(stationCount, routeCount, vehicleCount);
+
+    benchHeader();
+    TicketManager tickets;
+    HistoryManager history;
+    BinaryWriter bulkImage, itemImage;
+    ImportReport report;
+    bool ok;
+    {
+        RouteManager routes;
+        VehicleManager vehicles;
+        BenchTimer timer;
+        ok = BulkImporter::importFiles(stationsPath, routesPath, vehiclesPath, routes, vehicles, report);
+        benchReport("bulk_import", "csv_bulk", report.routesAdded, timer.elapsedMs());
+        SnapshotManager::serialize(bulkImage, routes, vehicles, tickets, history);
+    }
+    {
+        RouteManager routes;
+        VehicleManager vehicles;
+        BenchTimer timer;
+        addPerItem(routes, vehicles);
+        benchReport("bulk_import", "per_item_add", routes.totalRoutes(), timer.elapsedMs());
+        SnapshotManager::serialize(itemImage, routes, vehicles, tickets, history);
+    }
+
+    bool same = bulkImage.size() == itemImage.size() &&
+                memcmp(bulkImage.bytes(), itemImage.bytes(), bulkImage.size()) == 0;
+    cerr << "bulk_import: stations=" << report.stationsAdded << " routes=" << report.routesAdded
+         << " vehicles=" << report.vehiclesAdded << " errors=" << report.errors
+         << " same_as_per_item=" << (same ? "yes" : "NO") << "\n";
+    remove(stationsPath);
+    remove(routesPath);
+    remove(vehiclesPath);
+    return ok && same && report.errors == 0 ? 0 : 1;
+}
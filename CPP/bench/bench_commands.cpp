@@ -0,0 +1,96 @@
+// Headless command throughput: scripts of each command kind run through
+// CommandRunner (parse, execute, JSON result line), one phase at a time.
+//
+// Build: g++ -std=c++11 -O2 -o bench_commands bench/bench_commands.cpp
+// Run:   ./bench_commands [stations] [routes] [passengers] [queries]
+//        (defaults: 2000 10000 100000 20000)
+
+#include <iostream>
+#include <sstream>
+#include "bench_common.h"
+#include "../system/command_runner.h"
+
+using namespace std;
+
+static RouteManager *routes;
+static VehicleManager *vehicles;
+static TicketManager *tickets;
+static HistoryManager *history;
+
+// Run script, report it as one row; false if any command failed
+static bool runPhase(const char *variant, const string &script, long long n)
+{
+    ostringstream results;
+    istringstream in(script);
+    CommandRunner runner(*routes, *vehicles, *tickets, *history, results);
+    BenchTimer timer;
+    int errors = runner.run(in);
+    benchReport("commands", variant, n, timer.elapsedMs());
+    return errors == 0 && runner.commandCount() == n;
+}
+
+int main(int argc, char **argv)
+{
+    const long long defaults[] = {2000, 10000, 100000, 20000};
+    long long sizes[4];
+    benchSizes(argc, argv, sizes, 4, defaults, 4);
+    int stations = (int)sizes[0];
+    int routeCount = (int)sizes[1];
+    int passengers = (int)sizes[2];
+    int queries = (int)sizes[3];
+
+    RouteManager routeManager;
+    VehicleManager vehicleManager;
+    TicketManager ticketManager;
+    HistoryManager historyManager;
+    routes = &routeManager;
+    vehicles = &vehicleManager;
+    tickets = &ticketManager;
+    history = &historyManager;
+
+    BenchRng rng(40);
+    benchHeader();
+    bool ok = true;
+
+    ostringstream script;
+    for (int i = 1; i <= stations; i++)
+        script << "add-station " << i << " \"Station " << i << "\" Zone" << i % 10 << "\n";
+    ok = runPhase("add_station", script.str(), stations) && ok;
+
+    // A ring keeps the network connected, the rest are random chords
+    script.str("");
+    for (int i = 1; i <= routeCount; i++)
+    {
+        int start = i <= stations ? i : 1 + rng.nextInt(stations);
+        int end = i <= stations ? i % stations + 1 : 1 + rng.nextInt(stations);
+        if (end == start)
+            end = start % stations + 1;
+        script << "add-route " << i << " " << start << " " << end << " " << 1 + rng.nextInt(50) << "\n";
+    }
+    ok = runPhase("add_route", script.str(), routeCount) && ok;
+
+    script.str("");
+    for (int i = 1; i <= passengers; i++)
+        script << "add-passenger " << i << " Passenger" << i << " " << 18 + i % 60 << "\n";
+    ok = runPhase("add_passenger", script.str(), passengers) && ok;
+
+    script.str("");
+    for (int i = 0; i < passengers; i++)
+    {
+        int start = 1 + rng.nextInt(stations);
+        script << "issue-ticket " << start << " " << start % stations + 1 << "\n";
+    }
+    ok = runPhase("issue_ticket", script.str(), passengers) && ok;
+
+    script.str("");
+    for (int i = 0; i < queries; i++)
+        script << "shortest-path " << 1 + rng.nextInt(stations) << " " << 1 + rng.nextInt(stations) << "\n";
+    ok = runPhase("shortest_path", script.str(), queries) && ok;
+
+    script.str("");
+    for (int i = 0; i < 100; i++)
+        script << "busiest-route\n";
+    ok = runPhase("busiest_route", script.str(), 100) && ok;
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+using namespace std;
+
+// Shared helpers for the standalone benchmark programs in bench/
+
+// Wall-clock stopwatch in nanoseconds
+class BenchTimer
+{
+private:
+    chrono::steady_clock::time_point startTime;
+
+public:
+    BenchTimer() { reset(); }
+
+    void reset() { startTime = chrono::steady_clock::now(); }
+
+    long long elapsedNs() const
+    {
+        return (long long)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - startTime).count();
+    }
+
+    double elapsedMs() const { return elapsedNs() / 1e6; }
+};
+
+// Deterministic xorshift64* generator so every run sees the same inputs
+class BenchRng
+{
+private:
+    unsigned long long state;
+
+public:
+    BenchRng(unsigned long long seed = 0x9E3779B97F4A7C15ULL) : state(seed ? seed : 1) {}
+
+    unsigned long long next()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+
+    // Uniform int in [0, bound)
+    int nextInt(int bound) { return (int)(next() % (unsigned long long)bound); }
+};
+
+// One CSV result row: benchmark,case,n,ms,ns_per_elem
+inline void benchReport(const char *bench, const char *variant, long long n, double ms)
+{
+    cout << bench << "," << variant << "," << n << "," << ms << "," << (n > 0 ? ms * 1e6 / n : 0.0) << "\n";
+}
+
+inline void benchHeader()
+{
+    cout << "benchmark,case,n,ms,ns_per_elem\n";
+}
+
+// Parse sizes from argv, falling back to the given defaults
+inline int benchSizes(int argc, char **argv, long long out[], int maxOut, const long long defaults[], int numDefaults)
+{
+    int k = 0;
+    for (int i = 1; i < argc && k < maxOut; i++)
+        out[k++] = atoll(argv[i]);
+    if (k == 0)
+        for (int i = 0; i < numDefaults && k < maxOut; i++)
+            out[k++] = defaults[i];
+    return k;
+}
+
+// ---- Allocation counting and peak RSS (BenchSuite) ----
+
+// Heap allocations made through operator new since program start. Counted
+// only in programs that #define BENCH_COUNT_ALLOCS before including this
+// header (each bench is one translation unit, so the operators below are
+// defined exactly once); otherwise both stay 0.
+static atomic<long long> benchAllocCount(0);
+static atomic<long long> benchAllocBytes(0);
+
+#ifdef BENCH_COUNT_ALLOCS
+// Not inlined, so the compiler never pairs a new-expression with malloc/free
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+BENCH_NOINLINE void *operator new(size_t size)
+{
+    benchAllocCount.fetch_add(1, memory_order_relaxed);
+    benchAllocBytes.fetch_add((long long)size, memory_order_relaxed);
+    void *p = malloc(size ? size : 1);
+    if (!p)
+        throw bad_alloc();
+    return p;
+}
+
+BENCH_NOINLINE void *operator new[](size_t size) { return operator new(size); }
+BENCH_NOINLINE void operator delete(void *p) noexcept { free(p); }
+BENCH_NOINLINE void operator delete[](void *p) noexcept { free(p); }
+#endif
+
+// Peak resident set size of the process so far, in KiB (0 if unknown)
+inline long long benchPeakRssKb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return (long long)(pmc.PeakWorkingSetSize / 1024);
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return (long long)usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    return (long long)usage.ru_maxrss;
+#endif
+#endif
+}
+
+// Rows with ns/op, throughput, allocations and peak RSS, as CSV or as a
+// JSON array. Usage: start(); <work>; stop("bench", "case", ops);
+class BenchSuite
+{
+private:
+    bool json;
+    int rows;
+    BenchTimer timer;
+    long long allocsAtStart;
+    long long bytesAtStart;
+
+public:
+    BenchSuite(bool jsonOutput = false) : json(jsonOutput), rows(0), allocsAtStart(0), bytesAtStart(0) {}
+
+    void header()
+    {
+        if (json)
+            cout << "[\n";
+        else
+            cout << "benchmark,case,n,ms,ns_per_op,mops_per_s,allocs,alloc_bytes,peak_rss_kb\n";
+    }
+
+    void footer()
+    {
+        if (json)
+            cout << (rows ? "\n" : "") << "]\n";
+    }
+
+    void start()
+    {
+        allocsAtStart = benchAllocCount;
+        bytesAtStart = benchAllocBytes;
+        timer.reset();
+    }
+
+    // End the measurement started by start(); ops is the number of operations timed
+    void stop(const char *bench, const char *variant, long long ops)
+    {
+        double ms = timer.elapsedMs();
+        long long allocs = benchAllocCount - allocsAtStart;
+        long long bytes = benchAllocBytes - bytesAtStart;
+        double nsPerOp = ops > 0 ? ms * 1e6 / ops : 0.0;
+        double mops = ms > 0 ? ops / (ms * 1000.0) : 0.0;
+        if (json)
+        {
+            cout << (rows ? ",\n" : "") << "  {\"benchmark\":\"" << bench << "\",\"case\":\"" << variant
+                 << "\",\"n\":" << ops << ",\"ms\":" << ms << ",\"ns_per_op\":" << nsPerOp
+                 << ",\"mops_per_s\":" << mops << ",\"allocs\":" << allocs << ",\"alloc_bytes\":" << bytes
+                 << ",\"peak_rss_kb\":" << benchPeakRssKb() << "}";
+        }
+        else
+        {
+            cout << bench << "," << variant << "," << ops << "," << ms << "," << nsPerOp << "," << mops << ","
+                 << allocs << "," << bytes << "," << benchPeakRssKb() << "\n";
+        }
+        rows++;
+    }
+};
+
+#endif
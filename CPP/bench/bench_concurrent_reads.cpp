@@ -0,0 +1,118 @@
+// Concurrent queries on RouteManager: reader threads run shortest-path
+// queries on published network versions, first alone and then while a
+// writer keeps adding and removing routes (each followed by publish()).
+// Readers never wait for the writer; every query must still find a path on
+// the connected network and the station names must resolve.
+//
+// Build: g++ -std=c++11 -O2 -pthread -o bench_concurrent_reads bench/bench_concurrent_reads.cpp
+// Run:   ./bench_concurrent_reads [stations] [queries per reader]
+//        (defaults: 5000 500)
+
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <string>
+#include "bench_common.h"
+#include "../system/network_generator.h"
+
+using namespace std;
+
+static RouteManager *routes;
+static int stationCount;
+static atomic<long long> failures(0);
+static atomic<bool> stopWriter(false);
+static atomic<long long> writes(0);
+
+static void reader(int seed, int queries)
+{
+    BenchRng rng(seed);
+    DynamicArray<int> path;
+    for (int q = 0; q < queries; q++)
+    {
+        int s = 1 + rng.nextInt(stationCount);
+        int t = 1 + rng.nextInt(stationCount);
+        NetworkSnapshot net = routes->snapshot();
+        if (net->graph.shortestPath(s, t, path) < 0 || net->stationName(s).compare(0, 3, "ID ") == 0)
+            failures++;
+    }
+}
+
+// Add and remove one extra route at a time: the network stays connected
+static void writer()
+{
+    BenchRng rng(7);
+    streambuf *saved = cout.rdbuf(nullptr);
+    int id = 100000000;
+    while (!stopWriter.load())
+    {
+        routes->addRoute(Route(id, 1 + rng.nextInt(stationCount), 1 + rng.nextInt(stationCount), 1 + rng.nextInt(50)));
+        routes->publish();
+        routes->removeRouteById(id);
+        routes->publish();
+        id++;
+        writes += 2;
+    }
+    cout.rdbuf(saved);
+}
+
+int main(int argc, char **argv)
+{
+    const long long defaults[] = {5000, 500};
+    long long sizes[2];
+    int k = benchSizes(argc, argv, sizes, 2, defaults, 2);
+    for (; k < 2; k++)
+        sizes[k] = defaults[k];
+    stationCount = (int)sizes[0];
+    int queries = (int)sizes[1];
+
+    RouteManager routeManager;
+    VehicleManager vehicles;
+    TicketManager tickets;
+    GeneratorOptions options;
+    options.stations = stationCount;
+    options.vehicles = 0;
+    options.passengers = 0;
+    options.tickets = 0;
+    options.seed = 46;
+    NetworkGenerator generator(options);
+    generator.populate(routeManager, vehicles, tickets);
+    routeManager.publish();
+    routes = &routeManager;
+
+    benchHeader();
+    for (int withWriter = 0; withWriter < 2; withWriter++)
+    {
+        for (int readers = 1; readers <= 8; readers *= 2)
+        {
+            stopWriter = false;
+            writes = 0;
+            thread writerThread;
+            if (withWriter)
+                writerThread = thread(writer);
+
+            BenchTimer timer;
+            thread pool[8];
+            for (int r = 0; r < readers; r++)
+                pool[r] = thread(reader, 100 + r, queries);
+            for (int r = 0; r < readers; r++)
+                pool[r].join();
+            double ms = timer.elapsedMs();
+
+            stopWriter = true;
+            if (withWriter)
+                writerThread.join();
+            string variant = string(withWriter ? "writer_" : "idle_") + to_string(readers) + "_readers";
+            benchReport("concurrent_reads", variant.c_str(), (long long)readers * queries, ms);
+            if (withWriter)
+                cout << "#   writer mutations during run: " << writes.load() << "\n";
+        }
+    }
+
+    RcuDomain::instance().synchronize();
+    if (failures.load() != 0)
+    {
+        cerr << failures.load() << " queries failed\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,448 @@
+// Data-structure suite: every ds/ container, the sorting.h / searching.h
+// routines and the Graph algorithms on seeded synthetic inputs. Each row has
+// ns/op, throughput, heap allocations (operator new calls and bytes) and the
+// process peak RSS so far, as CSV or (--json) a JSON array.
+//
+// O(n^2) cases (bubble/selection/insertion sort, OrderedMap, LinkedList::get)
+// run on min(n, quadratic cap) elements. Graph algorithms that print (BFS,
+// DFS, Dijkstra, MST) run with cout muted, so their output formatting is
+// still part of the cost.
+//
+// Build: g++ -std=c++11 -O2 -pthread -o bench_ds bench/bench_ds.cpp
+// Run:   ./bench_ds [--json] [n] [graph vertices] [quadratic cap]
+//        (defaults: 200000 5000 10000; graphs get 4 edges per vertex)
+
+#define BENCH_COUNT_ALLOCS
+#include <iostream>
+#include <cstring>
+#include "bench_common.h"
+#include "../ds/array.h"
+#include "../ds/linkedlist.h"
+#include "../ds/queue.h"
+#include "../ds/stack.h"
+#include "../ds/hashtable.h"
+#include "../ds/orderedmap.h"
+#include "../ds/trees.h"
+#include "../ds/heap.h"
+#include "../ds/sorting.h"
+#include "../ds/parallel_sorting.h"
+#include "../ds/searching.h"
+#include "../ds/graph.h"
+
+using namespace std;
+
+static volatile long long benchSink; // keeps results from being optimized away
+static BenchSuite *suite;
+
+static void fillRandom(int arr[], int n, unsigned long long seed)
+{
+    BenchRng rng(seed);
+    for (int i = 0; i < n; i++)
+        arr[i] = (int)(rng.next() >> 33);
+}
+
+static bool isSorted(const int arr[], int n)
+{
+    for (int i = 1; i < n; i++)
+        if (arr[i - 1] > arr[i])
+            return false;
+    return true;
+}
+
+static void benchDynamicArray(int n, const int keys[])
+{
+    long long acc = 0;
+    {
+        suite->start();
+        DynamicArray<int> arr;
+        for (int i = 0; i < n; i++)
+            arr.push_back(keys[i]);
+        suite->stop("DynamicArray", "push_back", n);
+
+        suite->start();
+        for (int i = 0; i < n; i++)
+            acc += arr[keys[i] % n];
+        suite->stop("DynamicArray", "random_get", n);
+    }
+    {
+        suite->start();
+        DynamicArray<int> arr(n);
+        for (int i = 0; i < n; i++)
+            arr.push_back(keys[i]);
+        suite->stop("DynamicArray", "push_back_reserved", n);
+    }
+    benchSink += acc;
+}
+
+static void benchLinkedList(int n, int nq)
+{
+    long long acc = 0;
+    LinkedList<int> list;
+    suite->start();
+    for (int i = 0; i < n; i++)
+        list.insertEnd(i);
+    suite->stop("LinkedList", "insertEnd", n);
+
+    suite->start();
+    for (ListNode<int> *node = list.head; node; node = node->next)
+        acc += node->data;
+    suite->stop("LinkedList", "iterate", n);
+
+    int gets = nq / 10 > 0 ? nq / 10 : 1;
+    suite->start();
+    for (int i = 0; i < gets; i++)
+        acc += list.get((int)((long long)i * 7919 % list.size()));
+    suite->stop("LinkedList", "get_by_index", gets);
+
+    suite->start();
+    while (!list.isEmpty())
+        acc += list.popFront();
+    suite->stop("LinkedList", "popFront", n);
+
+    suite->start();
+    for (int i = 0; i < n; i++)
+        list.insertFront(i);
+    suite->stop("LinkedList", "insertFront", n);
+    benchSink += acc;
+}
+
+static void benchQueueStack(int n)
+{
+    long long acc = 0;
+    Queue<int> q;
+    suite->start();
+    for (int i = 0; i < n; i++)
+        q.enqueue(i);
+    suite->stop("Queue", "enqueue", n);
+
+    suite->start();
+    while (!q.isEmpty())
+        acc += q.dequeue();
+    suite->stop("Queue", "dequeue", n);
+
+    Stack<int> st;
+    suite->start();
+    for (int i = 0; i < n; i++)
+        st.push(i);
+    suite->stop("Stack", "push", n);
+
+    suite->start();
+    while (!st.isEmpty())
+        acc += st.pop();
+    suite->stop("Stack", "pop", n);
+    benchSink += acc;
+}
+
+static void benchHashTable(int n, const int keys[])
+{
+    long long acc = 0;
+    HashTable<int, int> table;
+    suite->start();
+    for (int i = 0; i < n; i++)
+        table.insert(keys[i], i);
+    suite->stop("HashTable", "insert", n);
+
+    suite->start();
+    for (int i = 0; i < n; i++)
+    {
+        int v;
+        if (table.search(keys[i], v))
+            acc += v;
+    }
+    suite->stop("HashTable", "search_hit", n);
+
+    suite->start();
+    for (int i = 0; i < n; i++)
+        acc += table.contains(-1 - keys[i]); // keys are non-negative
+    suite->stop("HashTable", "search_miss", n);
+
+    suite->start();
+    for (int i = 0; i < n; i++)
+        acc += table.remove(keys[i]);
+    suite->stop("HashTable", "remove", n);
+
+    HashTable<int, int> reserved;
+    suite->start();
+    reserved.reserve(n);
+    for (int i = 0; i < n; i++)
+        reserved.insert(keys[i], i);
+    suite->stop("HashTable", "insert_reserved", n);
+    benchSink += acc;
+}
+
+static void benchOrderedMap(int nq, const int keys[])
+{
+    long long acc = 0;
+    OrderedMap<int, int> map;
+    suite->start();
+    for (int i = 0; i < nq; i++)
+        map.insert(keys[i], i);
+    suite->stop("OrderedMap", "insert", nq);
+
+    suite->start();
+    for (int i = 0; i < nq; i++)
+        acc += map.find(keys[i]);
+    suite->stop("OrderedMap", "find", nq);
+
+    suite->start();
+    for (int i = 0; i < nq; i++)
+        acc += map.remove(keys[i]);
+    suite->stop("OrderedMap", "remove", nq);
+    benchSink += acc;
+}
+
+static void benchBstHeap(int n, const int keys[])
+{
+    long long acc = 0;
+    {
+        BST<int> tree;
+        suite->start();
+        for (int i = 0; i < n; i++)
+            tree.insert(keys[i]);
+        suite->stop("BST", "insert_random", n);
+
+        suite->start();
+        for (int i = 0; i < n; i++)
+            acc += tree.search(keys[i]);
+        suite->stop("BST", "search_hit", n);
+
+        suite->start();
+        for (int i = 0; i < n; i++)
+            acc += tree.search(-1 - keys[i]);
+        suite->stop("BST", "search_miss", n);
+    }
+
+    MinHeap<int> heap(n);
+    suite->start();
+    for (int i = 0; i < n; i++)
+        heap.insert(keys[i]);
+    suite->stop("MinHeap", "insert", n);
+
+    suite->start();
+    while (!heap.isEmpty())
+        acc += heap.extractMin();
+    suite->stop("MinHeap", "extractMin", n);
+    benchSink += acc;
+}
+
+static void benchSorting(int n, int nq)
+{
+    int *data = new int[n];
+    bool ok = true;
+
+    fillRandom(data, nq, 11);
+    suite->start();
+    bubbleSort(data, nq);
+    suite->stop("sort", "bubbleSort", nq);
+    ok = ok && isSorted(data, nq);
+
+    fillRandom(data, nq, 11);
+    suite->start();
+    selectionSort(data, nq);
+    suite->stop("sort", "selectionSort", nq);
+    ok = ok && isSorted(data, nq);
+
+    fillRandom(data, nq, 11);
+    suite->start();
+    insertionSort(data, nq);
+    suite->stop("sort", "insertionSort", nq);
+    ok = ok && isSorted(data, nq);
+
+    fillRandom(data, n, 11);
+    suite->start();
+    quickSort(data, 0, n - 1);
+    suite->stop("sort", "quickSort", n);
+    ok = ok && isSorted(data, n);
+
+    fillRandom(data, n, 11);
+    suite->start();
+    mergeSort(data, 0, n - 1);
+    suite->stop("sort", "mergeSort", n);
+    ok = ok && isSorted(data, n);
+
+    fillRandom(data, n, 11);
+    suite->start();
+    heapSort(data, n);
+    suite->stop("sort", "heapSort", n);
+    ok = ok && isSorted(data, n);
+
+    fillRandom(data, n, 11);
+    suite->start();
+    introSort(data, n);
+    suite->stop("sort", "introSort", n);
+    ok = ok && isSorted(data, n);
+
+    fillRandom(data, n, 11);
+    suite->start();
+    mergeSortBuffered(data, n);
+    suite->stop("sort", "mergeSortBuffered", n);
+    ok = ok && isSorted(data, n);
+
+    fillRandom(data, n, 11);
+    suite->start();
+    parallelMergeSort(data, n);
+    suite->stop("sort", "parallelMergeSort", n);
+    ok = ok && isSorted(data, n);
+
+    fillRandom(data, n, 11);
+    suite->start();
+    radixSort(data, n);
+    suite->stop("sort", "radixSort", n);
+    ok = ok && isSorted(data, n);
+
+    if (!ok)
+        cerr << "a sort produced unsorted output\n";
+    delete[] data;
+}
+
+static void benchSearching(int n, int nq)
+{
+    // Sorted even numbers: half the probes hit, half miss
+    int *arr = new int[n];
+    for (int i = 0; i < n; i++)
+        arr[i] = 2 * i;
+    int *probes = new int[n];
+    BenchRng rng(13);
+    for (int i = 0; i < n; i++)
+        probes[i] = rng.nextInt(2 * n);
+
+    long long acc = 0;
+    int scans = nq / 10 > 0 ? nq / 10 : 1; // full O(n) scans
+    suite->start();
+    for (int i = 0; i < scans; i++)
+        acc += linearSearch(arr, n, probes[i]);
+    suite->stop("search", "linearSearch", scans);
+
+    suite->start();
+    for (int i = 0; i < scans; i++)
+        acc += linearSearchInt(arr, n, probes[i]);
+    suite->stop("search", "linearSearchInt", scans);
+
+    suite->start();
+    for (int i = 0; i < n; i++)
+        acc += binarySearch(arr, n, probes[i]);
+    suite->stop("search", "binarySearch", n);
+
+    suite->start();
+    for (int i = 0; i < n; i++)
+        acc += branchlessBinarySearch(arr, n, probes[i]);
+    suite->stop("search", "branchlessBinarySearch", n);
+
+    suite->start();
+    for (int i = 0; i < n; i++)
+        acc += lowerBound(arr, n, probes[i]) + upperBound(arr, n, probes[i]);
+    suite->stop("search", "lowerBound+upperBound", n);
+
+    suite->start();
+    EytzingerIndex<int> eytz(arr, n);
+    suite->stop("search", "EytzingerIndex_build", n);
+
+    suite->start();
+    for (int i = 0; i < n; i++)
+        acc += eytz.search(probes[i]);
+    suite->stop("search", "EytzingerIndex_search", n);
+
+    benchSink += acc;
+    delete[] probes;
+    delete[] arr;
+}
+
+static void benchGraph(int vertices)
+{
+    // A ring (connected, has a cycle) plus 3 random chords per vertex
+    int edges = 4 * vertices;
+    BenchRng rng(17);
+    Graph g;
+    suite->start();
+    for (int i = 1; i <= vertices; i++)
+        g.addVertex(i);
+    for (int e = 0; e < edges; e++)
+    {
+        int u = e < vertices ? e + 1 : 1 + rng.nextInt(vertices);
+        int v = e < vertices ? (e + 1) % vertices + 1 : 1 + rng.nextInt(vertices);
+        g.addEdge(u, v, 1 + rng.nextInt(100));
+    }
+    suite->stop("Graph", "build", vertices + edges);
+
+    long long acc = 0;
+    int start = 1, end = vertices / 2 + 1;
+    int size = vertices + edges;
+    streambuf *saved;
+
+    suite->start();
+    saved = cout.rdbuf(nullptr); // the algorithms print as they go
+    g.BFS(start);
+    cout.rdbuf(saved);
+    suite->stop("Graph", "BFS", size);
+
+    suite->start();
+    saved = cout.rdbuf(nullptr);
+    g.DFS(start);
+    cout.rdbuf(saved);
+    suite->stop("Graph", "DFS", size);
+
+    suite->start();
+    saved = cout.rdbuf(nullptr);
+    g.Dijkstra(start, end);
+    cout.rdbuf(saved);
+    suite->stop("Graph", "Dijkstra_V2", size);
+
+    DynamicArray<int> path;
+    suite->start();
+    acc += g.shortestPath(start, end, path);
+    suite->stop("Graph", "shortestPath_heap", size);
+
+    suite->start();
+    saved = cout.rdbuf(nullptr);
+    g.MST();
+    cout.rdbuf(saved);
+    suite->stop("Graph", "MST", size);
+
+    suite->start();
+    acc += g.detectCycle();
+    suite->stop("Graph", "detectCycle", size);
+
+    benchSink += acc;
+}
+
+int main(int argc, char **argv)
+{
+    bool json = false;
+    long long sizes[3] = {200000, 5000, 10000};
+    int numSizes = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--json") == 0)
+            json = true;
+        else if (numSizes < 3)
+            sizes[numSizes++] = atoll(argv[i]);
+    }
+    int n = (int)sizes[0];
+    int vertices = (int)sizes[1];
+    int nq = (int)(sizes[2] < n ? sizes[2] : n);
+    if (n < 2 || vertices < 3 || nq < 1)
+    {
+        cerr << "usage: " << argv[0] << " [--json] [n >= 2] [graph vertices >= 3] [quadratic cap >= 1]\n";
+        return 2;
+    }
+
+    BenchSuite results(json);
+    suite = &results;
+    int *keys = new int[n];
+    fillRandom(keys, n, 7);
+
+    results.header();
+    benchDynamicArray(n, keys);
+    benchLinkedList(n, nq);
+    benchQueueStack(n);
+    benchHashTable(n, keys);
+    benchOrderedMap(nq, keys);
+    benchBstHeap(n, keys);
+    benchSorting(n, nq);
+    benchSearching(n, nq);
+    benchGraph(vertices);
+    results.footer();
+
+    delete[] keys;
+    return 0;
+}
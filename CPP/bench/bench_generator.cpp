@@ -0,0 +1,72 @@
+// Synthetic network generator: time to populate the managers (stations,
+// routes, vehicles, tickets) and to build a bare Graph for each topology,
+// plus heap-Dijkstra queries on the result. Generation is seeded, so every
+// run (and every machine) sees the same networks.
+//
+// Build: g++ -std=c++11 -O2 -o bench_generator bench/bench_generator.cpp
+// Run:   ./bench_generator [stations] [routes per station] [tickets]
+//        (defaults: 500000 2 500000; 5M stations x 2 = 10M routes needs several GB)
+
+#include <iostream>
+#include "bench_common.h"
+#include "../system/network_generator.h"
+
+using namespace std;
+
+int main(int argc, char **argv)
+{
+    const long long defaults[] = {500000, 2, 500000};
+    long long sizes[3];
+    int k = benchSizes(argc, argv, sizes, 3, defaults, 3);
+    for (; k < 3; k++)
+        sizes[k] = defaults[k];
+
+    const char *names[] = {"grid", "radial", "scale-free", "geometric"};
+    benchHeader();
+    for (int t = 0; t < 4; t++)
+    {
+        GeneratorOptions options;
+        NetworkGenerator::parseTopology(names[t], options.topology);
+        options.stations = (int)sizes[0];
+        options.routesPerStation = (int)sizes[1];
+        options.tickets = (int)sizes[2];
+        options.vehicles = 1000;
+        options.seed = 42;
+
+        string variant = string(names[t]) + "_populate";
+        long long routesAdded;
+        {
+            RouteManager routes;
+            VehicleManager vehicles;
+            TicketManager tickets;
+            NetworkGenerator generator(options);
+            BenchTimer timer;
+            generator.populate(routes, vehicles, tickets);
+            double ms = timer.elapsedMs();
+            const GeneratorReport &report = generator.getReport();
+            routesAdded = report.routesAdded;
+            benchReport("generator", variant.c_str(), report.stationsAdded + report.routesAdded + report.ticketsIssued, ms);
+        }
+
+        Graph g;
+        NetworkGenerator generator(options);
+        BenchTimer timer;
+        int edges = generator.buildGraph(g);
+        variant = string(names[t]) + "_graph";
+        benchReport("generator", variant.c_str(), g.vertexCount() + edges, timer.elapsedMs());
+
+        // Queries between seeded random stations (pairs may be unreachable in sparse geometric graphs)
+        BenchRng rng(t + 1);
+        DynamicArray<int> path;
+        int queries = 20, reachable = 0;
+        timer.reset();
+        for (int q = 0; q < queries; q++)
+            reachable += g.shortestPath(1 + rng.nextInt(g.vertexCount()), 1 + rng.nextInt(g.vertexCount()), path) >= 0;
+        variant = string(names[t]) + "_shortestPath";
+        benchReport("generator", variant.c_str(), queries, timer.elapsedMs());
+
+        cerr << names[t] << ": stations=" << g.vertexCount() << " routes=" << routesAdded << " reachable_pairs="
+             << reachable << "/" << queries << "\n";
+    }
+    return 0;
+}
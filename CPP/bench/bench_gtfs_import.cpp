@@ -0,0 +1,98 @@
+// GTFS import benchmark: a synthetic feed (stops on lines, trips running
+// each line repeatedly) imported with 1..N stop_times parser threads.
+// Every thread count must produce the same network.
+//
+// Build: g++ -std=c++11 -O2 -pthread -o bench_gtfs_import bench/bench_gtfs_import.cpp
+// Run:   ./bench_gtfs_import [stop_times rows]     (default: 2000000)
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#include <direct.h>
+#define BENCH_MKDIR(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define BENCH_MKDIR(path) mkdir(path, 0755)
+#endif
+#include "bench_common.h"
+#include "../system/gtfs_importer.h"
+#include "../system/snapshot.h"
+
+using namespace std;
+
+static const char *feedDir = "bench_gtfs_feed";
+
+// lines x stopsPerLine stops; trips run whole lines until rows are used up
+static void writeFeed(long long rows, int lines, int stopsPerLine)
+{
+    BENCH_MKDIR(feedDir);
+    BenchRng rng(3);
+    string dir = string(feedDir) + "/";
+
+    FILE *f = fopen((dir + "stops.txt").c_str(), "w");
+    fprintf(f, "stop_id,stop_name,stop_lat,stop_lon,location_type,parent_station\n");
+    for (int line = 0; line < lines; line++)
+        for (int s = 0; s < stopsPerLine; s++)
+            fprintf(f, "L%dS%d,Stop %d-%d,%.6f,%.6f,0,\n", line, s, line, s, 48.0 + rng.nextInt(100000) / 50000.0,
+                    11.0 + rng.nextInt(100000) / 50000.0);
+    fclose(f);
+
+    f = fopen((dir + "stop_times.txt").c_str(), "w");
+    fprintf(f, "trip_id,arrival_time,departure_time,stop_id,stop_sequence\n");
+    long long written = 0;
+    for (int trip = 0; written < rows; trip++)
+    {
+        int line = trip % lines;
+        // Lines share stops with the next line at their ends (transfers)
+        for (int s = 0; s < stopsPerLine && written < rows; s++, written++)
+        {
+            int minute = 300 + trip % 900 + s * 2;
+            int stopLine = s == stopsPerLine - 1 ? (line + 1) % lines : line;
+            int stop = s == stopsPerLine - 1 ? 0 : s;
+            fprintf(f, "T%d,%02d:%02d:00,%02d:%02d:30,L%dS%d,%d\n", trip, minute / 60, minute % 60, minute / 60,
+                    minute % 60, stopLine, stop, s + 1);
+        }
+    }
+    fclose(f);
+}
+
+int main(int argc, char **argv)
+{
+    long long rows = argc > 1 ? atoll(argv[1]) : 2000000;
+    writeFeed(rows, 500, 40);
+
+    benchHeader();
+    TicketManager tickets;
+    VehicleManager vehicles;
+    HistoryManager history;
+    BinaryWriter first, image;
+    bool ok = true, same = true;
+    GtfsReport report;
+    for (int threads = 1; threads <= 4; threads *= 2)
+    {
+        RouteManager routes;
+        GtfsOptions options;
+        options.threads = threads;
+        GtfsImporter importer(routes, options);
+        BenchTimer timer;
+        ok = importer.importFeed(feedDir) && ok;
+        double ms = timer.elapsedMs();
+        report = importer.getReport();
+        string variant = "threads_" + to_string(threads);
+        benchReport("gtfs_import", variant.c_str(), report.stopTimes, ms);
+
+        SnapshotManager::serialize(threads == 1 ? first : image, routes, vehicles, tickets, history);
+        if (threads > 1)
+            same = same && image.size() == first.size() && memcmp(image.bytes(), first.bytes(), first.size()) == 0;
+    }
+
+    cerr << "gtfs_import: stops=" << report.stops << " stations=" << report.stationsAdded
+         << " stop_times=" << report.stopTimes << " trips=" << report.trips << " hops=" << report.hops
+         << " routes=" << report.routesAdded << " same_for_all_threads=" << (same ? "yes" : "NO") << "\n";
+    remove((string(feedDir) + "/stops.txt").c_str());
+    remove((string(feedDir) + "/stop_times.txt").c_str());
+    remove(feedDir);
+    return ok && same ? 0 : 1;
+}
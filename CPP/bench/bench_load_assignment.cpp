@@ -0,0 +1,165 @@
+// Route load assignment: every ticket's trip routed over its shortest path
+// on a generated grid network. Reports a per-ticket Dijkstra baseline, the
+// first assignment (all trees built) with pools of 1, 2, 4 and 8 threads,
+// and an incremental batch served from the cached trees. Loads must match
+// the one-thread loads, and sum(load x route weight) must equal
+// sum(trips x shortest distance) over all OD pairs.
+//
+// Build: g++ -std=c++11 -O2 -pthread -o bench_load_assignment bench/bench_load_assignment.cpp
+// Run:   ./bench_load_assignment [tickets] [stations]   (default: 10000000 1000)
+
+#include <iostream>
+#include <string>
+#include "bench_common.h"
+#include "../system/network_generator.h"
+
+using namespace std;
+
+static bool sameLoads(const DynamicArray<RouteLoad> &a, const DynamicArray<RouteLoad> &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (int i = 0; i < a.size(); i++)
+        if (a[i].forward != b[i].forward || a[i].backward != b[i].backward)
+            return false;
+    return true;
+}
+
+// sum(trips x shortest distance) over the matrix, one Dijkstra per origin
+static long long tripDistance(const NetworkVersion &net, const OdMatrix &od)
+{
+    int V = net.graph.vertexCount();
+    DynamicArray<DynamicArray<int>> cellsFrom(V);
+    for (int v = 0; v < V; v++)
+        cellsFrom.push_back(DynamicArray<int>());
+    for (int c = 0; c < od.pairCount(); c++)
+        cellsFrom[net.graph.getIndex(od.cellOriginID(c))].push_back(c);
+    long long total = 0;
+    DynamicArray<int> dist;
+    for (int v = 0; v < V; v++)
+    {
+        if (cellsFrom[v].empty())
+            continue;
+        net.graph.distancesFrom(od.cellOriginID(cellsFrom[v][0]), dist);
+        for (int i = 0; i < cellsFrom[v].size(); i++)
+        {
+            int c = cellsFrom[v][i];
+            int d = dist[net.graph.getIndex(od.cellDestinationID(c))];
+            if (d != INT_MAX_VALUE)
+                total += (long long)od.cellTripCount(c) * d;
+        }
+    }
+    return total;
+}
+
+static long long loadDistance(const NetworkVersion &net, const DynamicArray<RouteLoad> &loads)
+{
+    long long total = 0;
+    for (int r = 0; r < loads.size(); r++)
+        total += (long long)loads[r].total() * (int)net.routes[r].getDistance();
+    return total;
+}
+
+int main(int argc, char **argv)
+{
+    const long long defaults[] = {10000000, 1000};
+    long long sizes[2];
+    int k = benchSizes(argc, argv, sizes, 2, defaults, 2);
+    for (; k < 2; k++)
+        sizes[k] = defaults[k];
+    int ticketCount = (int)sizes[0];
+    int stationCount = (int)sizes[1];
+
+    GeneratorOptions options;
+    options.stations = stationCount;
+    options.routesPerStation = 2;
+    options.seed = 50;
+    RouteManager routes;
+    VehicleManager vehicles;
+    TicketManager ticketManager;
+    NetworkGenerator generator(options);
+    generator.populate(routes, vehicles, ticketManager);
+    NetworkSnapshot net = routes.snapshot();
+
+    // Random trips; the last tenth is the incremental batch
+    BenchRng rng(50);
+    TicketStore tickets;
+    tickets.reserve(ticketCount);
+    Passenger rider(1, "Bench", 30);
+    int firstBatch = ticketCount - ticketCount / 10;
+    for (int t = 0; t < firstBatch; t++)
+        tickets.appendFields(t + 1, rider, net->stations[rng.nextInt(stationCount)].getID(),
+                             net->stations[rng.nextInt(stationCount)].getID(), 1704067200 + t);
+    OdMatrix od;
+    od.sync(tickets);
+
+    benchHeader();
+    cout << "#   " << net->stations.size() << " stations, " << net->routes.size() << " routes, " << od.pairCount()
+         << " OD pairs\n";
+
+    // Baseline: one heap Dijkstra per ticket
+    const int sample = 2000;
+    DynamicArray<int> path;
+    const DynamicArray<int> &starts = tickets.startStationColumn();
+    const DynamicArray<int> &ends = tickets.endStationColumn();
+    BenchTimer timer;
+    long long hops = 0;
+    for (int t = 0; t < sample; t++)
+    {
+        net->graph.shortestPath(starts[t], ends[t], path);
+        hops += path.size();
+    }
+    benchReport("load_assignment", "per_ticket_dijkstra", sample, timer.elapsedMs());
+
+    int failures = 0;
+    DynamicArray<RouteLoad> reference, loads;
+    LoadAssignment warm;
+    for (int threads = 1; threads <= 8; threads *= 2)
+    {
+        ThreadPoolOptions poolOptions;
+        poolOptions.threads = threads;
+        ThreadPool pool(poolOptions);
+        LoadAssignment engine;
+        timer.reset();
+        engine.assign(*net, od, pool);
+        benchReport("load_assignment", ("cold_" + to_string(threads) + "_threads").c_str(), firstBatch,
+                    timer.elapsedMs());
+        engine.routeLoads(*net, loads);
+        if (threads == 1)
+            reference = loads;
+        else if (!sameLoads(loads, reference))
+        {
+            cerr << "loads differ with " << threads << " threads\n";
+            failures++;
+        }
+        if (threads == 1)
+            warm.assign(*net, od, pool);
+    }
+
+    // Incremental batch on the cached trees (shared pool)
+    for (int t = firstBatch; t < ticketCount; t++)
+        tickets.appendFields(t + 1, rider, net->stations[rng.nextInt(stationCount)].getID(),
+                             net->stations[rng.nextInt(stationCount)].getID(), 1704067200 + t);
+    timer.reset();
+    od.sync(tickets);
+    benchReport("load_assignment", "incremental_od_sync", ticketCount - firstBatch, timer.elapsedMs());
+    timer.reset();
+    warm.assign(*net, od);
+    benchReport("load_assignment", "incremental_assign", ticketCount - firstBatch, timer.elapsedMs());
+    cout << "#   " << warm.cachedTrees() << " trees cached, " << warm.routedTrips() << " trips routed, "
+         << warm.unroutedTrips() << " unrouted, " << hops << " hops in the baseline sample\n";
+
+    warm.routeLoads(*net, loads);
+    long long expected = tripDistance(*net, od);
+    long long actual = loadDistance(*net, loads);
+    if (actual != expected || warm.routedTrips() + warm.unroutedTrips() != od.totalTrips())
+    {
+        cerr << "passenger-km " << actual << " differs from trips x shortest distance " << expected << "\n";
+        failures++;
+    }
+
+    if (failures != 0)
+        return 1;
+    cout << "# loads match across thread counts and the shortest distances\n";
+    return 0;
+}
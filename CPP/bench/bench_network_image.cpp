@@ -0,0 +1,95 @@
+// Network image benchmark: startup cost of mapping a read-only image versus
+// loading a snapshot, then lookup and query throughput on the mapped data.
+//
+// Build: g++ -std=c++11 -O2 -o bench_network_image bench/bench_network_image.cpp
+// Run:   ./bench_network_image [stations]     (default: 100000)
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include "bench_common.h"
+#include "../system/snapshot.h"
+#include "../system/network_image.h"
+
+using namespace std;
+
+int main(int argc, char **argv)
+{
+    int stationCount = argc > 1 ? atoi(argv[1]) : 100000;
+    const char *imagePath = "bench_network.img";
+    const char *snapshotPath = "bench_network.snap";
+
+    RouteManager routes;
+    VehicleManager vehicles;
+    TicketManager tickets;
+    HistoryManager history;
+    BenchRng rng(7);
+    streambuf *saved = cout.rdbuf(nullptr); // silence per-item output
+    for (int id = 1; id <= stationCount; id++)
+        routes.addStation(Station(id, "Station " + to_string(id), "Zone " + to_string(id % 50)));
+    int routeID = 1;
+    for (int id = 1; id <= stationCount; id++)
+    {
+        routes.addRoute(Route(routeID++, id, id % stationCount + 1, 1 + rng.nextInt(20)));
+        routes.addRoute(Route(routeID++, id, 1 + rng.nextInt(stationCount), 1 + rng.nextInt(50)));
+    }
+    cout.rdbuf(saved);
+
+    benchHeader();
+    BenchTimer timer;
+    bool ok = NetworkImage::write(imagePath, routes.getStations(), routes.getRoutes());
+    benchReport("network_image", "write", stationCount, timer.elapsedMs());
+    ok = ok && SnapshotManager::save(snapshotPath, routes, vehicles, tickets, history);
+
+    // Startup: snapshot load rebuilds in-memory structures, the image maps in O(1)
+    {
+        RouteManager r;
+        VehicleManager v;
+        TicketManager t;
+        HistoryManager h;
+        timer.reset();
+        ok = SnapshotManager::load(snapshotPath, r, v, t, h) && ok;
+        benchReport("network_image", "snapshot_load", stationCount, timer.elapsedMs());
+    }
+
+    NetworkImage image;
+    timer.reset();
+    ok = image.open(imagePath) && ok;
+    benchReport("network_image", "image_open", stationCount, timer.elapsedMs());
+
+    timer.reset();
+    ok = image.verify() && ok;
+    benchReport("network_image", "image_verify", stationCount, timer.elapsedMs());
+
+    const int lookups = 1000000;
+    long long checksum = 0;
+    timer.reset();
+    for (int i = 0; i < lookups; i++)
+        checksum += image.stationSlot(1 + rng.nextInt(stationCount));
+    benchReport("network_image", "id_lookup", lookups, timer.elapsedMs());
+
+    const int nameLookups = 100000;
+    timer.reset();
+    for (int i = 0; i < nameLookups; i++)
+        checksum += image.findStationIdByName("station " + to_string(1 + rng.nextInt(stationCount)));
+    benchReport("network_image", "name_lookup", nameLookups, timer.elapsedMs());
+
+    const int queries = 20;
+    DynamicArray<int> path;
+    timer.reset();
+    for (int i = 0; i < queries; i++)
+    {
+        int s = image.stationSlot(1 + rng.nextInt(stationCount));
+        int t = image.stationSlot(1 + rng.nextInt(stationCount));
+        checksum += image.getGraph().shortestPath(s, t, path);
+    }
+    benchReport("network_image", "dijkstra", queries, timer.elapsedMs());
+
+    cerr << "network_image: mapped=" << image.isMapped() << " checksum=" << checksum << "\n";
+    if (!ok)
+        cerr << "network_image: write, load or verify failed\n";
+    image.close();
+    remove(imagePath);
+    remove(snapshotPath);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+// Origin-destination matrix: building it from a ticket log, then query
+// latency for top-K pairs, pair counts and station marginals, overall,
+// over hour, day, week and month windows starting at any minute and over
+// calendar days and weeks. Windowed marginals are checked against a plain
+// scan of the ticket columns.
+//
+// Build: g++ -std=c++11 -O2 -pthread -o bench_od_matrix bench/bench_od_matrix.cpp
+// Run:   ./bench_od_matrix [tickets] [stations]   (default: 10000000 1000)
+
+#include <iostream>
+#include <string>
+#include "bench_common.h"
+#include "../system/od_matrix.h"
+
+using namespace std;
+
+static int stationCount;
+
+// Skewed station choice: low IDs are busier
+static int pickStation(BenchRng &rng)
+{
+    int a = rng.nextInt(stationCount);
+    int b = rng.nextInt(stationCount);
+    return 1 + (a < b ? a : b);
+}
+
+// Trips from origin in the hours that start in [from, to), by scanning
+static void scanStation(const TicketStore &tickets, int station, Timestamp from, Timestamp to, int &departures,
+                        int &arrivals)
+{
+    from = TimeBucketCounter::bucketStart(TimeBucketCounter::bucketOf(from, BUCKET_HOUR), BUCKET_HOUR);
+    to = TimeBucketCounter::bucketStart(TimeBucketCounter::bucketOf(to, BUCKET_HOUR), BUCKET_HOUR);
+    const DynamicArray<int> &starts = tickets.startStationColumn();
+    const DynamicArray<int> &ends = tickets.endStationColumn();
+    const DynamicArray<Timestamp> &times = tickets.issueTimeColumn();
+    departures = arrivals = 0;
+    for (int i = 0; i < tickets.size(); i++)
+    {
+        if (times[i] < from || times[i] >= to || starts[i] <= 0 || ends[i] <= 0)
+            continue;
+        if (starts[i] == station)
+            departures++;
+        if (ends[i] == station)
+            arrivals++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const long long defaults[] = {10000000, 1000};
+    long long sizes[2];
+    int k = benchSizes(argc, argv, sizes, 2, defaults, 2);
+    for (; k < 2; k++)
+        sizes[k] = defaults[k];
+    int ticketCount = (int)sizes[0];
+    stationCount = (int)sizes[1];
+
+    // 90 days of tickets in issue order, denser in the daytime
+    BenchRng rng(49);
+    TicketStore tickets;
+    tickets.reserve(ticketCount);
+    Passenger rider(1, "Bench", 30);
+    Timestamp start = makeTimestamp(2024, 1, 1);
+    long long span = 90 * SECONDS_PER_DAY;
+    for (int t = 0; t < ticketCount; t++)
+    {
+        Timestamp issued = start + span * t / ticketCount;
+        int origin = pickStation(rng);
+        int destination = pickStation(rng);
+        if (destination == origin)
+            destination = origin % stationCount + 1;
+        tickets.appendFields(t + 1, rider, origin, destination, issued);
+    }
+
+    benchHeader();
+    OdMatrix od;
+    BenchTimer timer;
+    od.sync(tickets);
+    benchReport("od_build", "sync_all", ticketCount, timer.elapsedMs());
+    cout << "#   " << od.pairCount() << " pairs, " << od.stationCount() << " stations\n";
+
+    const int queries = 1000;
+    DynamicArray<OdPair> pairs;
+    timer.reset();
+    for (int q = 0; q < queries; q++)
+        od.topPairs(10, pairs);
+    benchReport("od_query", "top10_all_time", queries, timer.elapsedMs());
+
+    long long sink = 0;
+    timer.reset();
+    for (int q = 0; q < queries; q++)
+        sink += od.tripsBetween(pickStation(rng), pickStation(rng)) + od.departuresFrom(pickStation(rng)) +
+                od.arrivalsAt(pickStation(rng));
+    benchReport("od_query", "pair_and_marginals_all_time", queries, timer.elapsedMs());
+
+    const char *names[] = {"hour", "day", "week", "month"};
+    const long long lengths[] = {SECONDS_PER_HOUR, SECONDS_PER_DAY, SECONDS_PER_WEEK, 30 * SECONDS_PER_DAY};
+    int failures = 0;
+    for (int w = 0; w < 4; w++)
+    {
+        // Windows starting at random minutes inside the log
+        DynamicArray<Timestamp> froms;
+        for (int q = 0; q < queries; q++)
+            froms.push_back(start + (Timestamp)rng.nextInt((int)(span - lengths[w]) / 60) * 60);
+
+        timer.reset();
+        for (int q = 0; q < queries; q++)
+            od.topPairs(10, froms[q], froms[q] + lengths[w], pairs);
+        benchReport("od_query", ("top10_" + string(names[w])).c_str(), queries, timer.elapsedMs());
+
+        timer.reset();
+        for (int q = 0; q < queries; q++)
+        {
+            int departures, arrivals;
+            od.stationTrips(pickStation(rng), froms[q], froms[q] + lengths[w], departures, arrivals);
+            sink += departures + arrivals + od.tripsBetween(pickStation(rng), pickStation(rng), froms[q],
+                                                            froms[q] + lengths[w]);
+        }
+        benchReport("od_query", ("pair_and_marginals_" + string(names[w])).c_str(), queries, timer.elapsedMs());
+
+        // Spot checks against a scan of the columns
+        for (int q = 0; q < 3; q++)
+        {
+            int station = pickStation(rng);
+            int departures, arrivals, expectedDepartures, expectedArrivals;
+            od.stationTrips(station, froms[q], froms[q] + lengths[w], departures, arrivals);
+            scanStation(tickets, station, froms[q], froms[q] + lengths[w], expectedDepartures, expectedArrivals);
+            if (departures != expectedDepartures || arrivals != expectedArrivals)
+                failures++;
+        }
+    }
+    // Whole calendar days and weeks: one slice each
+    const int granularities[] = {BUCKET_DAY, BUCKET_WEEK};
+    for (int w = 0; w < 2; w++)
+    {
+        long long first = TimeBucketCounter::bucketOf(start, granularities[w]) + 1;
+        long long last = TimeBucketCounter::bucketOf(start + span, granularities[w]);
+        timer.reset();
+        for (int q = 0; q < queries; q++)
+        {
+            long long b = first + q % (last - first);
+            od.topPairs(10, TimeBucketCounter::bucketStart(b, granularities[w]),
+                        TimeBucketCounter::bucketStart(b + 1, granularities[w]), pairs);
+            sink += pairs.size();
+        }
+        benchReport("od_query", w == 0 ? "top10_calendar_day" : "top10_calendar_week", queries, timer.elapsedMs());
+    }
+    cout << "#   checksum " << sink << "\n";
+
+    if (failures != 0)
+    {
+        cerr << failures << " windowed marginals differ from a scan of the ticket log\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Display/export output: the ticket listing written line by line with endl
+// (one flush per line, as the display paths used to do) against the
+// buffered OutputSink in text, CSV and JSON. Output goes to a scratch file
+// that is removed at the end.
+//
+// Build: g++ -std=c++11 -O2 -o bench_output bench/bench_output.cpp
+// Run:   ./bench_output [tickets] [stations]
+//        (defaults: 1000000 10000)
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include "bench_common.h"
+#include "../system/network_generator.h"
+
+using namespace std;
+
+static const char *scratchPath = "bench_output.tmp";
+
+static long long fileSize()
+{
+    ifstream in(scratchPath, ios::binary | ios::ate);
+    return in ? (long long)in.tellg() : 0;
+}
+
+int main(int argc, char **argv)
+{
+    const long long defaults[] = {1000000, 10000};
+    long long sizes[2];
+    int k = benchSizes(argc, argv, sizes, 2, defaults, 2);
+    for (; k < 2; k++)
+        sizes[k] = defaults[k];
+
+    RouteManager routes;
+    VehicleManager vehicles;
+    TicketManager tickets;
+    GeneratorOptions options;
+    options.stations = (int)sizes[1];
+    options.tickets = (int)sizes[0];
+    options.seed = 45;
+    NetworkGenerator generator(options);
+    generator.populate(routes, vehicles, tickets);
+    routes.setInstance();
+    int n = tickets.totalTicketsIssued();
+
+    benchHeader();
+    {
+        // Old display path: stream operators and endl on every line
+        ofstream file(scratchPath, ios::binary);
+        const TicketStore &store = tickets.getAllTickets();
+        BenchTimer timer;
+        file << "Issued Tickets:" << endl;
+        for (int i = 0; i < store.size(); i++)
+        {
+            Ticket t = store.get(i);
+            file << "Ticket ID: " << t.getTicketID() << " | ";
+            const Passenger &p = t.getPassengerRef();
+            file << "Passenger ID: " << p.getID() << ", Name: " << p.getName() << ", Age: " << p.getAge() << endl;
+            file << "    Route: " << RouteManager::getStationNameByIdStatic(t.getStartStationID()) << " -> "
+                 << RouteManager::getStationNameByIdStatic(t.getEndStationID()) << endl;
+        }
+        benchReport("output", "tickets_text_endl", n, timer.elapsedMs());
+    }
+    long long endlBytes = fileSize();
+
+    const char *variants[] = {"tickets_text_sink", "tickets_csv_sink", "tickets_json_sink"};
+    const OutputFormat formats[] = {OUTPUT_TEXT, OUTPUT_CSV, OUTPUT_JSON};
+    long long textBytes = 0;
+    for (int v = 0; v < 3; v++)
+    {
+        ofstream file(scratchPath, ios::binary);
+        BenchTimer timer;
+        {
+            OutputSink sink(file, 1 << 20);
+            tickets.exportTickets(sink, formats[v], RouteManager::getStationNameByIdStatic);
+        }
+        benchReport("output", variants[v], n, timer.elapsedMs());
+        file.close();
+        if (v == 0)
+            textBytes = fileSize();
+    }
+    remove(scratchPath);
+
+    if (endlBytes != textBytes)
+    {
+        cerr << "text output differs in size: " << endlBytes << " vs " << textBytes << " bytes\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,199 @@
+// Parallel analytics over the ticket log: per-station departures/arrivals
+// (traffic density, most crowded station), busiest route and the calendar
+// index behind the usage trends, each run with pools of 1, 2, 4 and 8
+// threads. Every result is compared with a serial reference: the original
+// per-ticket station and route loops and the calendar index kept
+// incrementally while the tickets were appended.
+//
+// Build: g++ -std=c++11 -O2 -pthread -o bench_parallel_analytics bench/bench_parallel_analytics.cpp
+// Run:   ./bench_parallel_analytics [tickets] [stations]   (default: 10000000 50)
+
+#include <iostream>
+#include <string>
+#include "bench_common.h"
+#include "../system/analytics.h"
+
+using namespace std;
+
+// Original nested loops of trafficDensityPrediction (countUnknown) and
+// mostCrowdedStationByTickets (IDs <= 0 skipped)
+static void referenceActivity(const DynamicArray<Station> &stations, const TicketStore &tickets, bool countUnknown,
+                              DynamicArray<int> &activity)
+{
+    activity.clear();
+    for (int j = 0; j < stations.size(); j++)
+        activity.push_back(0);
+    const DynamicArray<int> &starts = tickets.startStationColumn();
+    const DynamicArray<int> &ends = tickets.endStationColumn();
+    for (int i = 0; i < tickets.size(); i++)
+    {
+        int startID = starts[i];
+        int endID = ends[i];
+        for (int j = 0; j < stations.size(); j++)
+        {
+            int id = stations[j].getID();
+            if ((countUnknown || startID > 0) && id == startID)
+                activity[j]++;
+            if ((countUnknown || endID > 0) && id == endID)
+                activity[j]++;
+        }
+    }
+}
+
+// Original nested loops of busiestRouteByTickets: index of the busiest route
+// (first of equal pairs) and its ticket count, or -1
+static int referenceBusiestRoute(const DynamicArray<Route> &routes, const TicketStore &tickets, int &maxCount)
+{
+    // Store route keys and counts
+    DynamicArray<Pair<int, int>> routeKeys; // {startID, endID}
+    DynamicArray<int> routeCounts;
+
+    for (int i = 0; i < routes.size(); i++)
+    {
+        routeKeys.push_back(Pair<int, int>(routes[i].getStartStationID(), routes[i].getEndStationID()));
+        routeCounts.push_back(0);
+    }
+
+    // Only the start/end columns are read
+    const DynamicArray<int> &starts = tickets.startStationColumn();
+    const DynamicArray<int> &ends = tickets.endStationColumn();
+    for (int i = 0; i < tickets.size(); i++)
+    {
+        int startID = starts[i];
+        int endID = ends[i];
+        for (int j = 0; j < routeKeys.size(); j++)
+        {
+            if (routeKeys[j].first == startID && routeKeys[j].second == endID)
+            {
+                routeCounts[j]++;
+                break;
+            }
+        }
+    }
+
+    maxCount = 0;
+    int busiestIdx = -1;
+    for (int i = 0; i < routeCounts.size(); i++)
+    {
+        if (routeCounts[i] > maxCount)
+        {
+            maxCount = routeCounts[i];
+            busiestIdx = i;
+        }
+    }
+    return busiestIdx;
+}
+
+static bool sameTimeline(const TimeBucketCounter &a, const TimeBucketCounter &b)
+{
+    if (a.totalEvents() != b.totalEvents())
+        return false;
+    for (int g = 0; g < TIME_GRANULARITIES; g++)
+    {
+        if (a.firstBucketOf(g) != b.firstBucketOf(g) || a.lastBucketOf(g) != b.lastBucketOf(g))
+            return false;
+        for (long long k = a.firstBucketOf(g); k <= a.lastBucketOf(g); k = a.nextBucket(g, k + 1))
+            if (a.count(g, k) != b.count(g, k))
+                return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const long long defaults[] = {10000000, 50};
+    long long sizes[2];
+    int k = benchSizes(argc, argv, sizes, 2, defaults, 2);
+    for (; k < 2; k++)
+        sizes[k] = defaults[k];
+    int ticketCount = (int)sizes[0];
+    int stationCount = (int)sizes[1];
+
+    // Station IDs 1..S plus a duplicate ID and a station with ID 0
+    DynamicArray<Station> stations;
+    for (int id = 1; id <= stationCount; id++)
+        stations.push_back(Station(id, "Station " + to_string(id)));
+    stations.push_back(Station(1, "Duplicate"));
+    stations.push_back(Station(0, "Unknown"));
+    DynamicArray<Route> routes;
+    for (int id = 1; id <= stationCount; id++)
+        routes.push_back(Route(id, id, id % stationCount + 1, 1.0));
+
+    // Tickets in issue order, a few issued late (out of order) and a few
+    // without a known start or end station
+    BenchRng rng(48);
+    TicketStore tickets;
+    tickets.reserve(ticketCount);
+    Passenger rider(1, "Bench", 30);
+    Timestamp now = 1700000000;
+    for (int t = 0; t < ticketCount; t++)
+    {
+        now += rng.nextInt(3);
+        Timestamp issued = rng.nextInt(100) == 0 ? now - rng.nextInt(30 * 86400) : now;
+        int s = rng.nextInt(100) == 0 ? 0 : 1 + rng.nextInt(stationCount + 2);
+        int e = rng.nextInt(2) == 0 ? s % stationCount + 1 : 1 + rng.nextInt(stationCount);
+        tickets.appendFields(t + 1, rider, s, e, issued);
+        tickets.countIssued(issued, 1);
+    }
+
+    benchHeader();
+    DynamicArray<int> trafficReference, crowdedReference;
+    BenchTimer timer;
+    referenceActivity(stations, tickets, true, trafficReference);
+    referenceActivity(stations, tickets, false, crowdedReference);
+    benchReport("station_activity", "nested_loops_serial", 2LL * ticketCount, timer.elapsedMs());
+
+    int routeReferenceCount = 0;
+    timer.reset();
+    int routeReference = referenceBusiestRoute(routes, tickets, routeReferenceCount);
+    benchReport("busiest_route", "nested_loops_serial", ticketCount, timer.elapsedMs());
+
+    int failures = 0;
+    for (int threads = 1; threads <= 8; threads *= 2)
+    {
+        ThreadPoolOptions options;
+        options.threads = threads;
+        ThreadPool pool(options);
+        string variant = to_string(threads) + "_threads";
+
+        DynamicArray<int> departures, arrivals;
+        timer.reset();
+        Analytics::stationTicketCounts(stations, tickets, departures, arrivals, pool);
+        benchReport("station_activity", variant.c_str(), ticketCount, timer.elapsedMs());
+        for (int i = 0; i < stations.size(); i++)
+        {
+            int crowded = stations[i].getID() > 0 ? departures[i] + arrivals[i] : 0;
+            if (departures[i] + arrivals[i] != trafficReference[i] || crowded != crowdedReference[i])
+            {
+                cerr << "station activity differs at slot " << i << " with " << threads << " threads\n";
+                failures++;
+                break;
+            }
+        }
+
+        int count = 0;
+        timer.reset();
+        int busiest = Analytics::busiestRoute(routes, tickets, count, pool);
+        benchReport("busiest_route", variant.c_str(), ticketCount, timer.elapsedMs());
+        if (busiest != routeReference || count != routeReferenceCount)
+        {
+            cerr << "busiest route differs with " << threads << " threads\n";
+            failures++;
+        }
+
+        TimeBucketCounter timeline;
+        timer.reset();
+        tickets.buildTimeline(timeline, pool);
+        benchReport("build_timeline", variant.c_str(), ticketCount, timer.elapsedMs());
+        if (!sameTimeline(timeline, tickets.issueTimeline()))
+        {
+            cerr << "calendar index differs with " << threads << " threads\n";
+            failures++;
+        }
+    }
+
+    if (failures != 0)
+        return 1;
+    cout << "# all parallel results match the serial references\n";
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Search benchmark: binarySearch vs branchless lowerBound vs EytzingerIndex
+// on sorted arrays sized for L1, L2, L3 and DRAM, plus linearSearch vs the
+// SIMD linearSearchInt on short scans.
+//
+// Build: g++ -std=c++11 -O2 -o bench_searching bench/bench_searching.cpp
+// Run:   ./bench_searching [lookups]     (default: 2000000)
+
+#include <iostream>
+#include <cstdlib>
+#include "bench_common.h"
+#include "../ds/searching.h"
+
+using namespace std;
+
+static volatile long long benchSink; // keeps results from being optimized away
+
+static void benchSortedSearch(const char *level, int n, int lookups)
+{
+    // Sorted even numbers: half the probes hit, half miss
+    int *arr = new int[n];
+    for (int i = 0; i < n; i++)
+        arr[i] = 2 * i;
+
+    int *probes = new int[lookups];
+    BenchRng rng(n);
+    for (int i = 0; i < lookups; i++)
+        probes[i] = rng.nextInt(2 * n);
+
+    long long acc = 0;
+    BenchTimer timer;
+    for (int i = 0; i < lookups; i++)
+        acc += binarySearch(arr, n, probes[i]);
+    benchReport(level, "binarySearch", lookups, timer.elapsedMs());
+
+    timer.reset();
+    for (int i = 0; i < lookups; i++)
+        acc += lowerBound(arr, n, probes[i]);
+    benchReport(level, "lowerBound", lookups, timer.elapsedMs());
+
+    EytzingerIndex<int> eytz(arr, n);
+    timer.reset();
+    for (int i = 0; i < lookups; i++)
+        acc += eytz.lowerBound(probes[i]);
+    benchReport(level, "eytzinger", lookups, timer.elapsedMs());
+
+    benchSink = acc;
+    delete[] arr;
+    delete[] probes;
+}
+
+static void benchLinearScan(int n, int lookups)
+{
+    int *arr = new int[n];
+    BenchRng rng(n + 1);
+    for (int i = 0; i < n; i++)
+        arr[i] = (int)rng.next();
+
+    int *probes = new int[lookups];
+    for (int i = 0; i < lookups; i++)
+        probes[i] = arr[rng.nextInt(n)];
+
+    long long acc = 0;
+    BenchTimer timer;
+    for (int i = 0; i < lookups; i++)
+        acc += linearSearch(arr, n, probes[i]);
+    benchReport("linear", "linearSearch", lookups, timer.elapsedMs());
+
+    timer.reset();
+    for (int i = 0; i < lookups; i++)
+        acc += linearSearchInt(arr, n, probes[i]);
+    benchReport("linear", intSearchKernelName(), lookups, timer.elapsedMs());
+
+    benchSink = acc;
+    delete[] arr;
+    delete[] probes;
+}
+
+int main(int argc, char **argv)
+{
+    int lookups = argc > 1 ? atoi(argv[1]) : 2000000;
+
+    benchHeader();
+    benchSortedSearch("L1_4K", 4 * 1024, lookups); // 16 KB
+    benchSortedSearch("L2_64K", 64 * 1024, lookups); // 256 KB
+    benchSortedSearch("L3_1M", 1024 * 1024, lookups); // 4 MB
+    benchSortedSearch("DRAM_64M", 64 * 1024 * 1024, lookups); // 256 MB
+    benchLinearScan(256, lookups);
+    return 0;
+}
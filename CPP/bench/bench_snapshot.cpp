@@ -0,0 +1,98 @@
+// Snapshot persistence benchmark: save and load of a large network state
+// (stations, routes, vehicles, tickets, history), plus a round-trip check
+// that re-serializing the loaded state reproduces the file byte for byte.
+//
+// Build: g++ -std=c++11 -O2 -o bench_snapshot bench/bench_snapshot.cpp
+// Run:   ./bench_snapshot [stations] [tickets]     (default: 100000 1000000)
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include "bench_common.h"
+#include "../system/snapshot.h"
+
+using namespace std;
+
+static void buildState(int stationCount, int ticketCount, RouteManager &routes, VehicleManager &vehicles,
+                       TicketManager &tickets, HistoryManager &history)
+{
+    BenchRng rng(42);
+    streambuf *saved = cout.rdbuf(nullptr); // silence per-item output
+    for (int id = 1; id <= stationCount; id++)
+        routes.addStation(Station(id, "Station " + to_string(id), "Zone " + to_string(id % 50)));
+
+    // A ring plus one random chord per station
+    int routeID = 1;
+    for (int id = 1; id <= stationCount; id++)
+    {
+        int next = id % stationCount + 1;
+        routes.addRoute(Route(routeID++, id, next, 1 + rng.nextInt(20)));
+        routes.addRoute(Route(routeID++, id, 1 + rng.nextInt(stationCount), 1 + rng.nextInt(50)));
+    }
+
+    for (int id = 1; id <= 1000; id++)
+        vehicles.addVehicle(Vehicle(id, "Bus " + to_string(id), 20 + rng.nextInt(60)));
+
+    const char *names[] = {"Ali", "Sara", "Omar", "Hina", "Zain", "Ayesha", "Bilal", "Fatima"};
+    for (int i = 0; i < ticketCount; i++)
+        tickets.addPassengerToQueue(Passenger(i, names[i % 8], 18 + i % 60));
+    cout.rdbuf(saved);
+
+    DynamicArray<int> starts(4096), ends(4096);
+    for (int i = 0; i < 4096; i++)
+    {
+        starts.push_back(1 + rng.nextInt(stationCount));
+        ends.push_back(1 + rng.nextInt(stationCount));
+    }
+    while (tickets.issueTicketBatch(4096, starts.getRawArray(), ends.getRawArray()).issued > 0)
+    {
+    }
+
+    for (int i = 0; i < 1000; i++)
+        history.addAction("ADD_STATION:" + to_string(i + 1) + ":Station " + to_string(i + 1) + ":Zone");
+}
+
+int main(int argc, char **argv)
+{
+    int stationCount = argc > 1 ? atoi(argv[1]) : 100000;
+    int ticketCount = argc > 2 ? atoi(argv[2]) : 1000000;
+    const char *path = "bench_snapshot.snap";
+
+    RouteManager routes;
+    VehicleManager vehicles;
+    TicketManager tickets;
+    HistoryManager history;
+    buildState(stationCount, ticketCount, routes, vehicles, tickets, history);
+
+    benchHeader();
+    BenchTimer timer;
+    bool saved = SnapshotManager::save(path, routes, vehicles, tickets, history);
+    benchReport("snapshot", "save", ticketCount, timer.elapsedMs());
+
+    RouteManager loadedRoutes;
+    VehicleManager loadedVehicles;
+    TicketManager loadedTickets;
+    HistoryManager loadedHistory;
+    timer.reset();
+    bool loaded = SnapshotManager::load(path, loadedRoutes, loadedVehicles, loadedTickets, loadedHistory);
+    benchReport("snapshot", "load", ticketCount, timer.elapsedMs());
+
+    // Round trip: the loaded state must serialize to the same bytes
+    BinaryWriter original, restored;
+    SnapshotManager::serialize(original, routes, vehicles, tickets, history);
+    SnapshotManager::serialize(restored, loadedRoutes, loadedVehicles, loadedTickets, loadedHistory);
+    bool same = saved && loaded && original.size() == restored.size() &&
+                memcmp(original.bytes(), restored.bytes(), original.size()) == 0;
+    for (int id = 1; same && id <= ticketCount; id++)
+        same = loadedTickets.validateTicket(id);
+    same = same && loadedRoutes.stationExists(stationCount);
+
+    cerr << "snapshot: " << original.size() / (1024 * 1024) << " MiB, "
+         << loadedRoutes.totalStations() << " stations, " << loadedRoutes.totalRoutes() << " routes, "
+         << loadedTickets.totalTicketsIssued() << " tickets\n";
+    if (!same)
+        cerr << "snapshot: loaded state does not match the saved state\n";
+    remove(path);
+    return same ? 0 : 1;
+}
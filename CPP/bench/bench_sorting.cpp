@@ -0,0 +1,114 @@
+// Sorting benchmark: radixSort / radixSortIndices, introSort and the
+// buffered / parallel merge sorts vs mergeSort and quickSort on random keys.
+//
+// Build: g++ -std=c++11 -O2 -pthread -o bench_sorting bench/bench_sorting.cpp
+// Run:   ./bench_sorting [n1 n2 ...]     (default: 1000000 10000000)
+//        ./bench_sorting 100000000       (needs ~2 GB of RAM)
+
+#include <iostream>
+#include "bench_common.h"
+#include "../ds/array.h"
+#include "../ds/sorting.h"
+#include "../ds/parallel_sorting.h"
+#include "../models/ticket.h"
+
+using namespace std;
+
+static int ticketIdKey(const Ticket &t) { return t.getTicketID(); }
+
+static bool isSorted(const int arr[], int n)
+{
+    for (int i = 1; i < n; i++)
+        if (arr[i - 1] > arr[i])
+            return false;
+    return true;
+}
+
+static void fillRandom(int arr[], int n, unsigned long long seed)
+{
+    BenchRng rng(seed);
+    for (int i = 0; i < n; i++)
+        arr[i] = (int)rng.next();
+}
+
+static void benchIntArrays(int n)
+{
+    int *data = new int[n];
+    BenchTimer timer;
+
+    fillRandom(data, n, 42);
+    timer.reset();
+    radixSort(data, n);
+    benchReport("sort_int", "radixSort", n, timer.elapsedMs());
+    if (!isSorted(data, n))
+        cerr << "radixSort produced unsorted output\n";
+
+    fillRandom(data, n, 42);
+    timer.reset();
+    introSort(data, n);
+    benchReport("sort_int", "introSort", n, timer.elapsedMs());
+
+    fillRandom(data, n, 42);
+    timer.reset();
+    quickSort(data, 0, n - 1);
+    benchReport("sort_int", "quickSort", n, timer.elapsedMs());
+
+    fillRandom(data, n, 42);
+    timer.reset();
+    mergeSort(data, 0, n - 1);
+    benchReport("sort_int", "mergeSort", n, timer.elapsedMs());
+
+    fillRandom(data, n, 42);
+    timer.reset();
+    mergeSortBuffered(data, n);
+    benchReport("sort_int", "mergeSortBuffered", n, timer.elapsedMs());
+
+    fillRandom(data, n, 42);
+    timer.reset();
+    parallelMergeSort(data, n);
+    benchReport("sort_int", "parallelMergeSort", n, timer.elapsedMs());
+    if (!isSorted(data, n))
+        cerr << "parallelMergeSort produced unsorted output\n";
+
+    delete[] data;
+}
+
+// Sorting heavy records by ID: a permutation vs moving the records
+static void benchTickets(int n)
+{
+    DynamicArray<Ticket> tickets(n);
+    BenchRng rng(7);
+    for (int i = 0; i < n; i++)
+        tickets.push_back(Ticket(rng.nextInt(n), Passenger(i, "Passenger", 30), 1, 2));
+
+    BenchTimer timer;
+    DynamicArray<int> order(n);
+    radixSortIndices(tickets, ticketIdKey, order);
+    benchReport("sort_ticket", "radixSortIndices", n, timer.elapsedMs());
+
+    DynamicArray<Ticket> copy = tickets;
+    timer.reset();
+    introSortByKey(copy.getRawArray(), copy.size(), ticketIdKey);
+    benchReport("sort_ticket", "introSortByKey", n, timer.elapsedMs());
+
+    copy = tickets;
+    timer.reset();
+    parallelMergeSort(copy.getRawArray(), copy.size(), KeyCompare<int (*)(const Ticket &)>(ticketIdKey, true));
+    benchReport("sort_ticket", "parallelMergeSort", n, timer.elapsedMs());
+}
+
+int main(int argc, char **argv)
+{
+    const long long defaults[] = {1000000, 10000000};
+    long long sizes[16];
+    int numSizes = benchSizes(argc, argv, sizes, 16, defaults, 2);
+
+    benchHeader();
+    for (int s = 0; s < numSizes; s++)
+    {
+        benchIntArrays((int)sizes[s]);
+        // Ticket records are ~100 bytes each; cap so the copy fits in memory
+        benchTickets((int)(sizes[s] < 10000000 ? sizes[s] : 10000000));
+    }
+    return 0;
+}
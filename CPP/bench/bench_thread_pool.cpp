@@ -0,0 +1,159 @@
+// Thread pool benchmark: task overhead of parallelFor, a parallelReduce sum,
+// Graph::addEdges and Graph::distanceMatrix with pools of 1, 2, 4 and 8
+// threads, and Analytics::busiestRoute on the shared pool. Every parallel
+// result is checked against the one-thread result (graphs byte for byte).
+//
+// Build: g++ -std=c++11 -O2 -pthread -o bench_thread_pool bench/bench_thread_pool.cpp
+// Run:   ./bench_thread_pool [stations] [edges] [tickets]   (default: 200000 2000000 10000000)
+//        ITNMS_THREADS sets the shared pool used by busiestRoute.
+
+#include <iostream>
+#include <cstring>
+#include <string>
+#include "bench_common.h"
+#include "../system/analytics.h"
+#include "../ds/binary_stream.h"
+
+using namespace std;
+
+// Touches nothing: measures scheduling cost only
+struct EmptyBody
+{
+    void operator()(int, int) const {}
+};
+
+struct SumBody
+{
+    const int *values;
+
+    void operator()(int lo, int hi, long long &sum) const
+    {
+        for (int i = lo; i < hi; i++)
+            sum += values[i];
+    }
+};
+
+static void addSums(long long &a, const long long &b) { a += b; }
+
+static void buildGraph(Graph &g, int stations, const DynamicArray<int> &from, const DynamicArray<int> &to,
+                       const DynamicArray<int> &weights, ThreadPool *pool)
+{
+    g.reserveVertices(stations);
+    for (int id = 1; id <= stations; id++)
+        g.addVertex(id);
+    g.addEdges(from.getRawArray(), to.getRawArray(), weights.getRawArray(), from.size(), pool);
+}
+
+static bool sameGraph(const Graph &a, const Graph &b)
+{
+    BinaryWriter wa, wb;
+    a.writeSnapshot(wa);
+    b.writeSnapshot(wb);
+    return wa.size() == wb.size() && memcmp(wa.bytes(), wb.bytes(), wa.size()) == 0;
+}
+
+int main(int argc, char **argv)
+{
+    const long long defaults[] = {200000, 2000000, 10000000};
+    long long sizes[3];
+    int k = benchSizes(argc, argv, sizes, 3, defaults, 3);
+    for (; k < 3; k++)
+        sizes[k] = defaults[k];
+    int stations = (int)sizes[0];
+    int edges = (int)sizes[1];
+    int ticketCount = (int)sizes[2];
+    ThreadPool::configureShared(ThreadPoolOptions::fromEnvironment());
+
+    BenchRng rng(47);
+    DynamicArray<int> from(edges), to(edges), weights(edges);
+    for (int e = 0; e < edges; e++)
+    {
+        from.push_back(1 + rng.nextInt(stations));
+        to.push_back(1 + rng.nextInt(stations));
+        weights.push_back(1 + rng.nextInt(50));
+    }
+    const int sourceCount = 16;
+    DynamicArray<int> targets(sourceCount);
+    for (int i = 0; i < sourceCount; i++)
+        targets.push_back(1 + rng.nextInt(stations));
+
+    Graph reference;
+    buildGraph(reference, stations, from, to, weights, nullptr);
+    DynamicArray<int> referenceMatrix;
+    reference.distanceMatrix(targets.getRawArray(), sourceCount, targets.getRawArray(), sourceCount, referenceMatrix);
+    long long referenceSum = 0;
+    for (int e = 0; e < edges; e++)
+        referenceSum += weights[e];
+
+    benchHeader();
+    int failures = 0;
+    for (int threads = 1; threads <= 8; threads *= 2)
+    {
+        ThreadPoolOptions options;
+        options.threads = threads;
+        ThreadPool pool(options);
+        string suffix = "_" + to_string(threads) + "_threads";
+
+        EmptyBody empty;
+        const int loops = 1000;
+        BenchTimer timer;
+        for (int r = 0; r < loops; r++)
+            parallelFor(pool, 0, 64 * threads, 1, empty);
+        benchReport("parallel_for", ("empty_tasks" + suffix).c_str(), (long long)loops * 64 * threads,
+                    timer.elapsedMs());
+
+        SumBody sum;
+        sum.values = weights.getRawArray();
+        timer.reset();
+        long long total = 0;
+        for (int r = 0; r < 10; r++)
+            total = parallelReduce(pool, 0, edges, 65536, 0LL, sum, addSums);
+        benchReport("parallel_reduce", ("sum" + suffix).c_str(), 10LL * edges, timer.elapsedMs());
+        if (total != referenceSum)
+            failures++;
+
+        Graph g;
+        timer.reset();
+        buildGraph(g, stations, from, to, weights, &pool);
+        benchReport("graph_add_edges", ("edges" + suffix).c_str(), edges, timer.elapsedMs());
+        if (!sameGraph(g, reference))
+            failures++;
+
+        DynamicArray<int> matrix;
+        timer.reset();
+        g.distanceMatrix(targets.getRawArray(), sourceCount, targets.getRawArray(), sourceCount, matrix, &pool);
+        benchReport("distance_matrix", ("sources" + suffix).c_str(), sourceCount, timer.elapsedMs());
+        for (int i = 0; i < matrix.size(); i++)
+            if (matrix[i] != referenceMatrix[i])
+            {
+                failures++;
+                break;
+            }
+    }
+
+    // busiestRoute always runs on the shared pool
+    DynamicArray<Route> routes(stations);
+    for (int id = 1; id <= stations; id++)
+        routes.push_back(Route(id, id, id % stations + 1, 1.0));
+    TicketStore tickets;
+    tickets.reserve(ticketCount);
+    Passenger rider(1, "Bench", 30);
+    for (int t = 0; t < ticketCount; t++)
+    {
+        int s = 1 + rng.nextInt(stations);
+        tickets.append(Ticket(t + 1, rider, s, s % stations + 1));
+    }
+    int count = 0;
+    BenchTimer timer;
+    int busiest = Analytics::busiestRoute(routes, tickets, count);
+    string variant = "tickets_shared_" + to_string(ThreadPool::shared().size()) + "_threads";
+    benchReport("busiest_route", variant.c_str(), ticketCount, timer.elapsedMs());
+    cout << "#   busiest route index " << busiest << " with " << count << " tickets\n";
+
+    if (failures != 0)
+    {
+        cerr << failures << " parallel results differ from the one-thread results\n";
+        return 1;
+    }
+    return 0;
+}
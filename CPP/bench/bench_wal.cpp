@@ -0,0 +1,160 @@
+// Write-ahead log benchmark: logged mutation throughput at each sync mode,
+// group commit with concurrent writers, and crash recovery (snapshot +
+// log replay) checked byte-for-byte against the state that was logged.
+//
+// Build: g++ -std=c++11 -O2 -pthread -o bench_wal bench/bench_wal.cpp
+// Run:   ./bench_wal [mutations]     (default: 200000)
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include "bench_common.h"
+#include "../system/recovery.h"
+
+using namespace std;
+
+static const char *walPath = "bench_wal.wal";
+static const char *snapshotPath = "bench_wal.snap";
+
+// n station inserts through a RouteManager logging at the given mode
+static void benchMode(const char *name, WalSyncMode mode, int n)
+{
+    remove(walPath);
+    WriteAheadLog wal;
+    wal.open(walPath, WalOptions(mode));
+    RouteManager routes;
+    routes.attachLog(&wal);
+
+    streambuf *saved = cout.rdbuf(nullptr);
+    BenchTimer timer;
+    for (int id = 1; id <= n; id++)
+        routes.addStation(Station(id, "Station " + to_string(id), "Zone"));
+    wal.sync();
+    double ms = timer.elapsedMs();
+    cout.rdbuf(saved);
+    benchReport("wal", name, n, ms);
+}
+
+static void writerMain(WriteAheadLog *wal, int writer, int count)
+{
+    for (int i = 0; i < count; i++)
+        wal->logId(WAL_STATION_PASSENGER, writer);
+}
+
+// fsync-per-commit with several writers: group commit shares each fsync
+static void benchGroupCommit(int writers, int total)
+{
+    remove(walPath);
+    WriteAheadLog wal;
+    wal.open(walPath, WalOptions(WAL_SYNC_ALWAYS));
+    int perWriter = total / writers;
+
+    BenchTimer timer;
+    thread *threads = new thread[writers];
+    for (int w = 0; w < writers; w++)
+        threads[w] = thread(writerMain, &wal, w, perWriter);
+    for (int w = 0; w < writers; w++)
+        threads[w].join();
+    double ms = timer.elapsedMs();
+    delete[] threads;
+
+    string variant = "always_group_" + to_string(writers) + "w";
+    benchReport("wal", variant.c_str(), (long long)perWriter * writers, ms);
+}
+
+// A mixed workload: half before a checkpoint, half only in the log
+static void mutate(RouteManager &routes, VehicleManager &vehicles, TicketManager &tickets,
+                   HistoryManager &history, BenchRng &rng, int firstID, int n)
+{
+    for (int id = firstID; id < firstID + n; id++)
+    {
+        routes.addStation(Station(id, "Station " + to_string(id), "Zone " + to_string(id % 20)));
+        if (id > 1)
+            routes.addRoute(Route(id, id - 1, 1 + rng.nextInt(id - 1), 1 + rng.nextInt(30)));
+        if (id % 10 == 0)
+            vehicles.addVehicle(Vehicle(id, "Bus " + to_string(id), 20 + rng.nextInt(60)));
+        tickets.addPassengerToQueue(Passenger(id, "Passenger " + to_string(id), 18 + rng.nextInt(60)));
+        history.addAction("ADD_STATION:" + to_string(id));
+        if (id % 4 == 0)
+            tickets.issueTicketBatch(3, id - 1, id);
+        if (id % 7 == 0)
+            tickets.processNextPassenger(id, 1);
+        if (id % 9 == 0)
+        {
+            routes.incrementStationPassengers(id);
+            history.undo();
+        }
+        if (id % 50 == 0)
+            routes.removeRouteById(id - 20);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int n = argc > 1 ? atoi(argv[1]) : 200000;
+    bool ok = true;
+
+    benchHeader();
+    benchMode("none", WAL_SYNC_NONE, n);
+    benchMode("batch", WAL_SYNC_BATCH, n);
+    benchMode("always", WAL_SYNC_ALWAYS, n / 100);
+    for (int writers = 1; writers <= 8; writers *= 2)
+        benchGroupCommit(writers, n / 100);
+
+    // Recovery: checkpoint part way, crash (no final snapshot), recover
+    remove(walPath);
+    remove(snapshotPath);
+    int mutations = n / 10;
+    BinaryWriter expected, actual;
+    long long walBytes = 0;
+    {
+        RouteManager routes;
+        VehicleManager vehicles;
+        TicketManager tickets;
+        HistoryManager history;
+        WriteAheadLog wal;
+        ok = wal.open(walPath, WalOptions(WAL_SYNC_NONE)) && ok;
+        routes.attachLog(&wal);
+        vehicles.attachLog(&wal);
+        tickets.attachLog(&wal);
+        history.attachLog(&wal);
+
+        BenchRng rng(11);
+        streambuf *saved = cout.rdbuf(nullptr);
+        mutate(routes, vehicles, tickets, history, rng, 1, mutations / 2);
+        ok = RecoveryManager::checkpoint(snapshotPath, wal, routes, vehicles, tickets, history) && ok;
+        mutate(routes, vehicles, tickets, history, rng, mutations / 2 + 1, mutations - mutations / 2);
+        cout.rdbuf(saved);
+        ok = wal.sync() && ok;
+        SnapshotManager::serialize(expected, routes, vehicles, tickets, history);
+
+        FILE *f = fopen(walPath, "rb");
+        if (f)
+        {
+            fseek(f, 0, SEEK_END);
+            walBytes = ftell(f);
+            fclose(f);
+        }
+    }
+
+    RouteManager routes;
+    VehicleManager vehicles;
+    TicketManager tickets;
+    HistoryManager history;
+    long long lastLsn = 0;
+    int replayed = 0;
+    BenchTimer timer;
+    ok = RecoveryManager::recover(snapshotPath, walPath, routes, vehicles, tickets, history, lastLsn, &replayed) && ok;
+    benchReport("wal", "recover", replayed, timer.elapsedMs());
+
+    SnapshotManager::serialize(actual, routes, vehicles, tickets, history);
+    bool same = expected.size() == actual.size() && memcmp(expected.bytes(), actual.bytes(), expected.size()) == 0;
+    cerr << "wal: replayed=" << replayed << " records (" << walBytes << " bytes) lastLsn=" << lastLsn
+         << " recovered_state=" << (same ? "identical" : "DIFFERENT") << "\n";
+    remove(walPath);
+    remove(snapshotPath);
+    remove((string(snapshotPath) + ".tmp").c_str());
+    return ok && same ? 0 : 1;
+}
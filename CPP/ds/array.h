@@ -2,6 +2,7 @@
 #define ARRAYS_H
 
 #include <iostream>
+#include "memory_tracker.h"
 using namespace std;
 
 // Custom exception handling without STL
@@ -13,59 +14,90 @@ template <typename T>
 class DynamicArray
 {
 private:
-    T *data;      // pointer to array memory
-    int capacity; // total allocated size
-    int count;    // number of elements currently stored
+    T *data;                // pointer to array memory
+    int capacity;           // total allocated size
+    int count;              // number of elements currently stored
+    MemoryAccount *account; // where the buffer is charged
+
+    static MemoryAccount *defaultAccount()
+    {
+        static MemoryAccount *a = MemoryTracker::instance().account("other.DynamicArray", true);
+        return a;
+    }
+
+    // Allocate a buffer of n slots charged to account
+    T *allocate(int n)
+    {
+        T *p = new T[n];
+        memoryAllocated(account, (long long)n * sizeof(T));
+        if (!account->unattributed)
+        {
+            for (int i = 0; i < n; i++)
+                memoryAttach(p[i], account);
+        }
+        return p;
+    }
+
+    void release()
+    {
+        memoryReleased(account, (long long)capacity * sizeof(T));
+        delete[] data;
+    }
 
     // Resize array when full
     void resize(int newCapacity)
     {
-        T *newData = new T[newCapacity];
+        T *newData = allocate(newCapacity);
         for (int i = 0; i < count; i++)
         {
             newData[i] = data[i]; // copy old elements
         }
-        delete[] data; // free old memory
+        release(); // free old memory
         data = newData;
         capacity = newCapacity;
     }
 
 public:
-    // Constructor: default initial capacity = 10
-    DynamicArray(int initCap = 10)
+    // Constructor: default initial capacity = 10; account nullptr = unattributed
+    DynamicArray(int initCap = 10, MemoryAccount *memory = nullptr)
     {
         capacity = initCap;
         count = 0;
-        data = new T[capacity];
+        account = memory ? memory : defaultAccount();
+        data = allocate(capacity);
     }
 
     // Destructor: free memory
     ~DynamicArray()
     {
-        delete[] data;
+        release();
     }
 
-    // Copy constructor (deep copy)
+    // Copy constructor (deep copy, charged like the source)
     DynamicArray(const DynamicArray &other)
     {
         capacity = other.capacity;
         count = other.count;
-        data = new T[capacity];
+        account = other.account;
+        data = allocate(capacity);
         for (int i = 0; i < count; i++)
         {
             data[i] = other.data[i];
         }
     }
 
-    // Copy assignment operator (deep copy)
+    // Copy assignment operator (deep copy; an unattributed array takes the
+    // source's account)
     DynamicArray &operator=(const DynamicArray &other)
     {
         if (this != &other)
         {
-            delete[] data;
+            release();
+            if (account->unattributed)
+                account = other.account;
             capacity = other.capacity;
             count = other.count;
-            data = new T[capacity];
+            data = allocate(capacity);
             for (int i = 0; i < count; i++)
             {
                 data[i] = other.data[i];
@@ -79,7 +111,7 @@ public:
     {
         if (count == capacity)
         {
-            resize(capacity * 2); // double capacity
+            resize(capacity > 0 ? capacity * 2 : 1); // double capacity
         }
         data[count++] = element;
     }
@@ -87,6 +119,13 @@ public:
     // STL-style alias
     void push_back(const T &element) { add(element); }
 
+    // Make room for at least newCapacity elements without further resizes
+    void reserve(int newCapacity)
+    {
+        if (newCapacity > capacity)
+            resize(newCapacity);
+    }
+
     // Get element with bounds checking
     T &get(int index)
     {
@@ -127,6 +166,12 @@ public:
         return count;
     }
 
+    // Allocated slots
+    int getCapacity() const
+    {
+        return capacity;
+    }
+
     // Expose raw pointer for sorting/searching
     T *getRawArray()
     {
@@ -168,9 +213,33 @@ public:
         count--;
     }
 
-    // Swap contents with another array
+    // Charge this array (and nested containers) to memory from now on
+    void setMemoryAccount(MemoryAccount *memory)
+    {
+        if (!memory)
+            memory = defaultAccount();
+        memoryTransferred(account, memory, (long long)capacity * sizeof(T), 1);
+        account = memory;
+        for (int i = 0; i < capacity; i++)
+            memoryAttach(data[i], memory);
+    }
+
+    MemoryAccount *getMemoryAccount() const { return account; }
+
+    // Add the bytes of live elements (and their contents) to the accounts' used bytes
+    void measureMemory() const
+    {
+        account->addUsed((long long)count * sizeof(T));
+        for (int i = 0; i < count; i++)
+            memoryMeasure(data[i]);
+    }
+
+    // Swap contents with another array (each keeps its account; the
+    // buffers move between them)
     void swap(DynamicArray &other)
     {
+        memoryTransferred(account, other.account, (long long)capacity * sizeof(T), 1);
+        memoryTransferred(other.account, account, (long long)other.capacity * sizeof(T), 1);
         T *tmpData = data;
         data = other.data;
         other.data = tmpData;
@@ -185,4 +254,16 @@ public:
     }
 };
 
+template <typename T>
+inline void memoryAttach(DynamicArray<T> &a, MemoryAccount *account)
+{
+    a.setMemoryAccount(account);
+}
+
+template <typename T>
+inline void memoryMeasure(const DynamicArray<T> &a)
+{
+    a.measureMemory();
+}
+
 #endif
@@ -0,0 +1,259 @@
+#ifndef BINARY_STREAM_H
+#define BINARY_STREAM_H
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include "array.h"
+using namespace std;
+
+// CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320), table driven
+struct Crc32Table
+{
+    unsigned int entries[256];
+
+    Crc32Table()
+    {
+        for (unsigned int i = 0; i < 256; i++)
+        {
+            unsigned int c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            entries[i] = c;
+        }
+    }
+};
+
+inline unsigned int crc32Update(unsigned int crc, const char *bytes, long long n)
+{
+    static const Crc32Table table; // built once (thread-safe static init)
+    crc = ~crc;
+    for (long long i = 0; i < n; i++)
+        crc = table.entries[(crc ^ (unsigned char)bytes[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+inline unsigned int crc32(const char *bytes, long long n)
+{
+    return crc32Update(0, bytes, n);
+}
+
+// Growable byte buffer for building binary files in memory
+// Values are stored in host byte order; arrays of plain types are copied
+// with a single memcpy. Strings are a 32-bit length followed by the bytes.
+class BinaryWriter
+{
+private:
+    char *data;
+    long long count;
+    long long capacity;
+
+    BinaryWriter(const BinaryWriter &);
+    BinaryWriter &operator=(const BinaryWriter &);
+
+    void ensure(long long extra)
+    {
+        if (count + extra <= capacity)
+            return;
+        long long newCapacity = capacity * 2;
+        if (newCapacity < count + extra)
+            newCapacity = count + extra;
+        char *newData = new char[newCapacity];
+        if (count > 0)
+            memcpy(newData, data, count);
+        delete[] data;
+        data = newData;
+        capacity = newCapacity;
+    }
+
+public:
+    BinaryWriter(long long initCap = 4096) : count(0), capacity(initCap > 0 ? initCap : 1)
+    {
+        data = new char[capacity];
+    }
+
+    ~BinaryWriter()
+    {
+        delete[] data;
+    }
+
+    void writeBytes(const void *src, long long n)
+    {
+        ensure(n);
+        memcpy(data + count, src, n);
+        count += n;
+    }
+
+    void writeInt(int v) { writeBytes(&v, sizeof(v)); }
+    void writeUInt(unsigned int v) { writeBytes(&v, sizeof(v)); }
+    void writeInt64(long long v) { writeBytes(&v, sizeof(v)); }
+    void writeDouble(double v) { writeBytes(&v, sizeof(v)); }
+
+    void writeString(const string &s)
+    {
+        writeInt((int)s.size());
+        writeBytes(s.data(), (long long)s.size());
+    }
+
+    // Element count followed by the raw elements (plain types only)
+    template <typename T>
+    void writeArray(const DynamicArray<T> &arr)
+    {
+        writeInt(arr.size());
+        writeBytes(arr.getRawArray(), (long long)arr.size() * sizeof(T));
+    }
+
+    // Overwrite previously written bytes (e.g. a length field or header)
+    void patchBytes(long long offset, const void *src, long long n) { memcpy(data + offset, src, n); }
+    void patchUInt(long long offset, unsigned int v) { patchBytes(offset, &v, sizeof(v)); }
+    void patchInt64(long long offset, long long v) { patchBytes(offset, &v, sizeof(v)); }
+
+    // Zero-pad to a multiple of alignment bytes
+    void alignTo(int alignment)
+    {
+        static const char zeros[16] = {0};
+        while (count % alignment != 0)
+            writeBytes(zeros, alignment - count % alignment > 16 ? 16 : alignment - count % alignment);
+    }
+
+    long long size() const { return count; }
+    const char *bytes() const { return data; }
+
+    void clear() { count = 0; }
+
+    // Exchange buffers with another writer (no copies)
+    void swap(BinaryWriter &other)
+    {
+        char *tmpData = data;
+        data = other.data;
+        other.data = tmpData;
+        long long tmp = count;
+        count = other.count;
+        other.count = tmp;
+        tmp = capacity;
+        capacity = other.capacity;
+        other.capacity = tmp;
+    }
+};
+
+// Bounds-checked reader over a byte range written by BinaryWriter
+// Reading past the end never touches memory outside the range: the reader
+// goes into a failed state and returns zero values from then on.
+class BinaryReader
+{
+private:
+    const char *data;
+    long long count;
+    long long pos;
+    bool ok;
+
+public:
+    BinaryReader(const char *bytes, long long n) : data(bytes), count(n), pos(0), ok(true) {}
+
+    bool readBytes(void *dst, long long n)
+    {
+        if (!ok || n < 0 || n > count - pos)
+        {
+            ok = false;
+            return false;
+        }
+        memcpy(dst, data + pos, n);
+        pos += n;
+        return true;
+    }
+
+    int readInt()
+    {
+        int v = 0;
+        readBytes(&v, sizeof(v));
+        return v;
+    }
+
+    unsigned int readUInt()
+    {
+        unsigned int v = 0;
+        readBytes(&v, sizeof(v));
+        return v;
+    }
+
+    long long readInt64()
+    {
+        long long v = 0;
+        readBytes(&v, sizeof(v));
+        return v;
+    }
+
+    double readDouble()
+    {
+        double v = 0.0;
+        readBytes(&v, sizeof(v));
+        return v;
+    }
+
+    string readString()
+    {
+        int n = readInt();
+        if (!ok || n < 0 || n > count - pos)
+        {
+            ok = false;
+            return "";
+        }
+        string s(data + pos, n);
+        pos += n;
+        return s;
+    }
+
+    // Counterpart of BinaryWriter::writeArray
+    template <typename T>
+    bool readArray(DynamicArray<T> &arr)
+    {
+        int n = readInt();
+        if (!ok || n < 0 || (long long)n * sizeof(T) > (unsigned long long)(count - pos))
+        {
+            ok = false;
+            return false;
+        }
+        // Element-wise memcpy: the source bytes need not be aligned for T
+        arr.clear();
+        arr.reserve(n);
+        for (int i = 0; i < n; i++)
+        {
+            T v;
+            memcpy(&v, data + pos, sizeof(T));
+            arr.push_back(v);
+            pos += sizeof(T);
+        }
+        return true;
+    }
+
+    // Advance past n bytes
+    bool skip(long long n)
+    {
+        if (!ok || n < 0 || n > count - pos)
+        {
+            ok = false;
+            return false;
+        }
+        pos += n;
+        return true;
+    }
+
+    // A count that must fit in the remaining bytes at minBytes each
+    int readCount(int minBytes)
+    {
+        int n = readInt();
+        if (n < 0 || (long long)n * minBytes > count - pos)
+        {
+            ok = false;
+            return 0;
+        }
+        return n;
+    }
+
+    bool good() const { return ok; }
+    bool atEnd() const { return pos == count; }
+    long long position() const { return pos; }
+    long long remaining() const { return count - pos; }
+};
+
+#endif
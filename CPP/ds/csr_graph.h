@@ -0,0 +1,156 @@
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include <iostream>
+#include "array.h"
+#include "pair.h"
+#include "heap.h"
+#include "queue.h"
+#include "stack.h"
+using namespace std;
+
+// Read-only graph in compressed sparse row (CSR) form
+// The edges of vertex i are targets[offsets[i] .. offsets[i + 1]) with the
+// matching weights. The view does not own its arrays, so they can live in
+// a memory-mapped file and be queried with no parsing or copying.
+// Vertices are addressed by index (0 .. V-1); nodes[i] is the vertex's ID.
+class CsrGraphView
+{
+private:
+    int V;
+    const int *nodes;
+    const int *offsets;
+    const int *targets;
+    const int *weights;
+
+public:
+    CsrGraphView() : V(0), nodes(nullptr), offsets(nullptr), targets(nullptr), weights(nullptr) {}
+
+    void attach(int vertexCount, const int *nodeIDs, const int *edgeOffsets, const int *edgeTargets, const int *edgeWeights)
+    {
+        V = vertexCount;
+        nodes = nodeIDs;
+        offsets = edgeOffsets;
+        targets = edgeTargets;
+        weights = edgeWeights;
+    }
+
+    int vertexCount() const { return V; }
+    int edgeCount() const { return V > 0 ? offsets[V] : 0; }
+    int nodeID(int i) const { return nodes[i]; }
+    int edgeBegin(int i) const { return offsets[i]; }
+    int edgeEnd(int i) const { return offsets[i + 1]; }
+    int edgeTarget(int e) const { return targets[e]; }
+    int edgeWeight(int e) const { return weights[e]; }
+
+    // Vertices reachable from s in breadth-first order
+    void bfsOrder(int s, DynamicArray<int> &order) const
+    {
+        order.clear();
+        if (s < 0 || s >= V)
+            return;
+        DynamicArray<bool> visited(V);
+        for (int i = 0; i < V; i++)
+            visited.push_back(false);
+
+        Queue<int> q;
+        visited[s] = true;
+        q.push(s);
+        while (!q.empty())
+        {
+            int u = q.dequeue();
+            order.push_back(u);
+            for (int e = offsets[u]; e < offsets[u + 1]; e++)
+            {
+                int v = targets[e];
+                if (!visited[v])
+                {
+                    visited[v] = true;
+                    q.push(v);
+                }
+            }
+        }
+    }
+
+    // Vertices reachable from s in depth-first order (same visiting order
+    // as Graph::DFS for the same adjacency lists)
+    void dfsOrder(int s, DynamicArray<int> &order) const
+    {
+        order.clear();
+        if (s < 0 || s >= V)
+            return;
+        DynamicArray<bool> visited(V);
+        for (int i = 0; i < V; i++)
+            visited.push_back(false);
+
+        Stack<int> st;
+        st.push(s);
+        while (!st.empty())
+        {
+            int u = st.pop();
+            if (visited[u])
+                continue;
+            visited[u] = true;
+            order.push_back(u);
+            for (int e = offsets[u]; e < offsets[u + 1]; e++)
+            {
+                if (!visited[targets[e]])
+                    st.push(targets[e]);
+            }
+        }
+    }
+
+    // Dijkstra with a binary heap, O((V + E) log V). Fills path with vertex
+    // indices s .. t and returns the distance, or -1 if t is unreachable.
+    int shortestPath(int s, int t, DynamicArray<int> &path) const
+    {
+        path.clear();
+        if (s < 0 || s >= V || t < 0 || t >= V)
+            return -1;
+
+        DynamicArray<int> dist(V);
+        DynamicArray<int> parent(V);
+        for (int i = 0; i < V; i++)
+        {
+            dist.push_back(INT_MAX_VALUE);
+            parent.push_back(-1);
+        }
+
+        // Lazy deletion: one heap entry per relaxed edge; the heap grows as
+        // needed, so an early exit never pays for the whole edge set
+        MinHeap<Pair<int, int>> heap; // (distance, vertex)
+        dist[s] = 0;
+        heap.insert(Pair<int, int>(0, s));
+        while (!heap.isEmpty())
+        {
+            Pair<int, int> top = heap.extractMin();
+            int u = top.second;
+            if (top.first > dist[u])
+                continue;
+            if (u == t)
+                break;
+            for (int e = offsets[u]; e < offsets[u + 1]; e++)
+            {
+                int v = targets[e];
+                int d = dist[u] + weights[e];
+                if (d < dist[v])
+                {
+                    dist[v] = d;
+                    parent[v] = u;
+                    heap.insert(Pair<int, int>(d, v));
+                }
+            }
+        }
+
+        if (dist[t] == INT_MAX_VALUE)
+            return -1;
+        DynamicArray<int> reversed;
+        for (int v = t; v != -1; v = parent[v])
+            reversed.push_back(v);
+        for (int i = reversed.size() - 1; i >= 0; i--)
+            path.push_back(reversed[i]);
+        return dist[t];
+    }
+};
+
+#endif
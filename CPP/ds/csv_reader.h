@@ -0,0 +1,351 @@
+#ifndef CSV_READER_H
+#define CSV_READER_H
+
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "array.h"
+using namespace std;
+
+// Offset of the newline ending the record that starts at text[from], or -1
+// if text[from, to) holds no complete record (newlines in quotes are data).
+// quoted resumes a scan that stopped inside a quoted field.
+inline int csvFindRecordEnd(const char *text, int from, int to, bool quoted = false)
+{
+    for (int i = from; i < to; i++)
+    {
+        char c = text[i];
+        if (c == '"')
+            quoted = !quoted;
+        else if (c == '\n' && !quoted)
+            return i;
+    }
+    return -1;
+}
+
+// One CSV record split in place
+// split() turns delimiters into '\0' and unescapes quoted fields
+// ("a, ""b""") where they lie, so field(i) points straight into the
+// caller's text. No std::string is created; callers convert only the
+// fields they keep. Pointers stay valid until the text changes.
+class CsvRecord
+{
+private:
+    DynamicArray<char *> fields;
+    DynamicArray<int> lengths;
+
+    static const char *skipSpaces(const char *p)
+    {
+        while (*p == ' ' || *p == '\t')
+            p++;
+        return p;
+    }
+
+public:
+    CsvRecord() : fields(16), lengths(16) {}
+
+    // Split text[0, length); text[length] must be writable (it becomes '\0')
+    void split(char *text, int length, char delimiter)
+    {
+        fields.clear();
+        lengths.clear();
+        int to = length;
+        if (to > 0 && text[to - 1] == '\r')
+            to--;
+        text[to] = '\0';
+
+        int i = 0;
+        while (true)
+        {
+            char *out = text + i;
+            char *field = out;
+            if (i < to && text[i] == '"')
+            {
+                i++;
+                while (i < to)
+                {
+                    if (text[i] == '"')
+                    {
+                        if (i + 1 < to && text[i + 1] == '"')
+                        {
+                            *out++ = '"';
+                            i += 2;
+                            continue;
+                        }
+                        i++;
+                        break;
+                    }
+                    *out++ = text[i++];
+                }
+                while (i < to && text[i] != delimiter) // text after the closing quote
+                    *out++ = text[i++];
+            }
+            else
+            {
+                while (i < to && text[i] != delimiter)
+                    i++;
+                out = text + i;
+            }
+            bool more = i < to;
+            *out = '\0';
+            fields.push_back(field);
+            lengths.push_back((int)(out - field));
+            if (!more)
+                break;
+            i++; // skip the delimiter
+        }
+    }
+
+    void clear()
+    {
+        fields.clear();
+        lengths.clear();
+    }
+
+    int fieldCount() const { return fields.size(); }
+
+    // Null-terminated field text ("" if the record is shorter)
+    const char *field(int i) const { return i >= 0 && i < fields.size() ? fields[i] : ""; }
+    int fieldLength(int i) const { return i >= 0 && i < lengths.size() ? lengths[i] : 0; }
+
+    string getString(int i) const { return string(field(i), fieldLength(i)); }
+
+    // Whole field as a decimal int (surrounding blanks allowed)
+    bool getInt(int i, int &value) const
+    {
+        const char *p = skipSpaces(field(i));
+        bool negative = *p == '-';
+        if (*p == '-' || *p == '+')
+            p++;
+        if (*p < '0' || *p > '9')
+            return false;
+        long long v = 0;
+        while (*p >= '0' && *p <= '9')
+        {
+            v = v * 10 + (*p++ - '0');
+            if (v > 2147483648LL)
+                return false;
+        }
+        if (*skipSpaces(p) != '\0')
+            return false;
+        if (negative)
+            v = -v;
+        if (v > INT_MAX_VALUE)
+            return false;
+        value = (int)v;
+        return true;
+    }
+
+    // Whole field as a floating-point number (surrounding blanks allowed)
+    bool getDouble(int i, double &value) const
+    {
+        const char *p = skipSpaces(field(i));
+        if (*p == '\0')
+            return false;
+        char *stop;
+        double v = strtod(p, &stop);
+        if (stop == p || *skipSpaces(stop) != '\0')
+            return false;
+        value = v;
+        return true;
+    }
+
+    // Case-sensitive match of field i against text
+    bool fieldEquals(int i, const char *text) const
+    {
+        return strcmp(field(i), text) == 0;
+    }
+
+    // Index of the field equal to name (for header records), or -1
+    int columnIndex(const char *name) const
+    {
+        for (int i = 0; i < fields.size(); i++)
+            if (strcmp(fields[i], name) == 0)
+                return i;
+        return -1;
+    }
+};
+
+// Streaming CSV reader
+// The file is read in fixed-size chunks into one buffer and each record is
+// split in place (see CsvRecord). A record may span chunks (the buffer
+// grows if a single record is larger than a chunk). Handles CRLF, blank
+// lines and a UTF-8 byte-order mark. next() yields one record at a time;
+// nextBlock() hands out whole runs of raw records so other threads can
+// split them.
+class CsvReader
+{
+private:
+    FILE *file;
+    char *buffer;
+    int capacity;
+    int start; // first unconsumed byte
+    int end;   // one past the last byte read
+    bool eof;
+    char delimiter;
+    long long line;     // line number of the current record (1-based)
+    long long nextLine; // line number the next record starts on
+    CsvRecord record;
+
+    CsvReader(const CsvReader &);
+    CsvReader &operator=(const CsvReader &);
+
+    // Move unconsumed bytes to the front and read another chunk
+    bool fill()
+    {
+        if (eof)
+            return false;
+        if (start > 0)
+        {
+            memmove(buffer, buffer + start, end - start);
+            end -= start;
+            start = 0;
+        }
+        if (end == capacity) // one record fills the buffer: grow it
+        {
+            char *bigger = new char[capacity * 2 + 1];
+            memcpy(bigger, buffer, end);
+            delete[] buffer;
+            buffer = bigger;
+            capacity *= 2;
+        }
+        size_t got = fread(buffer + end, 1, capacity - end, file);
+        end += (int)got;
+        if (got == 0)
+            eof = true;
+        return got > 0;
+    }
+
+public:
+    CsvReader()
+        : file(nullptr), buffer(nullptr), capacity(0), start(0), end(0), eof(true), delimiter(','),
+          line(0), nextLine(1) {}
+
+    ~CsvReader() { close(); }
+
+    // Open path for reading in chunks of chunkBytes
+    bool open(const string &path, int chunkBytes = 1 << 20, char separator = ',')
+    {
+        close();
+        file = fopen(path.c_str(), "rb");
+        if (!file)
+            return false;
+        capacity = chunkBytes > 16 ? chunkBytes : 16;
+        buffer = new char[capacity + 1]; // +1: room to terminate the last record
+        start = end = 0;
+        eof = false;
+        delimiter = separator;
+        line = 0;
+        nextLine = 1;
+        fill();
+        if (end - start >= 3 && memcmp(buffer, "\xEF\xBB\xBF", 3) == 0)
+            start = 3; // UTF-8 byte-order mark
+        return true;
+    }
+
+    void close()
+    {
+        if (file)
+            fclose(file);
+        file = nullptr;
+        delete[] buffer;
+        buffer = nullptr;
+        capacity = start = end = 0;
+        eof = true;
+        record.clear();
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+    // Advance to the next non-blank record; false at end of file
+    bool next()
+    {
+        if (!file)
+            return false;
+        while (true)
+        {
+            int stop = csvFindRecordEnd(buffer, start, end);
+            while (stop < 0 && fill())
+                stop = csvFindRecordEnd(buffer, start, end);
+
+            int recordEnd = stop >= 0 ? stop : end; // last record may lack '\n'
+            if (stop < 0 && start >= end)
+                return false;
+
+            line = nextLine;
+            for (int i = start; i < recordEnd; i++)
+                if (buffer[i] == '\n')
+                    nextLine++; // newlines inside quoted fields
+            nextLine++;
+
+            int from = start;
+            start = stop >= 0 ? stop + 1 : end;
+            bool blank = recordEnd == from || (recordEnd == from + 1 && buffer[from] == '\r');
+            if (blank)
+                continue;
+            record.split(buffer + from, recordEnd - from, delimiter);
+            return true;
+        }
+    }
+
+    // Copy the next whole records, about targetBytes of them (at least one),
+    // into block (reallocated as needed, always one spare byte). Returns the
+    // number of bytes copied, 0 at end of file. Line numbers stop being
+    // tracked once blocks are used.
+    int nextBlock(char *&block, int &blockCapacity, int targetBytes)
+    {
+        if (!file)
+            return 0;
+        while (end - start < targetBytes && fill())
+        {
+        }
+        int cut = -1;
+        while (true)
+        {
+            int limit = end - start > targetBytes ? start + targetBytes : end;
+            // Last record end before limit (quote state is known: start is a record start)
+            bool quoted = false;
+            for (int i = start; i < limit; i++)
+            {
+                if (buffer[i] == '"')
+                    quoted = !quoted;
+                else if (buffer[i] == '\n' && !quoted)
+                    cut = i;
+            }
+            if (cut < 0 && limit < end)
+                cut = csvFindRecordEnd(buffer, limit, end, quoted); // one record longer than targetBytes
+            if (cut >= 0 || !fill())
+                break;
+        }
+
+        int length = cut >= 0 ? cut + 1 - start : end - start;
+        if (length <= 0)
+            return 0;
+        if (blockCapacity < length + 1)
+        {
+            delete[] block;
+            blockCapacity = length + 1 > targetBytes + 1 ? length + 1 : targetBytes + 1;
+            block = new char[blockCapacity];
+        }
+        memcpy(block, buffer + start, length);
+        start += length;
+        return length;
+    }
+
+    char getDelimiter() const { return delimiter; }
+    long long lineNumber() const { return line; }
+    const CsvRecord &current() const { return record; }
+
+    int fieldCount() const { return record.fieldCount(); }
+    const char *field(int i) const { return record.field(i); }
+    int fieldLength(int i) const { return record.fieldLength(i); }
+    string getString(int i) const { return record.getString(i); }
+    bool getInt(int i, int &value) const { return record.getInt(i, value); }
+    bool getDouble(int i, double &value) const { return record.getDouble(i, value); }
+    bool fieldEquals(int i, const char *text) const { return record.fieldEquals(i, text); }
+    int columnIndex(const char *name) const { return record.columnIndex(name); }
+};
+
+#endif
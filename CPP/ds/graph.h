@@ -7,6 +7,10 @@
 #include "pair.h"
 #include "queue.h"
 #include "stack.h"
+#include "heap.h"
+#include "id_index.h"
+#include "binary_stream.h"
+#include "thread_pool.h"
 using namespace std;
 
 // Define INT_MAX replacement to avoid <limits>
@@ -14,6 +18,23 @@ using namespace std;
 #define INT_MAX_VALUE 2147483647
 #endif
 
+// Below this many edges (or vertices) bulk work stays on the calling thread
+#define GRAPH_PARALLEL_GRAIN 16384
+
+// Names printed for node IDs: name(context, id). Passed to each printing
+// call instead of being stored, so concurrent readers can label the same
+// graph differently. Without a function the ID itself is printed.
+struct GraphLabels
+{
+    string (*name)(const void *, int);
+    const void *context;
+
+    GraphLabels(string (*nameFn)(const void *, int) = nullptr, const void *nameContext = nullptr)
+        : name(nameFn), context(nameContext) {}
+
+    string operator()(int id) const { return name ? name(context, id) : to_string(id); }
+};
+
 // Graph class using adjacency list with custom DS
 class Graph
 {
@@ -21,18 +42,83 @@ private:
     int V;                                          // number of vertices
     DynamicArray<int> nodes;                        // store node IDs
     DynamicArray<DynamicArray<Pair<int, int>>> adj; // adjacency list: Pair<neighbor_index, weight>
-    string (*labelProvider)(int);                   // function pointer for labels
+    IdIndex vertexIndex;                            // node ID -> index, O(1)
 
-    string nodeLabelByIndex(int idx)
+    // parallelFor bodies for addEdges and distanceMatrix
+
+    // Endpoint indices of edges [lo, hi)
+    struct ResolveEnds
     {
-        int id = nodes[idx];
-        if (labelProvider)
-            return labelProvider(id);
-        return to_string(id);
-    }
+        const Graph *graph;
+        const int *from;
+        const int *to;
+        int *ends;
+
+        void operator()(int lo, int hi) const
+        {
+            for (int k = lo; k < hi; k++)
+            {
+                ends[2 * k] = graph->getIndex(from[k]);
+                ends[2 * k + 1] = graph->getIndex(to[k]);
+            }
+        }
+    };
+
+    // Append each vertex's new incidences (grouped per vertex, edge order)
+    struct FillLists
+    {
+        Graph *graph;
+        const int *offsets;
+        const Pair<int, int> *incidences;
+
+        void operator()(int lo, int hi) const
+        {
+            for (int v = lo; v < hi; v++)
+            {
+                int first = offsets[v];
+                int last = offsets[v + 1];
+                if (first == last)
+                    continue;
+                DynamicArray<Pair<int, int>> &list = graph->adj[v];
+                list.reserve(list.size() + last - first);
+                for (int e = first; e < last; e++)
+                    list.push_back(incidences[e]);
+            }
+        }
+    };
+
+    // One distance-matrix row per source
+    struct MatrixRows
+    {
+        const Graph *graph;
+        const int *sources;
+        const int *targets;
+        int targetCount;
+        int *out;
+
+        void operator()(int lo, int hi) const
+        {
+            DynamicArray<int> dist;
+            for (int r = lo; r < hi; r++)
+            {
+                int *row = out + (long long)r * targetCount;
+                if (graph->distancesFrom(sources[r], dist) < 0)
+                {
+                    for (int c = 0; c < targetCount; c++)
+                        row[c] = -1;
+                    continue;
+                }
+                for (int c = 0; c < targetCount; c++)
+                {
+                    int t = graph->getIndex(targets[c]);
+                    row[c] = t == -1 || dist[t] == INT_MAX_VALUE ? -1 : dist[t];
+                }
+            }
+        }
+    };
 
 public:
-    Graph() : V(0), labelProvider(nullptr) {}
+    Graph() : V(0) {}
 
     // Clear the entire graph
     void clear()
@@ -43,12 +129,23 @@ public:
             nodes.erase(nodes.size() - 1);
         while (adj.size() > 0)
             adj.erase(adj.size() - 1);
+        vertexIndex.clear();
     }
 
-    // Set a label provider to display friendly names
-    void setLabelProvider(string (*provider)(int))
+    // Charge node IDs and adjacency lists to adjacency, the ID index to index
+    void setMemoryAccount(MemoryAccount *adjacency, MemoryAccount *index)
     {
-        labelProvider = provider;
+        nodes.setMemoryAccount(adjacency);
+        adj.setMemoryAccount(adjacency);
+        vertexIndex.setMemoryAccount(index);
+    }
+
+    // Edges count as used; spare adjacency-list capacity is slack
+    void measureMemory() const
+    {
+        nodes.measureMemory();
+        adj.measureMemory();
+        vertexIndex.measureMemory();
     }
 
     // Add a new vertex
@@ -56,16 +153,97 @@ public:
     {
         nodes.push_back(value);
         adj.push_back(DynamicArray<Pair<int, int>>());
+        if (!vertexIndex.contains(value)) // first vertex with this ID wins
+            vertexIndex.insert(value, V);
         V++;
     }
 
     // Find index of a node
-    int getIndex(int value)
+    int getIndex(int value) const
+    {
+        return vertexIndex.find(value); // -1 if not found
+    }
+
+    int vertexCount() const { return V; }
+
+    // Write the graph in CSR form: V, node IDs, per-vertex edge offsets,
+    // then neighbor indices and weights in adjacency-list order
+    void writeSnapshot(BinaryWriter &out) const
     {
+        out.writeInt(V);
+        out.writeArray(nodes);
+
+        DynamicArray<int> offsets(V + 1);
+        int edges = 0;
+        offsets.push_back(0);
         for (int i = 0; i < V; i++)
-            if (nodes[i] == value)
-                return i;
-        return -1; // not found
+        {
+            edges += adj[i].size();
+            offsets.push_back(edges);
+        }
+        out.writeArray(offsets);
+
+        DynamicArray<int> targets(edges + 1);
+        DynamicArray<int> weights(edges + 1);
+        for (int i = 0; i < V; i++)
+        {
+            for (int k = 0; k < adj[i].size(); k++)
+            {
+                targets.push_back(adj[i][k].first);
+                weights.push_back(adj[i][k].second);
+            }
+        }
+        out.writeArray(targets);
+        out.writeArray(weights);
+    }
+
+    // Exchange contents with another graph (each keeps its memory accounts)
+    void swap(Graph &other)
+    {
+        int tmpV = V;
+        V = other.V;
+        other.V = tmpV;
+        nodes.swap(other.nodes);
+        adj.swap(other.adj);
+        vertexIndex.swap(other.vertexIndex);
+    }
+
+    // Replace the graph with one written by writeSnapshot; adjacency lists
+    // are rebuilt directly, without any getIndex lookups
+    bool readSnapshot(BinaryReader &in)
+    {
+        int n = in.readInt();
+        DynamicArray<int> ids, offsets, targets, weights;
+        in.readArray(ids);
+        in.readArray(offsets);
+        in.readArray(targets);
+        in.readArray(weights);
+        if (!in.good() || n < 0 || ids.size() != n || offsets.size() != n + 1 ||
+            targets.size() != weights.size() || offsets[0] != 0 || offsets[n] != targets.size())
+            return false;
+        for (int i = 0; i < n; i++)
+            if (offsets[i] > offsets[i + 1])
+                return false;
+        for (int e = 0; e < targets.size(); e++)
+            if (targets[e] < 0 || targets[e] >= n)
+                return false;
+
+        clear();
+        nodes.swap(ids);
+        adj.reserve(n);
+        vertexIndex.reserve(n);
+        for (int i = 0; i < n; i++)
+        {
+            adj.push_back(DynamicArray<Pair<int, int>>());
+            DynamicArray<Pair<int, int>> &list = adj[i];
+            list.reserve(offsets[i + 1] - offsets[i]);
+            for (int e = offsets[i]; e < offsets[i + 1]; e++)
+                list.push_back(Pair<int, int>(targets[e], weights[e]));
+            if (!vertexIndex.contains(nodes[i]))
+                vertexIndex.insert(nodes[i], i);
+        }
+        V = n;
+        return true;
     }
 
     // Add edge between two nodes with weight (default 1)
@@ -82,23 +260,120 @@ public:
         adj[j].push_back(Pair<int, int>(i, weight)); // for undirected graph
     }
 
+    // Make room for n more vertices (bulk loads)
+    void reserveVertices(int n)
+    {
+        nodes.reserve(V + n);
+        adj.reserve(V + n);
+        vertexIndex.reserve(V + n);
+    }
+
+    // Add n edges at once, same result as n addEdge calls. Degrees are
+    // counted first so every adjacency list is grown exactly once.
+    // Returns the number of edges added (both endpoints must exist).
+    // With a pool, endpoint lookups and the per-vertex list fills run in
+    // parallel; the adjacency lists come out identical.
+    int addEdges(const int from[], const int to[], const int weights[], int n, ThreadPool *pool = nullptr)
+    {
+        bool parallel = pool && pool->size() > 1 && n >= GRAPH_PARALLEL_GRAIN;
+        DynamicArray<int> ends(2 * n + 1);
+        for (int k = 0; k < 2 * n; k++)
+            ends.push_back(-1);
+        ResolveEnds resolve;
+        resolve.graph = this;
+        resolve.from = from;
+        resolve.to = to;
+        resolve.ends = ends.getRawArray();
+        if (parallel)
+            parallelFor(*pool, 0, n, GRAPH_PARALLEL_GRAIN, resolve);
+        else
+            resolve(0, n);
+
+        DynamicArray<int> extra(V + 1);
+        for (int i = 0; i < V; i++)
+            extra.push_back(0);
+        for (int k = 0; k < n; k++)
+        {
+            int i = ends[2 * k];
+            int j = ends[2 * k + 1];
+            if (i != -1 && j != -1)
+            {
+                extra[i]++;
+                extra[j]++;
+            }
+        }
+        if (parallel)
+            return fillParallel(ends, extra, weights, n, *pool);
+
+        for (int i = 0; i < V; i++)
+            if (extra[i] > 0)
+                adj[i].reserve(adj[i].size() + extra[i]);
+
+        int added = 0;
+        for (int k = 0; k < n; k++)
+        {
+            int i = ends[2 * k];
+            int j = ends[2 * k + 1];
+            if (i == -1 || j == -1)
+                continue;
+            adj[i].push_back(Pair<int, int>(j, weights[k]));
+            adj[j].push_back(Pair<int, int>(i, weights[k]));
+            added++;
+        }
+        return added;
+    }
+
+    // Parallel half of addEdges: incidences are grouped per vertex in edge
+    // order (one counting-sort pass), then vertices are filled in parallel
+    int fillParallel(const DynamicArray<int> &ends, const DynamicArray<int> &degree, const int weights[], int n,
+                     ThreadPool &pool)
+    {
+        DynamicArray<int> offsets(V + 1);
+        offsets.push_back(0);
+        for (int v = 0; v < V; v++)
+            offsets.push_back(offsets[v] + degree[v]);
+        DynamicArray<int> cursor(offsets);
+        DynamicArray<Pair<int, int>> incidences(offsets[V] + 1);
+        for (int e = 0; e < offsets[V]; e++)
+            incidences.push_back(Pair<int, int>());
+
+        int added = 0;
+        for (int k = 0; k < n; k++)
+        {
+            int i = ends[2 * k];
+            int j = ends[2 * k + 1];
+            if (i == -1 || j == -1)
+                continue;
+            incidences[cursor[i]++] = Pair<int, int>(j, weights[k]);
+            incidences[cursor[j]++] = Pair<int, int>(i, weights[k]);
+            added++;
+        }
+
+        FillLists fill;
+        fill.graph = this;
+        fill.offsets = offsets.getRawArray();
+        fill.incidences = incidences.getRawArray();
+        parallelFor(pool, 0, V, GRAPH_PARALLEL_GRAIN / 16, fill);
+        return added;
+    }
+
     // Display graph
-    void display()
+    void display(const GraphLabels &label = GraphLabels()) const
     {
         for (int i = 0; i < V; i++)
         {
-            cout << nodeLabelByIndex(i) << " -> ";
+            cout << label(nodes[i]) << " -> ";
             for (int k = 0; k < adj[i].size(); k++)
             {
-                Pair<int, int> &p = adj[i][k];
-                cout << "(" << nodeLabelByIndex(p.first) << "," << p.second << ") ";
+                const Pair<int, int> &p = adj[i][k];
+                cout << "(" << label(nodes[p.first]) << "," << p.second << ") ";
             }
             cout << "\n";
         }
     }
 
     // BFS from start node
-    void BFS(int start)
+    void BFS(int start, const GraphLabels &label = GraphLabels()) const
     {
         int s = getIndex(start);
         if (s == -1)
@@ -116,7 +391,7 @@ public:
         {
             int u = q.front();
             q.pop();
-            cout << nodeLabelByIndex(u) << " ";
+            cout << label(nodes[u]) << " ";
 
             for (int k = 0; k < adj[u].size(); k++)
             {
@@ -132,7 +407,7 @@ public:
     }
 
     // DFS from start node
-    void DFS(int start)
+    void DFS(int start, const GraphLabels &label = GraphLabels()) const
     {
         int s = getIndex(start);
         if (s == -1)
@@ -152,7 +427,7 @@ public:
             if (!visited[u])
             {
                 visited[u] = true;
-                cout << nodeLabelByIndex(u) << " ";
+                cout << label(nodes[u]) << " ";
             }
 
             for (int k = 0; k < adj[u].size(); k++)
@@ -166,7 +441,7 @@ public:
     }
 
     // Dijkstra: shortest path from start node
-    void Dijkstra(int start, int end)
+    void Dijkstra(int start, int end, const GraphLabels &label = GraphLabels()) const
     {
         int s = getIndex(start);
         if (s == -1)
@@ -225,12 +500,128 @@ public:
             curr = parent[curr];
         }
         for (int i = path.size() - 1; i >= 0; i--)
-            cout << nodeLabelByIndex(path[i]) << " ";
+            cout << label(nodes[path[i]]) << " ";
         cout << "\n";
     }
 
+    // Dijkstra with a binary heap, O((V + E) log V), without printing.
+    // Fills path with node IDs start .. end and returns the distance, or -1
+    // if either node is missing or end is unreachable.
+    int shortestPath(int start, int end, DynamicArray<int> &path) const
+    {
+        path.clear();
+        int s = getIndex(start);
+        int t = getIndex(end);
+        if (s == -1 || t == -1)
+            return -1;
+
+        DynamicArray<int> dist(V);
+        DynamicArray<int> parent(V);
+        for (int i = 0; i < V; i++)
+        {
+            dist.push_back(INT_MAX_VALUE);
+            parent.push_back(-1);
+        }
+
+        // Lazy deletion: one heap entry per relaxed edge; the heap grows as
+        // needed, so an early exit never pays for the whole edge set
+        MinHeap<Pair<int, int>> heap; // (distance, vertex)
+        dist[s] = 0;
+        heap.insert(Pair<int, int>(0, s));
+        while (!heap.isEmpty())
+        {
+            Pair<int, int> top = heap.extractMin();
+            int u = top.second;
+            if (top.first > dist[u])
+                continue;
+            if (u == t)
+                break;
+            for (int k = 0; k < adj[u].size(); k++)
+            {
+                int v = adj[u][k].first;
+                int d = dist[u] + adj[u][k].second;
+                if (d < dist[v])
+                {
+                    dist[v] = d;
+                    parent[v] = u;
+                    heap.insert(Pair<int, int>(d, v));
+                }
+            }
+        }
+
+        if (dist[t] == INT_MAX_VALUE)
+            return -1;
+        DynamicArray<int> reversed;
+        for (int v = t; v != -1; v = parent[v])
+            reversed.push_back(nodes[v]);
+        for (int i = reversed.size() - 1; i >= 0; i--)
+            path.push_back(reversed[i]);
+        return dist[t];
+    }
+
+    // Dijkstra from start over the whole graph: dist[i] is the distance to
+    // vertex index i (INT_MAX_VALUE if unreachable). Returns start's index,
+    // or -1 if start is not a vertex. Prints nothing; safe to run
+    // concurrently on a graph no one is modifying.
+    int distancesFrom(int start, DynamicArray<int> &dist) const
+    {
+        dist.clear();
+        int s = getIndex(start);
+        if (s == -1)
+            return -1;
+        dist.reserve(V);
+        for (int i = 0; i < V; i++)
+            dist.push_back(INT_MAX_VALUE);
+
+        MinHeap<Pair<int, int>> heap(V + 1); // (distance, vertex), lazy deletion; grows as needed
+        dist[s] = 0;
+        heap.insert(Pair<int, int>(0, s));
+        while (!heap.isEmpty())
+        {
+            Pair<int, int> top = heap.extractMin();
+            int u = top.second;
+            if (top.first > dist[u])
+                continue;
+            for (int k = 0; k < adj[u].size(); k++)
+            {
+                int v = adj[u][k].first;
+                int d = dist[u] + adj[u][k].second;
+                if (d < dist[v])
+                {
+                    dist[v] = d;
+                    heap.insert(Pair<int, int>(d, v));
+                }
+            }
+        }
+        return s;
+    }
+
+    // Shortest distances between node sets: out[r * targetCount + c] is the
+    // distance from sources[r] to targets[c], -1 if either is missing or
+    // unreachable. One Dijkstra per source; sources run in parallel when a
+    // pool is given.
+    void distanceMatrix(const int sources[], int sourceCount, const int targets[], int targetCount,
+                        DynamicArray<int> &out, ThreadPool *pool = nullptr) const
+    {
+        out.clear();
+        long long cells = (long long)sourceCount * targetCount;
+        out.reserve((int)cells);
+        for (long long i = 0; i < cells; i++)
+            out.push_back(-1);
+        MatrixRows rows;
+        rows.graph = this;
+        rows.sources = sources;
+        rows.targets = targets;
+        rows.targetCount = targetCount;
+        rows.out = out.getRawArray();
+        if (pool && pool->size() > 1)
+            parallelFor(*pool, 0, sourceCount, 1, rows);
+        else
+            rows(0, sourceCount);
+    }
+
     // Detect cycle in undirected graph using DFS
-    bool detectCycleUtil(int u, DynamicArray<bool> &visited, int par)
+    bool detectCycleUtil(int u, DynamicArray<bool> &visited, int par) const
     {
         visited[u] = true;
         for (int k = 0; k < adj[u].size(); k++)
@@ -249,7 +640,7 @@ public:
         return false;
     }
 
-    bool detectCycle()
+    bool detectCycle() const
     {
         DynamicArray<bool> visited;
         for (int i = 0; i < V; i++)
@@ -265,7 +656,7 @@ public:
     }
 
     // Prim's MST
-    void MST()
+    void MST(const GraphLabels &label = GraphLabels()) const
     {
         DynamicArray<bool> inMST;
         DynamicArray<int> key;
@@ -304,10 +695,10 @@ public:
             {
                 for (int k = 0; k < adj[j].size(); k++)
                 {
-                    Pair<int, int> &p = adj[j][k];
+                    const Pair<int, int> &p = adj[j][k];
                     if (p.first == i && inMST[j])
                     {
-                        cout << nodeLabelByIndex(j) << " - " << nodeLabelByIndex(i) << " : " << p.second << "\n";
+                        cout << label(nodes[j]) << " - " << label(nodes[i]) << " : " << p.second << "\n";
                         mstWeight += p.second;
                         break;
                     }
@@ -5,6 +5,7 @@
 #include "linkedlist.h"
 #include "array.h"
 #include "pair.h"
+#include "metrics.h"
 using namespace std;
 
 // Template Hash Table with chaining using custom DS
@@ -14,11 +15,19 @@ class HashTable
 private:
     DynamicArray<LinkedList<Pair<K, V>>> table; // array of linked lists for chaining
     int capacity;                               // total buckets
+    int entries;                                // stored key-value pairs
 
     // Simple hash function for int keys
     int hashFunc(int key) const
     {
-        return key % capacity;
+        return (int)((unsigned int)key % (unsigned int)capacity);
+    }
+
+    // 64-bit keys (e.g. two packed IDs): mix both halves
+    int hashFunc(long long key) const
+    {
+        unsigned long long h = (unsigned long long)key * 0x9E3779B97F4A7C15ULL;
+        return (int)((h >> 32) % (unsigned long long)capacity);
     }
 
     // Hash for other types (string, etc.) - simple sum-based
@@ -27,84 +36,165 @@ private:
         int sum = 0;
         for (int i = 0; i < (int)key.size(); i++)
             sum += (int)key[i];
-        return sum % capacity;
+        return (int)((unsigned int)sum % (unsigned int)capacity);
+    }
+
+    // Node holding key in its bucket, or nullptr
+    ListNode<Pair<K, V>> *findNode(const K &key) const
+    {
+        ListNode<Pair<K, V>> *node = table[hashFunc(key)].head;
+        int probes = node ? 1 : 0;
+        while (node && !(node->data.first == key))
+        {
+            node = node->next;
+            probes += node ? 1 : 0;
+        }
+        METRIC_OBSERVE("itnms_hashtable_probe_length", "Chain nodes compared per hash-table lookup",
+                       metricProbeBuckets, probes);
+        return node;
+    }
+
+    void initBuckets(int size)
+    {
+        capacity = size > 0 ? size : 1;
+        table.clear();
+        table.reserve(capacity);
+        for (int i = 0; i < capacity; i++)
+        {
+            table.push_back(LinkedList<Pair<K, V>>(table.getMemoryAccount()));
+        }
+    }
+
+    static MemoryAccount *defaultAccount()
+    {
+        // Not marked unattributed, so the buckets follow the table
+        static MemoryAccount *a = MemoryTracker::instance().account("other.HashTable");
+        return a;
     }
 
 public:
     // Constructor
-    HashTable(int size = 10) : table(size), capacity(size)
+    HashTable(int size = 10) : table(size > 0 ? size : 1, defaultAccount()), capacity(0), entries(0)
     {
         // Initialize each bucket with an empty LinkedList
-        for (int i = 0; i < capacity; i++)
+        initBuckets(size);
+    }
+
+    // Re-bucket every entry into newCapacity buckets
+    void rehash(int newCapacity)
+    {
+        DynamicArray<LinkedList<Pair<K, V>>> old;
+        old.swap(table);
+        initBuckets(newCapacity);
+        for (int b = 0; b < old.size(); b++)
         {
-            table.push_back(LinkedList<Pair<K, V>>());
+            for (ListNode<Pair<K, V>> *node = old[b].head; node; node = node->next)
+                table[hashFunc(node->data.first)].push_back(node->data);
         }
     }
 
+    // Size the table for n entries (about one per bucket)
+    void reserve(int n)
+    {
+        if (n > capacity)
+            rehash(n);
+    }
+
     // Insert key-value pair
     void insert(K key, V value)
     {
-        int index = hashFunc(key);
-        LinkedList<Pair<K, V>> &bucket = table[index];
         // Check if key already exists
-        for (int i = 0; i < bucket.size(); i++)
+        ListNode<Pair<K, V>> *node = findNode(key);
+        if (node)
         {
-            if (bucket.get(i).first == key)
-            {
-                bucket.get(i).second = value; // update value
-                return;
-            }
+            node->data.second = value; // update value
+            return;
         }
-        bucket.push_back(Pair<K, V>(key, value));
+        // Keep chains short: grow once the average chain passes 2
+        if (entries >= capacity * 2)
+            rehash(capacity * 2);
+        table[hashFunc(key)].push_back(Pair<K, V>(key, value));
+        entries++;
     }
 
     // Search by key
     bool search(K key, V &value) const
     {
-        int index = hashFunc(key);
-        const LinkedList<Pair<K, V>> &bucket = table[index];
-        for (int i = 0; i < bucket.size(); i++)
+        ListNode<Pair<K, V>> *node = findNode(key);
+        if (node)
         {
-            if (bucket.get(i).first == key)
-            {
-                value = bucket.get(i).second;
-                return true;
-            }
+            value = node->data.second;
+            return true;
         }
         return false;
     }
 
+    // Pointer to the value stored for key, or nullptr (no copy; valid until
+    // the next insert or remove)
+    const V *find(const K &key) const
+    {
+        ListNode<Pair<K, V>> *node = findNode(key);
+        return node ? &node->data.second : nullptr;
+    }
+
     // Check if key exists (doesn't require default constructor)
     bool contains(K key) const
     {
-        int index = hashFunc(key);
-        const LinkedList<Pair<K, V>> &bucket = table[index];
-        for (int i = 0; i < bucket.size(); i++)
-        {
-            if (bucket.get(i).first == key)
-            {
-                return true;
-            }
-        }
-        return false;
+        return findNode(key) != nullptr;
     }
 
     // Remove key
     bool remove(K key)
     {
-        int index = hashFunc(key);
-        LinkedList<Pair<K, V>> &bucket = table[index];
-        for (int i = 0; i < bucket.size(); i++)
+        LinkedList<Pair<K, V>> &bucket = table[hashFunc(key)];
+        int i = 0;
+        for (ListNode<Pair<K, V>> *node = bucket.head; node; node = node->next, i++)
         {
-            if (bucket.get(i).first == key)
+            if (node->data.first == key)
             {
                 bucket.removeAt(i);
+                entries--;
                 return true;
             }
         }
         return false;
     }
 
+    // Number of stored entries
+    int size() const { return entries; }
+
+    // Exchange contents with another table (no copies)
+    void swap(HashTable &other)
+    {
+        table.swap(other.table);
+        int tmp = capacity;
+        capacity = other.capacity;
+        other.capacity = tmp;
+        tmp = entries;
+        entries = other.entries;
+        other.entries = tmp;
+    }
+
+    // Remove every entry (bucket count is kept)
+    void clear()
+    {
+        for (int i = 0; i < capacity; i++)
+            table[i].clear();
+        entries = 0;
+    }
+
+    // Charge the bucket array and every entry node to memory from now on
+    void setMemoryAccount(MemoryAccount *memory)
+    {
+        table.setMemoryAccount(memory ? memory : defaultAccount());
+    }
+
+    // Entries count as used; empty buckets and node links are slack
+    void measureMemory() const
+    {
+        table.getMemoryAccount()->addUsed((long long)entries * sizeof(Pair<K, V>));
+    }
+
     // Display all elements
     void display()
     {
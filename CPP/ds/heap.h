@@ -2,17 +2,24 @@
 #define HEAP_H
 
 #include <iostream>
+#include "memory_tracker.h"
 using namespace std;
 
-// Template Min Heap
+// Template Min Heap; the array doubles when an insert finds it full
 template <typename T>
 class MinHeap
 {
 private:
     T *heap;      // array to store heap elements
-    int capacity; // max size
+    int capacity; // allocated slots
     int size;     // current size
 
+    static MemoryAccount *account()
+    {
+        static MemoryAccount *a = MemoryTracker::instance().account("other.MinHeap", true);
+        return a;
+    }
+
     // Get parent and children indices
     int parent(int i) { return (i - 1) / 2; }
     int left(int i) { return 2 * i + 1; }
@@ -26,6 +33,20 @@ private:
         b = temp;
     }
 
+    // Double the array, keeping the elements
+    void grow()
+    {
+        int newCapacity = capacity > 0 ? capacity * 2 : 16;
+        T *bigger = new T[newCapacity];
+        for (int i = 0; i < size; i++)
+            bigger[i] = heap[i];
+        memoryReleased(account(), (long long)capacity * sizeof(T));
+        memoryAllocated(account(), (long long)newCapacity * sizeof(T));
+        delete[] heap;
+        heap = bigger;
+        capacity = newCapacity;
+    }
+
     // Heapify upwards
     void heapifyUp(int i)
     {
@@ -63,11 +84,13 @@ public:
         capacity = cap;
         size = 0;
         heap = new T[capacity];
+        memoryAllocated(account(), (long long)capacity * sizeof(T));
     }
 
     // Destructor
     ~MinHeap()
     {
+        memoryReleased(account(), (long long)capacity * sizeof(T));
         delete[] heap;
     }
 
@@ -75,10 +98,7 @@ public:
     void insert(T value)
     {
         if (size == capacity)
-        {
-            cout << "Heap is full!\n";
-            return;
-        }
+            grow();
 
         heap[size] = value;
         heapifyUp(size);
@@ -0,0 +1,255 @@
+#ifndef ID_INDEX_H
+#define ID_INDEX_H
+
+#include <iostream>
+#include "array.h"
+using namespace std;
+
+// Maps integer IDs to slots (array positions) in O(1)
+// While IDs are dense (e.g. handed out by an auto-increment counter) the
+// index is a direct-mapped array: slots[id - base]. If an ID arrives that
+// would leave the array mostly empty (far ahead, or before base) it
+// switches to an open-addressing hash table. Lookups never allocate.
+class IdIndex
+{
+private:
+    // Direct-mapped mode
+    DynamicArray<int> direct; // id - base -> slot, -1 = empty
+    int base;
+
+    // Hash mode (linear probing, power-of-two table)
+    DynamicArray<int> keys;
+    DynamicArray<int> values; // slot, or EMPTY / DELETED markers
+    int mask;
+    int used; // live + deleted entries in the hash table
+
+    bool hashed;
+    int count;
+
+    enum
+    {
+        EMPTY = -1,
+        DELETED = -2
+    };
+
+    static unsigned int hashInt(int key)
+    {
+        unsigned int h = (unsigned int)key;
+        h ^= h >> 16;
+        h *= 0x7feb352du;
+        h ^= h >> 15;
+        h *= 0x846ca68bu;
+        h ^= h >> 16;
+        return h;
+    }
+
+    void initTable(int capacity)
+    {
+        keys.clear();
+        values.clear();
+        keys.reserve(capacity);
+        values.reserve(capacity);
+        for (int i = 0; i < capacity; i++)
+        {
+            keys.push_back(0);
+            values.push_back(EMPTY);
+        }
+        mask = capacity - 1;
+        used = 0;
+    }
+
+    void hashInsert(int id, int slot)
+    {
+        unsigned int i = hashInt(id) & mask;
+        int tomb = -1;
+        while (values[i] != EMPTY)
+        {
+            if (values[i] == DELETED)
+            {
+                if (tomb == -1)
+                    tomb = (int)i;
+            }
+            else if (keys[i] == id)
+            {
+                values[i] = slot;
+                return;
+            }
+            i = (i + 1) & mask;
+        }
+        if (tomb != -1)
+            i = (unsigned int)tomb;
+        else
+            used++;
+        keys[i] = id;
+        values[i] = slot;
+        count++;
+    }
+
+    // Rebuild the hash table at a size that keeps load below 1/2
+    void rehash(int minLive)
+    {
+        DynamicArray<int> oldKeys;
+        DynamicArray<int> oldValues;
+        oldKeys.swap(keys);
+        oldValues.swap(values);
+
+        int capacity = 16;
+        while (capacity < minLive * 2 + 2)
+            capacity *= 2;
+        initTable(capacity);
+        count = 0;
+        for (int i = 0; i < oldKeys.size(); i++)
+            if (oldValues[i] >= 0)
+                hashInsert(oldKeys[i], oldValues[i]);
+    }
+
+    static void swapValue(int &a, int &b)
+    {
+        int tmp = a;
+        a = b;
+        b = tmp;
+    }
+
+    // Move every direct-mapped entry into a fresh hash table
+    void switchToHash()
+    {
+        int live = count;
+        initTable(16);
+        hashed = true;
+        count = 0;
+        rehash(live + 1);
+        for (int i = 0; i < direct.size(); i++)
+            if (direct[i] >= 0)
+                hashInsert(base + i, direct[i]);
+        direct.clear();
+    }
+
+public:
+    IdIndex() : base(1), mask(0), used(0), hashed(false), count(0) {}
+
+    // Map id -> slot (overwrites an existing mapping)
+    void insert(int id, int slot)
+    {
+        if (!hashed)
+        {
+            if (count == 0 && direct.empty())
+                base = id;
+            long long offset = (long long)id - base;
+            // Stay direct while the array would be at least ~1/2 full
+            if (offset >= 0 && offset < 2LL * (count + 1) + 1024)
+            {
+                while (direct.size() <= offset)
+                    direct.push_back(-1);
+                if (direct[(int)offset] < 0)
+                    count++;
+                direct[(int)offset] = slot;
+                return;
+            }
+            switchToHash();
+        }
+        if ((used + 1) * 2 > mask + 1)
+            rehash(count + 1);
+        hashInsert(id, slot);
+    }
+
+    // Slot for id, or -1 if not present
+    int find(int id) const
+    {
+        if (!hashed)
+        {
+            long long offset = (long long)id - base;
+            if (offset < 0 || offset >= direct.size())
+                return -1;
+            return direct[(int)offset];
+        }
+        unsigned int i = hashInt(id) & mask;
+        while (values[i] != EMPTY)
+        {
+            if (values[i] >= 0 && keys[i] == id)
+                return values[i];
+            i = (i + 1) & mask;
+        }
+        return -1;
+    }
+
+    bool contains(int id) const { return find(id) >= 0; }
+
+    // Remove id; returns false if it was not present
+    bool remove(int id)
+    {
+        if (!hashed)
+        {
+            long long offset = (long long)id - base;
+            if (offset < 0 || offset >= direct.size() || direct[(int)offset] < 0)
+                return false;
+            direct[(int)offset] = -1;
+            count--;
+            return true;
+        }
+        unsigned int i = hashInt(id) & mask;
+        while (values[i] != EMPTY)
+        {
+            if (values[i] >= 0 && keys[i] == id)
+            {
+                values[i] = DELETED;
+                count--;
+                return true;
+            }
+            i = (i + 1) & mask;
+        }
+        return false;
+    }
+
+    // Pre-size the direct array for n dense IDs
+    void reserve(int n)
+    {
+        if (!hashed)
+            direct.reserve(n);
+    }
+
+    int size() const { return count; }
+    bool isHashed() const { return hashed; }
+
+    // Exchange contents with another index (no copies)
+    void swap(IdIndex &other)
+    {
+        direct.swap(other.direct);
+        keys.swap(other.keys);
+        values.swap(other.values);
+        swapValue(base, other.base);
+        swapValue(mask, other.mask);
+        swapValue(used, other.used);
+        swapValue(count, other.count);
+        bool tmpHashed = hashed;
+        hashed = other.hashed;
+        other.hashed = tmpHashed;
+    }
+
+    // Charge the index arrays to memory from now on
+    void setMemoryAccount(MemoryAccount *memory)
+    {
+        direct.setMemoryAccount(memory);
+        keys.setMemoryAccount(memory);
+        values.setMemoryAccount(memory);
+    }
+
+    // Mapped IDs count as used; empty direct slots and free hash slots are slack
+    void measureMemory() const
+    {
+        direct.getMemoryAccount()->addUsed((long long)count * (hashed ? 2 : 1) * sizeof(int));
+    }
+
+    void clear()
+    {
+        direct.clear();
+        keys.clear();
+        values.clear();
+        base = 1;
+        mask = 0;
+        used = 0;
+        hashed = false;
+        count = 0;
+    }
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define LINKEDLIST_H
 
 #include <iostream>
+#include "memory_tracker.h"
 using namespace std;
 
 template <typename T>
@@ -17,12 +18,38 @@ class LinkedList
 {
 public:
     ListNode<T> *head;
+    ListNode<T> *tail; // last node, for O(1) insertEnd
     int count;
+    MemoryAccount *account; // where nodes are charged
 
-    LinkedList() : head(nullptr), count(0) {}
+    static MemoryAccount *defaultAccount()
+    {
+        static MemoryAccount *a = MemoryTracker::instance().account("other.LinkedList", true);
+        return a;
+    }
+
+    ListNode<T> *newNode(const T &val)
+    {
+        memoryAllocated(account, sizeof(ListNode<T>));
+        ListNode<T> *node = new ListNode<T>(val);
+        if (!account->unattributed)
+            memoryAttach(node->data, account);
+        return node;
+    }
+
+    void freeNode(ListNode<T> *node)
+    {
+        memoryReleased(account, sizeof(ListNode<T>));
+        delete node;
+    }
 
-    // Copy constructor (deep copy)
-    LinkedList(const LinkedList<T> &other) : head(nullptr), count(0)
+    LinkedList() : head(nullptr), tail(nullptr), count(0), account(defaultAccount()) {}
+
+    explicit LinkedList(MemoryAccount *memory)
+        : head(nullptr), tail(nullptr), count(0), account(memory ? memory : defaultAccount()) {}
+
+    // Copy constructor (deep copy, charged like the source)
+    LinkedList(const LinkedList<T> &other) : head(nullptr), tail(nullptr), count(0), account(other.account)
     {
         ListNode<T> *temp = other.head;
         while (temp)
@@ -38,6 +65,8 @@ public:
         if (this != &other)
         {
             clear();
+            if (account->unattributed)
+                account = other.account;
             ListNode<T> *temp = other.head;
             while (temp)
             {
@@ -56,29 +85,27 @@ public:
     // Insert at the end
     void insertEnd(T val)
     {
-        ListNode<T> *newNode = new ListNode<T>(val);
+        ListNode<T> *node = newNode(val);
         if (!head)
         {
-            head = newNode;
+            head = node;
         }
         else
         {
-            ListNode<T> *temp = head;
-            while (temp->next)
-            {
-                temp = temp->next;
-            }
-            temp->next = newNode;
+            tail->next = node;
         }
+        tail = node;
         count++;
     }
 
     // Insert at the front
     void insertFront(T val)
     {
-        ListNode<T> *newNode = new ListNode<T>(val);
-        newNode->next = head;
-        head = newNode;
+        ListNode<T> *node = newNode(val);
+        node->next = head;
+        head = node;
+        if (!tail)
+            tail = node;
         count++;
     }
 
@@ -93,7 +120,9 @@ public:
         {
             ListNode<T> *toDelete = head;
             head = head->next;
-            delete toDelete;
+            if (!head)
+                tail = nullptr;
+            freeNode(toDelete);
             count--;
             return true;
         }
@@ -108,7 +137,9 @@ public:
         {
             ListNode<T> *toDelete = temp->next;
             temp->next = temp->next->next;
-            delete toDelete;
+            if (toDelete == tail)
+                tail = temp;
+            freeNode(toDelete);
             count--;
             return true;
         }
@@ -129,11 +160,25 @@ public:
         {
             ListNode<T> *temp = head;
             head = head->next;
-            delete temp;
+            freeNode(temp);
         }
+        tail = nullptr;
         count = 0;
     }
 
+    // Remove the first node and return its value (list must not be empty)
+    T popFront()
+    {
+        ListNode<T> *toDelete = head;
+        T val = toDelete->data;
+        head = head->next;
+        if (!head)
+            tail = nullptr;
+        freeNode(toDelete);
+        count--;
+        return val;
+    }
+
     // New helpers for compatibility
     int size() const { return count; }
 
@@ -197,7 +242,9 @@ public:
         {
             ListNode<T> *toDelete = head;
             head = head->next;
-            delete toDelete;
+            if (!head)
+                tail = nullptr;
+            freeNode(toDelete);
             count--;
             return true;
         }
@@ -212,11 +259,33 @@ public:
             return false;
         ListNode<T> *toDelete = prev->next;
         prev->next = prev->next->next;
-        delete toDelete;
+        if (toDelete == tail)
+            tail = prev;
+        freeNode(toDelete);
         count--;
         return true;
     }
 
+    // Charge the nodes and their contents to memory from now on
+    void setMemoryAccount(MemoryAccount *memory)
+    {
+        if (!memory)
+            memory = defaultAccount();
+        memoryTransferred(account, memory, (long long)count * sizeof(ListNode<T>), count);
+        account = memory;
+        for (ListNode<T> *node = head; node; node = node->next)
+            memoryAttach(node->data, memory);
+    }
+
+    // Add the bytes of the stored values to the account's used bytes (the
+    // rest of each node is link overhead)
+    void measureMemory() const
+    {
+        account->addUsed((long long)count * sizeof(T));
+        for (ListNode<T> *node = head; node; node = node->next)
+            memoryMeasure(node->data);
+    }
+
     // Display list
     void display() const
     {
@@ -230,4 +299,16 @@ public:
     }
 };
 
+template <typename T>
+inline void memoryAttach(LinkedList<T> &list, MemoryAccount *account)
+{
+    list.setMemoryAccount(account);
+}
+
+template <typename T>
+inline void memoryMeasure(const LinkedList<T> &list)
+{
+    list.measureMemory();
+}
+
 #endif
@@ -0,0 +1,102 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <iostream>
+#include <string>
+#include <fstream>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Read-only view of a whole file
+// On POSIX systems the file is mmap'ed PROT_READ / MAP_SHARED: opening is
+// O(1), pages are faulted in on first touch, and every process mapping the
+// same file shares one copy in the page cache. Elsewhere the file is read
+// into a private buffer so callers still see a plain byte range.
+class MappedFile
+{
+private:
+    const char *bytes;
+    long long length;
+    bool mapped; // true: munmap on close, false: delete[]
+
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+
+public:
+    MappedFile() : bytes(nullptr), length(0), mapped(false) {}
+    ~MappedFile() { close(); }
+
+    bool open(const string &path)
+    {
+        close();
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        void *p = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // the mapping keeps its own reference
+        if (p == MAP_FAILED)
+            return false;
+        bytes = (const char *)p;
+        length = (long long)info.st_size;
+        mapped = true;
+        return true;
+#else
+        ifstream file(path.c_str(), ios::binary | ios::ate);
+        if (!file)
+            return false;
+        long long size = (long long)file.tellg();
+        if (size <= 0)
+            return false;
+        char *buffer = new char[size];
+        file.seekg(0);
+        file.read(buffer, size);
+        if (!file)
+        {
+            delete[] buffer;
+            return false;
+        }
+        bytes = buffer;
+        length = size;
+        mapped = false;
+        return true;
+#endif
+    }
+
+    void close()
+    {
+        if (!bytes)
+            return;
+#ifndef _WIN32
+        if (mapped)
+            munmap((void *)bytes, (size_t)length);
+        else
+            delete[] bytes;
+#else
+        delete[] bytes;
+#endif
+        bytes = nullptr;
+        length = 0;
+        mapped = false;
+    }
+
+    bool isOpen() const { return bytes != nullptr; }
+    bool isMapped() const { return mapped; }
+    const char *data() const { return bytes; }
+    long long size() const { return length; }
+};
+
+#endif
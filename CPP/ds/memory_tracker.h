@@ -0,0 +1,320 @@
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <atomic>
+#include <mutex>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define MEMORY_HAVE_MALLINFO2
+#endif
+using namespace std;
+
+// Memory accounting for the custom containers
+//
+// Every container allocation (DynamicArray buffers, LinkedList nodes, heap
+// arrays) is charged to a MemoryAccount: a named, process-wide bucket of
+// live bytes, live blocks, peak bytes and allocation count. Managers give
+// their containers named accounts ("stations", "graph.adjacency", ...);
+// anything else lands in an "other.<Container>" account.
+//
+// Nested containers follow their owner: the element arrays of an attributed
+// array are charged to the same account, and a copy of an attributed
+// container is charged to the source's account unless the copy already has
+// one of its own.
+//
+// The hooks are active only when ITNMS_MEMORY_TRACKING is defined (main.cpp
+// defines it unless built with -DITNMS_NO_MEMORY_TRACKING); otherwise they
+// are empty inline functions. Accounts are never destroyed, so a container
+// may outlive the manager that named it.
+//
+// "Used" bytes are not tracked on the hot path: a report first asks each
+// subsystem to measureMemory(), which walks its containers and adds the
+// bytes held by live elements. Live minus used is slack (spare capacity,
+// node links, empty buckets).
+
+#define MEMORY_MAX_ACCOUNTS 128
+
+struct MemoryAccount
+{
+    string name;
+    bool unattributed; // default account of a container type
+    atomic<long long> liveBytes;
+    atomic<long long> liveBlocks;
+    atomic<long long> peakBytes;
+    atomic<long long> allocations;
+    long long usedBytes; // from the last measurement, -1 = not measured
+
+    MemoryAccount() : unattributed(false), liveBytes(0), liveBlocks(0), peakBytes(0), allocations(0), usedBytes(-1) {}
+
+    void addUsed(long long bytes)
+    {
+        usedBytes = (usedBytes < 0 ? 0 : usedBytes) + bytes;
+    }
+};
+
+// Whole-process figures next to the tracked totals
+struct MemoryProcessStats
+{
+    long long rssKb;          // current resident set (0 if unknown)
+    long long peakRssKb;      // peak resident set (0 if unknown)
+    long long heapBytes;      // bytes the allocator got from the OS (-1 if unknown)
+    long long heapInUseBytes; // bytes handed out to the program
+    long long heapFreeBytes;  // held by the allocator but free: heap fragmentation
+
+    MemoryProcessStats() : rssKb(0), peakRssKb(0), heapBytes(-1), heapInUseBytes(-1), heapFreeBytes(-1) {}
+};
+
+class MemoryTracker
+{
+private:
+    mutex lock;
+    MemoryAccount accounts[MEMORY_MAX_ACCOUNTS];
+    atomic<int> accountCount;
+
+    MemoryTracker() : accountCount(0) {}
+
+    static string formatBytes(long long bytes)
+    {
+        const char *units[] = {"B", "KB", "MB", "GB", "TB"};
+        double v = (double)bytes;
+        int u = 0;
+        while ((v >= 1024.0 || v <= -1024.0) && u < 4)
+        {
+            v /= 1024.0;
+            u++;
+        }
+        ostringstream out;
+        out << fixed << setprecision(u == 0 ? 0 : 1) << v << " " << units[u];
+        return out.str();
+    }
+
+public:
+    static MemoryTracker &instance()
+    {
+        // Never destroyed: containers with static storage may free late
+        static MemoryTracker *tracker = new MemoryTracker();
+        return *tracker;
+    }
+
+    static bool enabled()
+    {
+#ifdef ITNMS_MEMORY_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Account called name (created on first use); the last slot is shared
+    // by every name once the table is full
+    MemoryAccount *account(const string &name, bool unattributed = false)
+    {
+        lock_guard<mutex> guard(lock);
+        int n = accountCount.load(memory_order_relaxed);
+        for (int i = 0; i < n; i++)
+            if (accounts[i].name == name)
+                return &accounts[i];
+        if (n == MEMORY_MAX_ACCOUNTS)
+            return &accounts[n - 1];
+        accounts[n].name = n == MEMORY_MAX_ACCOUNTS - 1 ? "other.overflow" : name;
+        accounts[n].unattributed = unattributed;
+        accountCount.store(n + 1, memory_order_release);
+        return &accounts[n];
+    }
+
+    int size() const { return accountCount.load(memory_order_acquire); }
+
+    const MemoryAccount &at(int i) const { return accounts[i]; }
+
+    // Forget the used bytes of the previous measurement
+    void beginMeasure()
+    {
+        int n = size();
+        for (int i = 0; i < n; i++)
+            accounts[i].usedBytes = -1;
+    }
+
+    long long totalLiveBytes() const
+    {
+        long long sum = 0;
+        int n = size();
+        for (int i = 0; i < n; i++)
+            sum += accounts[i].liveBytes.load(memory_order_relaxed);
+        return sum;
+    }
+
+    long long totalLiveBlocks() const
+    {
+        long long sum = 0;
+        int n = size();
+        for (int i = 0; i < n; i++)
+            sum += accounts[i].liveBlocks.load(memory_order_relaxed);
+        return sum;
+    }
+
+    static MemoryProcessStats processStats()
+    {
+        MemoryProcessStats s;
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS pmc;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        {
+            s.rssKb = (long long)(pmc.WorkingSetSize / 1024);
+            s.peakRssKb = (long long)(pmc.PeakWorkingSetSize / 1024);
+        }
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+#ifdef __APPLE__
+            s.peakRssKb = (long long)usage.ru_maxrss / 1024; // bytes on macOS
+#else
+            s.peakRssKb = (long long)usage.ru_maxrss;
+#endif
+        }
+        ifstream statm("/proc/self/statm");
+        long long pages, residentPages;
+        if (statm >> pages >> residentPages)
+            s.rssKb = residentPages * (long long)sysconf(_SC_PAGESIZE) / 1024;
+#endif
+#ifdef MEMORY_HAVE_MALLINFO2
+        struct mallinfo2 mi = mallinfo2();
+        s.heapBytes = (long long)(mi.arena + mi.hblkhd);
+        s.heapInUseBytes = (long long)(mi.uordblks + mi.hblkhd);
+        s.heapFreeBytes = (long long)mi.fordblks;
+#endif
+        return s;
+    }
+
+    // Table of accounts (largest first) followed by process totals
+    void writeReport(ostream &out) const
+    {
+        int n = size();
+        int order[MEMORY_MAX_ACCOUNTS];
+        for (int i = 0; i < n; i++)
+        {
+            // Insertion sort by live bytes, descending (at most a few dozen accounts)
+            int j = i;
+            long long live = accounts[i].liveBytes.load(memory_order_relaxed);
+            while (j > 0 && accounts[order[j - 1]].liveBytes.load(memory_order_relaxed) < live)
+            {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = i;
+        }
+
+        if (!enabled())
+            out << "  (allocation tracking compiled out: live figures are zero)\n";
+        out << "  " << left << setw(24) << "Account" << right << setw(12) << "Live" << setw(12) << "Blocks"
+            << setw(12) << "Peak" << setw(14) << "Allocations" << setw(12) << "Used" << setw(8) << "Slack" << "\n";
+        for (int k = 0; k < n; k++)
+        {
+            const MemoryAccount &a = accounts[order[k]];
+            long long live = a.liveBytes.load(memory_order_relaxed);
+            if (live == 0 && a.usedBytes <= 0 && a.allocations.load(memory_order_relaxed) == 0)
+                continue;
+            out << "  " << left << setw(24) << a.name << right << setw(12) << formatBytes(live) << setw(12)
+                << a.liveBlocks.load(memory_order_relaxed) << setw(12)
+                << formatBytes(a.peakBytes.load(memory_order_relaxed)) << setw(14)
+                << a.allocations.load(memory_order_relaxed) << setw(12)
+                << (a.usedBytes < 0 ? string("-") : formatBytes(a.usedBytes));
+            if (a.usedBytes >= 0 && live > 0 && live >= a.usedBytes)
+                out << setw(7) << fixed << setprecision(1) << 100.0 * (live - a.usedBytes) / live << "%";
+            else
+                out << setw(8) << "-";
+            out << "\n";
+        }
+
+        MemoryProcessStats p = processStats();
+        long long tracked = totalLiveBytes();
+        out << "\n  Tracked live:   " << formatBytes(tracked) << " in " << totalLiveBlocks() << " blocks\n";
+        if (p.rssKb > 0)
+            out << "  Resident (RSS): " << formatBytes(p.rssKb * 1024) << " (peak " << formatBytes(p.peakRssKb * 1024)
+                << "); untracked " << formatBytes(p.rssKb * 1024 - tracked) << "\n";
+        else if (p.peakRssKb > 0)
+            out << "  Peak RSS:       " << formatBytes(p.peakRssKb * 1024) << "\n";
+        if (p.heapBytes > 0)
+            out << "  Heap:           " << formatBytes(p.heapBytes) << " from the OS, " << formatBytes(p.heapInUseBytes)
+                << " in use, " << formatBytes(p.heapFreeBytes) << " free (" << fixed << setprecision(1)
+                << 100.0 * p.heapFreeBytes / p.heapBytes << "% fragmentation)\n";
+    }
+};
+
+// Hooks called by the containers
+
+inline void memoryAllocated(MemoryAccount *account, long long bytes)
+{
+#ifdef ITNMS_MEMORY_TRACKING
+    account->allocations.fetch_add(1, memory_order_relaxed);
+    account->liveBlocks.fetch_add(1, memory_order_relaxed);
+    long long live = account->liveBytes.fetch_add(bytes, memory_order_relaxed) + bytes;
+    long long peak = account->peakBytes.load(memory_order_relaxed);
+    while (live > peak && !account->peakBytes.compare_exchange_weak(peak, live, memory_order_relaxed))
+    {
+    }
+#else
+    (void)account;
+    (void)bytes;
+#endif
+}
+
+inline void memoryReleased(MemoryAccount *account, long long bytes)
+{
+#ifdef ITNMS_MEMORY_TRACKING
+    account->liveBlocks.fetch_sub(1, memory_order_relaxed);
+    account->liveBytes.fetch_sub(bytes, memory_order_relaxed);
+#else
+    (void)account;
+    (void)bytes;
+#endif
+}
+
+// Move live blocks from one account to another (container re-attributed)
+inline void memoryTransferred(MemoryAccount *from, MemoryAccount *to, long long bytes, long long blocks)
+{
+#ifdef ITNMS_MEMORY_TRACKING
+    if (from == to || blocks == 0)
+        return;
+    from->liveBlocks.fetch_sub(blocks, memory_order_relaxed);
+    from->liveBytes.fetch_sub(bytes, memory_order_relaxed);
+    to->liveBlocks.fetch_add(blocks, memory_order_relaxed);
+    long long live = to->liveBytes.fetch_add(bytes, memory_order_relaxed) + bytes;
+    long long peak = to->peakBytes.load(memory_order_relaxed);
+    while (live > peak && !to->peakBytes.compare_exchange_weak(peak, live, memory_order_relaxed))
+    {
+    }
+#else
+    (void)from;
+    (void)to;
+    (void)bytes;
+    (void)blocks;
+#endif
+}
+
+// Element hooks: containers call these on their elements so nested
+// containers follow their owner. Containers overload them for themselves;
+// anything else holds no tracked memory.
+template <typename T>
+inline void memoryAttach(T &, MemoryAccount *)
+{
+}
+
+template <typename T>
+inline void memoryMeasure(const T &)
+{
+}
+
+#endif
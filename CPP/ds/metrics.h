@@ -0,0 +1,368 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+using namespace std;
+
+// Hot-path metrics: counters and histograms kept per thread, summed on dump
+// and written in the Prometheus text format.
+//
+// Instrument code with the METRIC_* macros below. They are active only when
+// ITNMS_METRICS is defined (main.cpp defines it unless built with
+// -DITNMS_NO_METRICS); otherwise they expand to nothing, so the
+// instrumented code compiles exactly as if they were not there.
+//
+// Each call site registers its metric once (a function-local static) and
+// then only touches its own thread's shard: a relaxed load and store, no
+// lock and no shared cache line. Threads that exit fold their values into
+// a retired shard, so nothing is lost.
+//
+// A name may carry Prometheus labels, e.g. itnms_analytics_seconds{query="x"};
+// all label sets of one family share the HELP/TYPE lines.
+
+#define METRICS_MAX_METRICS 128
+#define METRICS_MAX_SLOTS 2048
+#define METRICS_MAX_BUCKETS 16
+
+enum MetricType
+{
+    METRIC_COUNTER,
+    METRIC_HISTOGRAM
+};
+
+// Bucket upper bounds of common histograms. Timers record nanoseconds and
+// are exported in seconds.
+static const long long metricLatencyBucketsNs[] = {1000LL, 4000LL, 16000LL, 64000LL, 256000LL, 1000000LL,
+                                                   4000000LL, 16000000LL, 64000000LL, 256000000LL, 1000000000LL};
+static const long long metricProbeBuckets[] = {0, 1, 2, 3, 4, 6, 8, 12, 16, 32};
+
+class MetricsRegistry
+{
+private:
+    struct MetricInfo
+    {
+        string family; // name without labels
+        string labels; // e.g. query="busiest_route" (may be empty)
+        string help;
+        MetricType type;
+        const long long *bounds; // histogram bucket upper bounds
+        int bucketCount;
+        double scale; // exported value = recorded value * scale
+        int firstSlot;
+    };
+
+    // One thread's values; slot layout per metric:
+    //   counter:   [value]
+    //   histogram: [bucket 0 .. bucket n-1, +Inf bucket, sum]
+    struct Shard
+    {
+        atomic<long long> slots[METRICS_MAX_SLOTS];
+        Shard *next;
+
+        Shard() : next(nullptr)
+        {
+            for (int i = 0; i < METRICS_MAX_SLOTS; i++)
+                slots[i].store(0, memory_order_relaxed);
+        }
+    };
+
+    // Registers the calling thread's shard, retires it when the thread ends
+    struct ShardHolder
+    {
+        Shard *shard;
+
+        ShardHolder() : shard(new Shard()) { instance().attach(shard); }
+        ~ShardHolder() { instance().retire(shard); }
+    };
+
+    mutex lock;
+    MetricInfo metrics[METRICS_MAX_METRICS];
+    int metricCount;
+    int slotCount;
+    Shard *live;   // shards of running threads
+    Shard retired; // totals of threads that have exited
+
+    MetricsRegistry() : metricCount(0), slotCount(0), live(nullptr) {}
+
+    void attach(Shard *s)
+    {
+        lock_guard<mutex> guard(lock);
+        s->next = live;
+        live = s;
+    }
+
+    void retire(Shard *s)
+    {
+        lock_guard<mutex> guard(lock);
+        for (int i = 0; i < slotCount; i++)
+            retired.slots[i].fetch_add(s->slots[i].load(memory_order_relaxed), memory_order_relaxed);
+        Shard **p = &live;
+        while (*p && *p != s)
+            p = &(*p)->next;
+        if (*p)
+            *p = s->next;
+        delete s;
+    }
+
+    static Shard &localShard()
+    {
+        static thread_local ShardHolder holder;
+        return *holder.shard;
+    }
+
+    // Slot of name (registered on first use); -1 if the registry is full
+    int registerMetric(const char *name, const char *help, MetricType type, const long long *bounds,
+                       int bucketCount, double scale)
+    {
+        lock_guard<mutex> guard(lock);
+        string full = name;
+        int brace = (int)full.find('{');
+        string family = brace < 0 ? full : full.substr(0, brace);
+        string labels = brace < 0 ? "" : full.substr(brace + 1, full.size() - brace - 2);
+        for (int i = 0; i < metricCount; i++)
+            if (metrics[i].family == family && metrics[i].labels == labels)
+                return metrics[i].firstSlot;
+
+        if (bucketCount > METRICS_MAX_BUCKETS)
+            bucketCount = METRICS_MAX_BUCKETS;
+        int slots = type == METRIC_COUNTER ? 1 : bucketCount + 2;
+        if (metricCount == METRICS_MAX_METRICS || slotCount + slots > METRICS_MAX_SLOTS)
+            return -1;
+        MetricInfo &m = metrics[metricCount++];
+        m.family = family;
+        m.labels = labels;
+        m.help = help;
+        m.type = type;
+        m.bounds = bounds;
+        m.bucketCount = type == METRIC_COUNTER ? 0 : bucketCount;
+        m.scale = scale;
+        m.firstSlot = slotCount;
+        slotCount += slots;
+        return m.firstSlot;
+    }
+
+    // Sum of one slot over every thread; caller holds lock
+    long long total(int slot) const
+    {
+        long long sum = retired.slots[slot].load(memory_order_relaxed);
+        for (Shard *s = live; s; s = s->next)
+            sum += s->slots[slot].load(memory_order_relaxed);
+        return sum;
+    }
+
+    static string withLabels(const string &labels, const string &extra)
+    {
+        if (labels.empty() && extra.empty())
+            return "";
+        if (labels.empty())
+            return "{" + extra + "}";
+        if (extra.empty())
+            return "{" + labels + "}";
+        return "{" + labels + "," + extra + "}";
+    }
+
+public:
+    static MetricsRegistry &instance()
+    {
+        static MetricsRegistry registry;
+        return registry;
+    }
+
+    int counter(const char *name, const char *help)
+    {
+        return registerMetric(name, help, METRIC_COUNTER, nullptr, 0, 1.0);
+    }
+
+    int histogram(const char *name, const char *help, const long long *bounds, int bucketCount, double scale = 1.0)
+    {
+        return registerMetric(name, help, METRIC_HISTOGRAM, bounds, bucketCount, scale);
+    }
+
+    // Latency histogram fed in nanoseconds, exported in seconds
+    int timer(const char *name, const char *help)
+    {
+        return histogram(name, help, metricLatencyBucketsNs,
+                         sizeof(metricLatencyBucketsNs) / sizeof(metricLatencyBucketsNs[0]), 1e-9);
+    }
+
+    // Hot path: only the calling thread ever writes its shard
+    static void add(int slot, long long delta)
+    {
+        if (slot < 0)
+            return;
+        atomic<long long> &v = localShard().slots[slot];
+        v.store(v.load(memory_order_relaxed) + delta, memory_order_relaxed);
+    }
+
+    static void observe(int slot, const long long bounds[], int bucketCount, long long value)
+    {
+        if (slot < 0)
+            return;
+        if (bucketCount > METRICS_MAX_BUCKETS)
+            bucketCount = METRICS_MAX_BUCKETS;
+        int b = 0;
+        while (b < bucketCount && value > bounds[b])
+            b++;
+        Shard &s = localShard();
+        s.slots[slot + b].store(s.slots[slot + b].load(memory_order_relaxed) + 1, memory_order_relaxed);
+        atomic<long long> &sum = s.slots[slot + bucketCount + 1];
+        sum.store(sum.load(memory_order_relaxed) + value, memory_order_relaxed);
+    }
+
+    // Current value of a counter summed over all threads (0 if unknown)
+    long long counterValue(const char *name)
+    {
+        lock_guard<mutex> guard(lock);
+        for (int i = 0; i < metricCount; i++)
+            if (metrics[i].type == METRIC_COUNTER && metrics[i].family + withLabels(metrics[i].labels, "") == name)
+                return total(metrics[i].firstSlot);
+        return 0;
+    }
+
+    // Number of observations of a histogram summed over all threads
+    long long histogramCount(const char *name)
+    {
+        lock_guard<mutex> guard(lock);
+        for (int i = 0; i < metricCount; i++)
+        {
+            const MetricInfo &m = metrics[i];
+            if (m.type != METRIC_HISTOGRAM || m.family + withLabels(m.labels, "") != name)
+                continue;
+            long long count = 0;
+            for (int b = 0; b <= m.bucketCount; b++)
+                count += total(m.firstSlot + b);
+            return count;
+        }
+        return 0;
+    }
+
+    int size()
+    {
+        lock_guard<mutex> guard(lock);
+        return metricCount;
+    }
+
+    // Prometheus text exposition format (version 0.0.4)
+    void writePrometheus(ostream &out)
+    {
+        lock_guard<mutex> guard(lock);
+#ifndef ITNMS_METRICS
+        out << "# metrics compiled out (build without -DITNMS_NO_METRICS to enable)\n";
+#endif
+        for (int i = 0; i < metricCount; i++)
+        {
+            const MetricInfo &m = metrics[i];
+            bool first = true;
+            for (int j = 0; j < i; j++)
+                first = first && metrics[j].family != m.family;
+            if (first)
+            {
+                out << "# HELP " << m.family << " " << m.help << "\n";
+                out << "# TYPE " << m.family << " " << (m.type == METRIC_COUNTER ? "counter" : "histogram") << "\n";
+            }
+            if (m.type == METRIC_COUNTER)
+            {
+                out << m.family << withLabels(m.labels, "") << " " << total(m.firstSlot) << "\n";
+                continue;
+            }
+            long long cumulative = 0;
+            for (int b = 0; b <= m.bucketCount; b++)
+            {
+                cumulative += total(m.firstSlot + b);
+                string le;
+                if (b == m.bucketCount)
+                    le = "le=\"+Inf\"";
+                else
+                {
+                    ostringstream bound;
+                    bound << m.bounds[b] * m.scale;
+                    le = "le=\"" + bound.str() + "\"";
+                }
+                out << m.family << "_bucket" << withLabels(m.labels, le) << " " << cumulative << "\n";
+            }
+            out << m.family << "_sum" << withLabels(m.labels, "") << " "
+                << total(m.firstSlot + m.bucketCount + 1) * m.scale << "\n";
+            out << m.family << "_count" << withLabels(m.labels, "") << " " << cumulative << "\n";
+        }
+    }
+
+    // Write the dump to path (replaced); false if the file cannot be written
+    bool writePrometheus(const string &path)
+    {
+        ofstream file(path.c_str(), ios::trunc);
+        if (!file)
+            return false;
+        writePrometheus(file);
+        file.close();
+        return (bool)file;
+    }
+};
+
+// Records the lifetime of its scope into a timer histogram
+class ScopedMetricTimer
+{
+private:
+    int slot;
+    chrono::steady_clock::time_point start;
+
+public:
+    ScopedMetricTimer(int timerSlot) : slot(timerSlot), start(chrono::steady_clock::now()) {}
+
+    ~ScopedMetricTimer()
+    {
+        long long ns = (long long)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        MetricsRegistry::observe(slot, metricLatencyBucketsNs,
+                                 sizeof(metricLatencyBucketsNs) / sizeof(metricLatencyBucketsNs[0]), ns);
+    }
+};
+
+#define METRIC_CONCAT_INNER(a, b) a##b
+#define METRIC_CONCAT(a, b) METRIC_CONCAT_INNER(a, b)
+
+#ifdef ITNMS_METRICS
+// Add n to a counter
+#define METRIC_ADD(name, help, n)                                                           \
+    do                                                                                      \
+    {                                                                                       \
+        static const int metricSlot = MetricsRegistry::instance().counter(name, help);      \
+        MetricsRegistry::add(metricSlot, n);                                                \
+    } while (0)
+// Record value into a histogram with the given bucket bounds array
+#define METRIC_OBSERVE(name, help, bounds, value)                                                          \
+    do                                                                                                     \
+    {                                                                                                      \
+        static const int metricSlot =                                                                      \
+            MetricsRegistry::instance().histogram(name, help, bounds, sizeof(bounds) / sizeof(bounds[0])); \
+        MetricsRegistry::observe(metricSlot, bounds, sizeof(bounds) / sizeof(bounds[0]), value);           \
+    } while (0)
+// Time the rest of the enclosing scope
+#define METRIC_TIMER(name, help)                                                                     \
+    static const int METRIC_CONCAT(metricTimerSlot, __LINE__) = MetricsRegistry::instance().timer(name, help); \
+    ScopedMetricTimer METRIC_CONCAT(metricTimer, __LINE__)(METRIC_CONCAT(metricTimerSlot, __LINE__))
+#else
+// Compiled out: arguments are not evaluated (sizeof only marks them used)
+#define METRIC_ADD(name, help, n) \
+    do                            \
+    {                             \
+        (void)sizeof(n);          \
+    } while (0)
+#define METRIC_OBSERVE(name, help, bounds, value) \
+    do                                            \
+    {                                             \
+        (void)sizeof(value);                      \
+    } while (0)
+#define METRIC_TIMER(name, help) \
+    do                           \
+    {                            \
+    } while (0)
+#endif
+
+#define METRIC_COUNT(name, help) METRIC_ADD(name, help, 1)
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+using namespace std;
+
+// Bounded lock-free multi-producer / multi-consumer queue
+// Ring buffer where every cell carries a sequence number (Vyukov's design).
+// A producer claims a cell with one CAS on the enqueue position, writes the
+// value and then publishes it by bumping the cell's sequence; consumers do
+// the mirror image. No locks, no allocation after construction. Capacity is
+// rounded up to a power of two. tryPush/tryPop fail instead of blocking
+// when the queue is full/empty so callers choose how to back off.
+
+#define MPMC_CACHE_LINE 64
+
+template <typename T>
+class MpmcQueue
+{
+private:
+    struct Cell
+    {
+        atomic<size_t> sequence;
+        T data;
+    };
+
+    Cell *buffer;
+    size_t mask;
+
+    // Keep the two hot positions on separate cache lines
+    char pad0[MPMC_CACHE_LINE];
+    atomic<size_t> enqueuePos;
+    char pad1[MPMC_CACHE_LINE];
+    atomic<size_t> dequeuePos;
+    char pad2[MPMC_CACHE_LINE];
+
+    // Not copyable
+    MpmcQueue(const MpmcQueue &);
+    MpmcQueue &operator=(const MpmcQueue &);
+
+public:
+    MpmcQueue(size_t capacity = 1024)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+        buffer = new Cell[size];
+        mask = size - 1;
+        for (size_t i = 0; i < size; i++)
+            buffer[i].sequence.store(i, memory_order_relaxed);
+        enqueuePos.store(0, memory_order_relaxed);
+        dequeuePos.store(0, memory_order_relaxed);
+    }
+
+    ~MpmcQueue()
+    {
+        delete[] buffer;
+    }
+
+    // Returns false if the queue is full
+    bool tryPush(const T &value)
+    {
+        Cell *cell;
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        while (true)
+        {
+            cell = &buffer[pos & mask];
+            size_t seq = cell->sequence.load(memory_order_acquire);
+            long long diff = (long long)seq - (long long)pos;
+            if (diff == 0)
+            {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false; // full
+            }
+            else
+            {
+                pos = enqueuePos.load(memory_order_relaxed);
+            }
+        }
+        cell->data = value;
+        cell->sequence.store(pos + 1, memory_order_release);
+        return true;
+    }
+
+    // Returns false if the queue is empty
+    bool tryPop(T &out)
+    {
+        Cell *cell;
+        size_t pos = dequeuePos.load(memory_order_relaxed);
+        while (true)
+        {
+            cell = &buffer[pos & mask];
+            size_t seq = cell->sequence.load(memory_order_acquire);
+            long long diff = (long long)seq - (long long)(pos + 1);
+            if (diff == 0)
+            {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false; // empty
+            }
+            else
+            {
+                pos = dequeuePos.load(memory_order_relaxed);
+            }
+        }
+        out = cell->data;
+        cell->sequence.store(pos + mask + 1, memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    // Approximate number of queued items (exact when no thread is active)
+    size_t approxSize() const
+    {
+        size_t e = enqueuePos.load(memory_order_relaxed);
+        size_t d = dequeuePos.load(memory_order_relaxed);
+        return e > d ? e - d : 0;
+    }
+};
+
+#endif
@@ -0,0 +1,306 @@
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstring>
+using namespace std;
+
+// Buffered output for display and export paths
+//
+// Values are formatted straight into one reusable buffer (integers by hand,
+// doubles with snprintf) and handed to the target stream in large blocks.
+// Nothing is flushed per line: the buffer goes out when it fills, on
+// flush(), and when the sink is destroyed, so a display method that prints
+// a million lines costs a few hundred writes instead of a million flushes.
+//
+// Use it like an ostream:
+//     OutputSink out(cout);
+//     out << "Station ID: " << id << ", Name: " << name << '\n';
+//     out.flush(); // explicit flush point (also done by the destructor)
+class OutputSink
+{
+private:
+    ostream &target;
+    char *buffer;
+    int length;
+    int capacity;
+
+    // Copying would flush the same bytes twice
+    OutputSink(const OutputSink &);
+    OutputSink &operator=(const OutputSink &);
+
+    void reserve(int n)
+    {
+        if (length + n > capacity)
+            drain();
+    }
+
+    // Hand buffered bytes to the stream without flushing it
+    void drain()
+    {
+        if (length > 0)
+            target.rdbuf()->sputn(buffer, length);
+        length = 0;
+    }
+
+public:
+    explicit OutputSink(ostream &out = cout, int bufferSize = 1 << 16)
+        : target(out), length(0), capacity(bufferSize < 64 ? 64 : bufferSize)
+    {
+        buffer = new char[capacity];
+    }
+
+    ~OutputSink()
+    {
+        flush();
+        delete[] buffer;
+    }
+
+    // Write everything buffered and flush the stream
+    void flush()
+    {
+        drain();
+        target.flush();
+    }
+
+    void write(const char *s, int n)
+    {
+        if (n > capacity)
+        {
+            drain();
+            target.rdbuf()->sputn(s, n);
+            return;
+        }
+        reserve(n);
+        memcpy(buffer + length, s, n);
+        length += n;
+    }
+
+    OutputSink &operator<<(char c)
+    {
+        reserve(1);
+        buffer[length++] = c;
+        return *this;
+    }
+
+    OutputSink &operator<<(const char *s)
+    {
+        write(s, (int)strlen(s));
+        return *this;
+    }
+
+    OutputSink &operator<<(const string &s)
+    {
+        write(s.data(), (int)s.size());
+        return *this;
+    }
+
+    OutputSink &operator<<(long long v)
+    {
+        char digits[24];
+        int n = 0;
+        unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+        do
+        {
+            digits[n++] = (char)('0' + u % 10);
+            u /= 10;
+        } while (u > 0);
+        reserve(n + 1);
+        if (v < 0)
+            buffer[length++] = '-';
+        while (n > 0)
+            buffer[length++] = digits[--n];
+        return *this;
+    }
+
+    OutputSink &operator<<(int v) { return *this << (long long)v; }
+    OutputSink &operator<<(long v) { return *this << (long long)v; }
+
+    // Same text as ostream's default (6 significant digits)
+    OutputSink &operator<<(double v) { return writeDouble(v, 6); }
+
+    OutputSink &writeDouble(double v, int precision)
+    {
+        reserve(32);
+        int n = snprintf(buffer + length, 32, "%.*g", precision, v);
+        if (n > 0 && n < 32)
+            length += n;
+        return *this;
+    }
+
+    // CSV field: quoted (with doubled quotes) only when it needs to be
+    OutputSink &writeCsv(const string &s)
+    {
+        if (s.find_first_of(",\"\r\n") == string::npos)
+            return *this << s;
+        *this << '"';
+        for (int i = 0; i < (int)s.size(); i++)
+        {
+            if (s[i] == '"')
+                *this << '"';
+            *this << s[i];
+        }
+        return *this << '"';
+    }
+
+    // JSON string literal with quotes; runs of plain characters are copied
+    // in one piece
+    OutputSink &writeJson(const string &s)
+    {
+        *this << '"';
+        int n = (int)s.size();
+        for (int i = 0; i < n; i++)
+        {
+            int run = i;
+            while (run < n && (unsigned char)s[run] >= 0x20 && s[run] != '"' && s[run] != '\\')
+                run++;
+            if (run > i)
+            {
+                write(s.data() + i, run - i);
+                i = run;
+                if (i == n)
+                    break;
+            }
+            unsigned char c = (unsigned char)s[i];
+            if (c == '"' || c == '\\')
+                *this << '\\' << (char)c;
+            else if (c == '\n')
+                *this << "\\n";
+            else if (c == '\t')
+                *this << "\\t";
+            else if (c == '\r')
+                *this << "\\r";
+            else if (c < 0x20)
+            {
+                char hex[8];
+                snprintf(hex, sizeof(hex), "\\u%04x", c);
+                *this << hex;
+            }
+            else
+                *this << (char)c;
+        }
+        return *this << '"';
+    }
+
+    // Bytes waiting in the buffer
+    int buffered() const { return length; }
+};
+
+// Export formats of the display paths
+enum OutputFormat
+{
+    OUTPUT_TEXT, // the human-readable lines printed by the menus
+    OUTPUT_CSV,  // header row, one row per record
+    OUTPUT_JSON  // array of objects
+};
+
+// Parse "text", "csv" or "json"; false if unknown
+inline bool parseOutputFormat(const string &name, OutputFormat &format)
+{
+    if (name == "text" || name == "txt")
+        format = OUTPUT_TEXT;
+    else if (name == "csv")
+        format = OUTPUT_CSV;
+    else if (name == "json")
+        format = OUTPUT_JSON;
+    else
+        return false;
+    return true;
+}
+
+// Rows of named fields written as CSV or as a JSON array of objects.
+// Fields must be given in column order, one beginRow()/endRow() per record:
+//     RecordWriter w(out, OUTPUT_CSV, columns, 3);
+//     w.beginRow(); w.field(id); w.field(name); w.field(km); w.endRow();
+//     w.finish();
+// (OUTPUT_TEXT is not a record format: display paths print their own lines.)
+class RecordWriter
+{
+private:
+    OutputSink &out;
+    OutputFormat format;
+    const char *const *columns;
+    int columnCount;
+    int column; // next field of the current row
+    int rows;
+    bool finished;
+
+    void separator()
+    {
+        if (column > 0)
+            out << ',';
+        if (format == OUTPUT_JSON)
+            out << '"' << columns[column < columnCount ? column : columnCount - 1] << "\":";
+        column++;
+    }
+
+public:
+    RecordWriter(OutputSink &sink, OutputFormat outputFormat, const char *const columnNames[], int n)
+        : out(sink), format(outputFormat), columns(columnNames), columnCount(n), column(0), rows(0), finished(false)
+    {
+        if (format == OUTPUT_CSV)
+        {
+            for (int i = 0; i < n; i++)
+                out << (i > 0 ? "," : "") << columns[i];
+            out << '\n';
+        }
+        else
+            out << '[';
+    }
+
+    ~RecordWriter() { finish(); }
+
+    void beginRow()
+    {
+        column = 0;
+        if (format == OUTPUT_JSON)
+            out << (rows > 0 ? ",\n{" : "\n{");
+    }
+
+    void endRow()
+    {
+        out << (format == OUTPUT_JSON ? "}" : "\n");
+        rows++;
+    }
+
+    void field(long long v)
+    {
+        separator();
+        out << v;
+    }
+
+    void field(int v) { field((long long)v); }
+
+    void field(double v)
+    {
+        separator();
+        out.writeDouble(v, 15);
+    }
+
+    void field(const string &s)
+    {
+        separator();
+        if (format == OUTPUT_JSON)
+            out.writeJson(s);
+        else
+            out.writeCsv(s);
+    }
+
+    void field(const char *s) { field(string(s)); }
+
+    // Close the JSON array (idempotent; the destructor calls it too)
+    void finish()
+    {
+        if (finished)
+            return;
+        finished = true;
+        if (format == OUTPUT_JSON)
+            out << (rows > 0 ? "\n]\n" : "]\n");
+    }
+
+    int rowCount() const { return rows; }
+};
+
+#endif
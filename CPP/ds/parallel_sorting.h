@@ -0,0 +1,200 @@
+#ifndef PARALLEL_SORTING_H
+#define PARALLEL_SORTING_H
+
+#include "sorting.h"
+#include "thread_pool.h"
+using namespace std;
+
+// Parallel Merge Sort
+// Fork-join version of mergeSortBuffered: the two halves are sorted as
+// separate pool tasks, and large merges are themselves split and run in
+// parallel. One scratch buffer is shared by the whole sort (every task
+// touches a disjoint range of it). Stable.
+//
+// Build with -pthread.
+
+// Below this many elements a sort or merge task is not worth forking
+#define PARALLEL_SORT_GRAIN 8192
+
+// First index in arr[lo..hi) whose value is not less than key
+template <typename T, typename Compare>
+int lowerBoundRange(const T arr[], int lo, int hi, const T &key, Compare less)
+{
+    while (lo < hi)
+    {
+        int mid = lo + (hi - lo) / 2;
+        if (less(arr[mid], key))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// First index in arr[lo..hi) whose value is greater than key
+template <typename T, typename Compare>
+int upperBoundRange(const T arr[], int lo, int hi, const T &key, Compare less)
+{
+    while (lo < hi)
+    {
+        int mid = lo + (hi - lo) / 2;
+        if (less(key, arr[mid]))
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+template <typename T, typename Compare>
+void parallelMergeRuns(ThreadPool &pool, const T src[], int a1, int a2, int b1, int b2, T dst[], int out,
+                       Compare less, int depth);
+
+template <typename T, typename Compare>
+void parallelMergeSortInto(ThreadPool &pool, T src[], T dst[], int lo, int hi, Compare less, int depth);
+
+// Forked halves of a merge and of a sort, run as pool tasks
+template <typename T, typename Compare>
+struct MergeRunsTask
+{
+    ThreadPool *pool;
+    const T *src;
+    int a1, a2, b1, b2;
+    T *dst;
+    int out;
+    Compare less;
+    int depth;
+
+    MergeRunsTask(ThreadPool *p, const T *s, int x1, int x2, int y1, int y2, T *d, int o, Compare c, int dp)
+        : pool(p), src(s), a1(x1), a2(x2), b1(y1), b2(y2), dst(d), out(o), less(c), depth(dp) {}
+
+    static void run(void *self)
+    {
+        MergeRunsTask *t = (MergeRunsTask *)self;
+        parallelMergeRuns(*t->pool, t->src, t->a1, t->a2, t->b1, t->b2, t->dst, t->out, t->less, t->depth);
+    }
+};
+
+template <typename T, typename Compare>
+struct MergeSortTask
+{
+    ThreadPool *pool;
+    T *src;
+    T *dst;
+    int lo, hi;
+    Compare less;
+    int depth;
+
+    MergeSortTask(ThreadPool *p, T *s, T *d, int l, int h, Compare c, int dp)
+        : pool(p), src(s), dst(d), lo(l), hi(h), less(c), depth(dp) {}
+
+    static void run(void *self)
+    {
+        MergeSortTask *t = (MergeSortTask *)self;
+        parallelMergeSortInto(*t->pool, t->src, t->dst, t->lo, t->hi, t->less, t->depth);
+    }
+};
+
+// Merge src[a1..a2) (left run) and src[b1..b2) (right run) into dst starting
+// at out. Splits around the median of the longer run and merges both sides
+// in parallel while depth allows.
+template <typename T, typename Compare>
+void parallelMergeRuns(ThreadPool &pool, const T src[], int a1, int a2, int b1, int b2, T dst[], int out,
+                       Compare less, int depth)
+{
+    int n1 = a2 - a1;
+    int n2 = b2 - b1;
+    if (depth <= 0 || n1 + n2 <= PARALLEL_SORT_GRAIN)
+    {
+        int i = a1, j = b1, k = out;
+        while (i < a2 && j < b2)
+        {
+            if (less(src[j], src[i]))
+                dst[k++] = src[j++];
+            else
+                dst[k++] = src[i++];
+        }
+        while (i < a2)
+            dst[k++] = src[i++];
+        while (j < b2)
+            dst[k++] = src[j++];
+        return;
+    }
+
+    // Pick the median of the longer run and find where it falls in the other.
+    // Equal keys from the left run always go first to keep the merge stable.
+    int am, bm;
+    if (n1 >= n2)
+    {
+        am = a1 + n1 / 2;
+        bm = lowerBoundRange(src, b1, b2, src[am], less);
+    }
+    else
+    {
+        bm = b1 + n2 / 2;
+        am = upperBoundRange(src, a1, a2, src[bm], less);
+    }
+    int split = out + (am - a1) + (bm - b1);
+
+    MergeRunsTask<T, Compare> left(&pool, src, a1, am, b1, bm, dst, out, less, depth - 1);
+    TaskGroup group(pool);
+    group.run(MergeRunsTask<T, Compare>::run, &left);
+    parallelMergeRuns(pool, src, am, a2, bm, b2, dst, split, less, depth - 1);
+    group.wait();
+}
+
+// Parallel counterpart of mergeSortInto: result for [lo..hi) ends up in dst
+template <typename T, typename Compare>
+void parallelMergeSortInto(ThreadPool &pool, T src[], T dst[], int lo, int hi, Compare less, int depth)
+{
+    if (depth <= 0 || hi - lo <= PARALLEL_SORT_GRAIN)
+    {
+        mergeSortInto(src, dst, lo, hi, less);
+        return;
+    }
+    int mid = lo + (hi - lo) / 2;
+    {
+        MergeSortTask<T, Compare> left(&pool, dst, src, lo, mid, less, depth - 1);
+        TaskGroup group(pool);
+        group.run(MergeSortTask<T, Compare>::run, &left);
+        parallelMergeSortInto(pool, dst, src, mid, hi, less, depth - 1);
+        group.wait();
+    }
+    parallelMergeRuns(pool, (const T *)src, lo, mid, mid, hi, dst, lo, less, depth);
+}
+
+// Parallel merge sort with a custom comparator on pool (the shared pool
+// when omitted). A one-thread pool sorts sequentially.
+template <typename T, typename Compare>
+void parallelMergeSort(T arr[], int size, Compare less, ThreadPool &pool)
+{
+    if (size < 2)
+        return;
+
+    // Each fork level doubles the number of tasks; a few per thread lets
+    // idle workers steal from uneven halves
+    int depth = 0;
+    if (pool.size() > 1)
+        while ((1 << depth) < pool.size() * 2)
+            depth++;
+
+    T *scratch = new T[size];
+    for (int i = 0; i < size; i++)
+        scratch[i] = arr[i];
+    parallelMergeSortInto(pool, scratch, arr, 0, size, less, depth);
+    delete[] scratch;
+}
+
+template <typename T, typename Compare>
+void parallelMergeSort(T arr[], int size, Compare less)
+{
+    parallelMergeSort(arr, size, less, ThreadPool::shared());
+}
+
+template <typename T>
+void parallelMergeSort(T arr[], int size)
+{
+    parallelMergeSort(arr, size, LessThan<T>(), ThreadPool::shared());
+}
+
+#endif
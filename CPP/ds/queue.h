@@ -39,13 +39,7 @@ public:
             return defaultVal;
         }
 
-        T frontVal = list.head->data;
-        // remove first node directly
-        ListNode<T> *tmp = list.head;
-        list.head = list.head->next;
-        delete tmp;
-        list.count--;
-        return frontVal;
+        return list.popFront();
     }
 
     // STL-style alias: pop returns void like std::queue
@@ -71,6 +65,11 @@ public:
 
     int size() const { return list.size(); }
 
+    // Memory accounting of the nodes (see memory_tracker.h)
+    void setMemoryAccount(MemoryAccount *memory) { list.setMemoryAccount(memory); }
+
+    void measureMemory() const { list.measureMemory(); }
+
     // Display the queue
     void display() const
     {
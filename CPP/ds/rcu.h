@@ -0,0 +1,261 @@
+#ifndef RCU_H
+#define RCU_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+using namespace std;
+
+// Epoch-based read-copy-update (RCU)
+//
+// Readers never lock. A read section records the current global epoch in
+// the thread's reader slot, loads the published pointer and uses the object
+// until the section ends. A writer builds a new object, swaps it in with
+// one atomic exchange and retires the old one; the old object is deleted
+// once every reader that could still hold it (one whose recorded epoch is
+// not newer than the retirement) has left its read section.
+//
+//     RcuPointer<Table> table;
+//     {
+//         RcuReadGuard guard;              // reader: no locks, no waiting
+//         const Table *t = table.read();
+//         ...                              // t stays valid until guard ends
+//     }
+//     table.publish(new Table(...));       // writer: old table retired
+//
+// Read sections nest. A pointer read inside a section must not be used
+// after it, nor handed to another thread. Reader slots are per thread and
+// registered on first use, like the metrics shards.
+
+class RcuDomain
+{
+private:
+    struct Reader
+    {
+        atomic<unsigned long long> epoch; // 0 = not in a read section
+        int depth;                        // nesting, touched by the owner only
+        Reader *next;
+
+        Reader() : epoch(0), depth(0), next(nullptr) {}
+    };
+
+    // Registers the calling thread's reader slot, removes it at thread exit
+    struct ReaderHolder
+    {
+        Reader *reader;
+
+        ReaderHolder() : reader(new Reader()) { instance().attach(reader); }
+        ~ReaderHolder() { instance().detach(reader); }
+    };
+
+    struct Retired
+    {
+        void *object;
+        void (*destroy)(void *);
+        unsigned long long epoch; // global epoch when it was unpublished
+        Retired *next;
+    };
+
+    mutex lock;
+    Reader *readers;
+    Retired *retired;
+    int pending;
+    atomic<unsigned long long> epoch;
+
+    RcuDomain() : readers(nullptr), retired(nullptr), pending(0), epoch(1) {}
+
+    void attach(Reader *r)
+    {
+        lock_guard<mutex> guard(lock);
+        r->next = readers;
+        readers = r;
+    }
+
+    void detach(Reader *r)
+    {
+        lock_guard<mutex> guard(lock);
+        Reader **p = &readers;
+        while (*p && *p != r)
+            p = &(*p)->next;
+        if (*p)
+            *p = r->next;
+        delete r;
+    }
+
+    static Reader &localReader()
+    {
+        static thread_local ReaderHolder holder;
+        return *holder.reader;
+    }
+
+    // Unlink every retired object no reader can still see; caller holds lock
+    Retired *takeReclaimable()
+    {
+        unsigned long long oldest = 0; // oldest epoch still being read, 0 = none
+        for (Reader *r = readers; r; r = r->next)
+        {
+            unsigned long long e = r->epoch.load(memory_order_seq_cst);
+            if (e != 0 && (oldest == 0 || e < oldest))
+                oldest = e;
+        }
+
+        Retired *free = nullptr;
+        Retired **p = &retired;
+        while (*p)
+        {
+            Retired *item = *p;
+            if (oldest == 0 || item->epoch < oldest)
+            {
+                *p = item->next;
+                item->next = free;
+                free = item;
+                pending--;
+            }
+            else
+                p = &item->next;
+        }
+        return free;
+    }
+
+    // Destroy outside the lock: objects can be large
+    static void destroyAll(Retired *list)
+    {
+        while (list)
+        {
+            Retired *next = list->next;
+            list->destroy(list->object);
+            delete list;
+            list = next;
+        }
+    }
+
+public:
+    static RcuDomain &instance()
+    {
+        // Never destroyed: reader slots of late-exiting threads detach here
+        static RcuDomain *domain = new RcuDomain();
+        return *domain;
+    }
+
+    void readLock()
+    {
+        Reader &r = localReader();
+        if (r.depth++ == 0)
+            r.epoch.store(epoch.load(memory_order_seq_cst), memory_order_seq_cst);
+    }
+
+    void readUnlock()
+    {
+        Reader &r = localReader();
+        if (--r.depth == 0)
+            r.epoch.store(0, memory_order_release);
+    }
+
+    // Hand over an object that has just been unpublished; destroy(object)
+    // runs once no reader can hold it (at once if nobody is reading)
+    void retire(void *object, void (*destroy)(void *))
+    {
+        Retired *item = new Retired();
+        item->object = object;
+        item->destroy = destroy;
+        Retired *free;
+        {
+            lock_guard<mutex> guard(lock);
+            item->epoch = epoch.fetch_add(1, memory_order_seq_cst);
+            item->next = retired;
+            retired = item;
+            pending++;
+            free = takeReclaimable();
+        }
+        destroyAll(free);
+    }
+
+    // Destroy what can be destroyed now; returns how many objects remain
+    int collect()
+    {
+        Retired *free;
+        int left;
+        {
+            lock_guard<mutex> guard(lock);
+            free = takeReclaimable();
+            left = pending;
+        }
+        destroyAll(free);
+        return left;
+    }
+
+    // Wait until every object retired so far is destroyed. Must not be
+    // called inside a read section (it would wait for itself).
+    void synchronize()
+    {
+        unsigned long long target = epoch.load(memory_order_seq_cst);
+        for (;;)
+        {
+            Retired *free;
+            bool done = true;
+            {
+                lock_guard<mutex> guard(lock);
+                free = takeReclaimable();
+                for (Retired *item = retired; item; item = item->next)
+                    if (item->epoch < target)
+                        done = false;
+            }
+            destroyAll(free);
+            if (done)
+                return;
+            this_thread::yield();
+        }
+    }
+
+    // Retired objects still waiting for readers
+    int pendingCount()
+    {
+        lock_guard<mutex> guard(lock);
+        return pending;
+    }
+};
+
+// Read section for the lifetime of the guard
+class RcuReadGuard
+{
+private:
+    RcuReadGuard(const RcuReadGuard &);
+    RcuReadGuard &operator=(const RcuReadGuard &);
+
+public:
+    RcuReadGuard() { RcuDomain::instance().readLock(); }
+    ~RcuReadGuard() { RcuDomain::instance().readUnlock(); }
+};
+
+// Pointer to an immutable T published by writers and read under RCU.
+// Owns the published object: replacing or destroying the pointer retires it.
+template <typename T>
+class RcuPointer
+{
+private:
+    atomic<T *> current;
+
+    RcuPointer(const RcuPointer &);
+    RcuPointer &operator=(const RcuPointer &);
+
+    static void destroy(void *object) { delete (T *)object; }
+
+public:
+    explicit RcuPointer(T *initial = nullptr) : current(initial) {}
+
+    ~RcuPointer() { publish(nullptr); }
+
+    // Current object; only valid inside a read section
+    const T *read() const { return current.load(memory_order_seq_cst); }
+
+    // Make next the current object (ownership passes to the pointer); the
+    // previous one is retired. Writers must serialize their publishes.
+    void publish(T *next)
+    {
+        T *old = current.exchange(next, memory_order_seq_cst);
+        if (old)
+            RcuDomain::instance().retire(old, destroy);
+    }
+};
+
+#endif
@@ -1,6 +1,13 @@
 #ifndef SEARCHING_H
 #define SEARCHING_H
 
+// SIMD kernels are only compiled for x86 with GCC/Clang; everything else
+// falls back to the scalar versions.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SEARCHING_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
 // Linear Search
 // Works on any data type
 // Checks each element one by one
@@ -26,7 +33,7 @@ int binarySearch(T arr[], int size, T key)
 
     while (low <= high)
     {
-        int mid = (low + high) / 2;
+        int mid = low + (high - low) / 2; // avoids int overflow
 
         if (arr[mid] == key)
             return mid; // key found
@@ -41,4 +48,247 @@ int binarySearch(T arr[], int size, T key)
     return -1; // not found
 }
 
+// Branchless Lower Bound
+// Index of the first element not less than key (size if none).
+// The loop has a fixed trip count of ~log2(n) and the only data-dependent
+// step is a conditional move, so there are no branch mispredictions.
+template <typename T>
+int lowerBound(const T arr[], int size, const T &key)
+{
+    if (size <= 0)
+        return 0;
+    const T *base = arr;
+    int n = size;
+    while (n > 1)
+    {
+        int half = n / 2;
+        base = (base[half] < key) ? base + half : base;
+        n -= half;
+    }
+    return (int)(base - arr) + (*base < key ? 1 : 0);
+}
+
+// Branchless Upper Bound
+// Index of the first element greater than key (size if none)
+template <typename T>
+int upperBound(const T arr[], int size, const T &key)
+{
+    if (size <= 0)
+        return 0;
+    const T *base = arr;
+    int n = size;
+    while (n > 1)
+    {
+        int half = n / 2;
+        base = (key < base[half]) ? base : base + half;
+        n -= half;
+    }
+    return (int)(base - arr) + (key < *base ? 0 : 1);
+}
+
+// Binary search built on the branchless lower bound; returns -1 if missing
+template <typename T>
+int branchlessBinarySearch(const T arr[], int size, const T &key)
+{
+    int i = lowerBound(arr, size, key);
+    if (i < size && !(key < arr[i]) && !(arr[i] < key))
+        return i;
+    return -1;
+}
+
+// Eytzinger Layout Search
+// Stores a sorted array in BFS (heap) order: the children of slot k are
+// 2k and 2k+1. The first levels of the tree share cache lines, so lookups
+// into large read-mostly arrays touch far fewer lines than binary search.
+// Build once from a sorted array, then search returns the index into that
+// original sorted array.
+template <typename T>
+class EytzingerIndex
+{
+private:
+    T *tree;       // tree[1..n] in Eytzinger order (slot 0 unused)
+    int *position; // position[k] = index of tree[k] in the sorted source
+    int n;
+
+    // In-order walk of the implicit tree assigns sorted elements to slots
+    int build(const T sorted[], int i, int k)
+    {
+        if (k <= n)
+        {
+            i = build(sorted, i, 2 * k);
+            tree[k] = sorted[i];
+            position[k] = i;
+            i++;
+            i = build(sorted, i, 2 * k + 1);
+        }
+        return i;
+    }
+
+    // Not copyable (owns raw buffers)
+    EytzingerIndex(const EytzingerIndex &);
+    EytzingerIndex &operator=(const EytzingerIndex &);
+
+public:
+    EytzingerIndex() : tree(nullptr), position(nullptr), n(0) {}
+
+    EytzingerIndex(const T sorted[], int size) : tree(nullptr), position(nullptr), n(0)
+    {
+        rebuild(sorted, size);
+    }
+
+    ~EytzingerIndex()
+    {
+        delete[] tree;
+        delete[] position;
+    }
+
+    // (Re)build from a sorted array
+    void rebuild(const T sorted[], int size)
+    {
+        delete[] tree;
+        delete[] position;
+        n = size > 0 ? size : 0;
+        tree = new T[n + 1];
+        position = new int[n + 1];
+        position[0] = n; // "past the end" for lowerBound misses
+        build(sorted, 0, 1);
+    }
+
+    int size() const { return n; }
+
+    // Index (in the sorted source) of the first element not less than key
+    int lowerBound(const T &key) const
+    {
+        int k = 1;
+        int lastAhead = n / 16; // deepest k whose prefetch target is still in tree
+        while (k <= n)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            // Descendants 4 levels down, clamped to the last slot
+            __builtin_prefetch(tree + (k <= lastAhead ? 16 * k : n));
+#endif
+            k = 2 * k + (tree[k] < key ? 1 : 0);
+        }
+        // Undo the trailing "went right" steps plus the last "went left"
+        while (k & 1)
+            k >>= 1;
+        k >>= 1;
+        return position[k];
+    }
+
+    // Index (in the sorted source) of key, or -1 if missing
+    int search(const T &key) const
+    {
+        int k = 1;
+        while (k <= n)
+            k = 2 * k + (tree[k] < key ? 1 : 0);
+        while (k & 1)
+            k >>= 1;
+        k >>= 1;
+        if (k == 0 || key < tree[k])
+            return -1;
+        return position[k];
+    }
+};
+
+// SIMD Linear Search (int keys)
+// Compares 8 (AVX2) or 4 (SSE2) keys per instruction. The best kernel for
+// the running CPU is picked once at first use; other CPUs and compilers use
+// the scalar loop.
+
+inline int linearSearchIntScalar(const int arr[], int size, int key)
+{
+    for (int i = 0; i < size; i++)
+    {
+        if (arr[i] == key)
+            return i;
+    }
+    return -1;
+}
+
+#ifdef SEARCHING_X86_SIMD
+
+__attribute__((target("sse2"))) inline int linearSearchIntSSE2(const int arr[], int size, int key)
+{
+    __m128i needle = _mm_set1_epi32(key);
+    int i = 0;
+    for (; i + 4 <= size; i += 4)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)(arr + i));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, needle)));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+    for (; i < size; i++)
+    {
+        if (arr[i] == key)
+            return i;
+    }
+    return -1;
+}
+
+__attribute__((target("avx2"))) inline int linearSearchIntAVX2(const int arr[], int size, int key)
+{
+    __m256i needle = _mm256_set1_epi32(key);
+    int i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        // Two vectors per iteration to keep both load ports busy
+        __m256i b0 = _mm256_loadu_si256((const __m256i *)(arr + i));
+        __m256i b1 = _mm256_loadu_si256((const __m256i *)(arr + i + 8));
+        __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi32(b0, needle), _mm256_cmpeq_epi32(b1, needle));
+        if (!_mm256_testz_si256(hit, hit))
+        {
+            int m0 = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(b0, needle)));
+            if (m0)
+                return i + __builtin_ctz(m0);
+            int m1 = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(b1, needle)));
+            return i + 8 + __builtin_ctz(m1);
+        }
+    }
+    for (; i < size; i++)
+    {
+        if (arr[i] == key)
+            return i;
+    }
+    return -1;
+}
+
+#endif
+
+typedef int (*IntSearchKernel)(const int[], int, int);
+
+// Pick the widest kernel this CPU supports
+inline IntSearchKernel selectIntSearchKernel()
+{
+#ifdef SEARCHING_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return linearSearchIntAVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return linearSearchIntSSE2;
+#endif
+    return linearSearchIntScalar;
+}
+
+// Name of the kernel in use (for benchmarks / diagnostics)
+inline const char *intSearchKernelName()
+{
+#ifdef SEARCHING_X86_SIMD
+    IntSearchKernel k = selectIntSearchKernel();
+    if (k == linearSearchIntAVX2)
+        return "avx2";
+    if (k == linearSearchIntSSE2)
+        return "sse2";
+#endif
+    return "scalar";
+}
+
+// Linear search for int keys with runtime CPU dispatch
+inline int linearSearchInt(const int arr[], int size, int key)
+{
+    static IntSearchKernel kernel = selectIntSearchKernel();
+    return kernel(arr, size, key);
+}
+
 #endif
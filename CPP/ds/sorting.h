@@ -2,6 +2,7 @@
 #define SORTING_H
 
 #include <iostream>
+#include "array.h"
 using namespace std;
 
 // Bubble Sort
@@ -181,4 +182,392 @@ void heapSort(T arr[], int n)
     }
 }
 
+// ---------------------------------------------------------------------------
+// Introsort (production sort)
+// Quick sort with median-of-three pivot, insertion sort for small ranges and
+// a heap sort fallback once recursion gets too deep. Always O(n log n), and
+// the stack depth stays O(log n) because we only recurse on the smaller side.
+// ---------------------------------------------------------------------------
+
+// Default comparator: ascending order using operator<
+template <typename T>
+struct LessThan
+{
+    bool operator()(const T &a, const T &b) const { return a < b; }
+};
+
+// Descending order using operator<
+template <typename T>
+struct GreaterThan
+{
+    bool operator()(const T &a, const T &b) const { return b < a; }
+};
+
+// Comparator built from a key extractor (function pointer or functor)
+template <typename KeyFn>
+struct KeyCompare
+{
+    KeyFn key;
+    bool ascending;
+
+    KeyCompare(KeyFn k, bool asc) : key(k), ascending(asc) {}
+
+    template <typename T>
+    bool operator()(const T &a, const T &b) const
+    {
+        return ascending ? key(a) < key(b) : key(b) < key(a);
+    }
+};
+
+// Ranges at or below this size are finished with insertion sort
+#define INTROSORT_THRESHOLD 16
+
+template <typename T>
+inline void sortSwap(T &a, T &b)
+{
+    T temp = a;
+    a = b;
+    b = temp;
+}
+
+// Insertion sort on arr[low..high] with a comparator
+template <typename T, typename Compare>
+void insertionSortRange(T arr[], int low, int high, Compare less)
+{
+    for (int i = low + 1; i <= high; i++)
+    {
+        if (!less(arr[i], arr[i - 1]))
+            continue;
+        T key = arr[i];
+        int j = i - 1;
+        while (j >= low && less(key, arr[j]))
+        {
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        arr[j + 1] = key;
+    }
+}
+
+// Sift-down on a max-heap stored in arr[base..base+n) (iterative)
+template <typename T, typename Compare>
+void siftDownRange(T arr[], int base, int n, int i, Compare less)
+{
+    while (true)
+    {
+        int largest = i;
+        int l = 2 * i + 1;
+        int r = l + 1;
+        if (l < n && less(arr[base + largest], arr[base + l]))
+            largest = l;
+        if (r < n && less(arr[base + largest], arr[base + r]))
+            largest = r;
+        if (largest == i)
+            return;
+        sortSwap(arr[base + i], arr[base + largest]);
+        i = largest;
+    }
+}
+
+// Heap sort on arr[low..high] with a comparator (introsort fallback)
+template <typename T, typename Compare>
+void heapSortRange(T arr[], int low, int high, Compare less)
+{
+    int n = high - low + 1;
+    for (int i = n / 2 - 1; i >= 0; i--)
+        siftDownRange(arr, low, n, i, less);
+    for (int i = n - 1; i > 0; i--)
+    {
+        sortSwap(arr[low], arr[low + i]);
+        siftDownRange(arr, low, i, 0, less);
+    }
+}
+
+// Order arr[a], arr[b], arr[c] so that arr[b] holds the median
+template <typename T, typename Compare>
+void medianOfThree(T arr[], int a, int b, int c, Compare less)
+{
+    if (less(arr[b], arr[a]))
+        sortSwap(arr[a], arr[b]);
+    if (less(arr[c], arr[b]))
+    {
+        sortSwap(arr[b], arr[c]);
+        if (less(arr[b], arr[a]))
+            sortSwap(arr[a], arr[b]);
+    }
+}
+
+// Hoare partition around a median-of-three pivot; returns split point p
+// such that arr[low..p] <= pivot <= arr[p+1..high]
+template <typename T, typename Compare>
+int introPartition(T arr[], int low, int high, Compare less)
+{
+    int mid = low + (high - low) / 2;
+    medianOfThree(arr, low, mid, high, less);
+    T pivot = arr[mid];
+
+    int i = low - 1;
+    int j = high + 1;
+    while (true)
+    {
+        do
+            i++;
+        while (less(arr[i], pivot));
+        do
+            j--;
+        while (less(pivot, arr[j]));
+        if (i >= j)
+            return j;
+        sortSwap(arr[i], arr[j]);
+    }
+}
+
+template <typename T, typename Compare>
+void introSortLoop(T arr[], int low, int high, int depthLimit, Compare less)
+{
+    while (high - low + 1 > INTROSORT_THRESHOLD)
+    {
+        if (depthLimit == 0)
+        {
+            heapSortRange(arr, low, high, less);
+            return;
+        }
+        depthLimit--;
+
+        int p = introPartition(arr, low, high, less);
+        // Recurse into the smaller half, loop on the larger one
+        if (p - low < high - p)
+        {
+            introSortLoop(arr, low, p, depthLimit, less);
+            low = p + 1;
+        }
+        else
+        {
+            introSortLoop(arr, p + 1, high, depthLimit, less);
+            high = p;
+        }
+    }
+    insertionSortRange(arr, low, high, less);
+}
+
+// Introsort main function with custom comparator (less(a, b) == "a before b")
+template <typename T, typename Compare>
+void introSort(T arr[], int size, Compare less)
+{
+    if (size < 2)
+        return;
+    int depthLimit = 0;
+    for (int n = size; n > 1; n >>= 1)
+        depthLimit += 2; // 2 * floor(log2(size))
+    introSortLoop(arr, 0, size - 1, depthLimit, less);
+}
+
+// Introsort using operator<
+template <typename T>
+void introSort(T arr[], int size)
+{
+    introSort(arr, size, LessThan<T>());
+}
+
+// Introsort by an extracted key, e.g. introSortByKey(arr, n, getCapacity)
+template <typename T, typename KeyFn>
+void introSortByKey(T arr[], int size, KeyFn key, bool ascending = true)
+{
+    introSort(arr, size, KeyCompare<KeyFn>(key, ascending));
+}
+
+// ---------------------------------------------------------------------------
+// Buffered Merge Sort
+// Same result as mergeSort (stable), but the scratch buffer is allocated once
+// for the whole sort instead of twice per merge, small runs are finished with
+// insertion sort, and the source/scratch arrays swap roles at every level so
+// nothing is copied back after a merge.
+// ---------------------------------------------------------------------------
+
+// Runs at or below this size are sorted with insertion sort
+#define MERGESORT_CUTOFF 32
+
+// Merge src[lo..mid) and src[mid..hi) into dst[lo..hi) (stable)
+template <typename T, typename Compare>
+void mergeRuns(const T src[], T dst[], int lo, int mid, int hi, Compare less)
+{
+    int i = lo, j = mid, k = lo;
+    while (i < mid && j < hi)
+    {
+        if (less(src[j], src[i]))
+            dst[k++] = src[j++];
+        else
+            dst[k++] = src[i++];
+    }
+    while (i < mid)
+        dst[k++] = src[i++];
+    while (j < hi)
+        dst[k++] = src[j++];
+}
+
+// Sort [lo..hi) so the result ends up in dst. On entry src and dst hold the
+// same values for this range; src is used as scratch.
+template <typename T, typename Compare>
+void mergeSortInto(T src[], T dst[], int lo, int hi, Compare less)
+{
+    if (hi - lo <= MERGESORT_CUTOFF)
+    {
+        insertionSortRange(dst, lo, hi - 1, less);
+        return;
+    }
+    int mid = lo + (hi - lo) / 2;
+    mergeSortInto(dst, src, lo, mid, less); // halves land in src
+    mergeSortInto(dst, src, mid, hi, less);
+    mergeRuns(src, dst, lo, mid, hi, less);
+}
+
+// Merge sort with a single scratch buffer and a custom comparator
+template <typename T, typename Compare>
+void mergeSortBuffered(T arr[], int size, Compare less)
+{
+    if (size < 2)
+        return;
+    T *scratch = new T[size];
+    for (int i = 0; i < size; i++)
+        scratch[i] = arr[i];
+    mergeSortInto(scratch, arr, 0, size, less);
+    delete[] scratch;
+}
+
+template <typename T>
+void mergeSortBuffered(T arr[], int size)
+{
+    mergeSortBuffered(arr, size, LessThan<T>());
+}
+
+// ---------------------------------------------------------------------------
+// LSD Radix Sort (integer keys)
+// Stable, O(n) per pass, 8-bit digits (4 passes over a 32-bit key). Passes
+// where every key shares the same digit are skipped. Works on a permutation
+// of indices so heavy records (Ticket, Station) are never moved.
+// ---------------------------------------------------------------------------
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+// Map a signed key to an unsigned one with the same ordering
+inline unsigned int radixKey(int key, bool ascending)
+{
+    unsigned int u = (unsigned int)key ^ 0x80000000u; // flip sign bit
+    return ascending ? u : ~u;
+}
+
+// Core pass loop: sorts (keys, perm) pairs of length size in place.
+// keyBuf/permBuf are scratch arrays of the same length; perm/permBuf may be
+// nullptr to sort the keys alone.
+inline void radixSortPairs(unsigned int keys[], int perm[], int size,
+                           unsigned int keyBuf[], int permBuf[])
+{
+    int counts[RADIX_BUCKETS];
+    unsigned int *srcK = keys, *dstK = keyBuf;
+    int *srcP = perm, *dstP = permBuf;
+
+    for (int shift = 0; shift < 32; shift += RADIX_BITS)
+    {
+        for (int b = 0; b < RADIX_BUCKETS; b++)
+            counts[b] = 0;
+        for (int i = 0; i < size; i++)
+            counts[(srcK[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+
+        // Every key has the same digit: this pass would be a no-op
+        if (counts[(srcK[0] >> shift) & (RADIX_BUCKETS - 1)] == size)
+            continue;
+
+        // Prefix sums -> starting offset of each bucket
+        int total = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++)
+        {
+            int c = counts[b];
+            counts[b] = total;
+            total += c;
+        }
+
+        for (int i = 0; i < size; i++)
+        {
+            int pos = counts[(srcK[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+            dstK[pos] = srcK[i];
+            if (srcP)
+                dstP[pos] = srcP[i];
+        }
+
+        unsigned int *tk = srcK;
+        srcK = dstK;
+        dstK = tk;
+        int *tp = srcP;
+        srcP = dstP;
+        dstP = tp;
+    }
+
+    // Result ended up in the scratch buffers: copy back
+    if (srcK != keys)
+    {
+        for (int i = 0; i < size; i++)
+            keys[i] = srcK[i];
+        if (perm)
+            for (int i = 0; i < size; i++)
+                perm[i] = srcP[i];
+    }
+}
+
+// Fill perm[0..size) with indices of arr ordered by key(arr[i]).
+// Ties keep their original relative order (stable).
+template <typename T, typename KeyFn>
+void radixSortIndices(const T arr[], int size, KeyFn key, int perm[], bool ascending = true)
+{
+    if (size <= 0)
+        return;
+
+    unsigned int *keys = new unsigned int[size];
+    unsigned int *keyBuf = new unsigned int[size];
+    int *permBuf = new int[size];
+
+    for (int i = 0; i < size; i++)
+    {
+        keys[i] = radixKey((int)key(arr[i]), ascending);
+        perm[i] = i;
+    }
+
+    radixSortPairs(keys, perm, size, keyBuf, permBuf);
+
+    delete[] keys;
+    delete[] keyBuf;
+    delete[] permBuf;
+}
+
+// DynamicArray version: perm is cleared and refilled with sorted indices
+template <typename T, typename KeyFn>
+void radixSortIndices(const DynamicArray<T> &arr, KeyFn key, DynamicArray<int> &perm, bool ascending = true)
+{
+    perm.clear();
+    for (int i = 0; i < arr.size(); i++)
+        perm.push_back(0);
+    radixSortIndices(arr.getRawArray(), arr.size(), key, perm.getRawArray(), ascending);
+}
+
+// In-place radix sort for plain int arrays
+inline void radixSort(int arr[], int size)
+{
+    if (size <= 0)
+        return;
+
+    unsigned int *keys = new unsigned int[size];
+    unsigned int *keyBuf = new unsigned int[size];
+
+    for (int i = 0; i < size; i++)
+        keys[i] = radixKey(arr[i], true);
+
+    radixSortPairs(keys, nullptr, size, keyBuf, nullptr);
+
+    for (int i = 0; i < size; i++)
+        arr[i] = (int)(keys[i] ^ 0x80000000u);
+
+    delete[] keys;
+    delete[] keyBuf;
+}
+
 #endif
@@ -24,12 +24,7 @@ public:
             static T defaultVal;
             return defaultVal;
         }
-        T val = list.head->data;
-        ListNode<T> *temp = list.head;
-        list.head = list.head->next;
-        delete temp;
-        list.count--;
-        return val;
+        return list.popFront();
     }
 
     T peek() const
@@ -57,6 +52,11 @@ public:
     T top() const { return peek(); }
     bool empty() const { return isEmpty(); }
 
+    // Memory accounting of the nodes (see memory_tracker.h)
+    void setMemoryAccount(MemoryAccount *memory) { list.setMemoryAccount(memory); }
+
+    void measureMemory() const { list.measureMemory(); }
+
     void display()
     {
         list.display();
@@ -0,0 +1,156 @@
+#ifndef STRING_DICTIONARY_H
+#define STRING_DICTIONARY_H
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include "array.h"
+using namespace std;
+
+// Dictionary encoding for repeated strings (names, dates, ...)
+// Each distinct string is stored once and gets a dense integer code
+// 0, 1, 2, ... in insertion order. Columns then store the int code instead
+// of a full std::string. Lookup uses open addressing with linear probing.
+class StringDictionary
+{
+private:
+    DynamicArray<string> values; // code -> string
+    DynamicArray<int> slots;     // hash slot -> code + 1 (0 = empty)
+    int mask;                    // slots.size() - 1 (power of two)
+
+    // FNV-1a hash
+    static unsigned int hashBytes(const char *s, int length)
+    {
+        unsigned int h = 2166136261u;
+        for (int i = 0; i < length; i++)
+        {
+            h ^= (unsigned char)s[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    static unsigned int hashString(const string &s) { return hashBytes(s.data(), (int)s.size()); }
+
+    void initSlots(int count)
+    {
+        slots.clear();
+        slots.reserve(count);
+        for (int i = 0; i < count; i++)
+            slots.push_back(0);
+        mask = count - 1;
+    }
+
+    // Double the slot table and re-insert every code
+    void grow()
+    {
+        initSlots((mask + 1) * 2);
+        for (int code = 0; code < values.size(); code++)
+        {
+            unsigned int i = hashString(values[code]) & mask;
+            while (slots[i] != 0)
+                i = (i + 1) & mask;
+            slots[i] = code + 1;
+        }
+    }
+
+public:
+    StringDictionary(int initialSlots = 64) : mask(0)
+    {
+        int count = 16;
+        while (count < initialSlots)
+            count *= 2;
+        initSlots(count);
+    }
+
+    // Code for s, or -1 if it has never been encoded
+    int find(const string &s) const
+    {
+        unsigned int i = hashString(s) & mask;
+        while (slots[i] != 0)
+        {
+            int code = slots[i] - 1;
+            if (values[code] == s)
+                return code;
+            i = (i + 1) & mask;
+        }
+        return -1;
+    }
+
+    // Same for a character range (no std::string needed, e.g. a parsed field)
+    int find(const char *s, int length) const
+    {
+        unsigned int i = hashBytes(s, length) & mask;
+        while (slots[i] != 0)
+        {
+            int code = slots[i] - 1;
+            if ((int)values[code].size() == length && memcmp(values[code].data(), s, length) == 0)
+                return code;
+            i = (i + 1) & mask;
+        }
+        return -1;
+    }
+
+    // Code for s, adding it if new
+    int encode(const string &s)
+    {
+        unsigned int i = hashString(s) & mask;
+        while (slots[i] != 0)
+        {
+            int code = slots[i] - 1;
+            if (values[code] == s)
+                return code;
+            i = (i + 1) & mask;
+        }
+
+        int code = values.size();
+        values.push_back(s);
+        slots[i] = code + 1;
+
+        // Keep load factor below 1/2
+        if (values.size() * 2 > mask + 1)
+            grow();
+        return code;
+    }
+
+    // String for a code
+    const string &decode(int code) const
+    {
+        return values.get(code);
+    }
+
+    // Number of distinct strings
+    int size() const { return values.size(); }
+
+    // Exchange contents with another dictionary (no copies)
+    void swap(StringDictionary &other)
+    {
+        values.swap(other.values);
+        slots.swap(other.slots);
+        int tmpMask = mask;
+        mask = other.mask;
+        other.mask = tmpMask;
+    }
+
+    // Charge the string and slot arrays to memory from now on (the string
+    // bodies themselves come from std::string's allocator and are untracked)
+    void setMemoryAccount(MemoryAccount *memory)
+    {
+        values.setMemoryAccount(memory);
+        slots.setMemoryAccount(memory);
+    }
+
+    void measureMemory() const
+    {
+        values.measureMemory();
+        slots.getMemoryAccount()->addUsed((long long)values.size() * sizeof(int));
+    }
+
+    void clear()
+    {
+        values.clear();
+        initSlots(16);
+    }
+};
+
+#endif
@@ -0,0 +1,544 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "array.h"
+#include "metrics.h"
+using namespace std;
+
+// Work-stealing thread pool and fork-join primitives
+//
+// Every worker owns a task deque: it pushes and pops its own work at the
+// back (LIFO, cache-warm) and, when that runs dry, steals from the front of
+// another worker's deque (FIFO, the oldest and usually largest pieces).
+// Threads outside the pool submit through a shared injection queue. A
+// thread waiting on a TaskGroup runs queued tasks meanwhile, so nested
+// parallelism never deadlocks and the caller counts as one of the threads.
+//
+// Primitives (templates taking a function pointer or a functor; bodies are
+// called concurrently and must only write their own indices/partials):
+//     parallelFor(pool, begin, end, grain, body)        body(lo, hi)
+//     parallelReduce(pool, begin, end, grain, identity, body, join)
+//                                                        body(lo, hi, partial)
+//                                                        join(into, from)
+// plus overloads over a DynamicArray's index range, and TaskGroup for
+// arbitrary fork-join work. Reductions join partials in range order, so the
+// result does not depend on scheduling.
+//
+// ThreadPool::shared() is the process-wide pool the subsystems use. Its
+// size, CPU pinning and per-task metrics come from ThreadPoolOptions: set
+// them with configureShared() before first use, or through the environment
+// (ITNMS_THREADS, ITNMS_PIN_THREADS=1, ITNMS_TASK_METRICS=1).
+//
+// Build with -pthread.
+
+// Chunks handed out per thread by parallelFor/parallelReduce: more than one
+// so stealing can even out uneven chunks
+#define POOL_CHUNKS_PER_THREAD 4
+
+struct ThreadPoolOptions
+{
+    int threads;      // total parallelism including the waiting caller (0 = hardware threads)
+    bool pinThreads;  // bind worker i to CPU (i + 1) mod CPUs; the caller keeps CPU 0's share
+    bool taskMetrics; // count tasks and steals and time every task (itnms_pool_*)
+
+    ThreadPoolOptions() : threads(0), pinThreads(false), taskMetrics(false) {}
+
+    // Defaults overridden by ITNMS_THREADS, ITNMS_PIN_THREADS, ITNMS_TASK_METRICS
+    static ThreadPoolOptions fromEnvironment()
+    {
+        ThreadPoolOptions o;
+        const char *v = getenv("ITNMS_THREADS");
+        if (v)
+            o.threads = atoi(v);
+        v = getenv("ITNMS_PIN_THREADS");
+        o.pinThreads = v && atoi(v) != 0;
+        v = getenv("ITNMS_TASK_METRICS");
+        o.taskMetrics = v && atoi(v) != 0;
+        return o;
+    }
+};
+
+class ThreadPool;
+class TaskGroup;
+
+struct PoolTask
+{
+    void (*fn)(void *);
+    void *arg;
+    TaskGroup *group;
+
+    PoolTask() : fn(nullptr), arg(nullptr), group(nullptr) {}
+    PoolTask(void (*taskFn)(void *), void *taskArg, TaskGroup *taskGroup) : fn(taskFn), arg(taskArg), group(taskGroup) {}
+};
+
+// Tasks that are waited for together. wait() (also run by the destructor)
+// returns once every task run() through the group has finished.
+class TaskGroup
+{
+private:
+    friend class ThreadPool;
+    ThreadPool &pool;
+    atomic<int> pending;
+
+    TaskGroup(const TaskGroup &);
+    TaskGroup &operator=(const TaskGroup &);
+
+public:
+    explicit TaskGroup(ThreadPool &owner) : pool(owner), pending(0) {}
+    ~TaskGroup() { wait(); }
+
+    // Queue fn(arg); arg must stay valid until wait() returns
+    void run(void (*fn)(void *), void *arg);
+
+    // Run queued tasks until the group's tasks are done
+    void wait();
+};
+
+class ThreadPool
+{
+private:
+    // One worker's deque (ring buffer); the owner uses the back, thieves
+    // the front. A short mutex per deque: contention only when stealing.
+    struct WorkQueue
+    {
+        mutex lock;
+        DynamicArray<PoolTask> ring;
+        int head;  // index of the front task
+        int count; // tasks queued
+
+        WorkQueue() : ring(64), head(0), count(0)
+        {
+            for (int i = 0; i < 64; i++)
+                ring.push_back(PoolTask());
+        }
+
+        void push(const PoolTask &task)
+        {
+            lock_guard<mutex> guard(lock);
+            int capacity = ring.size();
+            if (count == capacity)
+            {
+                DynamicArray<PoolTask> bigger(capacity * 2);
+                for (int i = 0; i < capacity * 2; i++)
+                    bigger.push_back(i < count ? ring[(head + i) % capacity] : PoolTask());
+                ring.swap(bigger);
+                head = 0;
+                capacity *= 2;
+            }
+            ring[(head + count) % capacity] = task;
+            count++;
+        }
+
+        bool popBack(PoolTask &task)
+        {
+            lock_guard<mutex> guard(lock);
+            if (count == 0)
+                return false;
+            count--;
+            task = ring[(head + count) % ring.size()];
+            return true;
+        }
+
+        bool popFront(PoolTask &task)
+        {
+            lock_guard<mutex> guard(lock);
+            if (count == 0)
+                return false;
+            task = ring[head];
+            head = (head + 1) % ring.size();
+            count--;
+            return true;
+        }
+    };
+
+    ThreadPoolOptions options;
+    int workerCount;
+    thread *workers;
+    WorkQueue *queues; // one per worker, then the injection queue
+    atomic<int> queued;
+    atomic<int> sleeping;
+    atomic<bool> stopping;
+    mutex sleepLock;
+    condition_variable wake;
+
+    ThreadPool(const ThreadPool &);
+    ThreadPool &operator=(const ThreadPool &);
+
+    // Index of the calling thread's deque in this pool, -1 if not a worker
+    int localIndex() const
+    {
+        return currentPool() == this ? currentIndex() : -1;
+    }
+
+    static const ThreadPool *&currentPool()
+    {
+        static thread_local const ThreadPool *pool = nullptr;
+        return pool;
+    }
+
+    static int &currentIndex()
+    {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    static int hardwareThreads()
+    {
+        int n = (int)thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }
+
+    static void pinCurrentThread(int cpu)
+    {
+#ifdef _WIN32
+        SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << (cpu % 64));
+#elif defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)cpu;
+#endif
+    }
+
+    // Take a task: own deque first, then the injection queue, then steal
+    bool take(int self, PoolTask &task)
+    {
+        if (self >= 0 && queues[self].popBack(task))
+        {
+            queued.fetch_sub(1, memory_order_seq_cst);
+            return true;
+        }
+        if (queues[workerCount].popFront(task))
+        {
+            queued.fetch_sub(1, memory_order_seq_cst);
+            return true;
+        }
+        int start = self >= 0 ? self + 1 : 0;
+        for (int k = 0; k < workerCount; k++)
+        {
+            int victim = (start + k) % workerCount;
+            if (victim != self && queues[victim].popFront(task))
+            {
+                queued.fetch_sub(1, memory_order_seq_cst);
+                if (options.taskMetrics)
+                    METRIC_COUNT("itnms_pool_steals_total", "Tasks a pool thread took from another worker's deque");
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void execute(const PoolTask &task)
+    {
+        if (options.taskMetrics)
+        {
+            METRIC_TIMER("itnms_pool_task_seconds", "Thread-pool task run time");
+            task.fn(task.arg);
+        }
+        else
+            task.fn(task.arg);
+        task.group->pending.fetch_sub(1, memory_order_release);
+    }
+
+    static void workerMain(ThreadPool *pool, int index)
+    {
+        currentPool() = pool;
+        currentIndex() = index;
+        if (pool->options.pinThreads)
+            pinCurrentThread((index + 1) % hardwareThreads());
+        PoolTask task;
+        for (;;)
+        {
+            if (pool->take(index, task))
+            {
+                pool->execute(task);
+                continue;
+            }
+            unique_lock<mutex> guard(pool->sleepLock);
+            pool->sleeping.fetch_add(1, memory_order_seq_cst);
+            while (pool->queued.load(memory_order_seq_cst) == 0 && !pool->stopping.load(memory_order_seq_cst))
+                pool->wake.wait(guard);
+            pool->sleeping.fetch_sub(1, memory_order_seq_cst);
+            if (pool->stopping.load(memory_order_seq_cst) && pool->queued.load(memory_order_seq_cst) == 0)
+                return;
+        }
+    }
+
+    static ThreadPoolOptions &sharedOptions()
+    {
+        static ThreadPoolOptions o = ThreadPoolOptions::fromEnvironment();
+        return o;
+    }
+
+    static atomic<bool> &sharedStarted()
+    {
+        static atomic<bool> started(false);
+        return started;
+    }
+
+public:
+    explicit ThreadPool(const ThreadPoolOptions &poolOptions = ThreadPoolOptions())
+        : options(poolOptions), queued(0), sleeping(0), stopping(false)
+    {
+        int threads = options.threads > 0 ? options.threads : hardwareThreads();
+        workerCount = threads - 1; // the waiting caller is the last thread
+        queues = new WorkQueue[workerCount + 1];
+        workers = workerCount > 0 ? new thread[workerCount] : nullptr;
+        for (int i = 0; i < workerCount; i++)
+            workers[i] = thread(workerMain, this, i);
+    }
+
+    ~ThreadPool()
+    {
+        {
+            lock_guard<mutex> guard(sleepLock);
+            stopping.store(true, memory_order_seq_cst);
+        }
+        wake.notify_all();
+        for (int i = 0; i < workerCount; i++)
+            workers[i].join();
+        delete[] workers;
+        delete[] queues;
+    }
+
+    // Threads working on a parallel loop: the workers plus the caller
+    int size() const { return workerCount + 1; }
+
+    const ThreadPoolOptions &getOptions() const { return options; }
+
+    // Queue a task of group (TaskGroup::run is the public entry)
+    void submit(const PoolTask &task)
+    {
+        task.group->pending.fetch_add(1, memory_order_relaxed);
+        if (workerCount == 0)
+        {
+            execute(task); // no workers: run inline
+            return;
+        }
+        if (options.taskMetrics)
+            METRIC_COUNT("itnms_pool_tasks_total", "Tasks submitted to the thread pool");
+        int self = localIndex();
+        queues[self >= 0 ? self : workerCount].push(task);
+        queued.fetch_add(1, memory_order_seq_cst);
+        if (sleeping.load(memory_order_seq_cst) > 0)
+        {
+            lock_guard<mutex> guard(sleepLock);
+            wake.notify_one();
+        }
+    }
+
+    // Run one queued task on the calling thread; false if none was found
+    bool runOne()
+    {
+        PoolTask task;
+        if (!take(localIndex(), task))
+            return false;
+        execute(task);
+        return true;
+    }
+
+    // Set the shared pool's options; false once the pool has been created
+    static bool configureShared(const ThreadPoolOptions &o)
+    {
+        if (sharedStarted().load())
+            return false;
+        sharedOptions() = o;
+        return true;
+    }
+
+    static ThreadPool &shared()
+    {
+        // Never destroyed: idle workers simply sleep until the process exits
+        static ThreadPool *pool = (sharedStarted().store(true), new ThreadPool(sharedOptions()));
+        return *pool;
+    }
+};
+
+inline void TaskGroup::run(void (*fn)(void *), void *arg)
+{
+    pool.submit(PoolTask(fn, arg, this));
+}
+
+inline void TaskGroup::wait()
+{
+    while (pending.load(memory_order_acquire) > 0)
+    {
+        if (!pool.runOne())
+            this_thread::yield();
+    }
+}
+
+// ---- Parallel loops ----
+
+// Chunk count for n indices: enough to balance, none smaller than grain
+inline int parallelChunks(const ThreadPool &pool, int n, int grain)
+{
+    if (grain < 1)
+        grain = 1;
+    int byGrain = (n + grain - 1) / grain;
+    int byThreads = pool.size() * POOL_CHUNKS_PER_THREAD;
+    int chunks = byGrain < byThreads ? byGrain : byThreads;
+    return chunks > 0 ? chunks : 1;
+}
+
+// Bounds of chunk c of [begin, end) split into chunks near-equal pieces
+inline int parallelChunkStart(int begin, int end, int chunks, int c)
+{
+    return begin + (int)((long long)(end - begin) * c / chunks);
+}
+
+template <typename Body>
+struct ParallelForChunk
+{
+    const Body *body;
+    int lo;
+    int hi;
+
+    static void run(void *self)
+    {
+        ParallelForChunk *c = (ParallelForChunk *)self;
+        (*c->body)(c->lo, c->hi);
+    }
+};
+
+// body(lo, hi) over [begin, end) in chunks of at least grain indices
+template <typename Body>
+void parallelFor(ThreadPool &pool, int begin, int end, int grain, const Body &body)
+{
+    int n = end - begin;
+    if (n <= 0)
+        return;
+    int chunks = parallelChunks(pool, n, grain);
+    if (chunks == 1 || pool.size() == 1)
+    {
+        body(begin, end);
+        return;
+    }
+    DynamicArray<ParallelForChunk<Body>> parts(chunks);
+    for (int c = 0; c < chunks; c++)
+    {
+        ParallelForChunk<Body> part;
+        part.body = &body;
+        part.lo = parallelChunkStart(begin, end, chunks, c);
+        part.hi = parallelChunkStart(begin, end, chunks, c + 1);
+        parts.push_back(part);
+    }
+    TaskGroup group(pool);
+    for (int c = 1; c < chunks; c++)
+        group.run(ParallelForChunk<Body>::run, &parts[c]);
+    ParallelForChunk<Body>::run(&parts[0]); // the caller takes the first chunk
+    group.wait();
+}
+
+template <typename T, typename Body>
+struct ParallelReduceChunk
+{
+    const Body *body;
+    int lo;
+    int hi;
+    T *partial;
+
+    static void run(void *self)
+    {
+        ParallelReduceChunk *c = (ParallelReduceChunk *)self;
+        (*c->body)(c->lo, c->hi, *c->partial);
+    }
+};
+
+// Fold [begin, end): every chunk starts from a copy of identity and is
+// filled by body(lo, hi, partial); partials are then joined left to right
+// with join(result, partial)
+template <typename T, typename Body, typename Join>
+T parallelReduce(ThreadPool &pool, int begin, int end, int grain, const T &identity, const Body &body,
+                 const Join &join)
+{
+    T result = identity;
+    int n = end - begin;
+    if (n <= 0)
+        return result;
+    int chunks = parallelChunks(pool, n, grain);
+    if (chunks == 1 || pool.size() == 1)
+    {
+        body(begin, end, result);
+        return result;
+    }
+    DynamicArray<T> partials(chunks);
+    for (int c = 0; c < chunks; c++)
+        partials.push_back(identity);
+    DynamicArray<ParallelReduceChunk<T, Body>> parts(chunks);
+    for (int c = 0; c < chunks; c++)
+    {
+        ParallelReduceChunk<T, Body> part;
+        part.body = &body;
+        part.lo = parallelChunkStart(begin, end, chunks, c);
+        part.hi = parallelChunkStart(begin, end, chunks, c + 1);
+        part.partial = &partials[c];
+        parts.push_back(part);
+    }
+    {
+        TaskGroup group(pool);
+        for (int c = 1; c < chunks; c++)
+            group.run(ParallelReduceChunk<T, Body>::run, &parts[c]);
+        ParallelReduceChunk<T, Body>::run(&parts[0]);
+        group.wait();
+    }
+    for (int c = 0; c < chunks; c++)
+        join(result, partials[c]);
+    return result;
+}
+
+// DynamicArray ranges: body(items, lo, hi) over every index of items
+template <typename E, typename Body>
+struct ArrayRangeBody
+{
+    const DynamicArray<E> *items;
+    const Body *body;
+
+    void operator()(int lo, int hi) const { (*body)(*items, lo, hi); }
+};
+
+template <typename E, typename Body>
+void parallelFor(ThreadPool &pool, const DynamicArray<E> &items, int grain, const Body &body)
+{
+    ArrayRangeBody<E, Body> range;
+    range.items = &items;
+    range.body = &body;
+    parallelFor(pool, 0, items.size(), grain, range);
+}
+
+template <typename E, typename T, typename Body>
+struct ArrayReduceBody
+{
+    const DynamicArray<E> *items;
+    const Body *body;
+
+    void operator()(int lo, int hi, T &partial) const { (*body)(*items, lo, hi, partial); }
+};
+
+// body(items, lo, hi, partial) over every index of items, joined in order
+template <typename E, typename T, typename Body, typename Join>
+T parallelReduce(ThreadPool &pool, const DynamicArray<E> &items, int grain, const T &identity, const Body &body,
+                 const Join &join)
+{
+    ArrayReduceBody<E, T, Body> range;
+    range.items = &items;
+    range.body = &body;
+    return parallelReduce(pool, 0, items.size(), grain, identity, range, join);
+}
+
+#endif
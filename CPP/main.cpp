@@ -1,4 +1,17 @@
+// Hot-path metrics (Save / Load menu > Dump Metrics); build with
+// -DITNMS_NO_METRICS to compile the instrumentation out entirely
+#ifndef ITNMS_NO_METRICS
+#define ITNMS_METRICS
+#endif
+
+// Per-subsystem allocation accounting (View menu > Memory Report); build
+// with -DITNMS_NO_MEMORY_TRACKING to compile the hooks out
+#ifndef ITNMS_NO_MEMORY_TRACKING
+#define ITNMS_MEMORY_TRACKING
+#endif
+
 #include <iostream>
+#include <fstream>
 #include "ds/array.h"
 #include "ds/linkedlist.h"
 #include "ds/queue.h"
@@ -19,6 +32,13 @@
 #include "system/route_manager.h"
 #include "system/ticket_manager.h"
 #include "system/vehicle_manager.h"
+#include "system/snapshot.h"
+#include "system/network_image.h"
+#include "system/write_ahead_log.h"
+#include "system/recovery.h"
+#include "system/bulk_importer.h"
+#include "system/gtfs_importer.h"
+#include "system/command_runner.h"
 
 using namespace std;
 
@@ -31,9 +51,10 @@ void displayRouteMenu(RouteManager &routeManager, HistoryManager &historyManager
 void displayVehicleMenu(VehicleManager &vehicleManager, HistoryManager &historyManager);
 void displayPassengerMenu(TicketManager &ticketManager, RouteManager &routeManager, HistoryManager &historyManager);
 void displayGraphMenu(RouteManager &routeManager);
-void displayViewMenu(RouteManager &routeManager, TicketManager &ticketManager, VehicleManager &vehicleManager);
+void displayViewMenu(RouteManager &routeManager, TicketManager &ticketManager, VehicleManager &vehicleManager, HistoryManager &historyManager);
 void displayHistoryMenu(HistoryManager &historyManager, RouteManager &routeManager, VehicleManager &vehicleManager);
 void displaySearchSortMenu(RouteManager &routeManager, VehicleManager &vehicleManager, TicketManager &ticketManager);
+void displaySnapshotMenu(RouteManager &routeManager, VehicleManager &vehicleManager, TicketManager &ticketManager, HistoryManager &historyManager, WriteAheadLog &wal);
 
 // ANSI Color codes for beautiful UI (works on Windows 10+ and Linux/Mac)
 #define RESET "\033[0m"
@@ -48,6 +69,10 @@ void displaySearchSortMenu(RouteManager &routeManager, VehicleManager &vehicleMa
 #define RED "\033[31m"
 #define BG_BLUE "\033[44m"
 
+// Default persistence files: the checkpoint snapshot and the log of changes since
+#define DEFAULT_SNAPSHOT "itnms.snap"
+#define DEFAULT_WAL "itnms.wal"
+
 // Enable ANSI colors and UTF-8 on Windows
 void enableColors()
 {
@@ -97,8 +122,86 @@ void waitForEnter()
     cin.get();
 }
 
-int main()
+// Thread-pool options of both modes: --threads N, --pin-threads and
+// --task-metrics (defaults from ITNMS_THREADS, ITNMS_PIN_THREADS and
+// ITNMS_TASK_METRICS). True if argv[i] is one; i is moved past its value.
+bool parsePoolOption(int argc, char **argv, int &i, ThreadPoolOptions &options)
+{
+    string arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc)
+        options.threads = atoi(argv[++i]);
+    else if (arg == "--pin-threads")
+        options.pinThreads = true;
+    else if (arg == "--task-metrics")
+        options.taskMetrics = true;
+    else
+        return false;
+    return true;
+}
+
+// Headless mode: itnms --batch [script | -] [--stop-on-error]
+// Runs a command script (stdin if none or "-") and prints one JSON result per
+// command. Starts from an empty network; use "load <file>" to begin from a snapshot.
+int runBatch(int argc, char **argv)
+{
+    string scriptPath = "-";
+    bool stopOnError = false;
+    ThreadPoolOptions poolOptions; // applied by main()
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--batch" || parsePoolOption(argc, argv, i, poolOptions))
+            continue;
+        if (arg == "--stop-on-error")
+            stopOnError = true;
+        else if (arg == "-" || arg[0] != '-')
+            scriptPath = arg;
+        else
+        {
+            cerr << "usage: " << argv[0]
+                 << " --batch [script | -] [--stop-on-error] [--threads N] [--pin-threads] [--task-metrics]\n";
+            return 2;
+        }
+    }
+
+    ifstream file;
+    if (scriptPath != "-")
+    {
+        file.open(scriptPath.c_str());
+        if (!file)
+        {
+            cerr << "ERROR: Cannot open script " << scriptPath << "\n";
+            return 2;
+        }
+    }
+
+    ios::sync_with_stdio(false);
+    RouteManager routeManager;
+    routeManager.setInstance();
+    TicketManager ticketManager;
+    VehicleManager vehicleManager;
+    HistoryManager historyManager;
+    ostream results(cout.rdbuf()); // cout itself is muted while commands run
+    CommandRunner runner(routeManager, vehicleManager, ticketManager, historyManager, results, stopOnError);
+    int errors = runner.run(scriptPath == "-" ? cin : file);
+    return errors > 0 ? 1 : 0;
+}
+
+int main(int argc, char **argv)
 {
+    ThreadPoolOptions poolOptions = ThreadPoolOptions::fromEnvironment();
+    bool batch = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (string(argv[i]) == "--batch")
+            batch = true;
+        else
+            parsePoolOption(argc, argv, i, poolOptions);
+    }
+    ThreadPool::configureShared(poolOptions);
+    if (batch)
+        return runBatch(argc, argv);
+
     enableColors();
     clearScreen();
     displayHeader();
@@ -111,6 +214,26 @@ int main()
     HistoryManager historyManager;
     Analytics analyticsManager;
 
+    // Restore the last session: checkpoint snapshot + write-ahead log tail
+    long long lastLsn = 0;
+    int replayed = 0;
+    if (!RecoveryManager::recover(DEFAULT_SNAPSHOT, DEFAULT_WAL, routeManager, vehicleManager, ticketManager,
+                                  historyManager, lastLsn, &replayed))
+        cout << RED << "  [X] ERROR: Previous session could not be recovered!" << RESET << "\n";
+    else if (replayed > 0)
+        cout << GREEN << "  [OK] Recovered " << replayed << " logged changes" << RESET << "\n";
+
+    WriteAheadLog wal;
+    if (wal.open(DEFAULT_WAL, WalOptions(), lastLsn))
+    {
+        routeManager.attachLog(&wal);
+        vehicleManager.attachLog(&wal);
+        ticketManager.attachLog(&wal);
+        historyManager.attachLog(&wal);
+    }
+    else
+        cout << RED << "  [X] ERROR: Write-ahead log unavailable, changes will not survive a crash" << RESET << "\n";
+
     int mainChoice;
     bool running = true;
 
@@ -143,7 +266,7 @@ int main()
             displayPassengerMenu(ticketManager, routeManager, historyManager);
             break;
         case 5:
-            displayViewMenu(routeManager, ticketManager, vehicleManager);
+            displayViewMenu(routeManager, ticketManager, vehicleManager, historyManager);
             break;
         case 6:
             displayGraphMenu(routeManager);
@@ -155,6 +278,9 @@ int main()
             displayHistoryMenu(historyManager, routeManager, vehicleManager);
             break;
         case 9:
+            displaySnapshotMenu(routeManager, vehicleManager, ticketManager, historyManager, wal);
+            break;
+        case 10:
             cout << "\n======================================================================\n";
             cout << "          Thank you for using ITNMS! Goodbye!\n";
             cout << "======================================================================\n\n";
@@ -185,7 +311,8 @@ void displayMainMenu()
     cout << "  |" << CYAN << "   [6]" << WHITE << "  [GRF]  Graph Algorithms & Analysis           " << GREEN << "|\n";
     cout << "  |" << CYAN << "   [7]" << WHITE << "  [SRC]  Search & Sort                         " << GREEN << "|\n";
     cout << "  |" << CYAN << "   [8]" << WHITE << "  [HST]  History & Undo                        " << GREEN << "|\n";
-    cout << "  |" << RED << "   [9]" << WHITE << "  [EXIT] Exit                                  " << GREEN << "|\n";
+    cout << "  |" << CYAN << "   [9]" << WHITE << "  [SAV]  Save / Load / Import Data             " << GREEN << "|\n";
+    cout << "  |" << RED << "  [10]" << WHITE << "  [EXIT] Exit                                  " << GREEN << "|\n";
     cout << "  |                                                        |\n";
     cout << "  +========================================================+\n";
     cout << RESET;
@@ -363,9 +490,9 @@ void displayRouteMenu(RouteManager &routeManager, HistoryManager &historyManager
             cin >> distance;
 
             // Validate inputs
-            if (distance <= 0)
+            if (!Route::validDistance(distance))
             {
-                cout << "ERROR: Distance must be greater than 0!\n";
+                cout << "ERROR: Distance must be a positive number below 2147483647 km!\n";
                 break;
             }
 
@@ -524,8 +651,8 @@ void displayVehicleMenu(VehicleManager &vehicleManager, HistoryManager &historyM
                 break;
             }
 
-            vehicleManager.removeVehicle(deleteVehicleID);
-            historyManager.addAction("DELETE_VEHICLE:" + to_string(deleteVehicleID));
+            if (vehicleManager.removeVehicle(deleteVehicleID))
+                historyManager.addAction("DELETE_VEHICLE:" + to_string(deleteVehicleID));
             waitForEnter();
             break;
         }
@@ -613,7 +740,8 @@ void displayPassengerMenu(TicketManager &ticketManager, RouteManager &routeManag
             }
 
             Passenger newPassenger(passengerID, passengerName, age);
-            ticketManager.addPassengerToQueue(newPassenger);
+            if (!ticketManager.addPassengerToQueue(newPassenger))
+                break;
             cout << "Passenger added to queue!\n";
 
             // Record history for undo
@@ -652,10 +780,10 @@ void displayPassengerMenu(TicketManager &ticketManager, RouteManager &routeManag
             }
 
             cout << "\n";
-            ticketManager.processNextPassenger(startID, endID, startName, endName);
-            // Update passenger counts at both stations
-            routeManager.incrementStationPassengers(startID);
-            routeManager.incrementStationPassengers(endID);
+            // Update passenger counts at both stations once the ticket is issued
+            if (ticketManager.processNextPassenger(startID, endID, startName, endName) &&
+                routeManager.incrementStationPassengers(startID))
+                routeManager.incrementStationPassengers(endID);
             waitForEnter();
             break;
         }
@@ -678,7 +806,7 @@ void displayPassengerMenu(TicketManager &ticketManager, RouteManager &routeManag
     }
 }
 
-void displayViewMenu(RouteManager &routeManager, TicketManager &ticketManager, VehicleManager &vehicleManager)
+void displayViewMenu(RouteManager &routeManager, TicketManager &ticketManager, VehicleManager &vehicleManager, HistoryManager &historyManager)
 {
     int viewChoice;
     bool viewMenuActive = true;
@@ -704,7 +832,11 @@ void displayViewMenu(RouteManager &routeManager, TicketManager &ticketManager, V
         cout << "  |" << GREEN << "  [10]" << RESET << "   Show Busiest Route                        " << WHITE << BOLD << "|\n";
         cout << "  |" << GREEN << "  [11]" << RESET << "   Fastest Vehicle Assignment                " << WHITE << BOLD << "|\n";
         cout << "  |" << GREEN << "  [12]" << RESET << "   Traffic Density Prediction                " << WHITE << BOLD << "|\n";
-        cout << "  |" << YELLOW << "  [13]" << RESET << "   [<] Back to Main Menu                     " << WHITE << BOLD << "|\n";
+        cout << "  |" << GREEN << "  [13]" << RESET << "   Ticket Usage Trends                       " << WHITE << BOLD << "|\n";
+        cout << "  |" << GREEN << "  [14]" << RESET << "   Top Origin-Destination Pairs              " << WHITE << BOLD << "|\n";
+        cout << "  |" << GREEN << "  [15]" << RESET << "   Route Loads (Trips on Shortest Paths)     " << WHITE << BOLD << "|\n";
+        cout << "  |" << GREEN << "  [16]" << RESET << "   Memory Report (per Subsystem)             " << WHITE << BOLD << "|\n";
+        cout << "  |" << YELLOW << "  [17]" << RESET << "   [<] Back to Main Menu                     " << WHITE << BOLD << "|\n";
         cout << "  |                                                        |\n";
         cout << "  +========================================================+\n";
         cout << RESET;
@@ -797,6 +929,38 @@ void displayViewMenu(RouteManager &routeManager, TicketManager &ticketManager, V
             waitForEnter();
             break;
         case 13:
+        {
+            int bucket;
+            cout << "\n1. Per minute\n2. Hourly\n3. Daily\n4. Weekly\nEnter choice: ";
+            cin >> bucket;
+            cout << "\n";
+            if (bucket < 1 || bucket > 4)
+                bucket = 3;
+            Analytics::usageTrends(ticketManager.getAllTickets(), bucket - 1);
+            waitForEnter();
+            break;
+        }
+        case 14:
+            cout << "\n";
+            routeManager.showTopOdPairs(ticketManager.originDestination(), 10);
+            waitForEnter();
+            break;
+        case 15:
+            cout << "\n";
+            routeManager.showRouteLoads(ticketManager.originDestination(), 10);
+            waitForEnter();
+            break;
+        case 16:
+            cout << "\n";
+            MemoryTracker::instance().beginMeasure();
+            routeManager.measureMemory();
+            vehicleManager.measureMemory();
+            ticketManager.measureMemory();
+            historyManager.measureMemory();
+            MemoryTracker::instance().writeReport(cout);
+            waitForEnter();
+            break;
+        case 17:
             viewMenuActive = false;
             break;
         default:
@@ -962,7 +1126,7 @@ void displayHistoryMenu(HistoryManager &historyManager, RouteManager &routeManag
         case 2:
         {
             string last = historyManager.undo();
-            if (last == "No actions to undo.")
+            if (last == "No actions to undo." || last.compare(0, 7, "ERROR: ") == 0)
             {
                 cout << last << endl;
                 break;
@@ -1029,8 +1193,8 @@ void displayHistoryMenu(HistoryManager &historyManager, RouteManager &routeManag
             break;
         }
         case 3:
-            historyManager.clearHistory();
-            cout << "History cleared." << endl;
+            if (historyManager.clearHistory())
+                cout << "History cleared." << endl;
             waitForEnter();
             break;
         case 4:
@@ -1190,3 +1354,282 @@ void displaySearchSortMenu(RouteManager &routeManager, VehicleManager &vehicleMa
         }
     }
 }
+
+void displaySnapshotMenu(RouteManager &routeManager, VehicleManager &vehicleManager, TicketManager &ticketManager, HistoryManager &historyManager, WriteAheadLog &wal)
+{
+    int choice;
+    bool menuActive = true;
+
+    while (menuActive)
+    {
+        clearScreen();
+        displayHeader();
+        cout << CYAN << BOLD;
+        cout << "  +========================================================+\n";
+        cout << "  |" << WHITE << "              SAVE / LOAD / IMPORT DATA                " << CYAN << "|\n";
+        cout << "  +========================================================+\n";
+        cout << "  |                                                        |\n";
+        cout << "  |" << GREEN << "   [1]" << WHITE << "  [SAV] Save Network State to File             " << CYAN << "|\n";
+        cout << "  |" << GREEN << "   [2]" << WHITE << "  [LOD] Load Network State from File           " << CYAN << "|\n";
+        cout << "  |" << GREEN << "   [3]" << WHITE << "  [IMG] Export / Load Network Image            " << CYAN << "|\n";
+        cout << "  |" << GREEN << "   [4]" << WHITE << "  [CSV] Bulk Import from CSV Files             " << CYAN << "|\n";
+        cout << "  |" << GREEN << "   [5]" << WHITE << "  [GTF] Import GTFS Feed Directory             " << CYAN << "|\n";
+        cout << "  |" << GREEN << "   [6]" << WHITE << "  [MET] Dump Metrics (Prometheus Format)       " << CYAN << "|\n";
+        cout << "  |" << GREEN << "   [7]" << WHITE << "  [EXP] Export Records (Text / CSV / JSON)     " << CYAN << "|\n";
+        cout << "  |" << YELLOW << "   [8]" << WHITE << "  [<]   Back to Main Menu                      " << CYAN << "|\n";
+        cout << "  |                                                        |\n";
+        cout << "  +========================================================+\n";
+        cout << RESET;
+        cout << "\n  " << CYAN << ">>" << RESET << " Enter choice: ";
+        cin >> choice;
+
+        if (cin.fail())
+        {
+            cin.clear();
+            cin.ignore(10000, '\n');
+            cout << "\nInvalid input! Please enter a number.\n\n";
+            continue;
+        }
+
+        switch (choice)
+        {
+        case 1:
+        case 2:
+        {
+            string path;
+            cout << "\nEnter snapshot file path [" << DEFAULT_SNAPSHOT << "]: ";
+            cin.ignore();
+            getline(cin, path);
+            if (path.empty())
+                path = DEFAULT_SNAPSHOT;
+
+            if (choice == 1)
+            {
+                // Saving to the default path is a checkpoint: it also empties the log
+                bool saved = path == DEFAULT_SNAPSHOT && wal.isOpen()
+                                 ? RecoveryManager::checkpoint(path, wal, routeManager, vehicleManager, ticketManager, historyManager)
+                                 : SnapshotManager::save(path, routeManager, vehicleManager, ticketManager, historyManager);
+                if (saved)
+                    cout << GREEN << "  [OK] Snapshot saved to " << path << RESET << "\n";
+                else
+                    cout << RED << "  [X] ERROR: Snapshot could not be saved!" << RESET << "\n";
+            }
+            else
+            {
+                // The log describes changes to the old state, so checkpoint the loaded one
+                bool loaded = SnapshotManager::load(path, routeManager, vehicleManager, ticketManager, historyManager);
+                if (loaded && wal.isOpen() &&
+                    !RecoveryManager::checkpoint(DEFAULT_SNAPSHOT, wal, routeManager, vehicleManager, ticketManager, historyManager))
+                    cout << RED << "  [X] ERROR: Loaded state could not be checkpointed!" << RESET << "\n";
+                if (loaded)
+                    cout << GREEN << "  [OK] Loaded " << routeManager.totalStations() << " stations, "
+                         << routeManager.totalRoutes() << " routes, " << vehicleManager.totalVehicles()
+                         << " vehicles, " << ticketManager.totalTicketsIssued() << " tickets" << RESET << "\n";
+                else
+                    cout << RED << "  [X] ERROR: Snapshot could not be loaded!" << RESET << "\n";
+            }
+            waitForEnter();
+            break;
+        }
+        case 3:
+        {
+            int action;
+            cout << "\n1. Export stations & routes to an image\n2. Load stations & routes from an image\nEnter choice: ";
+            cin >> action;
+            if (cin.fail() || action < 1 || action > 2)
+            {
+                cin.clear();
+                cin.ignore(10000, '\n');
+                cout << RED << "  [X] ERROR: Invalid choice!" << RESET << "\n";
+                waitForEnter();
+                break;
+            }
+            string path;
+            cout << "Enter image file path [itnms.img]: ";
+            cin.ignore();
+            getline(cin, path);
+            if (path.empty())
+                path = "itnms.img";
+
+            if (action == 1)
+            {
+                if (NetworkImage::write(path, routeManager.getStations(), routeManager.getRoutes()))
+                    cout << GREEN << "  [OK] Network image written to " << path << RESET << "\n";
+                else
+                    cout << RED << "  [X] ERROR: Network image could not be written!" << RESET << "\n";
+                waitForEnter();
+                break;
+            }
+
+            // Replaced unlogged, then checkpointed like an import
+            DynamicArray<Station> stations;
+            DynamicArray<Route> routes;
+            if (!NetworkImage::load(path, stations, routes))
+            {
+                cout << RED << "  [X] ERROR: Network image could not be loaded!" << RESET << "\n";
+                waitForEnter();
+                break;
+            }
+            routeManager.replaceNetwork(stations, routes);
+            if (wal.isOpen() &&
+                !RecoveryManager::checkpoint(DEFAULT_SNAPSHOT, wal, routeManager, vehicleManager, ticketManager, historyManager))
+                cout << RED << "  [X] ERROR: Loaded network could not be checkpointed!" << RESET << "\n";
+            cout << GREEN << "  [OK] Loaded " << stations.size() << " stations and " << routes.size() << " routes from "
+                 << path << RESET << "\n";
+            waitForEnter();
+            break;
+        }
+        case 4:
+        {
+            string stationsPath, routesPath, vehiclesPath;
+            cout << "\nStations CSV (id,name,location) [none]: ";
+            cin.ignore();
+            getline(cin, stationsPath);
+            cout << "Routes CSV (id,start_id,end_id,distance) [none]: ";
+            getline(cin, routesPath);
+            cout << "Vehicles CSV (id,name,capacity) [none]: ";
+            getline(cin, vehiclesPath);
+
+            // Import unlogged, then checkpoint: one snapshot instead of a log record per row
+            routeManager.attachLog(nullptr);
+            vehicleManager.attachLog(nullptr);
+            ImportReport report;
+            bool ok = BulkImporter::importFiles(stationsPath, routesPath, vehiclesPath, routeManager, vehicleManager, report);
+            if (wal.isOpen())
+            {
+                routeManager.attachLog(&wal);
+                vehicleManager.attachLog(&wal);
+                if (!RecoveryManager::checkpoint(DEFAULT_SNAPSHOT, wal, routeManager, vehicleManager, ticketManager, historyManager))
+                    cout << RED << "  [X] ERROR: Imported data could not be checkpointed!" << RESET << "\n";
+            }
+
+            cout << (ok && report.errors == 0 ? GREEN : YELLOW) << "  Imported " << report.stationsAdded << "/"
+                 << report.stationsRead << " stations, " << report.routesAdded << "/" << report.routesRead
+                 << " routes, " << report.vehiclesAdded << "/" << report.vehiclesRead << " vehicles ("
+                 << report.errors << " rows rejected)" << RESET << "\n";
+            waitForEnter();
+            break;
+        }
+        case 5:
+        {
+            string dir;
+            int routeType;
+            cout << "\nGTFS feed directory (stops.txt, stop_times.txt, ...): ";
+            cin.ignore();
+            getline(cin, dir);
+            cout << "Only route_type (e.g. 1 = metro, 3 = bus; -1 = all): ";
+            cin >> routeType;
+            if (cin.fail())
+            {
+                cin.clear();
+                routeType = -1;
+            }
+
+            GtfsOptions options;
+            options.routeType = routeType;
+            GtfsImporter importer(routeManager, options);
+            routeManager.attachLog(nullptr); // as for CSV: checkpoint instead of logging each row
+            bool ok = importer.importFeed(dir);
+            if (wal.isOpen())
+            {
+                routeManager.attachLog(&wal);
+                if (ok && !RecoveryManager::checkpoint(DEFAULT_SNAPSHOT, wal, routeManager, vehicleManager, ticketManager, historyManager))
+                    cout << RED << "  [X] ERROR: Imported data could not be checkpointed!" << RESET << "\n";
+            }
+
+            const GtfsReport &report = importer.getReport();
+            if (ok)
+                cout << GREEN << "  [OK] " << report.stationsAdded << " stations and " << report.routesAdded
+                     << " routes from " << report.trips << " trips (" << report.stopTimes << " stop times, "
+                     << report.unknownStops << " unknown stops, " << report.badRows << " bad rows)" << RESET << "\n";
+            else
+                cout << RED << "  [X] ERROR: GTFS feed could not be imported!" << RESET << "\n";
+            waitForEnter();
+            break;
+        }
+        case 6:
+        {
+            string path;
+            cout << "\nEnter metrics file path [itnms_metrics.prom]: ";
+            cin.ignore();
+            getline(cin, path);
+            if (path.empty())
+                path = "itnms_metrics.prom";
+
+            if (MetricsRegistry::instance().writePrometheus(path))
+                cout << GREEN << "  [OK] " << MetricsRegistry::instance().size() << " metrics written to " << path << RESET << "\n";
+            else
+                cout << RED << "  [X] ERROR: Metrics could not be written!" << RESET << "\n";
+            waitForEnter();
+            break;
+        }
+        case 7:
+        {
+            int dataset, formatChoice;
+            cout << "\n1. Stations\n2. Routes\n3. Vehicles\n4. Tickets\nEnter choice: ";
+            cin >> dataset;
+            cout << "1. Text\n2. CSV\n3. JSON\nEnter format: ";
+            cin >> formatChoice;
+            if (cin.fail() || dataset < 1 || dataset > 4 || formatChoice < 1 || formatChoice > 3)
+            {
+                cin.clear();
+                cin.ignore(10000, '\n');
+                cout << RED << "  [X] ERROR: Invalid choice!" << RESET << "\n";
+                waitForEnter();
+                break;
+            }
+            int orderChoice = 1;
+            if (dataset == 4)
+            {
+                cout << "1. By ticket ID\n2. By passenger\n3. By origin station\n4. By destination station\nEnter order: ";
+                cin >> orderChoice;
+                if (cin.fail() || orderChoice < 1 || orderChoice > 4)
+                {
+                    cin.clear();
+                    cin.ignore(10000, '\n');
+                    cout << RED << "  [X] ERROR: Invalid choice!" << RESET << "\n";
+                    waitForEnter();
+                    break;
+                }
+            }
+            const char *names[] = {"stations", "routes", "vehicles", "tickets"};
+            const char *extensions[] = {"txt", "csv", "json"};
+            OutputFormat format = (OutputFormat)(formatChoice - 1);
+            string defaultPath = string("itnms_") + names[dataset - 1] + "." + extensions[formatChoice - 1];
+
+            string path;
+            cout << "Enter output file path [" << defaultPath << "]: ";
+            cin.ignore();
+            getline(cin, path);
+            if (path.empty())
+                path = defaultPath;
+
+            ofstream file(path.c_str(), ios::binary);
+            if (file)
+            {
+                OutputSink sink(file, 1 << 20);
+                if (dataset == 1)
+                    routeManager.exportStations(sink, format);
+                else if (dataset == 2)
+                    routeManager.exportRoutes(sink, format);
+                else if (dataset == 3)
+                    vehicleManager.exportVehicles(sink, format);
+                else
+                    ticketManager.exportTickets(sink, format, RouteManager::getStationNameByIdStatic,
+                                                (TicketOrder)(orderChoice - 1));
+            }
+            if (file.good())
+                cout << GREEN << "  [OK] " << names[dataset - 1] << " exported to " << path << RESET << "\n";
+            else
+                cout << RED << "  [X] ERROR: Could not write " << path << "!" << RESET << "\n";
+            waitForEnter();
+            break;
+        }
+        case 8:
+            menuActive = false;
+            break;
+        default:
+            cout << "\nInvalid choice!\n";
+        }
+    }
+}
@@ -2,6 +2,7 @@
 #define PASSENGER_H
 
 #include <iostream>
+#include "../ds/output_sink.h"
 using namespace std;
 
 class Passenger
@@ -29,9 +30,15 @@ public:
     // Display passenger info
     void display() const
     {
-        cout << "Passenger ID: " << id
-             << ", Name: " << name
-             << ", Age: " << age << endl;
+        OutputSink out(cout);
+        display(out);
+    }
+
+    void display(OutputSink &out) const
+    {
+        out << "Passenger ID: " << id
+            << ", Name: " << name
+            << ", Age: " << age << '\n';
     }
 
     // Operator overloading for comparisons
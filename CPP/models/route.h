@@ -2,8 +2,13 @@
 #define ROUTE_H
 
 #include <iostream>
+#include <cmath>
+#include "../ds/output_sink.h"
 using namespace std;
 
+// Routes are stored in the graph with int distances
+#define ROUTE_MAX_DISTANCE 2147483647.0
+
 class Route
 {
 private:
@@ -27,13 +32,33 @@ public:
     // Setters
     void setDistance(double _distance) { distance = _distance; }
 
+    // The check every route entry point applies: finite, positive and
+    // below ROUTE_MAX_DISTANCE km
+    static bool validDistance(double km) { return isfinite(km) && km > 0 && km < ROUTE_MAX_DISTANCE; }
+    static const char *distanceRule() { return "distance must be a positive number below 2147483647 km"; }
+
     // Display route info
     void display() const
     {
-        cout << "Route ID: " << routeID
-             << ", From: " << startStationID
-             << ", To: " << endStationID
-             << ", Distance: " << distance << " km" << endl;
+        OutputSink out(cout);
+        display(out);
+    }
+
+    void display(OutputSink &out) const
+    {
+        out << "Route ID: " << routeID
+            << ", From: " << startStationID
+            << ", To: " << endStationID
+            << ", Distance: " << distance << " km\n";
+    }
+
+    // Same line with station names instead of IDs
+    void displayWithNames(OutputSink &out, const string &startName, const string &endName) const
+    {
+        out << "Route ID: " << routeID
+            << ", From: " << startName
+            << ", To: " << endName
+            << ", Distance: " << distance << " km\n";
     }
 
     // Operator overloading for comparisons
@@ -2,6 +2,7 @@
 #define STATION_H
 
 #include <iostream>
+#include "../ds/output_sink.h"
 using namespace std;
 
 class Station
@@ -40,10 +41,16 @@ public:
     // Display station info
     void display() const
     {
-        cout << "Station ID: " << stationID
-             << ", Name: " << name
-             << ", Location: " << location
-             << ", Passengers: " << passengersCount << endl;
+        OutputSink out(cout);
+        display(out);
+    }
+
+    void display(OutputSink &out) const
+    {
+        out << "Station ID: " << stationID
+            << ", Name: " << name
+            << ", Location: " << location
+            << ", Passengers: " << passengersCount << '\n';
     }
 
     // Comparison operator
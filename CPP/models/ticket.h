@@ -4,6 +4,7 @@
 #include <iostream>
 #include "passenger.h"
 #include "route.h"
+#include "timestamp.h"
 
 using namespace std;
 
@@ -12,43 +13,57 @@ class Ticket
 private:
     int ticketID;
     Passenger passenger;
-    string issueDate;
+    Timestamp issueTime; // seconds since epoch (UTC), captured at issue
     int startStationID;
     int endStationID;
 
 public:
-    Ticket() : ticketID(0), passenger(Passenger(0, "", 0)), issueDate(""), startStationID(0), endStationID(0) {}
-    // Constructor
-    Ticket(int _id, Passenger _p, int _start = 0, int _end = 0)
-        : ticketID(_id), passenger(_p), issueDate("2025-12-22"),
+    Ticket() : ticketID(0), passenger(Passenger(0, "", 0)), issueTime(0), startStationID(0), endStationID(0) {}
+    // Constructor (issue time defaults to now)
+    Ticket(int _id, const Passenger &_p, int _start = 0, int _end = 0, Timestamp _issueTime = -1)
+        : ticketID(_id), passenger(_p), issueTime(_issueTime < 0 ? currentTimestamp() : _issueTime),
           startStationID(_start), endStationID(_end) {}
 
     // Getters
     int getTicketID() const { return ticketID; }
     Passenger getPassenger() const { return passenger; }
-    string getIssueDate() const { return issueDate; }
+    const Passenger &getPassengerRef() const { return passenger; }
+    Timestamp getIssueTime() const { return issueTime; }
+    string getIssueDate() const { return formatDate(issueTime); }
     int getStartStationID() const { return startStationID; }
     int getEndStationID() const { return endStationID; }
 
     // Display ticket info (with station label provider if available)
     void display() const
     {
-        cout << "Ticket ID: " << ticketID << " | ";
-        passenger.display();
+        OutputSink out(cout);
+        display(out);
+    }
+
+    void display(OutputSink &out) const
+    {
+        out << "Ticket ID: " << ticketID << " | ";
+        passenger.display(out);
         if (startStationID > 0 && endStationID > 0)
         {
-            cout << "    Route: Station " << startStationID << " -> Station " << endStationID << endl;
+            out << "    Route: Station " << startStationID << " -> Station " << endStationID << '\n';
         }
     }
 
     // Display with station names
     void displayWithNames(const string &startName, const string &endName) const
     {
-        cout << "Ticket ID: " << ticketID << " | ";
-        passenger.display();
+        OutputSink out(cout);
+        displayWithNames(out, startName, endName);
+    }
+
+    void displayWithNames(OutputSink &out, const string &startName, const string &endName) const
+    {
+        out << "Ticket ID: " << ticketID << " | ";
+        passenger.display(out);
         if (startStationID > 0 && endStationID > 0)
         {
-            cout << "    Route: " << startName << " -> " << endName << endl;
+            out << "    Route: " << startName << " -> " << endName << '\n';
         }
     }
 
@@ -0,0 +1,110 @@
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <iostream>
+#include <string>
+#include <ctime>
+#include <cstdio>
+using namespace std;
+
+// 64-bit timestamp: seconds since 1970-01-01 00:00:00 UTC
+typedef long long Timestamp;
+
+#define SECONDS_PER_MINUTE 60LL
+#define SECONDS_PER_HOUR 3600LL
+#define SECONDS_PER_DAY 86400LL
+#define SECONDS_PER_WEEK 604800LL
+
+// Current wall-clock time
+inline Timestamp currentTimestamp()
+{
+    return (Timestamp)time(nullptr);
+}
+
+// Floor division that rounds towards -infinity (pre-1970 timestamps)
+inline long long floorDiv(long long a, long long b)
+{
+    long long q = a / b;
+    if ((a % b != 0) && ((a < 0) != (b < 0)))
+        q--;
+    return q;
+}
+
+// Days since epoch -> civil date (proleptic Gregorian, UTC)
+inline void civilFromDays(long long days, int &year, int &month, int &day)
+{
+    days += 719468;
+    long long era = floorDiv(days, 146097);
+    long long doe = days - era * 146097; // [0, 146096]
+    long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365; // [0, 399]
+    long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100); // [0, 365]
+    long long mp = (5 * doy + 2) / 153; // [0, 11]
+    day = (int)(doy - (153 * mp + 2) / 5 + 1);
+    month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    year = (int)(yoe + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+// Civil date -> days since epoch
+inline long long daysFromCivil(int year, int month, int day)
+{
+    long long y = year - (month <= 2 ? 1 : 0);
+    long long era = floorDiv(y, 400);
+    long long yoe = y - era * 400;
+    long long mp = month > 2 ? month - 3 : month + 9;
+    long long doy = (153 * mp + 2) / 5 + day - 1;
+    long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// Build a timestamp from a UTC calendar date and time
+inline Timestamp makeTimestamp(int year, int month, int day, int hour = 0, int minute = 0, int second = 0)
+{
+    return daysFromCivil(year, month, day) * SECONDS_PER_DAY +
+           hour * SECONDS_PER_HOUR + minute * SECONDS_PER_MINUTE + second;
+}
+
+inline string twoDigits(int v)
+{
+    string s = to_string(v);
+    return v < 10 ? "0" + s : s;
+}
+
+// "YYYY-MM-DD"
+inline string formatDate(Timestamp ts)
+{
+    int y, m, d;
+    civilFromDays(floorDiv(ts, SECONDS_PER_DAY), y, m, d);
+    return to_string(y) + "-" + twoDigits(m) + "-" + twoDigits(d);
+}
+
+// "YYYY-MM-DD HH:MM"
+inline string formatDateTime(Timestamp ts)
+{
+    long long secs = ts - floorDiv(ts, SECONDS_PER_DAY) * SECONDS_PER_DAY;
+    return formatDate(ts) + " " + twoDigits((int)(secs / SECONDS_PER_HOUR)) + ":" +
+           twoDigits((int)(secs % SECONDS_PER_HOUR / SECONDS_PER_MINUTE));
+}
+
+// Parse "YYYY-MM-DD", "YYYY-MM-DD HH:MM" or "YYYY-MM-DDTHH:MM" (UTC);
+// false if the text is not one of these
+inline bool parseDateTime(const string &text, Timestamp &ts)
+{
+    int year, month, day, hour = 0, minute = 0, used = 0;
+    const char *s = text.c_str();
+    if (sscanf(s, "%4d-%2d-%2d%n", &year, &month, &day, &used) != 3 || used != 10)
+        return false;
+    if (s[used] == ' ' || s[used] == 'T')
+    {
+        int more = 0;
+        if (sscanf(s + used + 1, "%2d:%2d%n", &hour, &minute, &more) != 2 || more != 5)
+            return false;
+        used += 1 + more;
+    }
+    if (s[used] != '\0' || month < 1 || month > 12 || day < 1 || day > 31 || hour < 0 || hour > 23 ||
+        minute < 0 || minute > 59)
+        return false;
+    ts = makeTimestamp(year, month, day, hour, minute);
+    return true;
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define VEHICLE_H
 
 #include <iostream>
+#include "../ds/output_sink.h"
 using namespace std;
 
 class Vehicle
@@ -29,9 +30,15 @@ public:
     // Display vehicle info
     void display() const
     {
-        cout << "Vehicle ID: " << vehicleID
-             << ", Name: " << name
-             << ", Capacity: " << capacity << endl;
+        OutputSink out(cout);
+        display(out);
+    }
+
+    void display(OutputSink &out) const
+    {
+        out << "Vehicle ID: " << vehicleID
+            << ", Name: " << name
+            << ", Capacity: " << capacity << '\n';
     }
 
     // Operator overloading for comparisons
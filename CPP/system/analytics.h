@@ -5,10 +5,20 @@
 #include "../ds/array.h"
 #include "../ds/pair.h"
 #include "../ds/heap.h"
+#include "../ds/hashtable.h"
+#include "../ds/id_index.h"
+#include "../ds/metrics.h"
+#include "../ds/graph.h"
+#include "../ds/thread_pool.h"
+#include "../ds/output_sink.h"
 #include "../models/station.h"
 #include "../models/route.h"
 #include "../models/vehicle.h"
 #include "../models/ticket.h"
+#include "ticket_store.h"
+#include "od_matrix.h"
+#include "load_assignment.h"
+#include "time_buckets.h"
 using namespace std;
 
 // Define INT_MAX replacement to avoid <limits>
@@ -16,12 +26,69 @@ using namespace std;
 #define INT_MAX_VALUE 2147483647
 #endif
 
+// Tickets per parallel chunk: smaller scans stay on the calling thread
+#define ANALYTICS_PARALLEL_GRAIN 65536
+
 class Analytics
 {
+private:
+    // Directed (start, end) pair as one hash key
+    static long long stationPairKey(int startID, int endID)
+    {
+        return ((long long)startID << 32) | (unsigned int)endID;
+    }
+
+    // parallelReduce body of busiestRoute: tickets per route for [lo, hi)
+    struct RouteTicketCounts
+    {
+        const HashTable<long long, int> *routeIndex;
+        const int *starts;
+        const int *ends;
+
+        void operator()(int lo, int hi, DynamicArray<int> &counts) const
+        {
+            for (int i = lo; i < hi; i++)
+            {
+                const int *idx = routeIndex->find(stationPairKey(starts[i], ends[i]));
+                if (idx)
+                    counts[*idx]++;
+            }
+        }
+    };
+
+    // parallelReduce body of stationTicketCounts: counts[2 * slot] are
+    // departures and counts[2 * slot + 1] arrivals of the station in slot
+    struct StationTicketCounts
+    {
+        const IdIndex *slots;
+        const int *starts;
+        const int *ends;
+
+        void operator()(int lo, int hi, DynamicArray<int> &counts) const
+        {
+            for (int i = lo; i < hi; i++)
+            {
+                int from = slots->find(starts[i]);
+                if (from >= 0)
+                    counts[2 * from]++;
+                int to = slots->find(ends[i]);
+                if (to >= 0)
+                    counts[2 * to + 1]++;
+            }
+        }
+    };
+
+    static void addCounts(DynamicArray<int> &into, const DynamicArray<int> &from)
+    {
+        for (int i = 0; i < into.size(); i++)
+            into[i] += from[i];
+    }
+
 public:
     // Find the station with the most passengers
     static Station mostCrowdedStation(const DynamicArray<Station> &stations)
     {
+        METRIC_TIMER("itnms_analytics_seconds{query=\"most_crowded_station\"}", "Analytics query latency");
         if (stations.size() == 0)
         {
             cerr << "Error: No stations available" << endl;
@@ -37,70 +104,119 @@ public:
         return stations[maxIdx];
     }
 
-    // Busiest route based on ticket counts (start->end frequency)
-    static void busiestRouteByTickets(const DynamicArray<Route> &routes,
-                                      const DynamicArray<Ticket> &tickets,
-                                      string (*getStationName)(int))
+    // Departures and arrivals per station as data: departures[i] and
+    // arrivals[i] count the tickets starting and ending at stations[i].
+    // O(S + T): ticket ranges are counted on the pool into per-chunk
+    // slot-indexed counters and summed, so the result does not depend on
+    // the thread count. Stations sharing an ID all get that ID's counts.
+    static void stationTicketCounts(const DynamicArray<Station> &stations, const TicketStore &tickets,
+                                    DynamicArray<int> &departures, DynamicArray<int> &arrivals,
+                                    ThreadPool &pool = ThreadPool::shared())
     {
-        if (routes.size() == 0)
+        IdIndex slots;
+        slots.reserve(stations.size());
+        DynamicArray<int> counts(2 * stations.size() + 1);
+        for (int i = 0; i < stations.size(); i++)
         {
-            cout << "No routes available." << endl;
-            return;
+            if (!slots.contains(stations[i].getID()))
+                slots.insert(stations[i].getID(), i);
+            counts.push_back(0);
+            counts.push_back(0);
         }
-        if (tickets.size() == 0)
+
+        StationTicketCounts body;
+        body.slots = &slots;
+        body.starts = tickets.startStationColumn().getRawArray();
+        body.ends = tickets.endStationColumn().getRawArray();
+        counts = parallelReduce(pool, 0, tickets.size(), ANALYTICS_PARALLEL_GRAIN, counts, body, addCounts);
+
+        departures.clear();
+        arrivals.clear();
+        departures.reserve(stations.size());
+        arrivals.reserve(stations.size());
+        for (int i = 0; i < stations.size(); i++)
         {
-            cout << "No tickets issued yet. Cannot determine busiest route." << endl;
-            return;
+            int slot = slots.find(stations[i].getID());
+            departures.push_back(counts[2 * slot]);
+            arrivals.push_back(counts[2 * slot + 1]);
         }
+    }
 
-        // Store route keys and counts
-        DynamicArray<Pair<int, int>> routeKeys; // {startID, endID}
-        DynamicArray<int> routeCounts;
+    // Busiest route as data: index of the route whose (start, end) pair has
+    // the most tickets, or -1 if no ticket matches a route. O(R + T): routes
+    // are keyed by their packed station pair; the first of duplicates wins.
+    static int busiestRoute(const DynamicArray<Route> &routes, const TicketStore &tickets, int &ticketCount,
+                            ThreadPool &pool = ThreadPool::shared())
+    {
+        METRIC_TIMER("itnms_analytics_seconds{query=\"busiest_route\"}", "Analytics query latency");
+        ticketCount = 0;
+        if (routes.size() == 0 || tickets.size() == 0)
+            return -1;
 
+        HashTable<long long, int> routeIndex(routes.size());
+        DynamicArray<int> routeCounts(routes.size());
         for (int i = 0; i < routes.size(); i++)
         {
-            routeKeys.push_back(Pair<int, int>(routes[i].getStartStationID(), routes[i].getEndStationID()));
+            long long key = stationPairKey(routes[i].getStartStationID(), routes[i].getEndStationID());
+            if (!routeIndex.contains(key))
+                routeIndex.insert(key, i);
             routeCounts.push_back(0);
         }
 
-        for (int i = 0; i < tickets.size(); i++)
-        {
-            int startID = tickets[i].getStartStationID();
-            int endID = tickets[i].getEndStationID();
-            for (int j = 0; j < routeKeys.size(); j++)
-            {
-                if (routeKeys[j].first == startID && routeKeys[j].second == endID)
-                {
-                    routeCounts[j]++;
-                    break;
-                }
-            }
-        }
+        // Only the start/end columns are read; ticket ranges are counted in
+        // parallel and the per-chunk counts summed
+        RouteTicketCounts body;
+        body.routeIndex = &routeIndex;
+        body.starts = tickets.startStationColumn().getRawArray();
+        body.ends = tickets.endStationColumn().getRawArray();
+        routeCounts = parallelReduce(pool, 0, tickets.size(), ANALYTICS_PARALLEL_GRAIN, routeCounts,
+                                     body, addCounts);
 
-        int maxCount = 0;
         int busiestIdx = -1;
         for (int i = 0; i < routeCounts.size(); i++)
         {
-            if (routeCounts[i] > maxCount)
+            if (routeCounts[i] > ticketCount)
             {
-                maxCount = routeCounts[i];
+                ticketCount = routeCounts[i];
                 busiestIdx = i;
             }
         }
+        return busiestIdx;
+    }
 
+    // Busiest route based on ticket counts (start->end frequency)
+    static void busiestRouteByTickets(const DynamicArray<Route> &routes,
+                                      const TicketStore &tickets,
+                                      const GraphLabels &getStationName)
+    {
+        METRIC_TIMER("itnms_analytics_seconds{query=\"busiest_route_report\"}", "Analytics query latency");
+        if (routes.size() == 0)
+        {
+            cout << "No routes available." << endl;
+            return;
+        }
+        if (tickets.size() == 0)
+        {
+            cout << "No tickets issued yet. Cannot determine busiest route." << endl;
+            return;
+        }
+
+        int maxCount = 0;
+        int busiestIdx = busiestRoute(routes, tickets, maxCount);
         if (busiestIdx == -1)
         {
             cout << "No route activity recorded." << endl;
             return;
         }
 
-        cout << "Busiest Route: " << getStationName(routeKeys[busiestIdx].first) << " -> " << getStationName(routeKeys[busiestIdx].second)
-             << " | Tickets: " << maxCount << endl;
+        cout << "Busiest Route: " << getStationName(routes[busiestIdx].getStartStationID()) << " -> "
+             << getStationName(routes[busiestIdx].getEndStationID()) << " | Tickets: " << maxCount << endl;
     }
 
     // Fastest vehicle assignment: choose smallest-capacity vehicle that fits requirement
     static void fastestVehicleAssignment(const DynamicArray<Vehicle> &vehicles, int requiredPassengers)
     {
+        METRIC_TIMER("itnms_analytics_seconds{query=\"fastest_vehicle\"}", "Analytics query latency");
         if (vehicles.size() == 0)
         {
             cout << "No vehicles available." << endl;
@@ -139,36 +255,27 @@ public:
 
     // Traffic density prediction using ticket activity (rank stations)
     static void trafficDensityPrediction(const DynamicArray<Station> &stations,
-                                         const DynamicArray<Ticket> &tickets,
-                                         string (*getStationName)(int),
+                                         const TicketStore &tickets,
+                                         const GraphLabels &getStationName,
                                          int topN = 5)
     {
+        METRIC_TIMER("itnms_analytics_seconds{query=\"traffic_density\"}", "Analytics query latency");
         if (stations.size() == 0)
         {
             cout << "No stations available." << endl;
             return;
         }
 
-        // Count activity per station
+        // Activity per station: departures + arrivals
         DynamicArray<int> stationIDs;
         DynamicArray<int> activity;
+        DynamicArray<int> departures;
+        DynamicArray<int> arrivals;
+        stationTicketCounts(stations, tickets, departures, arrivals);
         for (int i = 0; i < stations.size(); i++)
         {
             stationIDs.push_back(stations[i].getID());
-            activity.push_back(0);
-        }
-
-        for (int i = 0; i < tickets.size(); i++)
-        {
-            int startID = tickets[i].getStartStationID();
-            int endID = tickets[i].getEndStationID();
-            for (int j = 0; j < stationIDs.size(); j++)
-            {
-                if (stationIDs[j] == startID)
-                    activity[j]++;
-                if (stationIDs[j] == endID)
-                    activity[j]++;
-            }
+            activity.push_back(departures[i] + arrivals[i]);
         }
 
         // Sort by activity (simple selection sort for top N)
@@ -192,70 +299,108 @@ public:
         }
     }
 
-    // Daily usage trends
-    static void dailyUsageTrends(const DynamicArray<Ticket> &tickets)
+    // Top origin-destination pairs of all trips (multi-hop trips included),
+    // with each origin's departures and each destination's arrivals
+    static void topOriginDestinationPairs(const OdMatrix &od, int topN, const GraphLabels &getStationName)
     {
-        if (tickets.size() == 0)
+        METRIC_TIMER("itnms_analytics_seconds{query=\"top_od_pairs\"}", "Analytics query latency");
+        if (od.totalTrips() == 0)
         {
-            cout << "No tickets issued yet." << endl;
+            cout << "No trips recorded yet." << endl;
             return;
         }
 
-        // Count tickets per date
-        DynamicArray<string> dates;
-        DynamicArray<int> counts;
+        DynamicArray<OdPair> pairs;
+        od.topPairs(topN, pairs);
+        OutputSink out(cout);
+        out << "Top " << pairs.size() << " origin-destination pairs (" << od.totalTrips() << " trips, "
+            << od.pairCount() << " pairs):\n";
+        for (int i = 0; i < pairs.size(); i++)
+        {
+            const OdPair &p = pairs[i];
+            out << i + 1 << ". " << getStationName(p.origin) << " -> " << getStationName(p.destination)
+                << " | Trips: " << p.trips << " (of " << od.departuresFrom(p.origin) << " departures, "
+                << od.arrivalsAt(p.destination) << " arrivals)\n";
+        }
+    }
 
-        for (int i = 0; i < tickets.size(); i++)
+    // Routes carrying the most passengers when every trip rides its
+    // shortest path; loads come heaviest first (RouteManager::routeLoads)
+    static void heaviestRoutes(const DynamicArray<RouteLoad> &loads, int topN, long long routedTrips,
+                               long long unroutedTrips, const GraphLabels &getStationName)
+    {
+        METRIC_TIMER("itnms_analytics_seconds{query=\"route_loads\"}", "Analytics query latency");
+        if (routedTrips + unroutedTrips == 0)
         {
-            string date = tickets[i].getIssueDate();
-            int found = -1;
-            for (int j = 0; j < dates.size(); j++)
-            {
-                if (dates[j] == date)
-                {
-                    found = j;
-                    break;
-                }
-            }
-            if (found == -1)
-            {
-                dates.push_back(date);
-                counts.push_back(1);
-            }
-            else
-            {
-                counts[found]++;
-            }
+            cout << "No trips recorded yet." << endl;
+            return;
         }
 
-        // Simple sort by date string (lexicographic)
-        for (int i = 0; i < dates.size() - 1; i++)
+        int shown = topN < loads.size() ? topN : loads.size();
+        OutputSink out(cout);
+        out << "Heaviest " << shown << " routes (" << routedTrips << " trips on shortest paths";
+        if (unroutedTrips > 0)
+            out << ", " << unroutedTrips << " without a path";
+        out << "):\n";
+        for (int i = 0; i < shown; i++)
         {
-            for (int j = i + 1; j < dates.size(); j++)
-            {
-                if (dates[j] < dates[i])
-                {
-                    // Swap
-                    string tmpD = dates[i];
-                    dates[i] = dates[j];
-                    dates[j] = tmpD;
-                    int tmpC = counts[i];
-                    counts[i] = counts[j];
-                    counts[j] = tmpC;
-                }
-            }
+            const RouteLoad &r = loads[i];
+            out << i + 1 << ". " << getStationName(r.startStationID) << " <-> " << getStationName(r.endStationID)
+                << " (Route " << r.routeID << ") | Passengers: " << r.total() << " (" << r.forward << " forward, "
+                << r.backward << " back)\n";
+        }
+    }
+
+    // Usage trends bucketed by minute, hour, day or week.
+    // Reads the store's calendar index: O(buckets), not O(tickets).
+    static void usageTrends(const TicketStore &tickets, int granularity)
+    {
+        METRIC_TIMER("itnms_analytics_seconds{query=\"usage_trends\"}", "Analytics query latency");
+        if (tickets.size() == 0)
+        {
+            cout << "No tickets issued yet." << endl;
+            return;
         }
 
-        cout << "Daily Usage Trends (date -> tickets):\n";
-        for (int i = 0; i < dates.size(); i++)
+        const TimeBucketCounter &timeline = tickets.issueTimeline();
+        const char *label = "Weekly";
+        if (granularity == BUCKET_MINUTE)
+            label = "Per-Minute";
+        else if (granularity == BUCKET_HOUR)
+            label = "Hourly";
+        else if (granularity == BUCKET_DAY)
+            label = "Daily";
+        OutputSink out(cout);
+        out << label << " Usage Trends (period start -> tickets):\n";
+        long long last = timeline.lastBucketOf(granularity);
+        for (long long b = timeline.firstBucketOf(granularity); b <= last; b = timeline.nextBucket(granularity, b + 1))
         {
-            cout << dates[i] << " -> " << counts[i] << "\n";
+            int c = timeline.count(granularity, b);
+            if (c == 0)
+                continue;
+            Timestamp start = TimeBucketCounter::bucketStart(b, granularity);
+            out << (granularity <= BUCKET_HOUR ? formatDateTime(start) : formatDate(start)) << " -> " << c << '\n';
         }
     }
 
+    // Daily usage trends
+    static void dailyUsageTrends(const TicketStore &tickets)
+    {
+        METRIC_TIMER("itnms_analytics_seconds{query=\"daily_usage_trends\"}", "Analytics query latency");
+        usageTrends(tickets, BUCKET_DAY);
+    }
+
+    // Tickets issued in [from, to)
+    static long long ticketsInPeriod(const TicketStore &tickets, Timestamp from, Timestamp to)
+    {
+        METRIC_TIMER("itnms_analytics_seconds{query=\"tickets_in_period\"}", "Analytics query latency");
+        return tickets.issueTimeline().countRange(from, to);
+    }
+
     // Total passengers across all stations
     static int totalPassengers(const DynamicArray<Station> &stations)
     {
+        METRIC_TIMER("itnms_analytics_seconds{query=\"total_passengers\"}", "Analytics query latency");
         int total = 0;
         for (int i = 0; i < stations.size(); i++)
             total += stations[i].getPassengerCount();
@@ -264,9 +409,10 @@ public:
 
     // Find most crowded station based on ticket activity
     static void mostCrowdedStationByTickets(const DynamicArray<Station> &stations,
-                                            const DynamicArray<Ticket> &tickets,
-                                            string (*getStationName)(int))
+                                            const TicketStore &tickets,
+                                            const GraphLabels &getStationName)
     {
+        METRIC_TIMER("itnms_analytics_seconds{query=\"most_crowded_station_by_tickets\"}", "Analytics query latency");
         if (stations.size() == 0)
         {
             cout << "No stations available." << endl;
@@ -279,37 +425,24 @@ public:
             return;
         }
 
-        // Count departures and arrivals per station
-        DynamicArray<int> stationIDs;
-        DynamicArray<int> stationActivity;
-        for (int i = 0; i < stations.size(); i++)
-        {
-            stationIDs.push_back(stations[i].getID());
-            stationActivity.push_back(0);
-        }
-
-        for (int i = 0; i < tickets.size(); i++)
-        {
-            int startID = tickets[i].getStartStationID();
-            int endID = tickets[i].getEndStationID();
-            for (int j = 0; j < stationIDs.size(); j++)
-            {
-                if (startID > 0 && stationIDs[j] == startID)
-                    stationActivity[j]++;
-                if (endID > 0 && stationIDs[j] == endID)
-                    stationActivity[j]++;
-            }
-        }
+        // Departures and arrivals per station (tickets without a station
+        // carry ID 0 and are not counted)
+        DynamicArray<int> departures;
+        DynamicArray<int> arrivals;
+        stationTicketCounts(stations, tickets, departures, arrivals);
 
         // Find station with max activity
         int maxActivity = 0;
         int busiestStationID = -1;
-        for (int i = 0; i < stationActivity.size(); i++)
+        int busiestSlot = -1;
+        for (int i = 0; i < stations.size(); i++)
         {
-            if (stationActivity[i] > maxActivity)
+            int activity = stations[i].getID() > 0 ? departures[i] + arrivals[i] : 0;
+            if (activity > maxActivity)
             {
-                maxActivity = stationActivity[i];
-                busiestStationID = stationIDs[i];
+                maxActivity = activity;
+                busiestStationID = stations[i].getID();
+                busiestSlot = i;
             }
         }
 
@@ -325,16 +458,8 @@ public:
         cout << "Total Activity: " << maxActivity << " (departures + arrivals)\n";
 
         // Breakdown
-        int departures = 0, arrivals = 0;
-        for (int i = 0; i < tickets.size(); i++)
-        {
-            if (tickets[i].getStartStationID() == busiestStationID)
-                departures++;
-            if (tickets[i].getEndStationID() == busiestStationID)
-                arrivals++;
-        }
-        cout << "  - Departures: " << departures << "\n";
-        cout << "  - Arrivals: " << arrivals << "\n";
+        cout << "  - Departures: " << departures[busiestSlot] << "\n";
+        cout << "  - Arrivals: " << arrivals[busiestSlot] << "\n";
         cout << "================================\n"
              << endl;
     }
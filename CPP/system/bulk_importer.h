@@ -0,0 +1,273 @@
+#ifndef BULK_IMPORTER_H
+#define BULK_IMPORTER_H
+
+#include <iostream>
+#include <string>
+#include "../ds/array.h"
+#include "../ds/id_index.h"
+#include "../ds/csv_reader.h"
+#include "../models/station.h"
+#include "../models/route.h"
+#include "../models/vehicle.h"
+#include "route_manager.h"
+#include "vehicle_manager.h"
+
+using namespace std;
+
+// Counts from one import
+struct ImportReport
+{
+    int stationsRead, stationsAdded;
+    int routesRead, routesAdded;
+    int vehiclesRead, vehiclesAdded;
+    int errors;
+
+    ImportReport()
+        : stationsRead(0), stationsAdded(0), routesRead(0), routesAdded(0), vehiclesRead(0),
+          vehiclesAdded(0), errors(0) {}
+};
+
+// Bulk CSV import of stations, routes and vehicles
+//
+//   stations.csv  id,name,location
+//   routes.csv    id,start_station_id,end_station_id,distance
+//   vehicles.csv  id,name,capacity
+//
+// A header line is optional. Files are streamed through CsvReader; rows
+// are only parsed and collected while reading. commit() then checks every
+// row at once (unique positive IDs, route endpoints among the existing or
+// imported stations, positive capacity, Route::validDistance), skips and
+// reports bad rows, and hands the rest to RouteManager/VehicleManager::
+// addBulk, which build the arrays, hash tables and graph in one pre-sized
+// pass.
+class BulkImporter
+{
+private:
+    RouteManager &routeManager;
+    VehicleManager &vehicleManager;
+
+    DynamicArray<Station> stations;
+    DynamicArray<Route> routes;
+    DynamicArray<Vehicle> vehicles;
+    DynamicArray<int> stationLines; // source line of each row, for messages
+    DynamicArray<int> routeLines;
+    DynamicArray<int> vehicleLines;
+    string stationsFile, routesFile, vehiclesFile;
+
+    ImportReport report;
+    int maxMessages;
+
+    void error(const string &file, long long line, const string &message)
+    {
+        report.errors++;
+        if (report.errors <= maxMessages)
+            cout << "ERROR: " << file << ":" << line << ": " << message << endl;
+        else if (report.errors == maxMessages + 1)
+            cout << "ERROR: further errors not shown" << endl;
+    }
+
+    // Line 1 with a non-numeric ID is taken as a header
+    static bool isHeader(const CsvReader &csv)
+    {
+        int id;
+        return csv.lineNumber() == 1 && !csv.getInt(0, id);
+    }
+
+    bool openFile(CsvReader &csv, const string &path)
+    {
+        if (csv.open(path))
+            return true;
+        cout << "ERROR: Cannot open " << path << endl;
+        return false;
+    }
+
+public:
+    BulkImporter(RouteManager &routes, VehicleManager &vehicles, int maxErrorMessages = 10)
+        : routeManager(routes), vehicleManager(vehicles), stations(1024), routes(1024), vehicles(64),
+          stationLines(1024), routeLines(1024), vehicleLines(64), maxMessages(maxErrorMessages) {}
+
+    bool readStations(const string &path)
+    {
+        CsvReader csv;
+        if (!openFile(csv, path))
+            return false;
+        stationsFile = path;
+        while (csv.next())
+        {
+            if (isHeader(csv))
+                continue;
+            report.stationsRead++;
+            int id;
+            if (csv.fieldCount() < 2 || !csv.getInt(0, id))
+            {
+                error(path, csv.lineNumber(), "expected id,name[,location]");
+                continue;
+            }
+            stations.push_back(Station(id, csv.getString(1), csv.getString(2)));
+            stationLines.push_back((int)csv.lineNumber());
+        }
+        return true;
+    }
+
+    bool readRoutes(const string &path)
+    {
+        CsvReader csv;
+        if (!openFile(csv, path))
+            return false;
+        routesFile = path;
+        while (csv.next())
+        {
+            if (isHeader(csv))
+                continue;
+            report.routesRead++;
+            int id, start, end;
+            double distance;
+            if (csv.fieldCount() < 4 || !csv.getInt(0, id) || !csv.getInt(1, start) || !csv.getInt(2, end) ||
+                !csv.getDouble(3, distance))
+            {
+                error(path, csv.lineNumber(), "expected id,start_station_id,end_station_id,distance");
+                continue;
+            }
+            routes.push_back(Route(id, start, end, distance));
+            routeLines.push_back((int)csv.lineNumber());
+        }
+        return true;
+    }
+
+    bool readVehicles(const string &path)
+    {
+        CsvReader csv;
+        if (!openFile(csv, path))
+            return false;
+        vehiclesFile = path;
+        while (csv.next())
+        {
+            if (isHeader(csv))
+                continue;
+            report.vehiclesRead++;
+            int id, capacity;
+            if (csv.fieldCount() < 3 || !csv.getInt(0, id) || !csv.getInt(2, capacity))
+            {
+                error(path, csv.lineNumber(), "expected id,name,capacity");
+                continue;
+            }
+            vehicles.push_back(Vehicle(id, csv.getString(1), capacity));
+            vehicleLines.push_back((int)csv.lineNumber());
+        }
+        return true;
+    }
+
+    // Validate everything read so far and add the valid rows
+    ImportReport commit()
+    {
+        // Stations: positive, unique in the file and not already present
+        IdIndex newStationIDs;
+        newStationIDs.reserve(stations.size());
+        DynamicArray<Station> goodStations(stations.size() + 1);
+        for (int i = 0; i < stations.size(); i++)
+        {
+            int id = stations[i].getID();
+            if (id <= 0)
+                error(stationsFile, stationLines[i], "station ID must be positive");
+            else if (stations[i].getName().empty())
+                error(stationsFile, stationLines[i], "station name is empty");
+            else if (routeManager.stationExists(id) || newStationIDs.contains(id))
+                error(stationsFile, stationLines[i], "duplicate station ID " + to_string(id));
+            else
+            {
+                newStationIDs.insert(id, goodStations.size());
+                goodStations.push_back(stations[i]);
+            }
+        }
+
+        // Routes: both endpoints among existing or accepted new stations
+        IdIndex newRouteIDs;
+        newRouteIDs.reserve(routes.size());
+        DynamicArray<Route> goodRoutes(routes.size() + 1);
+        for (int i = 0; i < routes.size(); i++)
+        {
+            const Route &r = routes[i];
+            int start = r.getStartStationID();
+            int end = r.getEndStationID();
+            if (r.getRouteID() <= 0)
+                error(routesFile, routeLines[i], "route ID must be positive");
+            else if (!Route::validDistance(r.getDistance()))
+                error(routesFile, routeLines[i], Route::distanceRule());
+            else if (start == end)
+                error(routesFile, routeLines[i], "start and end stations are the same");
+            else if (!newStationIDs.contains(start) && !routeManager.stationExists(start))
+                error(routesFile, routeLines[i], "start station " + to_string(start) + " not found");
+            else if (!newStationIDs.contains(end) && !routeManager.stationExists(end))
+                error(routesFile, routeLines[i], "end station " + to_string(end) + " not found");
+            else if (routeManager.routeExists(r.getRouteID()) || newRouteIDs.contains(r.getRouteID()))
+                error(routesFile, routeLines[i], "duplicate route ID " + to_string(r.getRouteID()));
+            else
+            {
+                newRouteIDs.insert(r.getRouteID(), goodRoutes.size());
+                goodRoutes.push_back(r);
+            }
+        }
+
+        IdIndex newVehicleIDs;
+        newVehicleIDs.reserve(vehicles.size());
+        DynamicArray<Vehicle> goodVehicles(vehicles.size() + 1);
+        for (int i = 0; i < vehicles.size(); i++)
+        {
+            int id = vehicles[i].getID();
+            if (id <= 0)
+                error(vehiclesFile, vehicleLines[i], "vehicle ID must be positive");
+            else if (vehicles[i].getCapacity() <= 0)
+                error(vehiclesFile, vehicleLines[i], "vehicle capacity must be greater than 0");
+            else if (vehicleManager.vehicleExists(id) || newVehicleIDs.contains(id))
+                error(vehiclesFile, vehicleLines[i], "duplicate vehicle ID " + to_string(id));
+            else
+            {
+                newVehicleIDs.insert(id, goodVehicles.size());
+                goodVehicles.push_back(vehicles[i]);
+            }
+        }
+
+        // addBulk keeps only what it could log; the rest count as errors
+        int stationsBefore = routeManager.getStations().size();
+        int routesBefore = routeManager.getRoutes().size();
+        int vehiclesBefore = vehicleManager.totalVehicles();
+        bool networkStored = routeManager.addBulk(goodStations, goodRoutes);
+        bool vehiclesStored = vehicleManager.addBulk(goodVehicles);
+        int stationsAdded = routeManager.getStations().size() - stationsBefore;
+        int routesAdded = routeManager.getRoutes().size() - routesBefore;
+        int vehiclesAdded = vehicleManager.totalVehicles() - vehiclesBefore;
+        if (!networkStored)
+            report.errors += goodStations.size() - stationsAdded + goodRoutes.size() - routesAdded;
+        if (!vehiclesStored)
+            report.errors += goodVehicles.size() - vehiclesAdded;
+        report.stationsAdded += stationsAdded;
+        report.routesAdded += routesAdded;
+        report.vehiclesAdded += vehiclesAdded;
+
+        stations.clear();
+        routes.clear();
+        vehicles.clear();
+        stationLines.clear();
+        routeLines.clear();
+        vehicleLines.clear();
+        return report;
+    }
+
+    // Import whichever of the three files are given (empty path = skip)
+    static bool importFiles(const string &stationsPath, const string &routesPath, const string &vehiclesPath,
+                            RouteManager &routes, VehicleManager &vehicles, ImportReport &result)
+    {
+        BulkImporter importer(routes, vehicles);
+        bool ok = true;
+        if (!stationsPath.empty())
+            ok = importer.readStations(stationsPath) && ok;
+        if (!routesPath.empty())
+            ok = importer.readRoutes(routesPath) && ok;
+        if (!vehiclesPath.empty())
+            ok = importer.readVehicles(vehiclesPath) && ok;
+        result = importer.commit();
+        return ok;
+    }
+};
+
+#endif
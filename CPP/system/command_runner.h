@@ -0,0 +1,925 @@
+#ifndef COMMAND_RUNNER_H
+#define COMMAND_RUNNER_H
+
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <cerrno>
+#include <cmath>
+#include <chrono>
+#include "../ds/array.h"
+#include "../ds/metrics.h"
+#include "../ds/memory_tracker.h"
+#include "../ds/output_sink.h"
+#include "../models/station.h"
+#include "../models/route.h"
+#include "../models/vehicle.h"
+#include "../models/passenger.h"
+#include "route_manager.h"
+#include "vehicle_manager.h"
+#include "ticket_manager.h"
+#include "history_manager.h"
+#include "snapshot.h"
+#include "network_image.h"
+#include "network_generator.h"
+
+using namespace std;
+
+// Headless command-script mode: one command per line, one JSON object per
+// result line (JSON Lines), no menus, screen clears or pauses.
+//
+//   add-station 1 "Central Station" Downtown
+//   shortest-path 1 4
+//   -> {"line":2,"cmd":"shortest-path","ok":true,"distance":12,"path":[1,3,4]}
+//
+// Arguments are separated by blanks; "double quotes" group words (with \"
+// and \\ escapes) and '#' starts a comment. Stations may be given by ID or
+// by (quoted) name.
+// The managers' own console messages are captured while a command runs:
+// the first line of a failed command becomes its "error" field.
+class CommandRunner
+{
+private:
+    struct CommandSpec
+    {
+        const char *name;
+        int minArgs; // arguments after the command name
+        int maxArgs;
+        const char *usage;
+        bool (*handler)(CommandRunner &);
+    };
+
+    RouteManager &routes;
+    VehicleManager &vehicles;
+    TicketManager &tickets;
+    HistoryManager &history;
+    ostream &out;
+    bool stopOnError;
+
+    DynamicArray<string> args; // args[0] is the command name
+    ostringstream fields;      // extra result fields of the current command
+    ostringstream captured;    // console output of the managers
+    string error;              // why the current command failed
+    int commands;
+    int errors;
+
+    static const CommandSpec *commandTable(int &count)
+    {
+        static const CommandSpec table[] = {
+            {"add-station", 2, 3, "add-station <id> <name> [location]", &CommandRunner::cmdAddStation},
+            {"remove-station", 1, 1, "remove-station <id>", &CommandRunner::cmdRemoveStation},
+            {"add-route", 4, 4, "add-route <id> <start> <end> <distance>", &CommandRunner::cmdAddRoute},
+            {"remove-route", 1, 1, "remove-route <id>", &CommandRunner::cmdRemoveRoute},
+            {"add-vehicle", 3, 3, "add-vehicle <id> <name> <capacity>", &CommandRunner::cmdAddVehicle},
+            {"remove-vehicle", 1, 1, "remove-vehicle <id>", &CommandRunner::cmdRemoveVehicle},
+            {"add-passenger", 3, 3, "add-passenger <id> <name> <age>", &CommandRunner::cmdAddPassenger},
+            {"issue-ticket", 2, 2, "issue-ticket <start> <end>", &CommandRunner::cmdIssueTicket},
+            {"issue-tickets", 3, 3, "issue-tickets <count> <start> <end>", &CommandRunner::cmdIssueTickets},
+            {"shortest-path", 2, 2, "shortest-path <start> <end>", &CommandRunner::cmdShortestPath},
+            {"distance-matrix", 1, 1024, "distance-matrix <station>...", &CommandRunner::cmdDistanceMatrix},
+            {"busiest-route", 0, 0, "busiest-route", &CommandRunner::cmdBusiestRoute},
+            {"od-top", 1, 3, "od-top <k> [from to]", &CommandRunner::cmdOdTop},
+            {"od-pair", 2, 4, "od-pair <origin> <destination> [from to]", &CommandRunner::cmdOdPair},
+            {"od-station", 1, 3, "od-station <station> [from to]", &CommandRunner::cmdOdStation},
+            {"route-loads", 0, 1, "route-loads [k]", &CommandRunner::cmdRouteLoads},
+            {"find-station", 1, 1, "find-station <name>", &CommandRunner::cmdFindStation},
+            {"stats", 0, 0, "stats", &CommandRunner::cmdStats},
+            {"save", 1, 1, "save <snapshot file>", &CommandRunner::cmdSave},
+            {"load", 1, 1, "load <snapshot file>", &CommandRunner::cmdLoad},
+            {"image-save", 1, 1, "image-save <image file>", &CommandRunner::cmdImageSave},
+            {"image-load", 1, 1, "image-load <image file>", &CommandRunner::cmdImageLoad},
+            {"metrics", 1, 1, "metrics <file>", &CommandRunner::cmdMetrics},
+            {"memory", 0, 0, "memory", &CommandRunner::cmdMemory},
+            {"export", 2, 4, "export <stations|routes|vehicles|tickets> <file> [text|csv|json] [by-id|by-passenger|by-origin|by-destination]",
+             &CommandRunner::cmdExport},
+            {"generate", 2, 5, "generate <grid|radial|scale-free|geometric> <stations> [routes per station] [tickets] [seed]",
+             &CommandRunner::cmdGenerate},
+        };
+        count = sizeof(table) / sizeof(table[0]);
+        return table;
+    }
+
+    // Split a line into args; false on an unterminated quote
+    static bool tokenize(const string &line, DynamicArray<string> &tokens)
+    {
+        tokens.clear();
+        int i = 0, n = (int)line.size();
+        while (i < n)
+        {
+            char c = line[i];
+            if (c == ' ' || c == '\t' || c == '\r')
+            {
+                i++;
+                continue;
+            }
+            if (c == '#')
+                break;
+            if (c == '"')
+            {
+                // Quoted: \" and \\ are escapes, any other backslash is literal
+                string token;
+                for (i++; i < n && line[i] != '"'; i++)
+                {
+                    if (line[i] == '\\' && i + 1 < n && (line[i + 1] == '"' || line[i + 1] == '\\'))
+                        i++;
+                    token += line[i];
+                }
+                if (i >= n)
+                    return false;
+                tokens.push_back(token);
+                i++;
+                continue;
+            }
+            int start = i;
+            while (i < n && line[i] != ' ' && line[i] != '\t' && line[i] != '\r')
+                i++;
+            tokens.push_back(line.substr(start, i - start));
+        }
+        return true;
+    }
+
+    static string jsonEscape(const string &s)
+    {
+        string outStr;
+        outStr.reserve(s.size() + 2);
+        outStr += '"';
+        for (int i = 0; i < (int)s.size(); i++)
+        {
+            unsigned char c = (unsigned char)s[i];
+            if (c == '"' || c == '\\')
+            {
+                outStr += '\\';
+                outStr += (char)c;
+            }
+            else if (c == '\n')
+                outStr += "\\n";
+            else if (c == '\t')
+                outStr += "\\t";
+            else if (c < 0x20)
+            {
+                const char *hex = "0123456789abcdef";
+                outStr += "\\u00";
+                outStr += hex[c >> 4];
+                outStr += hex[c & 15];
+            }
+            else
+                outStr += (char)c;
+        }
+        outStr += '"';
+        return outStr;
+    }
+
+    bool parseInt(int argIndex, const char *what, int &value)
+    {
+        const string &s = args[argIndex];
+        char *end = nullptr;
+        errno = 0;
+        long v = strtol(s.c_str(), &end, 10);
+        if (s.empty() || *end != '\0' || errno != 0 || v < -2147483647L || v > 2147483647L)
+        {
+            error = string(what) + " must be an integer: " + s;
+            return false;
+        }
+        value = (int)v;
+        return true;
+    }
+
+    bool parseDouble(int argIndex, const char *what, double &value)
+    {
+        const string &s = args[argIndex];
+        char *end = nullptr;
+        value = strtod(s.c_str(), &end);
+        if (s.empty() || *end != '\0' || isnan(value) || isinf(value))
+        {
+            error = string(what) + " must be a finite number: " + s;
+            return false;
+        }
+        return true;
+    }
+
+    // Optional time window in args[first] and args[first + 1]; false (with
+    // error set) if only one bound is given or a bound does not parse
+    bool parseWindow(int first, bool &windowed, Timestamp &from, Timestamp &to)
+    {
+        windowed = args.size() > first;
+        if (!windowed)
+            return true;
+        if (args.size() != first + 2)
+        {
+            error = "a time window needs both from and to";
+            return false;
+        }
+        if (!parseDateTime(args[first], from) || !parseDateTime(args[first + 1], to))
+        {
+            error = "times must be YYYY-MM-DD or \"YYYY-MM-DD HH:MM\"";
+            return false;
+        }
+        return true;
+    }
+
+    // Station given by ID or by name
+    bool resolveStation(int argIndex, int &stationID)
+    {
+        const string &s = args[argIndex];
+        char *end = nullptr;
+        long v = strtol(s.c_str(), &end, 10);
+        if (!s.empty() && *end == '\0')
+            stationID = (int)v;
+        else
+            stationID = routes.findStationIdByName(s);
+        if (stationID <= 0 || !routes.stationExists(stationID))
+        {
+            error = "station not found: " + s;
+            return false;
+        }
+        return true;
+    }
+
+    // Both stations of a trip, which must differ
+    bool resolveTrip(int startArg, int &startID, int &endID)
+    {
+        if (!resolveStation(startArg, startID) || !resolveStation(startArg + 1, endID))
+            return false;
+        if (startID == endID)
+        {
+            error = "departure and arrival stations are the same";
+            return false;
+        }
+        return true;
+    }
+
+    // First captured console line, without its "ERROR: " prefix
+    string capturedError(const char *fallback) const
+    {
+        string text = captured.str();
+        int eol = (int)text.find('\n');
+        if (eol >= 0)
+            text = text.substr(0, eol);
+        if (text.compare(0, 7, "ERROR: ") == 0)
+            text = text.substr(7);
+        return text.empty() ? string(fallback) : text;
+    }
+
+    // Push an undo-history entry; false (error set) if it could not be logged
+    bool recordAction(const string &action)
+    {
+        if (history.addAction(action))
+            return true;
+        error = capturedError("action not recorded in history");
+        return false;
+    }
+
+    // ---- Commands: fill fields on success, error on failure ----
+
+    static bool cmdAddStation(CommandRunner &r)
+    {
+        int id;
+        if (!r.parseInt(1, "station id", id))
+            return false;
+        string location = r.args.size() > 3 ? r.args[3] : "";
+        if (!r.routes.addStation(Station(id, r.args[2], location)))
+        {
+            r.error = r.capturedError("station not added");
+            return false;
+        }
+        if (!r.recordAction("ADD_STATION:" + to_string(id) + ":" + r.args[2] + ":" + location))
+            return false;
+        r.fields << ",\"station\":" << id;
+        return true;
+    }
+
+    static bool cmdRemoveStation(CommandRunner &r)
+    {
+        int id;
+        if (!r.parseInt(1, "station id", id))
+            return false;
+        if (!r.routes.removeStation(id))
+        {
+            r.error = r.capturedError("station not removed");
+            return false;
+        }
+        if (!r.recordAction("DELETE_STATION:" + to_string(id)))
+            return false;
+        r.fields << ",\"station\":" << id;
+        return true;
+    }
+
+    static bool cmdAddRoute(CommandRunner &r)
+    {
+        int id, startID, endID;
+        double distance;
+        if (!r.parseInt(1, "route id", id) || !r.resolveTrip(2, startID, endID) ||
+            !r.parseDouble(4, "distance", distance))
+            return false;
+        if (id <= 0)
+        {
+            r.error = "route id must be positive";
+            return false;
+        }
+        if (!Route::validDistance(distance))
+        {
+            r.error = Route::distanceRule();
+            return false;
+        }
+        if (r.routes.routeExists(id))
+        {
+            r.error = "route with ID " + to_string(id) + " already exists";
+            return false;
+        }
+        if (!r.routes.addRoute(Route(id, startID, endID, distance)))
+        {
+            r.error = r.capturedError("route not added");
+            return false;
+        }
+        if (!r.recordAction("ADD_ROUTE:" + to_string(id) + ":" + to_string(startID) + ":" + to_string(endID) + ":" +
+                                to_string((int)distance)))
+            return false;
+        r.fields << ",\"route\":" << id << ",\"start\":" << startID << ",\"end\":" << endID;
+        return true;
+    }
+
+    static bool cmdRemoveRoute(CommandRunner &r)
+    {
+        int id;
+        if (!r.parseInt(1, "route id", id))
+            return false;
+        if (!r.routes.removeRouteById(id))
+        {
+            r.error = r.capturedError("route not removed");
+            return false;
+        }
+        if (!r.recordAction("DELETE_ROUTE:" + to_string(id)))
+            return false;
+        r.fields << ",\"route\":" << id;
+        return true;
+    }
+
+    static bool cmdAddVehicle(CommandRunner &r)
+    {
+        int id, capacity;
+        if (!r.parseInt(1, "vehicle id", id) || !r.parseInt(3, "capacity", capacity))
+            return false;
+        if (!r.vehicles.addVehicle(Vehicle(id, r.args[2], capacity)))
+        {
+            r.error = r.capturedError("vehicle not added");
+            return false;
+        }
+        if (!r.recordAction("ADD_VEHICLE:" + to_string(id) + ":" + r.args[2] + ":" + to_string(capacity)))
+            return false;
+        r.fields << ",\"vehicle\":" << id;
+        return true;
+    }
+
+    static bool cmdRemoveVehicle(CommandRunner &r)
+    {
+        int id;
+        if (!r.parseInt(1, "vehicle id", id))
+            return false;
+        if (!r.vehicles.vehicleExists(id))
+        {
+            r.error = "vehicle not found: ID " + to_string(id);
+            return false;
+        }
+        if (!r.vehicles.removeVehicle(id))
+        {
+            r.error = r.capturedError("vehicle not removed");
+            return false;
+        }
+        if (!r.recordAction("DELETE_VEHICLE:" + to_string(id)))
+            return false;
+        r.fields << ",\"vehicle\":" << id;
+        return true;
+    }
+
+    static bool cmdAddPassenger(CommandRunner &r)
+    {
+        int id, age;
+        if (!r.parseInt(1, "passenger id", id) || !r.parseInt(3, "age", age))
+            return false;
+        if (id <= 0 || age <= 0 || age > 150)
+        {
+            r.error = "passenger id must be positive and age between 1 and 150";
+            return false;
+        }
+        if (!r.tickets.addPassengerToQueue(Passenger(id, r.args[2], age)))
+        {
+            r.error = r.capturedError("passenger not queued");
+            return false;
+        }
+        if (!r.recordAction("ADD_PASSENGER:" + to_string(id) + ":" + r.args[2] + ":" + to_string(age)))
+            return false;
+        r.fields << ",\"passenger\":" << id << ",\"queue\":" << r.tickets.queueSize();
+        return true;
+    }
+
+    // Issue up to count tickets on one trip and count the passengers at both ends
+    bool issue(int count, int startID, int endID, TicketBatchSummary &summary)
+    {
+        if (tickets.queueSize() == 0)
+        {
+            error = "no passengers in queue";
+            return false;
+        }
+        summary = tickets.issueTicketBatch(count, startID, endID);
+        if (summary.issued == 0)
+        {
+            error = capturedError("no tickets issued");
+            return false;
+        }
+        for (int i = 0; i < summary.issued; i++)
+        {
+            if (!routes.incrementStationPassengers(startID) || !routes.incrementStationPassengers(endID))
+            {
+                error = capturedError("passenger counts not updated");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool cmdIssueTicket(CommandRunner &r)
+    {
+        int startID, endID;
+        TicketBatchSummary summary;
+        if (!r.resolveTrip(1, startID, endID) || !r.issue(1, startID, endID, summary))
+            return false;
+        r.fields << ",\"ticket\":" << summary.firstTicketID << ",\"start\":" << startID << ",\"end\":" << endID;
+        return true;
+    }
+
+    static bool cmdIssueTickets(CommandRunner &r)
+    {
+        int count, startID, endID;
+        TicketBatchSummary summary;
+        if (!r.parseInt(1, "count", count))
+            return false;
+        if (count <= 0)
+        {
+            r.error = "count must be positive";
+            return false;
+        }
+        if (!r.resolveTrip(2, startID, endID) || !r.issue(count, startID, endID, summary))
+            return false;
+        r.fields << ",\"issued\":" << summary.issued << ",\"first\":" << summary.firstTicketID
+                 << ",\"last\":" << summary.lastTicketID << ",\"queue\":" << summary.remainingQueue;
+        return true;
+    }
+
+    static bool cmdShortestPath(CommandRunner &r)
+    {
+        int startID, endID;
+        if (!r.resolveStation(1, startID) || !r.resolveStation(2, endID))
+            return false;
+        DynamicArray<int> path;
+        int distance = r.routes.findShortestPath(startID, endID, path);
+        if (distance < 0)
+        {
+            r.error = "no path from " + to_string(startID) + " to " + to_string(endID);
+            return false;
+        }
+        r.fields << ",\"distance\":" << distance << ",\"path\":[";
+        for (int i = 0; i < path.size(); i++)
+            r.fields << (i ? "," : "") << path[i];
+        r.fields << "]";
+        return true;
+    }
+
+    // Shortest distances between every pair of the given stations (-1 =
+    // unreachable); rows are computed in parallel
+    static bool cmdDistanceMatrix(CommandRunner &r)
+    {
+        DynamicArray<int> stations(r.args.size());
+        for (int i = 1; i < r.args.size(); i++)
+        {
+            int id;
+            if (!r.resolveStation(i, id))
+                return false;
+            stations.push_back(id);
+        }
+        DynamicArray<int> distances;
+        r.routes.distanceMatrix(stations, stations, distances);
+        int n = stations.size();
+        r.fields << ",\"stations\":[";
+        for (int i = 0; i < n; i++)
+            r.fields << (i ? "," : "") << stations[i];
+        r.fields << "],\"distances\":[";
+        for (int i = 0; i < n; i++)
+        {
+            r.fields << (i ? ",[" : "[");
+            for (int j = 0; j < n; j++)
+                r.fields << (j ? "," : "") << distances[i * n + j];
+            r.fields << "]";
+        }
+        r.fields << "]";
+        return true;
+    }
+
+    static bool cmdBusiestRoute(CommandRunner &r)
+    {
+        int count = 0;
+        Route route;
+        if (!r.routes.findBusiestRoute(r.tickets.getAllTickets(), route, count))
+        {
+            r.fields << ",\"route\":null,\"tickets\":0";
+            return true;
+        }
+        r.fields << ",\"route\":" << route.getRouteID() << ",\"start\":" << route.getStartStationID()
+                 << ",\"end\":" << route.getEndStationID() << ",\"tickets\":" << count;
+        return true;
+    }
+
+    // Origin-destination pairs with the most trips, overall or in a window
+    static bool cmdOdTop(CommandRunner &r)
+    {
+        int k;
+        bool windowed;
+        Timestamp from = 0, to = 0;
+        if (!r.parseInt(1, "k", k) || !r.parseWindow(2, windowed, from, to))
+            return false;
+        if (k <= 0)
+        {
+            r.error = "k must be positive";
+            return false;
+        }
+        const OdMatrix &od = r.tickets.originDestination();
+        DynamicArray<OdPair> pairs;
+        if (windowed)
+            od.topPairs(k, from, to, pairs);
+        else
+            od.topPairs(k, pairs);
+        r.fields << ",\"trips\":" << od.totalTrips() << ",\"pairs\":[";
+        for (int i = 0; i < pairs.size(); i++)
+            r.fields << (i ? "," : "") << "{\"origin\":" << pairs[i].origin << ",\"destination\":"
+                     << pairs[i].destination << ",\"trips\":" << pairs[i].trips << "}";
+        r.fields << "]";
+        return true;
+    }
+
+    static bool cmdOdPair(CommandRunner &r)
+    {
+        int origin, destination;
+        bool windowed;
+        Timestamp from = 0, to = 0;
+        if (!r.resolveStation(1, origin) || !r.resolveStation(2, destination) || !r.parseWindow(3, windowed, from, to))
+            return false;
+        const OdMatrix &od = r.tickets.originDestination();
+        int trips = windowed ? od.tripsBetween(origin, destination, from, to) : od.tripsBetween(origin, destination);
+        r.fields << ",\"origin\":" << origin << ",\"destination\":" << destination << ",\"trips\":" << trips;
+        return true;
+    }
+
+    // Per-origin and per-destination marginals of one station
+    static bool cmdOdStation(CommandRunner &r)
+    {
+        int station;
+        bool windowed;
+        Timestamp from = 0, to = 0;
+        if (!r.resolveStation(1, station) || !r.parseWindow(2, windowed, from, to))
+            return false;
+        const OdMatrix &od = r.tickets.originDestination();
+        int departures = od.departuresFrom(station);
+        int arrivals = od.arrivalsAt(station);
+        if (windowed)
+            od.stationTrips(station, from, to, departures, arrivals);
+        r.fields << ",\"station\":" << station << ",\"departures\":" << departures << ",\"arrivals\":" << arrivals;
+        return true;
+    }
+
+    // Routes carrying the most passengers on shortest paths (default 10)
+    static bool cmdRouteLoads(CommandRunner &r)
+    {
+        int k = 10;
+        if (r.args.size() > 1 && !r.parseInt(1, "k", k))
+            return false;
+        DynamicArray<RouteLoad> loads;
+        long long routed, unrouted;
+        r.routes.routeLoads(r.tickets.originDestination(), loads, routed, unrouted);
+        r.fields << ",\"routed\":" << routed << ",\"unrouted\":" << unrouted << ",\"routes\":[";
+        for (int i = 0; i < k && i < loads.size(); i++)
+            r.fields << (i ? "," : "") << "{\"route\":" << loads[i].routeID << ",\"start\":" << loads[i].startStationID
+                     << ",\"end\":" << loads[i].endStationID << ",\"forward\":" << loads[i].forward
+                     << ",\"backward\":" << loads[i].backward << "}";
+        r.fields << "]";
+        return true;
+    }
+
+    static bool cmdFindStation(CommandRunner &r)
+    {
+        int id = r.routes.findStationIdByName(r.args[1]);
+        if (id == -1)
+        {
+            r.error = "station not found: " + r.args[1];
+            return false;
+        }
+        r.fields << ",\"station\":" << id;
+        return true;
+    }
+
+    static bool cmdStats(CommandRunner &r)
+    {
+        r.fields << ",\"stations\":" << r.routes.totalStations() << ",\"routes\":" << r.routes.totalRoutes()
+                 << ",\"vehicles\":" << r.vehicles.totalVehicles() << ",\"queue\":" << r.tickets.queueSize()
+                 << ",\"tickets\":" << r.tickets.totalTicketsIssued();
+        return true;
+    }
+
+    static bool cmdSave(CommandRunner &r)
+    {
+        if (!SnapshotManager::save(r.args[1], r.routes, r.vehicles, r.tickets, r.history))
+        {
+            r.error = "cannot save snapshot " + r.args[1];
+            return false;
+        }
+        r.fields << ",\"file\":" << jsonEscape(r.args[1]);
+        return true;
+    }
+
+    static bool cmdLoad(CommandRunner &r)
+    {
+        if (!SnapshotManager::load(r.args[1], r.routes, r.vehicles, r.tickets, r.history))
+        {
+            r.error = "cannot load snapshot " + r.args[1];
+            return false;
+        }
+        r.fields << ",\"file\":" << jsonEscape(r.args[1]);
+        return true;
+    }
+
+    static bool cmdImageSave(CommandRunner &r)
+    {
+        if (!NetworkImage::write(r.args[1], r.routes.getStations(), r.routes.getRoutes()))
+        {
+            r.error = "cannot write network image " + r.args[1];
+            return false;
+        }
+        r.fields << ",\"file\":" << jsonEscape(r.args[1]);
+        return true;
+    }
+
+    // Replace the stations and routes with those of a network image
+    static bool cmdImageLoad(CommandRunner &r)
+    {
+        DynamicArray<Station> stations;
+        DynamicArray<Route> routes;
+        if (!NetworkImage::load(r.args[1], stations, routes))
+        {
+            r.error = "cannot load network image " + r.args[1];
+            return false;
+        }
+        r.routes.replaceNetwork(stations, routes);
+        r.fields << ",\"file\":" << jsonEscape(r.args[1]) << ",\"stations\":" << stations.size()
+                 << ",\"routes\":" << routes.size();
+        return true;
+    }
+
+    static bool cmdMetrics(CommandRunner &r)
+    {
+        if (!MetricsRegistry::instance().writePrometheus(r.args[1]))
+        {
+            r.error = "cannot write metrics to " + r.args[1];
+            return false;
+        }
+        r.fields << ",\"file\":" << jsonEscape(r.args[1]) << ",\"metrics\":" << MetricsRegistry::instance().size();
+        return true;
+    }
+
+    static bool cmdMemory(CommandRunner &r)
+    {
+        MemoryTracker &memory = MemoryTracker::instance();
+        memory.beginMeasure();
+        r.routes.measureMemory();
+        r.vehicles.measureMemory();
+        r.tickets.measureMemory();
+        r.history.measureMemory();
+
+        MemoryProcessStats process = MemoryTracker::processStats();
+        r.fields << ",\"tracking\":" << (MemoryTracker::enabled() ? "true" : "false")
+                 << ",\"tracked_bytes\":" << memory.totalLiveBytes() << ",\"rss_kb\":" << process.rssKb
+                 << ",\"peak_rss_kb\":" << process.peakRssKb << ",\"heap_bytes\":" << process.heapBytes
+                 << ",\"heap_free_bytes\":" << process.heapFreeBytes << ",\"accounts\":[";
+        bool first = true;
+        for (int i = 0; i < memory.size(); i++)
+        {
+            const MemoryAccount &a = memory.at(i);
+            long long live = a.liveBytes.load(memory_order_relaxed);
+            if (live == 0 && a.usedBytes <= 0 && a.allocations.load(memory_order_relaxed) == 0)
+                continue;
+            r.fields << (first ? "" : ",") << "{\"name\":" << jsonEscape(a.name) << ",\"live_bytes\":" << live
+                     << ",\"blocks\":" << a.liveBlocks.load(memory_order_relaxed)
+                     << ",\"peak_bytes\":" << a.peakBytes.load(memory_order_relaxed)
+                     << ",\"allocations\":" << a.allocations.load(memory_order_relaxed)
+                     << ",\"used_bytes\":" << a.usedBytes << "}";
+            first = false;
+        }
+        r.fields << "]";
+        return true;
+    }
+
+    static bool cmdExport(CommandRunner &r)
+    {
+        // Format from an argument, else from the file extension (text by
+        // default); tickets also take a row order
+        const string &what = r.args[1];
+        OutputFormat format = OUTPUT_TEXT;
+        TicketOrder order = TICKETS_BY_ID;
+        bool formatGiven = false;
+        for (int i = 3; i < (int)r.args.size(); i++)
+        {
+            if (!formatGiven && parseOutputFormat(r.args[i], format))
+                formatGiven = true;
+            else if (what != "tickets" || !parseTicketOrder(r.args[i], order))
+            {
+                if (what == "tickets")
+                    r.error = "unknown format or order " + r.args[i] +
+                              " (text, csv or json; by-id, by-passenger, by-origin or by-destination)";
+                else
+                    r.error = "unknown format " + r.args[i] + " (text, csv or json)";
+                return false;
+            }
+        }
+        if (!formatGiven)
+        {
+            int dot = (int)r.args[2].rfind('.');
+            if (dot >= 0)
+                parseOutputFormat(r.args[2].substr(dot + 1), format);
+        }
+
+        int records;
+        if (what == "stations")
+            records = r.routes.totalStations();
+        else if (what == "routes")
+            records = r.routes.totalRoutes();
+        else if (what == "vehicles")
+            records = r.vehicles.totalVehicles();
+        else if (what == "tickets")
+            records = r.tickets.totalTicketsIssued();
+        else
+        {
+            r.error = "unknown dataset " + what + " (stations, routes, vehicles or tickets)";
+            return false;
+        }
+
+        ofstream file(r.args[2].c_str(), ios::binary);
+        if (!file)
+        {
+            r.error = "cannot write " + r.args[2];
+            return false;
+        }
+        {
+            OutputSink sink(file, 1 << 20);
+            if (what == "stations")
+                r.routes.exportStations(sink, format);
+            else if (what == "routes")
+                r.routes.exportRoutes(sink, format);
+            else if (what == "vehicles")
+                r.vehicles.exportVehicles(sink, format);
+            else
+            {
+                r.routes.setInstance();
+                r.tickets.exportTickets(sink, format, RouteManager::getStationNameByIdStatic, order);
+            }
+        }
+        if (!file.good())
+        {
+            r.error = "write failed for " + r.args[2];
+            return false;
+        }
+        const char *formats[] = {"text", "csv", "json"};
+        r.fields << ",\"file\":" << jsonEscape(r.args[2]) << ",\"format\":\"" << formats[format]
+                 << "\",\"records\":" << records;
+        return true;
+    }
+
+    static bool cmdGenerate(CommandRunner &r)
+    {
+        GeneratorOptions options;
+        if (!NetworkGenerator::parseTopology(r.args[1], options.topology))
+        {
+            r.error = "unknown topology: " + r.args[1];
+            return false;
+        }
+        int seed = 1;
+        if (!r.parseInt(2, "stations", options.stations) ||
+            (r.args.size() > 3 && !r.parseInt(3, "routes per station", options.routesPerStation)) ||
+            (r.args.size() > 4 && !r.parseInt(4, "tickets", options.tickets)) ||
+            (r.args.size() > 5 && !r.parseInt(5, "seed", seed)))
+            return false;
+        if (options.stations <= 0 || options.routesPerStation <= 0 || options.tickets < 0)
+        {
+            r.error = "stations and routes per station must be positive, tickets not negative";
+            return false;
+        }
+        options.seed = (unsigned long long)seed;
+        if (!NetworkGenerator::checkOptions(options, r.error))
+            return false;
+
+        NetworkGenerator generator(options);
+        bool stored = generator.populate(r.routes, r.vehicles, r.tickets);
+        const GeneratorReport &report = generator.getReport();
+        if (!stored)
+        {
+            r.error = "could not store the whole network (added " + to_string(report.stationsAdded) +
+                      " stations, " + to_string(report.routesAdded) + " routes, " +
+                      to_string(report.ticketsIssued) + " tickets)";
+            return false;
+        }
+        r.fields << ",\"stations\":" << report.stationsAdded << ",\"routes\":" << report.routesAdded
+                 << ",\"tickets\":" << report.ticketsIssued;
+        return true;
+    }
+
+    // Run args as one command; false if it failed
+    bool execute()
+    {
+        int count;
+        const CommandSpec *table = commandTable(count);
+        for (int i = 0; i < count; i++)
+        {
+            if (args[0] != table[i].name)
+                continue;
+            int n = args.size() - 1;
+            if (n < table[i].minArgs || n > table[i].maxArgs)
+            {
+                error = string("usage: ") + table[i].usage;
+                return false;
+            }
+            return table[i].handler(*this);
+        }
+        error = "unknown command";
+        return false;
+    }
+
+public:
+    // Results go to results, which must not be cout (cout is muted while
+    // commands run). With stopOnFirstError the script ends at the first failure.
+    CommandRunner(RouteManager &r, VehicleManager &v, TicketManager &t, HistoryManager &h,
+                  ostream &results, bool stopOnFirstError = false)
+        : routes(r), vehicles(v), tickets(t), history(h), out(results), stopOnError(stopOnFirstError),
+          commands(0), errors(0)
+    {
+    }
+
+    // Run one script line; returns false if it held a failing command
+    bool runLine(const string &line, int lineNumber)
+    {
+        error.clear();
+        bool ok = tokenize(line, args);
+        if (!ok)
+        {
+            args.clear();
+            args.push_back("");
+            error = "unterminated quote";
+        }
+        else if (args.size() == 0)
+            return true; // blank or comment
+
+        fields.str("");
+        captured.str("");
+        streambuf *saved = cout.rdbuf(captured.rdbuf());
+        if (ok)
+            ok = execute();
+        cout.rdbuf(saved);
+
+        commands++;
+        out << "{\"line\":" << lineNumber << ",\"cmd\":" << jsonEscape(args[0]) << ",\"ok\":" << (ok ? "true" : "false");
+        if (ok)
+            out << fields.str();
+        else
+        {
+            errors++;
+            out << ",\"error\":" << jsonEscape(error);
+        }
+        out << "}\n";
+        return ok;
+    }
+
+    // Run a whole script; returns the number of failed commands.
+    // A one-line summary with the throughput goes to stderr.
+    int run(istream &script)
+    {
+        chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+        string line;
+        int lineNumber = 0;
+        while (getline(script, line))
+        {
+            lineNumber++;
+            if (!runLine(line, lineNumber) && stopOnError)
+                break;
+        }
+        out.flush();
+
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+        cerr << "batch: " << commands << " commands, " << errors << " errors, " << ms << " ms";
+        if (ms > 0)
+            cerr << " (" << (long long)(commands * 1000.0 / ms) << " commands/s)";
+        cerr << "\n";
+        return errors;
+    }
+
+    int commandCount() const { return commands; }
+    int errorCount() const { return errors; }
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef DURABLE_FILE_H
+#define DURABLE_FILE_H
+
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include "write_ahead_log.h" // WAL_FSYNC and the platform file headers
+
+using namespace std;
+
+#ifdef _WIN32
+#define DURABLE_OPEN_FLAGS (O_WRONLY | O_CREAT | O_TRUNC | O_BINARY)
+#else
+#define DURABLE_OPEN_FLAGS (O_WRONLY | O_CREAT | O_TRUNC)
+#endif
+
+// Whole-file writes that survive a crash: the bytes go to path.tmp, are
+// fsynced, renamed over path, and then the directory is fsynced so the
+// rename itself is durable. Readers see either the old file or the new one.
+class DurableFile
+{
+public:
+    // Write bytes to a fresh file and fsync it before closing
+    static bool writeBytes(const string &path, const char *bytes, long long size)
+    {
+        int fd = ::open(path.c_str(), DURABLE_OPEN_FLAGS, 0644);
+        if (fd < 0)
+        {
+            cerr << "Cannot open " << path << " for writing" << endl;
+            return false;
+        }
+        long long done = 0;
+        while (done < size)
+        {
+            long long chunk = size - done < (1 << 30) ? size - done : (1 << 30);
+            long long n = (long long)::write(fd, bytes + done, (unsigned int)chunk);
+            if (n <= 0)
+                break;
+            done += n;
+        }
+        bool ok = done == size && WAL_FSYNC(fd) == 0;
+        if (::close(fd) != 0)
+            ok = false;
+        if (!ok)
+            cerr << "Failed writing " << path << endl;
+        return ok;
+    }
+
+    // fsync the directory holding path so a rename into it survives a crash
+    // (Windows has no directory handles to flush; rename there is journaled)
+    static bool syncDirectory(const string &path)
+    {
+#ifdef _WIN32
+        (void)path;
+        return true;
+#else
+        size_t slash = path.find_last_of('/');
+        string dir = slash == string::npos ? string(".") : (slash == 0 ? string("/") : path.substr(0, slash));
+        int fd = ::open(dir.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        bool ok = fsync(fd) == 0;
+        ::close(fd);
+        return ok;
+#endif
+    }
+
+    // Replace path with bytes; true only once the new file and the rename
+    // are both on stable storage
+    static bool replace(const string &path, const char *bytes, long long size)
+    {
+        string tmpPath = path + ".tmp";
+        if (!writeBytes(tmpPath, bytes, size))
+        {
+            remove(tmpPath.c_str());
+            return false;
+        }
+        if (rename(tmpPath.c_str(), path.c_str()) != 0)
+        {
+            cerr << "Cannot replace " << path << endl;
+            remove(tmpPath.c_str());
+            return false;
+        }
+        if (!syncDirectory(path))
+        {
+            cerr << "Cannot sync the directory of " << path << endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+#endif
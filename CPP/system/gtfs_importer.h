@@ -0,0 +1,461 @@
+#ifndef GTFS_IMPORTER_H
+#define GTFS_IMPORTER_H
+
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cmath>
+#include "../ds/array.h"
+#include "../ds/pair.h"
+#include "../ds/hashtable.h"
+#include "../ds/sorting.h"
+#include "../ds/string_dictionary.h"
+#include "../ds/csv_reader.h"
+#include "../ds/thread_pool.h"
+#include "../models/station.h"
+#include "../models/route.h"
+#include "route_manager.h"
+
+using namespace std;
+
+struct GtfsOptions
+{
+    int threads;        // stop_times blocks parsed per round (0 = shared pool size)
+    int blockBytes;     // stop_times bytes handed to a parser task at a time
+    int routeType;      // only trips of routes with this route_type (-1 = all)
+    bool mergePlatforms; // stops with a parent_station become that station
+
+    GtfsOptions() : threads(0), blockBytes(4 << 20), routeType(-1), mergePlatforms(true) {}
+};
+
+// Counts from one feed import
+struct GtfsReport
+{
+    int stops;            // rows in stops.txt
+    int stationsAdded;    // stations created
+    long long stopTimes;  // rows in stop_times.txt
+    int trips;            // trip runs seen in stop_times.txt
+    long long hops;       // consecutive stop pairs (before deduplication)
+    int routesAdded;      // distinct station pairs added as routes
+    long long unknownStops; // stop_times rows naming a stop not in stops.txt
+    long long badRows;    // rows that could not be parsed
+
+    GtfsReport()
+        : stops(0), stationsAdded(0), stopTimes(0), trips(0), hops(0), routesAdded(0), unknownStops(0),
+          badRows(0) {}
+};
+
+// One block of stop_times.txt and what a parser task made of it
+struct GtfsBlock
+{
+    char *text;
+    int capacity;
+    int length;
+
+    DynamicArray<int> stations;  // station slot per row (-1 = skip and break the chain)
+    DynamicArray<int> sequences; // stop_sequence per row
+    DynamicArray<char> breaks;   // 1 if the row's trip_id differs from the previous row's
+    string firstTrip, lastTrip;  // trip_ids at the block edges, to stitch blocks together
+    long long badRows, unknownStops;
+
+    GtfsBlock() : text(nullptr), capacity(0), length(0), stations(1024), sequences(1024), breaks(1024),
+                  badRows(0), unknownStops(0) {}
+    ~GtfsBlock() { delete[] text; }
+
+private:
+    GtfsBlock(const GtfsBlock &);
+    GtfsBlock &operator=(const GtfsBlock &);
+};
+
+// GTFS feed import (stops.txt, stop_times.txt, and optionally trips.txt /
+// routes.txt) into RouteManager, entirely from local files
+//
+// Each stop becomes a Station (platforms fold into their parent station by
+// default). Every pair of consecutive stops on a trip becomes a Route
+// weighted by the great-circle distance in km; a pair is added once no
+// matter how many trips run it, in either direction.
+//
+// stop_times.txt is streamed: the reader hands fixed-size blocks of whole
+// records to parser tasks on the shared thread pool, which split them in
+// place and resolve stop IDs against a read-only dictionary. The parsed
+// rows are then walked in file order to form trips. Memory is bounded by
+// (threads x blockBytes), the stops and the distinct edges, not by the
+// file size. Trips are expected to be contiguous, as feeds write them; a
+// trip split across the file is treated as separate trips.
+class GtfsImporter
+{
+private:
+    RouteManager &routeManager;
+    GtfsOptions options;
+    GtfsReport report;
+
+    StringDictionary stopCodes;         // stop_id -> code
+    DynamicArray<int> stationOfStop;    // code -> new station slot, -1 = none
+    DynamicArray<Station> newStations;  // slot -> station
+    DynamicArray<double> latitudes;     // slot -> coordinates
+    DynamicArray<double> longitudes;
+    StringDictionary allowedTrips;      // trip_ids kept by the route_type filter
+    bool filterTrips;
+
+    // Trip being assembled and the edges found so far
+    DynamicArray<Pair<int, int>> run;   // (stop_sequence, station slot)
+    HashTable<long long, int> edgeSet;  // packed slot pair -> index in newRoutes
+    DynamicArray<Route> newRoutes;
+    int firstStationID, nextRouteID;
+
+    static double toRadians(double deg) { return deg * 3.14159265358979323846 / 180.0; }
+
+    // Great-circle distance in km
+    static double haversineKm(double lat1, double lon1, double lat2, double lon2)
+    {
+        double dLat = toRadians(lat2 - lat1);
+        double dLon = toRadians(lon2 - lon1);
+        double a = sin(dLat / 2) * sin(dLat / 2) +
+                   cos(toRadians(lat1)) * cos(toRadians(lat2)) * sin(dLon / 2) * sin(dLon / 2);
+        return 2 * 6371.0 * asin(sqrt(a > 1 ? 1 : a)); // NaN coordinates stay NaN
+    }
+
+    static string feedFile(const string &dir, const char *name)
+    {
+        if (dir.empty())
+            return name;
+        char last = dir[dir.size() - 1];
+        return last == '/' || last == '\\' ? dir + name : dir + "/" + name;
+    }
+
+    static bool missingColumn(const string &file, const char *column)
+    {
+        cout << "ERROR: " << file << " has no " << column << " column" << endl;
+        return false;
+    }
+
+    // route_type filter: trips.txt rows whose route has the wanted type
+    bool readTripFilter(const string &dir)
+    {
+        StringDictionary routeIDs;
+        CsvReader csv;
+        string path = feedFile(dir, "routes.txt");
+        if (!csv.open(path) || !csv.next())
+        {
+            cout << "ERROR: Cannot read " << path << endl;
+            return false;
+        }
+        int idCol = csv.columnIndex("route_id");
+        int typeCol = csv.columnIndex("route_type");
+        if (idCol < 0 || typeCol < 0)
+            return missingColumn(path, idCol < 0 ? "route_id" : "route_type");
+        while (csv.next())
+        {
+            int type;
+            if (csv.getInt(typeCol, type) && type == options.routeType)
+                routeIDs.encode(csv.getString(idCol));
+        }
+
+        path = feedFile(dir, "trips.txt");
+        if (!csv.open(path) || !csv.next())
+        {
+            cout << "ERROR: Cannot read " << path << endl;
+            return false;
+        }
+        int tripCol = csv.columnIndex("trip_id");
+        int routeCol = csv.columnIndex("route_id");
+        if (tripCol < 0 || routeCol < 0)
+            return missingColumn(path, tripCol < 0 ? "trip_id" : "route_id");
+        while (csv.next())
+            if (routeIDs.find(csv.field(routeCol), csv.fieldLength(routeCol)) >= 0)
+                allowedTrips.encode(csv.getString(tripCol));
+        filterTrips = true;
+        return true;
+    }
+
+    bool readStops(const string &dir)
+    {
+        CsvReader csv;
+        string path = feedFile(dir, "stops.txt");
+        if (!csv.open(path) || !csv.next())
+        {
+            cout << "ERROR: Cannot read " << path << endl;
+            return false;
+        }
+        int idCol = csv.columnIndex("stop_id");
+        int nameCol = csv.columnIndex("stop_name");
+        int latCol = csv.columnIndex("stop_lat");
+        int lonCol = csv.columnIndex("stop_lon");
+        int typeCol = csv.columnIndex("location_type");
+        int parentCol = csv.columnIndex("parent_station");
+        if (idCol < 0)
+            return missingColumn(path, "stop_id");
+
+        // Collect first: a parent may be listed after its platforms
+        DynamicArray<string> names(4096);
+        DynamicArray<double> lats(4096), lons(4096);
+        DynamicArray<int> types(4096);
+        DynamicArray<string> parents(4096);
+        while (csv.next())
+        {
+            int code = stopCodes.encode(csv.getString(idCol));
+            if (code < names.size())
+            {
+                report.badRows++; // repeated stop_id: first row wins
+                continue;
+            }
+            double lat = 0, lon = 0;
+            int type = 0;
+            csv.getDouble(latCol, lat);
+            csv.getDouble(lonCol, lon);
+            csv.getInt(typeCol, type);
+            names.push_back(csv.getString(nameCol));
+            lats.push_back(lat);
+            lons.push_back(lon);
+            types.push_back(type);
+            parents.push_back(csv.getString(parentCol));
+        }
+        report.stops = names.size();
+
+        // Root of each stop: itself, or its outermost known parent
+        int n = names.size();
+        DynamicArray<int> root(n + 1);
+        for (int i = 0; i < n; i++)
+        {
+            int r = i;
+            for (int depth = 0; options.mergePlatforms && depth < 4 && !parents[r].empty(); depth++)
+            {
+                int p = stopCodes.find(parents[r]);
+                if (p < 0 || p == r)
+                    break;
+                r = p;
+            }
+            root.push_back(r);
+        }
+
+        // Stations for roots that are stops or stations (not entrances etc.)
+        stationOfStop.reserve(n);
+        for (int i = 0; i < n; i++)
+            stationOfStop.push_back(-1);
+        for (int i = 0; i < n; i++)
+        {
+            if (root[i] != i || types[i] > 1 || names[i].empty())
+                continue;
+            char location[64];
+            snprintf(location, sizeof(location), "%.6f, %.6f", lats[i], lons[i]);
+            stationOfStop[i] = newStations.size();
+            newStations.push_back(Station(firstStationID + newStations.size(), names[i], location));
+            latitudes.push_back(lats[i]);
+            longitudes.push_back(lons[i]);
+        }
+        for (int i = 0; i < n; i++)
+            if (root[i] != i)
+                stationOfStop[i] = stationOfStop[root[i]];
+        return true;
+    }
+
+    // Parser task body: split one block and resolve its stops
+    static void parseBlock(GtfsBlock *block, const GtfsImporter *importer, char delimiter, int tripCol,
+                           int stopCol, int seqCol)
+    {
+        block->stations.clear();
+        block->sequences.clear();
+        block->breaks.clear();
+        block->badRows = block->unknownStops = 0;
+        block->firstTrip.clear();
+        block->lastTrip.clear();
+
+        CsvRecord record;
+        const char *prevTrip = nullptr;
+        int prevTripLength = -1;
+        bool tripAllowed = true;
+        int pos = 0;
+        while (pos < block->length)
+        {
+            int stop = csvFindRecordEnd(block->text, pos, block->length);
+            int recordEnd = stop >= 0 ? stop : block->length;
+            int from = pos;
+            pos = recordEnd + 1;
+            if (recordEnd == from || (recordEnd == from + 1 && block->text[from] == '\r'))
+                continue; // blank line
+            record.split(block->text + from, recordEnd - from, delimiter);
+
+            const char *trip = record.field(tripCol);
+            int tripLength = record.fieldLength(tripCol);
+            bool newTrip = tripLength != prevTripLength || memcmp(trip, prevTrip, tripLength) != 0;
+            if (newTrip)
+            {
+                if (prevTrip == nullptr)
+                    block->firstTrip.assign(trip, tripLength);
+                tripAllowed = !importer->filterTrips || importer->allowedTrips.find(trip, tripLength) >= 0;
+                prevTrip = trip;
+                prevTripLength = tripLength;
+            }
+
+            int slot = -1, sequence = 0;
+            if (record.fieldCount() <= stopCol || !record.getInt(seqCol, sequence))
+                block->badRows++;
+            else if (tripAllowed)
+            {
+                int code = importer->stopCodes.find(record.field(stopCol), record.fieldLength(stopCol));
+                if (code < 0)
+                    block->unknownStops++;
+                else
+                    slot = importer->stationOfStop[code];
+            }
+            block->stations.push_back(slot);
+            block->sequences.push_back(sequence);
+            block->breaks.push_back(newTrip ? 1 : 0);
+        }
+        if (prevTrip)
+            block->lastTrip.assign(prevTrip, prevTripLength);
+    }
+
+    // parallelFor body: parse blocks[lo..hi)
+    struct GtfsParseBody
+    {
+        GtfsBlock *blocks;
+        const GtfsImporter *importer;
+        char delimiter;
+        int tripCol, stopCol, seqCol;
+
+        GtfsParseBody(GtfsBlock *b, const GtfsImporter *imp, char delim, int trip, int stop, int seq)
+            : blocks(b), importer(imp), delimiter(delim), tripCol(trip), stopCol(stop), seqCol(seq) {}
+
+        void operator()(int lo, int hi) const
+        {
+            for (int b = lo; b < hi; b++)
+                parseBlock(&blocks[b], importer, delimiter, tripCol, stopCol, seqCol);
+        }
+    };
+
+    // Turn the finished trip into edges
+    void flushRun()
+    {
+        if (run.size() == 0)
+            return;
+        report.trips++;
+        insertionSort(run.getRawArray(), run.size()); // by stop_sequence, usually sorted already
+        for (int i = 0; i + 1 < run.size(); i++)
+        {
+            int a = run[i].second;
+            int b = run[i + 1].second;
+            if (a < 0 || b < 0 || a == b)
+                continue;
+            report.hops++;
+            long long key = a < b ? ((long long)a << 32) | b : ((long long)b << 32) | a;
+            if (edgeSet.contains(key))
+                continue;
+            double km = haversineKm(latitudes[a], longitudes[a], latitudes[b], longitudes[b]);
+            km = floor(km * 1000 + 0.5) / 1000;
+            if (km <= 0)
+                km = 0.001; // same coordinates
+            if (!Route::validDistance(km))
+            {
+                report.badRows++; // NaN or huge: unusable stop_lat/stop_lon
+                continue;
+            }
+            edgeSet.insert(key, newRoutes.size());
+            newRoutes.push_back(Route(nextRouteID++, newStations[a].getID(), newStations[b].getID(), km));
+        }
+        run.clear();
+    }
+
+    bool readStopTimes(const string &dir)
+    {
+        CsvReader csv;
+        string path = feedFile(dir, "stop_times.txt");
+        if (!csv.open(path) || !csv.next())
+        {
+            cout << "ERROR: Cannot read " << path << endl;
+            return false;
+        }
+        int tripCol = csv.columnIndex("trip_id");
+        int stopCol = csv.columnIndex("stop_id");
+        int seqCol = csv.columnIndex("stop_sequence");
+        if (tripCol < 0 || stopCol < 0 || seqCol < 0)
+            return missingColumn(path, tripCol < 0 ? "trip_id" : stopCol < 0 ? "stop_id" : "stop_sequence");
+
+        ThreadPool &pool = ThreadPool::shared();
+        int threads = options.threads > 0 ? options.threads : pool.size();
+        GtfsBlock *blocks = new GtfsBlock[threads];
+        GtfsParseBody parse(blocks, this, csv.getDelimiter(), tripCol, stopCol, seqCol);
+        string prevTrip;
+        bool havePrev = false;
+
+        while (true)
+        {
+            // Read up to one block per parser, parse them in parallel...
+            int used = 0;
+            while (used < threads)
+            {
+                blocks[used].length = csv.nextBlock(blocks[used].text, blocks[used].capacity, options.blockBytes);
+                if (blocks[used].length == 0)
+                    break;
+                used++;
+            }
+            if (used == 0)
+                break;
+            parallelFor(pool, 0, used, 1, parse);
+
+            // ...then walk the rows in file order
+            for (int b = 0; b < used; b++)
+            {
+                GtfsBlock &block = blocks[b];
+                report.badRows += block.badRows;
+                report.unknownStops += block.unknownStops;
+                report.stopTimes += block.stations.size();
+                for (int i = 0; i < block.stations.size(); i++)
+                {
+                    bool newTrip = i > 0 ? block.breaks[i] != 0 : !havePrev || block.firstTrip != prevTrip;
+                    if (newTrip)
+                        flushRun();
+                    run.push_back(Pair<int, int>(block.sequences[i], block.stations[i]));
+                }
+                if (block.stations.size() > 0)
+                {
+                    prevTrip = block.lastTrip;
+                    havePrev = true;
+                }
+            }
+        }
+        flushRun();
+        delete[] blocks;
+        return true;
+    }
+
+public:
+    GtfsImporter(RouteManager &routes, const GtfsOptions &opts = GtfsOptions())
+        : routeManager(routes), options(opts), stopCodes(1024), allowedTrips(16), filterTrips(false),
+          run(256), edgeSet(1024), firstStationID(1), nextRouteID(1) {}
+
+    // Import the feed in directory dir; false if a required file is
+    // missing or malformed (nothing is added then), or if the stations and
+    // routes could not all be logged (the report counts what was kept)
+    bool importFeed(const string &dir)
+    {
+        const DynamicArray<Station> &stations = routeManager.getStations();
+        const DynamicArray<Route> &routes = routeManager.getRoutes();
+        for (int i = 0; i < stations.size(); i++)
+            if (stations[i].getID() >= firstStationID)
+                firstStationID = stations[i].getID() + 1;
+        for (int i = 0; i < routes.size(); i++)
+            if (routes[i].getRouteID() >= nextRouteID)
+                nextRouteID = routes[i].getRouteID() + 1;
+
+        if (options.routeType >= 0 && !readTripFilter(dir))
+            return false;
+        if (!readStops(dir))
+            return false;
+        edgeSet.reserve(newStations.size() * 2);
+        if (!readStopTimes(dir))
+            return false;
+
+        // addBulk keeps only what it could log
+        int stationsBefore = stations.size();
+        int routesBefore = routes.size();
+        bool stored = routeManager.addBulk(newStations, newRoutes);
+        report.stationsAdded = stations.size() - stationsBefore;
+        report.routesAdded = routes.size() - routesBefore;
+        return stored;
+    }
+
+    const GtfsReport &getReport() const { return report; }
+};
+
+#endif
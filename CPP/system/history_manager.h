@@ -4,18 +4,42 @@
 #include <iostream>
 #include "../ds/stack.h"
 #include "../ds/array.h"
+#include "../ds/binary_stream.h"
+#include "../ds/output_sink.h"
+#include "write_ahead_log.h"
 using namespace std;
 
 class HistoryManager
 {
 private:
     Stack<string> historyStack; // Stores actions for undo
+    WriteAheadLog *wal;         // mutation log (nullptr = not logged)
 
 public:
+    HistoryManager() : wal(nullptr)
+    {
+        historyStack.setMemoryAccount(MemoryTracker::instance().account("history"));
+    }
+
+    // Log every later change to log (nullptr to stop logging)
+    void attachLog(WriteAheadLog *log) { wal = log; }
+
+    // Add used bytes of the undo stack to its account (memory report)
+    void measureMemory() const
+    {
+        historyStack.measureMemory();
+    }
+
     // Add an action to history
-    void addAction(const string &action)
+    bool addAction(const string &action)
     {
+        if (wal && !wal->logHistory(WAL_HISTORY_PUSH, action))
+        {
+            cout << "ERROR: Could not log the change; action not recorded in history" << endl;
+            return false;
+        }
         historyStack.push(action);
+        return true;
     }
 
     // Undo last action
@@ -25,6 +49,8 @@ public:
         {
             return "No actions to undo.";
         }
+        if (wal && !wal->logHistory(WAL_HISTORY_POP))
+            return "ERROR: Could not log the change; nothing undone";
         string lastAction = historyStack.top();
         historyStack.pop();
         return lastAction;
@@ -62,10 +88,11 @@ public:
             temp.push_back(historyStack.top());
             historyStack.pop();
         }
-        cout << "Action History (most recent first):" << endl;
+        OutputSink out(cout);
+        out << "Action History (most recent first):\n";
         for (int i = 0; i < temp.size(); i++)
         {
-            cout << "- " << temp[i] << endl;
+            out << "- " << temp[i] << '\n';
             historyStack.push(temp[i]); // restore
         }
         // Restore in reverse order
@@ -78,13 +105,55 @@ public:
             historyStack.push(reversed[i]);
     }
 
+    // Serialize the action log, oldest first (snapshot section)
+    void writeSnapshot(BinaryWriter &out) const
+    {
+        DynamicArray<string> newestFirst;
+        Stack<string> temp = historyStack; // copy to preserve original
+        while (!temp.empty())
+            newestFirst.push_back(temp.pop());
+
+        out.writeInt(newestFirst.size());
+        for (int i = newestFirst.size() - 1; i >= 0; i--)
+            out.writeString(newestFirst[i]);
+    }
+
+    // Take over the action log another manager read from a snapshot
+    void adoptSnapshot(HistoryManager &loaded)
+    {
+        historyStack = loaded.historyStack;
+    }
+
+    // Replace the action log with a snapshot section; untouched on failure
+    bool readSnapshot(BinaryReader &in)
+    {
+        int n = in.readCount(4);
+        DynamicArray<string> oldestFirst(n + 1);
+        for (int i = 0; i < n && in.good(); i++)
+            oldestFirst.push_back(in.readString());
+        if (!in.good())
+            return false;
+
+        while (!historyStack.empty())
+            historyStack.pop();
+        for (int i = 0; i < oldestFirst.size(); i++)
+            historyStack.push(oldestFirst[i]);
+        return true;
+    }
+
     // Clear all history
-    void clearHistory()
+    bool clearHistory()
     {
+        if (wal && !historyStack.empty() && !wal->logHistory(WAL_HISTORY_CLEAR))
+        {
+            cout << "ERROR: Could not log the change; history not cleared" << endl;
+            return false;
+        }
         while (!historyStack.empty())
         {
             historyStack.pop();
         }
+        return true;
     }
 };
 
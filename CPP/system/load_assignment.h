@@ -0,0 +1,495 @@
+#ifndef LOAD_ASSIGNMENT_H
+#define LOAD_ASSIGNMENT_H
+
+#include <iostream>
+#include "../ds/array.h"
+#include "../ds/pair.h"
+#include "../ds/heap.h"
+#include "../ds/metrics.h"
+#include "../ds/memory_tracker.h"
+#include "../ds/thread_pool.h"
+#include "network_version.h"
+#include "od_matrix.h"
+
+using namespace std;
+
+// Define INT_MAX replacement to avoid <limits>
+#ifndef INT_MAX_VALUE
+#define INT_MAX_VALUE 2147483647
+#endif
+
+// Memory for cached shortest-path trees; origins beyond it get their tree
+// rebuilt on every assignment
+#define LOAD_TREE_CACHE_BYTES (256LL << 20)
+
+// Trips carried by one route, per direction
+struct RouteLoad
+{
+    int routeID;
+    int startStationID;
+    int endStationID;
+    int forward;  // ridden start -> end
+    int backward; // ridden end -> start
+
+    RouteLoad() : routeID(0), startStationID(0), endStationID(0), forward(0), backward(0) {}
+    RouteLoad(int id, int start, int end, int f, int b)
+        : routeID(id), startStationID(start), endStationID(end), forward(f), backward(b) {}
+
+    int total() const { return forward + backward; }
+};
+
+// Heaviest first, then by route ID
+struct RouteLoadHeavier
+{
+    bool operator()(const RouteLoad &a, const RouteLoad &b) const
+    {
+        return a.total() > b.total() || (a.total() == b.total() && a.routeID < b.routeID);
+    }
+};
+
+// Shortest-path tree of one origin (vertex indexes of the network graph)
+struct LoadTree
+{
+    DynamicArray<int> order;  // reached vertices by distance, origin first
+    DynamicArray<int> parent; // per vertex: previous vertex, -1 if unreached or the origin
+    DynamicArray<int> via;    // per vertex: edge code of the route into it
+};
+
+inline void memoryAttach(LoadTree &tree, MemoryAccount *account)
+{
+    tree.order.setMemoryAccount(account);
+    tree.parent.setMemoryAccount(account);
+    tree.via.setMemoryAccount(account);
+}
+
+inline void memoryMeasure(const LoadTree &tree)
+{
+    tree.order.measureMemory();
+    tree.parent.measureMemory();
+    tree.via.measureMemory();
+}
+
+// Route loads from the origin-destination matrix: every trip rides its
+// shortest path (all-or-nothing assignment) and adds one passenger to each
+// route on it, in the direction ridden.
+//
+// Trips are taken per OD pair, not per ticket, so a batch costs one
+// shortest-path tree per origin with new trips plus the paths of its
+// pairs: an origin's paths are walked back through the tree when it has
+// few destinations, otherwise the trips are pushed up the tree once in
+// reverse distance order (O(reached stations)). Trees are cached per
+// origin (up to LOAD_TREE_CACHE_BYTES) and every assign() only adds the
+// trips the matrix gained since the last one. Origins run in parallel,
+// each chunk into its own per-route counters, summed in order.
+//
+// Paths follow Graph's weights ((int) route distance) and edge order, so
+// ties go the way Graph::shortestPath breaks them. A new network version
+// with the same routes keeps the cache; any other change, or a cleared
+// matrix, starts over. Not thread-safe: callers serialize (RouteManager
+// holds a lock).
+class LoadAssignment
+{
+private:
+    // Network the trees and loads belong to: per vertex the incident routes
+    // in Graph's order. Edge code 2 * route slot rides start -> end, 2 *
+    // slot + 1 end -> start.
+    long long networkNumber; // NetworkVersion::number, -1 before the first
+    int routeCount;
+    DynamicArray<int> vertexIDs; // vertex index -> station ID
+    DynamicArray<int> offsets;   // edges of vertex v: [offsets[v], offsets[v + 1])
+    DynamicArray<int> targets;
+    DynamicArray<int> weights;
+    DynamicArray<int> codes;
+
+    DynamicArray<int> treeOf; // origin vertex -> trees slot, -1 if not cached
+    DynamicArray<LoadTree> trees;
+    int maxTrees;
+
+    DynamicArray<int> loads;      // per edge code
+    DynamicArray<int> assignedOf; // per OD cell: trips assigned so far
+    long long odEpoch;
+    long long routed;   // trips on a path (same-station trips included)
+    long long unrouted; // trips between stations missing or not connected
+
+    // Per-chunk result of AssignOrigins
+    struct LoadPartial
+    {
+        DynamicArray<int> loads;
+        long long unrouted;
+
+        LoadPartial() : unrouted(0) {}
+    };
+
+    // parallelReduce body: the batch trips of origins[lo, hi). Trips of
+    // origins[i] are batch[starts[i] .. starts[i + 1]) as (vertex, trips).
+    struct AssignOrigins
+    {
+        LoadAssignment *self;
+        const int *origins;
+        const int *starts;
+        const Pair<int, int> *batch;
+
+        void operator()(int lo, int hi, LoadPartial &partial) const
+        {
+            LoadTree scratch;
+            DynamicArray<int> dist;
+            DynamicArray<int> demand;
+            for (int i = lo; i < hi; i++)
+            {
+                int o = origins[i];
+                const LoadTree *tree = &scratch;
+                int slot = self->treeOf[o];
+                if (slot >= 0)
+                {
+                    // Slots are reserved before the loop; each origin is
+                    // handled by one task, so the tree has one writer
+                    if (self->trees[slot].order.empty())
+                        self->buildTree(o, self->trees[slot], dist);
+                    tree = &self->trees[slot];
+                }
+                else
+                    self->buildTree(o, scratch, dist);
+                self->addTrips(o, *tree, batch + starts[i], starts[i + 1] - starts[i], partial, demand);
+            }
+        }
+    };
+
+    static void addPartials(LoadPartial &into, const LoadPartial &from)
+    {
+        if (into.loads.empty())
+            into.loads = from.loads;
+        else
+            for (int i = 0; i < from.loads.size(); i++)
+                into.loads[i] += from.loads[i];
+        into.unrouted += from.unrouted;
+    }
+
+    static bool sameInts(const DynamicArray<int> &a, const DynamicArray<int> &b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (int i = 0; i < a.size(); i++)
+            if (a[i] != b[i])
+                return false;
+        return true;
+    }
+
+    // Dijkstra from vertex o over the whole network (as Graph::distancesFrom)
+    void buildTree(int o, LoadTree &tree, DynamicArray<int> &dist) const
+    {
+        int V = vertexIDs.size();
+        tree.order.clear();
+        tree.parent.clear();
+        tree.via.clear();
+        dist.clear();
+        tree.parent.reserve(V);
+        tree.via.reserve(V);
+        dist.reserve(V);
+        for (int v = 0; v < V; v++)
+        {
+            tree.parent.push_back(-1);
+            tree.via.push_back(-1);
+            dist.push_back(INT_MAX_VALUE);
+        }
+
+        MinHeap<Pair<int, int>> heap(V + 1); // (distance, vertex), lazy deletion; grows as needed
+        dist[o] = 0;
+        heap.insert(Pair<int, int>(0, o));
+        while (!heap.isEmpty())
+        {
+            Pair<int, int> top = heap.extractMin();
+            int u = top.second;
+            if (top.first > dist[u])
+                continue;
+            tree.order.push_back(u);
+            for (int e = offsets[u]; e < offsets[u + 1]; e++)
+            {
+                int v = targets[e];
+                int d = dist[u] + weights[e];
+                if (d < dist[v])
+                {
+                    dist[v] = d;
+                    tree.parent[v] = u;
+                    tree.via[v] = codes[e];
+                    heap.insert(Pair<int, int>(d, v));
+                }
+            }
+        }
+    }
+
+    // Put n trips per (destination, n) of origin o on the tree's paths
+    void addTrips(int o, const LoadTree &tree, const Pair<int, int> *trips, int count, LoadPartial &partial,
+                  DynamicArray<int> &demand) const
+    {
+        if (partial.loads.empty())
+            for (int i = 0; i < loads.size(); i++)
+                partial.loads.push_back(0);
+
+        // Few destinations: walk each path back to the origin
+        if (count * 8 < tree.order.size())
+        {
+            for (int i = 0; i < count; i++)
+            {
+                int d = trips[i].first;
+                int n = trips[i].second;
+                if (d != o && tree.parent[d] < 0)
+                {
+                    partial.unrouted += n;
+                    continue;
+                }
+                for (int v = d; v != o; v = tree.parent[v])
+                    partial.loads[tree.via[v]] += n;
+            }
+            return;
+        }
+
+        // Many: every reached vertex passes its trips (and those of the
+        // vertices behind it) to its parent, farthest first
+        if (demand.empty())
+            for (int v = 0; v < vertexIDs.size(); v++)
+                demand.push_back(0);
+        for (int i = 0; i < count; i++)
+        {
+            int d = trips[i].first;
+            if (d != o && tree.parent[d] < 0)
+                partial.unrouted += trips[i].second;
+            else
+                demand[d] += trips[i].second;
+        }
+        for (int i = tree.order.size() - 1; i > 0; i--)
+        {
+            int v = tree.order[i];
+            int n = demand[v];
+            if (n == 0)
+                continue;
+            partial.loads[tree.via[v]] += n;
+            demand[tree.parent[v]] += n;
+            demand[v] = 0;
+        }
+        demand[o] = 0;
+    }
+
+    // Rebuild the edge lists from net; keep the trees and loads if the
+    // routes are unchanged (e.g. only passenger counts differ)
+    void attach(const NetworkVersion &net)
+    {
+        const Graph &graph = net.graph;
+        int V = graph.vertexCount();
+        int R = net.routes.size();
+        DynamicArray<int> ids(V + 1);
+        for (int v = 0; v < V; v++)
+            ids.push_back(0);
+        for (int i = 0; i < net.stations.size(); i++)
+        {
+            int v = graph.getIndex(net.stations[i].getID());
+            if (v >= 0)
+                ids[v] = net.stations[i].getID();
+        }
+
+        // Endpoints (-1: route not in the graph or a loop) and degrees
+        DynamicArray<int> from(R + 1), to(R + 1), first(V + 1);
+        for (int v = 0; v <= V; v++)
+            first.push_back(0);
+        for (int r = 0; r < R; r++)
+        {
+            int u = graph.getIndex(net.routes[r].getStartStationID());
+            int v = graph.getIndex(net.routes[r].getEndStationID());
+            if (u < 0 || v < 0 || u == v)
+                u = v = -1;
+            from.push_back(u);
+            to.push_back(v);
+            if (u >= 0)
+            {
+                first[u + 1]++;
+                first[v + 1]++;
+            }
+        }
+        for (int v = 0; v < V; v++)
+            first[v + 1] += first[v];
+
+        // Each vertex's routes in slot order, both directions (Graph's order)
+        int E = first[V];
+        DynamicArray<int> target(E + 1), weight(E + 1), code(E + 1);
+        for (int e = 0; e < E; e++)
+        {
+            target.push_back(0);
+            weight.push_back(0);
+            code.push_back(0);
+        }
+        DynamicArray<int> cursor(first);
+        for (int r = 0; r < R; r++)
+        {
+            int u = from[r];
+            int v = to[r];
+            if (u < 0)
+                continue;
+            int w = (int)net.routes[r].getDistance();
+            target[cursor[u]] = v;
+            weight[cursor[u]] = w;
+            code[cursor[u]++] = 2 * r;
+            target[cursor[v]] = u;
+            weight[cursor[v]] = w;
+            code[cursor[v]++] = 2 * r + 1;
+        }
+
+        networkNumber = net.number;
+        if (routeCount == R && sameInts(ids, vertexIDs) && sameInts(first, offsets) && sameInts(target, targets) &&
+            sameInts(weight, weights) && sameInts(code, codes))
+            return;
+        routeCount = R;
+        vertexIDs.swap(ids);
+        offsets.swap(first);
+        targets.swap(target);
+        weights.swap(weight);
+        codes.swap(code);
+        treeOf.clear();
+        for (int v = 0; v < V; v++)
+            treeOf.push_back(-1);
+        trees.clear();
+        maxTrees = (int)(LOAD_TREE_CACHE_BYTES / (12LL * (V + 1)));
+        resetLoads();
+    }
+
+    void resetLoads()
+    {
+        loads.clear();
+        for (int i = 0; i < 2 * routeCount; i++)
+            loads.push_back(0);
+        assignedOf.clear();
+        routed = unrouted = 0;
+    }
+
+public:
+    LoadAssignment()
+        : networkNumber(-1), routeCount(0), maxTrees(0), odEpoch(-1), routed(0), unrouted(0)
+    {
+    }
+
+    // Bring the loads up to date with od's trips on net's routes
+    void assign(const NetworkVersion &net, const OdMatrix &od, ThreadPool &pool = ThreadPool::shared())
+    {
+        if (net.number != networkNumber)
+            attach(net);
+        if (od.epoch() != odEpoch)
+        {
+            resetLoads();
+            odEpoch = od.epoch();
+        }
+        if (assignedOf.size() == od.pairCount() && routed + unrouted == od.totalTrips())
+            return;
+        METRIC_TIMER("itnms_load_assignment_seconds", "Route load assignments (new trips only)");
+
+        // New trips per cell, grouped by origin vertex (counting sort)
+        int V = vertexIDs.size();
+        DynamicArray<int> starts(V + 1);
+        for (int v = 0; v <= V; v++)
+            starts.push_back(0);
+        DynamicArray<int> cellOrigins, cellDestinations, cellNew;
+        for (int c = 0; c < od.pairCount(); c++)
+        {
+            if (c == assignedOf.size())
+                assignedOf.push_back(0);
+            int n = od.cellTripCount(c) - assignedOf[c];
+            if (n == 0)
+                continue;
+            assignedOf[c] += n;
+            int o = net.graph.getIndex(od.cellOriginID(c));
+            int d = net.graph.getIndex(od.cellDestinationID(c));
+            if (o < 0 || d < 0)
+            {
+                unrouted += n;
+                continue;
+            }
+            cellOrigins.push_back(o);
+            cellDestinations.push_back(d);
+            cellNew.push_back(n);
+            starts[o + 1]++;
+        }
+        DynamicArray<int> origins;
+        for (int v = 0; v < V; v++)
+        {
+            if (starts[v + 1] > 0)
+                origins.push_back(v);
+            starts[v + 1] += starts[v];
+        }
+        DynamicArray<Pair<int, int>> batch(cellNew.size() + 1);
+        for (int i = 0; i < cellNew.size(); i++)
+            batch.push_back(Pair<int, int>());
+        DynamicArray<int> cursor(starts);
+        for (int i = 0; i < cellNew.size(); i++)
+            batch[cursor[cellOrigins[i]]++] = Pair<int, int>(cellDestinations[i], cellNew[i]);
+
+        // Per-origin ranges, cache slots reserved up front
+        DynamicArray<int> ranges(origins.size() + 1);
+        for (int i = 0; i < origins.size(); i++)
+        {
+            int o = origins[i];
+            ranges.push_back(starts[o]);
+            if (treeOf[o] < 0 && trees.size() < maxTrees)
+            {
+                treeOf[o] = trees.size();
+                trees.push_back(LoadTree());
+            }
+        }
+        ranges.push_back(cellNew.size());
+
+        AssignOrigins body;
+        body.self = this;
+        body.origins = origins.getRawArray();
+        body.starts = ranges.getRawArray();
+        body.batch = batch.getRawArray();
+        LoadPartial total = parallelReduce(pool, 0, origins.size(), 1, LoadPartial(), body, addPartials);
+        for (int i = 0; i < total.loads.size(); i++)
+            loads[i] += total.loads[i];
+        unrouted += total.unrouted;
+        routed = od.totalTrips() - unrouted;
+    }
+
+    // One entry per route of net (in route order); call assign() first
+    void routeLoads(const NetworkVersion &net, DynamicArray<RouteLoad> &out) const
+    {
+        out.clear();
+        out.reserve(net.routes.size());
+        for (int r = 0; r < net.routes.size(); r++)
+        {
+            const Route &route = net.routes[r];
+            int forward = 2 * r < loads.size() ? loads[2 * r] : 0;
+            int backward = 2 * r + 1 < loads.size() ? loads[2 * r + 1] : 0;
+            out.push_back(RouteLoad(route.getRouteID(), route.getStartStationID(), route.getEndStationID(), forward,
+                                    backward));
+        }
+    }
+
+    long long routedTrips() const { return routed; }
+    long long unroutedTrips() const { return unrouted; }
+    int cachedTrees() const { return trees.size(); }
+
+    // Charge the edge lists, cached trees and loads to memory
+    void setMemoryAccount(MemoryAccount *account)
+    {
+        vertexIDs.setMemoryAccount(account);
+        offsets.setMemoryAccount(account);
+        targets.setMemoryAccount(account);
+        weights.setMemoryAccount(account);
+        codes.setMemoryAccount(account);
+        treeOf.setMemoryAccount(account);
+        trees.setMemoryAccount(account);
+        loads.setMemoryAccount(account);
+        assignedOf.setMemoryAccount(account);
+    }
+
+    void measureMemory() const
+    {
+        vertexIDs.measureMemory();
+        offsets.measureMemory();
+        targets.measureMemory();
+        weights.measureMemory();
+        codes.measureMemory();
+        treeOf.measureMemory();
+        trees.measureMemory();
+        loads.measureMemory();
+        assignedOf.measureMemory();
+    }
+};
+
+#endif
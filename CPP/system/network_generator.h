@@ -0,0 +1,582 @@
+#ifndef NETWORK_GENERATOR_H
+#define NETWORK_GENERATOR_H
+
+#include <iostream>
+#include <string>
+#include <cmath>
+#include "../ds/array.h"
+#include "../ds/graph.h"
+#include "../models/station.h"
+#include "../models/route.h"
+#include "../models/vehicle.h"
+#include "../models/passenger.h"
+#include "../models/timestamp.h"
+#include "route_manager.h"
+#include "vehicle_manager.h"
+#include "ticket_manager.h"
+#include "ticket_store.h"
+
+using namespace std;
+
+enum NetworkTopology
+{
+    TOPOLOGY_GRID,       // city blocks: right/down neighbours, diagonals at >= 3 routes per station
+    TOPOLOGY_RADIAL,     // metro: spokes from a centre, ring lines at >= 2 routes per station
+    TOPOLOGY_SCALE_FREE, // preferential attachment: a few large hubs, many leaves
+    TOPOLOGY_GEOMETRIC   // random points, linked when closer than a radius
+};
+
+struct GeneratorOptions
+{
+    NetworkTopology topology;
+    int stations;            // station count
+    int routesPerStation;    // scale-free: links per new station; geometric: half the mean degree
+    int vehicles;            // vehicles to register
+    int passengers;          // passengers left waiting in the queue
+    int tickets;             // tickets issued over the simulated period
+    int ticketDays;          // length of that period, starting Monday 2024-01-01
+    unsigned long long seed; // same seed and options -> same network
+
+    GeneratorOptions()
+        : topology(TOPOLOGY_GRID), stations(1000), routesPerStation(2), vehicles(0), passengers(0), tickets(0),
+          ticketDays(7), seed(1) {}
+};
+
+// What populate() added
+struct GeneratorReport
+{
+    int stationsAdded;
+    int routesAdded;
+    int vehiclesAdded;
+    int passengersQueued;
+    int ticketsIssued;
+
+    GeneratorReport() : stationsAdded(0), routesAdded(0), vehiclesAdded(0), passengersQueued(0), ticketsIssued(0) {}
+};
+
+// SplitMix64-seeded xorshift64*: fast, and identical on every platform
+class GeneratorRng
+{
+private:
+    unsigned long long state;
+
+public:
+    GeneratorRng(unsigned long long seed)
+    {
+        unsigned long long z = seed + 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        state = (z ^ (z >> 31)) | 1;
+    }
+
+    unsigned long long next()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+
+    // Uniform int in [0, bound)
+    int nextInt(int bound) { return (int)((next() >> 11) % (unsigned long long)bound); }
+
+    // Uniform double in [0, 1)
+    double nextDouble() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+// Deterministic synthetic transit networks for scale testing
+//
+// The layout (station coordinates in km and the route edge list) is built
+// first; populate() then turns it into Stations, Routes, Vehicles, queued
+// Passengers and issued tickets and hands them to the managers' bulk APIs
+// (RouteManager::addBulk, VehicleManager::addBulk, mergeTickets), while
+// buildGraph() feeds just the topology to a Graph via addEdges. Nothing is
+// printed per item, so millions of stations and routes load in seconds.
+//
+// Route distances are straight-line km (at least 1, so integer graph
+// weights stay positive). Ticket trips are route hops half the time and
+// otherwise hub-weighted origin/destination pairs; issue times follow a
+// weekday commuter profile (morning and evening peaks, quieter weekends).
+class NetworkGenerator
+{
+private:
+    GeneratorOptions options;
+    GeneratorRng rng;
+    DynamicArray<double> xs, ys;        // station coordinates (km)
+    DynamicArray<int> from, to;         // route endpoints (station indices)
+    GeneratorReport report;
+
+    static double roundedDistance(double dx, double dy)
+    {
+        double d = floor(sqrt(dx * dx + dy * dy) * 10.0 + 0.5) / 10.0;
+        return d < 1.0 ? 1.0 : d;
+    }
+
+    void addPoint(double x, double y)
+    {
+        xs.push_back(x);
+        ys.push_back(y);
+    }
+
+    void addLink(int a, int b)
+    {
+        from.push_back(a);
+        to.push_back(b);
+    }
+
+    void layoutGrid(int n)
+    {
+        int side = (int)ceil(sqrt((double)n));
+        for (int k = 0; k < n; k++)
+            addPoint((k % side) * 1.5 + (rng.nextDouble() - 0.5) * 0.6,
+                     (k / side) * 1.5 + (rng.nextDouble() - 0.5) * 0.6);
+        for (int k = 0; k < n; k++)
+        {
+            int col = k % side;
+            if (col + 1 < side && k + 1 < n)
+                addLink(k, k + 1);
+            if (k + side < n)
+                addLink(k, k + side);
+            if (options.routesPerStation >= 3 && col + 1 < side && k + side + 1 < n)
+                addLink(k, k + side + 1);
+        }
+    }
+
+    // Station 0 is the centre; station i >= 1 sits on spoke (i - 1) % S,
+    // ring (i - 1) / S, so rings fill up outwards
+    void layoutRadial(int n)
+    {
+        int spokes = (int)sqrt(n / 3.0);
+        if (spokes < 3)
+            spokes = 3;
+        const double pi = 3.14159265358979323846;
+        addPoint(0.0, 0.0);
+        for (int i = 1; i < n; i++)
+        {
+            int spoke = (i - 1) % spokes, ring = (i - 1) / spokes;
+            double angle = 2.0 * pi * spoke / spokes + (rng.nextDouble() - 0.5) * 0.05;
+            double radius = 1.2 * (ring + 1) + (rng.nextDouble() - 0.5) * 0.3;
+            addPoint(radius * cos(angle), radius * sin(angle));
+        }
+        for (int i = 1; i < n; i++)
+        {
+            int spoke = (i - 1) % spokes, ring = (i - 1) / spokes;
+            addLink(ring == 0 ? 0 : i - spokes, i);
+            int next = 1 + ring * spokes + (spoke + 1) % spokes;
+            if (options.routesPerStation >= 2 && next < n && next != i)
+                addLink(i, next);
+        }
+    }
+
+    // Barabasi-Albert: every new station links to m distinct earlier ones,
+    // picked with probability proportional to their degree (a uniform pick
+    // from the list of all route endpoints so far)
+    void layoutScaleFree(int n)
+    {
+        int m = options.routesPerStation > 0 ? options.routesPerStation : 1;
+        double side = 2.0 * sqrt((double)n);
+        for (int k = 0; k < n; k++)
+            addPoint(rng.nextDouble() * side, rng.nextDouble() * side);
+
+        int seedNodes = m + 1 < n ? m + 1 : n;
+        long long slots = 2 * ((long long)n * m + (long long)seedNodes * seedNodes); // fits: checkOptions
+        DynamicArray<int> endpoints((int)slots);
+        for (int a = 0; a < seedNodes; a++)
+            for (int b = a + 1; b < seedNodes; b++)
+            {
+                addLink(a, b);
+                endpoints.push_back(a);
+                endpoints.push_back(b);
+            }
+
+        DynamicArray<int> picked(m);
+        for (int v = seedNodes; v < n; v++)
+        {
+            picked.clear();
+            while (picked.size() < m && picked.size() < v)
+            {
+                int t = endpoints.size() > 0 ? endpoints[rng.nextInt(endpoints.size())] : rng.nextInt(v);
+                bool seen = false;
+                for (int i = 0; i < picked.size(); i++)
+                    seen = seen || picked[i] == t;
+                if (!seen)
+                    picked.push_back(t);
+            }
+            for (int i = 0; i < picked.size(); i++)
+            {
+                addLink(picked[i], v);
+                endpoints.push_back(picked[i]);
+                endpoints.push_back(v);
+            }
+        }
+    }
+
+    // Points at 1 per 4 km^2; each pair closer than r is linked, found by
+    // bucketing points into r x r cells and checking the 3 x 3 neighbourhood.
+    // At low degree such graphs fall apart into islands, so components are
+    // then stitched together: walking the points in cell order, consecutive
+    // points of different components get a (short) link.
+    void layoutGeometric(int n)
+    {
+        int m = options.routesPerStation > 0 ? options.routesPerStation : 1;
+        const double pi = 3.14159265358979323846;
+        double side = 2.0 * sqrt((double)n);
+        double r = sqrt(8.0 * m / pi); // mean degree = density * pi * r^2 = 2m
+        int cells = (int)(side / r) + 1;
+        for (int k = 0; k < n; k++)
+            addPoint(rng.nextDouble() * side, rng.nextDouble() * side);
+
+        // Counting sort of points by cell
+        DynamicArray<int> cellStart(cells * cells + 1);
+        for (int c = 0; c <= cells * cells; c++)
+            cellStart.push_back(0);
+        DynamicArray<int> cellOf(n);
+        for (int k = 0; k < n; k++)
+        {
+            int c = (int)(ys[k] / r) * cells + (int)(xs[k] / r);
+            cellOf.push_back(c);
+            cellStart[c + 1]++;
+        }
+        for (int c = 0; c < cells * cells; c++)
+            cellStart[c + 1] += cellStart[c];
+        DynamicArray<int> fill(cellStart);
+        DynamicArray<int> members(n);
+        for (int k = 0; k < n; k++)
+            members.push_back(0);
+        for (int k = 0; k < n; k++)
+            members[fill[cellOf[k]]++] = k;
+
+        double r2 = r * r;
+        for (int k = 0; k < n; k++)
+        {
+            int cx = cellOf[k] % cells, cy = cellOf[k] / cells;
+            for (int y = cy - 1; y <= cy + 1; y++)
+            {
+                if (y < 0 || y >= cells)
+                    continue;
+                for (int x = cx - 1; x <= cx + 1; x++)
+                {
+                    if (x < 0 || x >= cells)
+                        continue;
+                    int c = y * cells + x;
+                    for (int i = cellStart[c]; i < cellStart[c + 1]; i++)
+                    {
+                        int j = members[i];
+                        double dx = xs[j] - xs[k], dy = ys[j] - ys[k];
+                        if (j > k && dx * dx + dy * dy <= r2)
+                            addLink(k, j);
+                    }
+                }
+            }
+        }
+
+        DynamicArray<int> component(n); // union-find parents
+        for (int k = 0; k < n; k++)
+            component.push_back(k);
+        for (int e = 0; e < from.size(); e++)
+            unite(component, from[e], to[e]);
+        for (int i = 1; i < n; i++)
+            if (unite(component, members[i - 1], members[i]))
+                addLink(members[i - 1], members[i]);
+    }
+
+    static int findRoot(DynamicArray<int> &parent, int k)
+    {
+        while (parent[k] != k)
+        {
+            parent[k] = parent[parent[k]]; // path halving
+            k = parent[k];
+        }
+        return k;
+    }
+
+    // Merge the components of a and b; false if they were already one
+    static bool unite(DynamicArray<int> &parent, int a, int b)
+    {
+        a = findRoot(parent, a);
+        b = findRoot(parent, b);
+        if (a == b)
+            return false;
+        if (a < b)
+            parent[b] = a;
+        else
+            parent[a] = b;
+        return true;
+    }
+
+    // Build coordinates and the edge list once; false if the options are
+    // out of range
+    bool layout()
+    {
+        if (xs.size() > 0 || options.stations <= 0)
+            return true;
+        string why;
+        if (!checkOptions(options, why))
+        {
+            cout << "ERROR: " << why << endl;
+            return false;
+        }
+        int n = options.stations;
+        xs.reserve(n);
+        ys.reserve(n);
+        switch (options.topology)
+        {
+        case TOPOLOGY_GRID:
+            layoutGrid(n);
+            break;
+        case TOPOLOGY_RADIAL:
+            layoutRadial(n);
+            break;
+        case TOPOLOGY_SCALE_FREE:
+            layoutScaleFree(n);
+            break;
+        case TOPOLOGY_GEOMETRIC:
+            layoutGeometric(n);
+            break;
+        }
+        return true;
+    }
+
+    string stationName(int k) const
+    {
+        switch (options.topology)
+        {
+        case TOPOLOGY_GRID:
+            return "Block " + to_string(k);
+        case TOPOLOGY_RADIAL:
+            return "Metro " + to_string(k);
+        case TOPOLOGY_SCALE_FREE:
+            return "Hub " + to_string(k);
+        default:
+            return "Stop " + to_string(k);
+        }
+    }
+
+    // Relative demand per hour of the week (weekdays peak at 8:00 and 17:00)
+    static double hourWeight(int hourOfPeriod)
+    {
+        static const double weekday[24] = {0.1, 0.05, 0.05, 0.05, 0.1, 0.4, 1.2, 2.6, 3.0, 1.8, 1.0, 1.0,
+                                           1.1, 1.0, 1.0, 1.2, 2.0, 2.8, 2.4, 1.4, 0.9, 0.7, 0.5, 0.3};
+        int day = hourOfPeriod / 24 % 7; // day 0 is a Monday
+        return weekday[hourOfPeriod % 24] * (day >= 5 ? 0.6 : 1.0);
+    }
+
+    // Origin/destination for one ticket, as station indices
+    void pickTrip(int &start, int &end)
+    {
+        int e = rng.nextInt(from.size());
+        start = from[e];
+        end = to[e];
+        if (rng.nextInt(2) == 0)
+            return; // a single route hop
+        // Any pair, with busy (high-degree) stations more likely at both ends
+        int e1 = rng.nextInt(from.size()), e2 = rng.nextInt(from.size());
+        int a = rng.nextInt(2) ? from[e1] : to[e1];
+        int b = rng.nextInt(2) ? from[e2] : to[e2];
+        if (a != b)
+        {
+            start = a;
+            end = b;
+        }
+    }
+
+    // Issue the ticket stream in chunks, so memory stays bounded for any count.
+    // Issue times are the quantiles (i + u) / n of the hourly demand profile,
+    // so they come out in order without sorting. Stops at the first chunk
+    // the manager rejects (its IDs are given back) and returns false.
+    bool issueTickets(TicketManager &tickets, int stationBase, int passengerBase)
+    {
+        int n = options.tickets;
+        if (n <= 0 || from.size() == 0)
+            return true;
+        int hours = (options.ticketDays > 0 ? options.ticketDays : 1) * 24;
+        DynamicArray<double> cumulative(hours + 1);
+        cumulative.push_back(0.0);
+        for (int h = 0; h < hours; h++)
+            cumulative.push_back(cumulative[h] + hourWeight(h));
+        double total = cumulative[hours];
+        Timestamp base = makeTimestamp(2024, 1, 1);
+
+        const int chunk = 1 << 18;
+        DynamicArray<TicketRecord> records(n < chunk ? n : chunk);
+        int hour = 0;
+        for (int done = 0; done < n;)
+        {
+            int count = n - done < chunk ? n - done : chunk;
+            int firstID = tickets.allocateTicketIDs(count);
+            records.clear();
+            for (int i = 0; i < count; i++)
+            {
+                double u = (done + i + rng.nextDouble()) / n * total;
+                while (hour + 1 < hours && cumulative[hour + 1] <= u)
+                    hour++;
+                double within = (u - cumulative[hour]) / hourWeight(hour);
+                int start, end;
+                pickTrip(start, end);
+
+                TicketRecord r;
+                r.ticketID = firstID + i;
+                int pid = passengerBase + done + i;
+                r.passenger = Passenger(pid, "Rider " + to_string(pid), 5 + rng.nextInt(80));
+                r.startStationID = stationBase + start;
+                r.endStationID = stationBase + end;
+                r.issueTime = base + (Timestamp)hour * 3600 + (Timestamp)(within * 3600.0);
+                records.push_back(r);
+            }
+            if (!tickets.mergeTickets(records))
+            {
+                tickets.releaseTicketIDs(firstID, count);
+                return false;
+            }
+            done += count;
+            report.ticketsIssued = done;
+        }
+        return true;
+    }
+
+public:
+    NetworkGenerator(const GeneratorOptions &opts) : options(opts), rng(opts.seed) {}
+
+    // False (with why set) if the network the options describe would not
+    // fit the int-indexed route arrays. Scale-free layouts keep two
+    // endpoint slots per link; geometric ones average routesPerStation
+    // links per station.
+    static bool checkOptions(const GeneratorOptions &o, string &why)
+    {
+        long long n = o.stations > 0 ? o.stations : 0;
+        long long m = o.routesPerStation > 0 ? o.routesPerStation : 1;
+        long long slots = 0;
+        if (o.topology == TOPOLOGY_SCALE_FREE)
+        {
+            long long seedNodes = m + 1 < n ? m + 1 : n;
+            slots = 2 * (n * m + seedNodes * seedNodes);
+        }
+        else if (o.topology == TOPOLOGY_GEOMETRIC)
+            slots = 2 * n * m; // headroom over the expected n * m links
+        if (slots > INT_MAX_VALUE)
+        {
+            why = "too many routes: " + to_string(n) + " stations x " + to_string(m) +
+                  " routes per station exceeds the route arrays";
+            return false;
+        }
+        return true;
+    }
+
+    // Station coordinates and edge list, without touching any manager
+    int stationCount()
+    {
+        layout();
+        return xs.size();
+    }
+
+    int routeCount()
+    {
+        layout();
+        return from.size();
+    }
+
+    // Load only the topology into g: vertices firstID .. firstID + n - 1 and
+    // one edge per route weighted by its distance. Returns the edge count.
+    int buildGraph(Graph &g, int firstID = 1)
+    {
+        layout();
+        int n = xs.size(), m = from.size();
+        g.reserveVertices(n);
+        for (int k = 0; k < n; k++)
+            g.addVertex(firstID + k);
+        DynamicArray<int> a(m), b(m), w(m);
+        for (int e = 0; e < m; e++)
+        {
+            a.push_back(firstID + from[e]);
+            b.push_back(firstID + to[e]);
+            w.push_back((int)roundedDistance(xs[to[e]] - xs[from[e]], ys[to[e]] - ys[from[e]]));
+        }
+        return g.addEdges(a.getRawArray(), b.getRawArray(), w.getRawArray(), m);
+    }
+
+    // Add the whole network to the managers. Station, route and vehicle IDs
+    // continue after the largest existing ones, so an existing network is
+    // extended, never overwritten. False if the options are out of range or
+    // a manager rejected part of the data; the report counts what was added.
+    bool populate(RouteManager &routes, VehicleManager &vehicles, TicketManager &tickets)
+    {
+        if (!layout())
+            return false;
+        int stationBase = 1, routeBase = 1, vehicleBase = 1;
+        const DynamicArray<Station> &oldStations = routes.getStations();
+        const DynamicArray<Route> &oldRoutes = routes.getRoutes();
+        const DynamicArray<Vehicle> &oldVehicles = vehicles.getVehicles();
+        for (int i = 0; i < oldStations.size(); i++)
+            if (oldStations[i].getID() >= stationBase)
+                stationBase = oldStations[i].getID() + 1;
+        for (int i = 0; i < oldRoutes.size(); i++)
+            if (oldRoutes[i].getRouteID() >= routeBase)
+                routeBase = oldRoutes[i].getRouteID() + 1;
+        for (int i = 0; i < oldVehicles.size(); i++)
+            if (oldVehicles[i].getID() >= vehicleBase)
+                vehicleBase = oldVehicles[i].getID() + 1;
+
+        int n = xs.size(), m = from.size();
+        {
+            DynamicArray<Station> newStations(n);
+            for (int k = 0; k < n; k++)
+                newStations.push_back(Station(stationBase + k, stationName(k), "Zone " + to_string(1 + k % 16)));
+            DynamicArray<Route> newRoutes(m);
+            for (int e = 0; e < m; e++)
+                newRoutes.push_back(Route(routeBase + e, stationBase + from[e], stationBase + to[e],
+                                          roundedDistance(xs[to[e]] - xs[from[e]], ys[to[e]] - ys[from[e]])));
+            int stationsBefore = oldStations.size(), routesBefore = oldRoutes.size();
+            bool stored = routes.addBulk(newStations, newRoutes);
+            report.stationsAdded = oldStations.size() - stationsBefore;
+            report.routesAdded = oldRoutes.size() - routesBefore;
+            if (!stored)
+                return false;
+        }
+
+        static const char *kinds[] = {"Bus", "Tram", "Metro", "Regional"};
+        static const int capacities[] = {60, 180, 900, 400};
+        DynamicArray<Vehicle> newVehicles(options.vehicles > 0 ? options.vehicles : 1);
+        for (int i = 0; i < options.vehicles; i++)
+        {
+            int kind = rng.nextInt(4);
+            int capacity = capacities[kind] * (8 + rng.nextInt(5)) / 10;
+            newVehicles.push_back(Vehicle(vehicleBase + i, string(kinds[kind]) + " " + to_string(vehicleBase + i), capacity));
+        }
+        int vehiclesBefore = oldVehicles.size();
+        bool stored = vehicles.addBulk(newVehicles);
+        report.vehiclesAdded = oldVehicles.size() - vehiclesBefore;
+        if (!stored)
+            return false;
+
+        DynamicArray<Passenger> waiting(options.passengers > 0 ? options.passengers : 1);
+        for (int i = 0; i < options.passengers; i++)
+            waiting.push_back(Passenger(1 + i, "Rider " + to_string(1 + i), 5 + rng.nextInt(80)));
+        int queuedBefore = tickets.queueSize();
+        stored = tickets.addPassengersToQueue(waiting);
+        report.passengersQueued = tickets.queueSize() - queuedBefore;
+        if (!stored)
+            return false;
+
+        return issueTickets(tickets, stationBase, 1 + options.passengers);
+    }
+
+    const GeneratorReport &getReport() const { return report; }
+
+    // "grid", "radial", "scale-free" or "geometric"; false if unknown
+    static bool parseTopology(const string &name, NetworkTopology &topology)
+    {
+        if (name == "grid")
+            topology = TOPOLOGY_GRID;
+        else if (name == "radial")
+            topology = TOPOLOGY_RADIAL;
+        else if (name == "scale-free")
+            topology = TOPOLOGY_SCALE_FREE;
+        else if (name == "geometric")
+            topology = TOPOLOGY_GEOMETRIC;
+        else
+            return false;
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,633 @@
+#ifndef NETWORK_IMAGE_H
+#define NETWORK_IMAGE_H
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include "../ds/array.h"
+#include "../ds/binary_stream.h"
+#include "../ds/mapped_file.h"
+#include "../ds/output_sink.h"
+#include "../ds/csr_graph.h"
+#include "../ds/id_index.h"
+#include "../ds/searching.h"
+#include "../ds/sorting.h"
+#include "../models/station.h"
+#include "../models/route.h"
+#include "durable_file.h"
+
+using namespace std;
+
+// Read-only network image, laid out to be queried straight from mmap
+//
+// Every array is 8-byte aligned at a file offset recorded in the header, so
+// once the file is mapped the arrays are used in place: no parsing, no
+// copying, and pages are shared between all processes mapping the image.
+//
+//   stations  IDs, passenger counts, (name, location) refs into the string
+//             table, IDs sorted with their slots (binary search by ID) and
+//             an open-addressing table of lower-cased names
+//   graph     CSR: edgeOffsets[V + 1], edgeTargets/Weights/Routes[E]; vertex
+//             i is station slot i, edges appear in Graph adjacency order
+//   routes    IDs, endpoints, distances, IDs sorted with their slots
+//   strings   one blob of UTF-8 bytes
+
+#define NETWORK_IMAGE_VERSION 1
+#define NETWORK_IMAGE_BYTE_ORDER 0x01020304u
+
+struct NetworkImageHeader
+{
+    char magic[8]; // "ITNMIMG1"
+    unsigned int version;
+    unsigned int byteOrder;
+    int stationCount;
+    int routeCount;
+    int edgeCount;     // directed edges, two per route
+    int nameSlotCount; // power of two
+    long long fileSize;
+    unsigned int payloadCrc; // CRC-32 of every byte after the header
+    unsigned int headerCrc;  // CRC-32 of the header bytes before this field
+
+    // File offsets of each array
+    long long stationIDs;
+    long long stationPassengers;
+    long long stationStrings; // 4 ints per station: name off/len, location off/len
+    long long sortedStationIDs;
+    long long sortedStationSlots;
+    long long nameSlots; // station slot + 1, 0 = empty
+    long long edgeOffsets;
+    long long edgeTargets;
+    long long edgeWeights;
+    long long edgeRoutes; // route slot of each edge
+    long long routeIDs;
+    long long routeStarts;
+    long long routeEnds;
+    long long routeDistances;
+    long long sortedRouteIDs;
+    long long sortedRouteSlots;
+    long long stringData;
+    long long stringBytes;
+};
+
+class NetworkImage
+{
+private:
+    MappedFile file;
+    const NetworkImageHeader *header;
+
+    const int *stationIDs;
+    const int *stationPassengers;
+    const int *stationStrings;
+    const int *sortedStationIDs;
+    const int *sortedStationSlots;
+    const int *nameSlots;
+    const int *edgeRoutes;
+    const int *routeIDs;
+    const int *routeStarts;
+    const int *routeEnds;
+    const double *routeDistances;
+    const int *sortedRouteIDs;
+    const int *sortedRouteSlots;
+    const char *strings;
+
+    CsrGraphView graph;
+
+    static int stationIDKey(const Station &s) { return s.getID(); }
+    static int routeIDKey(const Route &r) { return r.getRouteID(); }
+
+    static string toLower(const string &s)
+    {
+        string out = s;
+        for (int i = 0; i < (int)out.size(); i++)
+        {
+            if (out[i] >= 'A' && out[i] <= 'Z')
+                out[i] = out[i] + ('a' - 'A');
+        }
+        return out;
+    }
+
+    // FNV-1a of the lower-cased bytes
+    static unsigned int hashName(const char *s, int n)
+    {
+        unsigned int h = 2166136261u;
+        for (int i = 0; i < n; i++)
+        {
+            char c = s[i];
+            if (c >= 'A' && c <= 'Z')
+                c = c + ('a' - 'A');
+            h ^= (unsigned char)c;
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    static bool sameNameIgnoreCase(const char *a, int n, const string &lowerB)
+    {
+        if (n != (int)lowerB.size())
+            return false;
+        for (int i = 0; i < n; i++)
+        {
+            char c = a[i];
+            if (c >= 'A' && c <= 'Z')
+                c = c + ('a' - 'A');
+            if (c != lowerB[i])
+                return false;
+        }
+        return true;
+    }
+
+    // Append an int array at an 8-byte boundary; returns its file offset
+    static long long writeInts(BinaryWriter &out, const int *values, int n)
+    {
+        out.alignTo(8);
+        long long offset = out.size();
+        out.writeBytes(values, (long long)n * sizeof(int));
+        return offset;
+    }
+
+    // Does [offset, offset + n * elemSize) lie inside the file, aligned?
+    bool inFile(long long offset, long long n, long long elemSize) const
+    {
+        return offset >= (long long)sizeof(NetworkImageHeader) && offset % 8 == 0 && n >= 0 &&
+               offset + n * elemSize <= file.size();
+    }
+
+    template <typename T>
+    const T *at(long long offset) const
+    {
+        return (const T *)(file.data() + offset);
+    }
+
+    // Does every stored index point inside its array? CSR offsets rise from
+    // 0 to E, edge targets/routes, sorted slots, name slots and string refs
+    // are in range, the name table holds at most one entry per station, and
+    // edge weights are non-negative with a total below INT_MAX (so no path
+    // length overflows). One pass over the index arrays; the CRC is not read.
+    bool indicesInRange(const NetworkImageHeader *h) const
+    {
+        int S = h->stationCount, R = h->routeCount, E = h->edgeCount;
+        const int *offsets = at<int>(h->edgeOffsets);
+        if (offsets[0] != 0 || offsets[S] != E)
+            return false;
+        for (int i = 0; i < S; i++)
+            if (offsets[i] > offsets[i + 1])
+                return false;
+        const int *targets = at<int>(h->edgeTargets);
+        const int *weights = at<int>(h->edgeWeights);
+        const int *routesOf = at<int>(h->edgeRoutes);
+        long long totalWeight = 0;
+        for (int e = 0; e < E; e++)
+        {
+            if ((unsigned int)targets[e] >= (unsigned int)S || (unsigned int)routesOf[e] >= (unsigned int)R ||
+                weights[e] < 0)
+                return false;
+            totalWeight += weights[e];
+        }
+        if (totalWeight >= INT_MAX_VALUE)
+            return false;
+
+        const int *slots = at<int>(h->sortedStationSlots);
+        const int *refs = at<int>(h->stationStrings);
+        for (int i = 0; i < S; i++)
+        {
+            if ((unsigned int)slots[i] >= (unsigned int)S)
+                return false;
+            for (int k = 4 * i; k < 4 * i + 4; k += 2)
+                if (refs[k] < 0 || refs[k + 1] < 0 || (long long)refs[k] + refs[k + 1] > h->stringBytes)
+                    return false;
+        }
+        // At most one name slot per station, so with nameSlotCount > 2S more
+        // than half the table is empty and every probe ends
+        const int *names = at<int>(h->nameSlots);
+        int occupied = 0;
+        for (int i = 0; i < h->nameSlotCount; i++)
+        {
+            if (names[i] < 0 || names[i] > S)
+                return false;
+            if (names[i] != 0)
+                occupied++;
+        }
+        if (occupied > S)
+            return false;
+        const int *routeSlots = at<int>(h->sortedRouteSlots);
+        for (int r = 0; r < R; r++)
+            if ((unsigned int)routeSlots[r] >= (unsigned int)R)
+                return false;
+        return true;
+    }
+
+    string stringAt(int offset, int length) const
+    {
+        return string(strings + offset, length);
+    }
+
+public:
+    NetworkImage() : header(nullptr) {}
+
+    // Write an image of the given stations and routes. Routes whose
+    // endpoints are not in stations are skipped (RouteManager never has any).
+    // True only once the image is fsynced and renamed into place.
+    static bool write(const string &path, const DynamicArray<Station> &stations, const DynamicArray<Route> &routes)
+    {
+        int S = stations.size();
+        IdIndex slotOf;
+        slotOf.reserve(S);
+        for (int i = 0; i < S; i++)
+            if (!slotOf.contains(stations[i].getID()))
+                slotOf.insert(stations[i].getID(), i);
+
+        // CSR in Graph::addEdge order: route r adds start->end, then end->start
+        DynamicArray<int> usable(routes.size() + 1);
+        DynamicArray<int> offsets(S + 1);
+        for (int i = 0; i <= S; i++)
+            offsets.push_back(0);
+        for (int r = 0; r < routes.size(); r++)
+        {
+            int u = slotOf.find(routes[r].getStartStationID());
+            int v = slotOf.find(routes[r].getEndStationID());
+            if (u < 0 || v < 0)
+                continue;
+            usable.push_back(r);
+            offsets[u + 1]++;
+            offsets[v + 1]++;
+        }
+        for (int i = 0; i < S; i++)
+            offsets[i + 1] += offsets[i];
+        int E = offsets[S];
+
+        DynamicArray<int> cursor(S + 1), targets(E + 1), weights(E + 1), edgeRoute(E + 1);
+        for (int i = 0; i < S; i++)
+            cursor.push_back(offsets[i]);
+        for (int e = 0; e < E; e++)
+        {
+            targets.push_back(0);
+            weights.push_back(0);
+            edgeRoute.push_back(0);
+        }
+        for (int k = 0; k < usable.size(); k++)
+        {
+            const Route &route = routes[usable[k]];
+            int u = slotOf.find(route.getStartStationID());
+            int v = slotOf.find(route.getEndStationID());
+            int w = (int)route.getDistance();
+            int e = cursor[u]++;
+            targets[e] = v;
+            weights[e] = w;
+            edgeRoute[e] = usable[k];
+            e = cursor[v]++;
+            targets[e] = u;
+            weights[e] = w;
+            edgeRoute[e] = usable[k];
+        }
+
+        // Station columns and string table
+        DynamicArray<int> ids(S + 1), passengers(S + 1), stringRefs(4 * S + 1);
+        BinaryWriter blob(1 << 16);
+        for (int i = 0; i < S; i++)
+        {
+            ids.push_back(stations[i].getID());
+            passengers.push_back(stations[i].getPassengerCount());
+            string name = stations[i].getName();
+            string location = stations[i].getLocation();
+            stringRefs.push_back((int)blob.size());
+            stringRefs.push_back((int)name.size());
+            blob.writeBytes(name.data(), (long long)name.size());
+            stringRefs.push_back((int)blob.size());
+            stringRefs.push_back((int)location.size());
+            blob.writeBytes(location.data(), (long long)location.size());
+        }
+
+        // Sorted ID indexes (stable radix sort of slots by ID)
+        DynamicArray<int> stationOrder(S + 1), sortedIDs(S + 1);
+        radixSortIndices(stations, stationIDKey, stationOrder, true);
+        for (int i = 0; i < S; i++)
+            sortedIDs.push_back(stations[stationOrder[i]].getID());
+
+        int R = routes.size();
+        DynamicArray<int> routeOrder(R + 1), sortedRoutes(R + 1), rIDs(R + 1), rStarts(R + 1), rEnds(R + 1);
+        DynamicArray<double> rDistances(R + 1);
+        radixSortIndices(routes, routeIDKey, routeOrder, true);
+        for (int r = 0; r < R; r++)
+        {
+            sortedRoutes.push_back(routes[routeOrder[r]].getRouteID());
+            rIDs.push_back(routes[r].getRouteID());
+            rStarts.push_back(routes[r].getStartStationID());
+            rEnds.push_back(routes[r].getEndStationID());
+            rDistances.push_back(routes[r].getDistance());
+        }
+
+        // Name table: first station with a given (case-insensitive) name wins,
+        // matching RouteManager::findStationIdByName
+        int slotCount = 16;
+        while (slotCount < 2 * S + 2)
+            slotCount *= 2;
+        DynamicArray<int> names(slotCount);
+        for (int i = 0; i < slotCount; i++)
+            names.push_back(0);
+        for (int i = 0; i < S; i++)
+        {
+            string lower = toLower(stations[i].getName());
+            unsigned int h = hashName(lower.data(), (int)lower.size()) & (slotCount - 1);
+            bool duplicate = false;
+            while (names[h] != 0)
+            {
+                if (toLower(stations[names[h] - 1].getName()) == lower)
+                {
+                    duplicate = true;
+                    break;
+                }
+                h = (h + 1) & (slotCount - 1);
+            }
+            if (!duplicate)
+                names[h] = i + 1;
+        }
+
+        NetworkImageHeader hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        memcpy(hdr.magic, "ITNMIMG1", 8);
+        hdr.version = NETWORK_IMAGE_VERSION;
+        hdr.byteOrder = NETWORK_IMAGE_BYTE_ORDER;
+        hdr.stationCount = S;
+        hdr.routeCount = R;
+        hdr.edgeCount = E;
+        hdr.nameSlotCount = slotCount;
+
+        BinaryWriter out(1 << 20);
+        out.writeBytes(&hdr, sizeof(hdr)); // placeholder, patched below
+        hdr.stationIDs = writeInts(out, ids.getRawArray(), S);
+        hdr.stationPassengers = writeInts(out, passengers.getRawArray(), S);
+        hdr.stationStrings = writeInts(out, stringRefs.getRawArray(), 4 * S);
+        hdr.sortedStationIDs = writeInts(out, sortedIDs.getRawArray(), S);
+        hdr.sortedStationSlots = writeInts(out, stationOrder.getRawArray(), S);
+        hdr.nameSlots = writeInts(out, names.getRawArray(), slotCount);
+        hdr.edgeOffsets = writeInts(out, offsets.getRawArray(), S + 1);
+        hdr.edgeTargets = writeInts(out, targets.getRawArray(), E);
+        hdr.edgeWeights = writeInts(out, weights.getRawArray(), E);
+        hdr.edgeRoutes = writeInts(out, edgeRoute.getRawArray(), E);
+        hdr.routeIDs = writeInts(out, rIDs.getRawArray(), R);
+        hdr.routeStarts = writeInts(out, rStarts.getRawArray(), R);
+        hdr.routeEnds = writeInts(out, rEnds.getRawArray(), R);
+        out.alignTo(8);
+        hdr.routeDistances = out.size();
+        out.writeBytes(rDistances.getRawArray(), (long long)R * sizeof(double));
+        hdr.sortedRouteIDs = writeInts(out, sortedRoutes.getRawArray(), R);
+        hdr.sortedRouteSlots = writeInts(out, routeOrder.getRawArray(), R);
+        out.alignTo(8);
+        hdr.stringData = out.size();
+        hdr.stringBytes = blob.size();
+        out.writeBytes(blob.bytes(), blob.size());
+        out.alignTo(8);
+
+        hdr.fileSize = out.size();
+        hdr.payloadCrc = crc32(out.bytes() + sizeof(hdr), out.size() - (long long)sizeof(hdr));
+        hdr.headerCrc = crc32((const char *)&hdr, (const char *)&hdr.headerCrc - (const char *)&hdr);
+        out.patchBytes(0, &hdr, sizeof(hdr));
+
+        return DurableFile::replace(path, out.bytes(), out.size());
+    }
+
+    // Map an image. The header, array bounds and every stored index are
+    // checked (linear in stations and edges, no CRC pass), so queries never
+    // read outside the mapping; call verify() to also check the payload CRC.
+    bool open(const string &path)
+    {
+        close();
+        if (!file.open(path))
+        {
+            cerr << "Cannot open network image " << path << endl;
+            return false;
+        }
+
+        const NetworkImageHeader *h = at<NetworkImageHeader>(0);
+        bool ok = file.size() >= (long long)sizeof(NetworkImageHeader) && memcmp(h->magic, "ITNMIMG1", 8) == 0 &&
+                  crc32((const char *)h, (const char *)&h->headerCrc - (const char *)h) == h->headerCrc &&
+                  h->version == NETWORK_IMAGE_VERSION && h->byteOrder == NETWORK_IMAGE_BYTE_ORDER &&
+                  h->fileSize == file.size();
+        if (ok)
+        {
+            long long S = h->stationCount, R = h->routeCount, E = h->edgeCount;
+            ok = S >= 0 && R >= 0 && E >= 0 && h->nameSlotCount > 2 * S && (h->nameSlotCount & (h->nameSlotCount - 1)) == 0 &&
+                 inFile(h->stationIDs, S, 4) && inFile(h->stationPassengers, S, 4) &&
+                 inFile(h->stationStrings, 4 * S, 4) && inFile(h->sortedStationIDs, S, 4) &&
+                 inFile(h->sortedStationSlots, S, 4) && inFile(h->nameSlots, h->nameSlotCount, 4) &&
+                 inFile(h->edgeOffsets, S + 1, 4) && inFile(h->edgeTargets, E, 4) &&
+                 inFile(h->edgeWeights, E, 4) && inFile(h->edgeRoutes, E, 4) &&
+                 inFile(h->routeIDs, R, 4) && inFile(h->routeStarts, R, 4) && inFile(h->routeEnds, R, 4) &&
+                 inFile(h->routeDistances, R, 8) && inFile(h->sortedRouteIDs, R, 4) &&
+                 inFile(h->sortedRouteSlots, R, 4) && inFile(h->stringData, h->stringBytes, 1) &&
+                 indicesInRange(h);
+        }
+        if (!ok)
+        {
+            cerr << "Not a valid network image: " << path << endl;
+            file.close();
+            return false;
+        }
+
+        header = h;
+        stationIDs = at<int>(h->stationIDs);
+        stationPassengers = at<int>(h->stationPassengers);
+        stationStrings = at<int>(h->stationStrings);
+        sortedStationIDs = at<int>(h->sortedStationIDs);
+        sortedStationSlots = at<int>(h->sortedStationSlots);
+        nameSlots = at<int>(h->nameSlots);
+        edgeRoutes = at<int>(h->edgeRoutes);
+        routeIDs = at<int>(h->routeIDs);
+        routeStarts = at<int>(h->routeStarts);
+        routeEnds = at<int>(h->routeEnds);
+        routeDistances = at<double>(h->routeDistances);
+        sortedRouteIDs = at<int>(h->sortedRouteIDs);
+        sortedRouteSlots = at<int>(h->sortedRouteSlots);
+        strings = at<char>(h->stringData);
+        graph.attach(h->stationCount, stationIDs, at<int>(h->edgeOffsets), at<int>(h->edgeTargets), at<int>(h->edgeWeights));
+        return true;
+    }
+
+    // Full integrity check: the payload CRC (reads the whole file once;
+    // index bounds were already checked by open)
+    bool verify() const
+    {
+        if (!header)
+            return false;
+        return crc32(file.data() + sizeof(NetworkImageHeader), file.size() - (long long)sizeof(NetworkImageHeader)) ==
+               header->payloadCrc;
+    }
+
+    // Open and verify an image and copy out its stations and routes, e.g. to
+    // load it back into a RouteManager. Duplicate IDs (first one wins),
+    // non-positive station IDs and routes with unknown endpoints are dropped.
+    static bool load(const string &path, DynamicArray<Station> &stations, DynamicArray<Route> &routes)
+    {
+        NetworkImage image;
+        if (!image.open(path))
+            return false;
+        if (!image.verify())
+        {
+            cerr << "Network image " << path << " is corrupt" << endl;
+            return false;
+        }
+        stations.clear();
+        routes.clear();
+        stations.reserve(image.totalStations());
+        routes.reserve(image.totalRoutes());
+        for (int i = 0; i < image.totalStations(); i++)
+            if (image.stationIDs[i] > 0 && image.stationSlot(image.stationIDs[i]) == i)
+                stations.push_back(image.stationAt(i));
+        for (int r = 0; r < image.totalRoutes(); r++)
+            if (image.routeSlot(image.routeIDs[r]) == r && image.routeStarts[r] > 0 && image.routeEnds[r] > 0 &&
+                Route::validDistance(image.routeDistances[r]) &&
+                image.stationExists(image.routeStarts[r]) && image.stationExists(image.routeEnds[r]))
+                routes.push_back(image.routeAt(r));
+        return true;
+    }
+
+    void close()
+    {
+        file.close();
+        header = nullptr;
+        graph.attach(0, nullptr, nullptr, nullptr, nullptr);
+    }
+
+    bool isOpen() const { return header != nullptr; }
+    bool isMapped() const { return file.isMapped(); }
+
+    int totalStations() const { return header ? header->stationCount : 0; }
+    int totalRoutes() const { return header ? header->routeCount : 0; }
+    const CsrGraphView &getGraph() const { return graph; }
+
+    // Station slot for an ID, or -1 (binary search over the sorted IDs)
+    int stationSlot(int stationID) const
+    {
+        int n = totalStations();
+        int i = lowerBound(sortedStationIDs, n, stationID);
+        return (i < n && sortedStationIDs[i] == stationID) ? sortedStationSlots[i] : -1;
+    }
+
+    // Route slot for an ID, or -1
+    int routeSlot(int routeID) const
+    {
+        int n = totalRoutes();
+        int i = lowerBound(sortedRouteIDs, n, routeID);
+        return (i < n && sortedRouteIDs[i] == routeID) ? sortedRouteSlots[i] : -1;
+    }
+
+    bool stationExists(int stationID) const { return stationSlot(stationID) >= 0; }
+
+    string stationName(int slot) const { return stringAt(stationStrings[4 * slot], stationStrings[4 * slot + 1]); }
+    string stationLocation(int slot) const { return stringAt(stationStrings[4 * slot + 2], stationStrings[4 * slot + 3]); }
+
+    Station stationAt(int slot) const
+    {
+        Station s(stationIDs[slot], stationName(slot), stationLocation(slot));
+        s.setPassengerCount(stationPassengers[slot]);
+        return s;
+    }
+
+    Route routeAt(int slot) const
+    {
+        return Route(routeIDs[slot], routeStarts[slot], routeEnds[slot], routeDistances[slot]);
+    }
+
+    // Same contract as RouteManager::getStationNameById
+    string getStationNameById(int stationID) const
+    {
+        int slot = stationSlot(stationID);
+        if (slot < 0)
+            return "ID " + to_string(stationID);
+        return stationName(slot);
+    }
+
+    // Same contract as RouteManager::findStationIdByName, but O(1)
+    int findStationIdByName(const string &name) const
+    {
+        if (!header)
+            return -1;
+        string lower = toLower(name);
+        int mask = header->nameSlotCount - 1;
+        unsigned int h = hashName(lower.data(), (int)lower.size()) & mask;
+        for (int probes = 0; probes < header->nameSlotCount && nameSlots[h] != 0; probes++)
+        {
+            int slot = nameSlots[h] - 1;
+            if (sameNameIgnoreCase(strings + stationStrings[4 * slot], stationStrings[4 * slot + 1], lower))
+                return stationIDs[slot];
+            h = (h + 1) & mask;
+        }
+        return -1;
+    }
+
+    void displayStations() const
+    {
+        OutputSink out(cout);
+        out << "Stations:\n";
+        for (int i = 0; i < totalStations(); i++)
+            stationAt(i).display(out);
+    }
+
+    // BFS / DFS / shortest path print the same lines as RouteManager
+    void BFS(int startID) const
+    {
+        DynamicArray<int> order;
+        graph.bfsOrder(stationSlot(startID), order);
+        cout << "BFS starting from " << getStationNameById(startID) << ":" << endl;
+        for (int i = 0; i < order.size(); i++)
+            cout << stationName(order[i]) << " ";
+        cout << "\n";
+    }
+
+    void DFS(int startID) const
+    {
+        DynamicArray<int> order;
+        graph.dfsOrder(stationSlot(startID), order);
+        cout << "DFS starting from " << getStationNameById(startID) << ":" << endl;
+        for (int i = 0; i < order.size(); i++)
+            cout << stationName(order[i]) << " ";
+        cout << "\n";
+    }
+
+    void shortestPath(int startID, int endID) const
+    {
+        cout << "Shortest path from " << getStationNameById(startID) << " to " << getStationNameById(endID) << ":" << endl;
+        DynamicArray<int> path;
+        int dist = graph.shortestPath(stationSlot(startID), stationSlot(endID), path);
+        if (dist < 0)
+        {
+            cout << "No path found.\n";
+            return;
+        }
+        cout << "Shortest distance: " << dist << "\n";
+        cout << "Path: ";
+        for (int i = 0; i < path.size(); i++)
+            cout << stationName(path[i]) << " ";
+        cout << "\n";
+    }
+
+    // Direct routes between two stations: scans only startID's edges
+    void searchRoute(int startID, int endID) const
+    {
+        int u = stationSlot(startID);
+        int v = stationSlot(endID);
+        bool found = false;
+        if (u >= 0 && v >= 0)
+        {
+            for (int e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++)
+            {
+                if (graph.edgeTarget(e) != v)
+                    continue;
+                Route r = routeAt(edgeRoutes[e]);
+                cout << "Route found!" << endl;
+                cout << "Route ID: " << r.getRouteID()
+                     << ", From: " << getStationNameById(r.getStartStationID())
+                     << ", To: " << getStationNameById(r.getEndStationID())
+                     << ", Distance: " << r.getDistance() << " km" << endl;
+                found = true;
+                if (u == v)
+                    e++; // a self-loop appears twice in its own list
+            }
+        }
+        if (!found)
+            cout << "No direct route found between these stations." << endl;
+    }
+};
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef NETWORK_VERSION_H
+#define NETWORK_VERSION_H
+
+#include <iostream>
+#include <string>
+#include "../ds/graph.h"
+#include "../ds/array.h"
+#include "../ds/id_index.h"
+#include "../ds/rcu.h"
+#include "../ds/memory_tracker.h"
+#include "../models/station.h"
+#include "../models/route.h"
+
+using namespace std;
+
+// One published state of the route network: stations, routes and the graph
+// as they were when RouteManager published it. Never modified after
+// construction, so any number of threads may query it at once. Slot
+// indexes replace the writer's hash tables (built once, O(1) lookups).
+class NetworkVersion
+{
+public:
+    long long number; // RouteManager change count this version reflects
+    Graph graph;
+    DynamicArray<Station> stations;
+    DynamicArray<Route> routes;
+    IdIndex stationSlots; // station ID -> index into stations
+    IdIndex routeSlots;   // route ID -> index into routes (first wins)
+
+    static string toLower(const string &s)
+    {
+        string out = s;
+        for (int i = 0; i < (int)out.size(); i++)
+        {
+            if (out[i] >= 'A' && out[i] <= 'Z')
+                out[i] = out[i] + ('a' - 'A');
+        }
+        return out;
+    }
+
+    // Station name for GraphLabels; context is the version
+    static string labelOf(const void *version, int stationID)
+    {
+        return ((const NetworkVersion *)version)->stationName(stationID);
+    }
+
+    NetworkVersion(long long changeCount, const Graph &g, const DynamicArray<Station> &s, const DynamicArray<Route> &r)
+        : number(changeCount), graph(g), stations(s), routes(r)
+    {
+        MemoryAccount *memory = MemoryTracker::instance().account("network.versions");
+        graph.setMemoryAccount(memory, memory);
+        stations.setMemoryAccount(memory);
+        routes.setMemoryAccount(memory);
+        stationSlots.setMemoryAccount(memory);
+        routeSlots.setMemoryAccount(memory);
+
+        stationSlots.reserve(stations.size());
+        for (int i = 0; i < stations.size(); i++)
+            stationSlots.insert(stations[i].getID(), i);
+        routeSlots.reserve(routes.size());
+        for (int i = 0; i < routes.size(); i++)
+            if (!routeSlots.contains(routes[i].getRouteID()))
+                routeSlots.insert(routes[i].getRouteID(), i);
+    }
+
+    const Station *findStation(int stationID) const
+    {
+        int slot = stationSlots.find(stationID);
+        return slot >= 0 ? &stations[slot] : nullptr;
+    }
+
+    bool hasStation(int stationID) const { return stationSlots.contains(stationID); }
+    bool hasRoute(int routeID) const { return routeSlots.contains(routeID); }
+
+    // Station name, or "ID n" if there is no such station
+    string stationName(int stationID) const
+    {
+        const Station *station = findStation(stationID);
+        if (station)
+            return station->getName();
+        return "ID " + to_string(stationID);
+    }
+
+    // Station ID by name (case-insensitive); -1 if not found
+    int findStationIdByName(const string &name) const
+    {
+        string key = toLower(name);
+        for (int i = 0; i < stations.size(); i++)
+        {
+            if (toLower(stations[i].getName()) == key)
+                return stations[i].getID();
+        }
+        return -1;
+    }
+
+    // Labels printing station names for Graph and Analytics output
+    GraphLabels labels() const { return GraphLabels(labelOf, this); }
+
+    // Add used bytes of every container to its account (memory report)
+    void measureMemory() const
+    {
+        graph.measureMemory();
+        stations.measureMemory();
+        routes.measureMemory();
+        stationSlots.measureMemory();
+        routeSlots.measureMemory();
+    }
+};
+
+// A pinned NetworkVersion: an RCU read section for the handle's lifetime.
+// Taking one never blocks; the version stays valid (and unchanged) until
+// the handle is destroyed, however many versions are published meanwhile.
+// Use it on the thread that took it.
+class NetworkSnapshot
+{
+private:
+    const NetworkVersion *version;
+
+    NetworkSnapshot &operator=(const NetworkSnapshot &);
+
+public:
+    explicit NetworkSnapshot(const RcuPointer<NetworkVersion> &published)
+    {
+        RcuDomain::instance().readLock();
+        version = published.read();
+    }
+
+    // Copies nest the read section (same thread)
+    NetworkSnapshot(const NetworkSnapshot &other) : version(other.version)
+    {
+        RcuDomain::instance().readLock();
+    }
+
+    ~NetworkSnapshot() { RcuDomain::instance().readUnlock(); }
+
+    const NetworkVersion *operator->() const { return version; }
+    const NetworkVersion &operator*() const { return *version; }
+};
+
+#endif
@@ -0,0 +1,731 @@
+#ifndef OD_MATRIX_H
+#define OD_MATRIX_H
+
+#include <iostream>
+#include "../ds/array.h"
+#include "../ds/pair.h"
+#include "../ds/heap.h"
+#include "../ds/hashtable.h"
+#include "../ds/id_index.h"
+#include "../ds/sorting.h"
+#include "../ds/metrics.h"
+#include "../ds/memory_tracker.h"
+#include "../models/timestamp.h"
+#include "ticket_store.h"
+#include "time_buckets.h"
+
+using namespace std;
+
+// Slice levels of OdMatrix: hour, day and week buckets
+#define OD_LEVELS 3
+
+// One origin-destination pair and its trips (station IDs)
+struct OdPair
+{
+    int origin;
+    int destination;
+    int trips;
+
+    OdPair() : origin(0), destination(0), trips(0) {}
+    OdPair(int o, int d, int t) : origin(o), destination(d), trips(t) {}
+};
+
+// Trips starting and ending at one station (by station index) in a slice
+struct OdStationCount
+{
+    int station;
+    int departures;
+    int arrivals;
+
+    OdStationCount() : station(0), departures(0), arrivals(0) {}
+    OdStationCount(int s, int d, int a) : station(s), departures(d), arrivals(a) {}
+};
+
+// Trips of one time bucket
+struct OdSlice
+{
+    DynamicArray<Pair<int, int>> cells;    // (cell, trips) by cell
+    DynamicArray<Pair<int, int>> ranked;   // the same, most trips first
+    DynamicArray<OdStationCount> stations; // per-station marginals by station
+};
+
+inline void memoryAttach(OdSlice &slice, MemoryAccount *account)
+{
+    slice.cells.setMemoryAccount(account);
+    slice.ranked.setMemoryAccount(account);
+    slice.stations.setMemoryAccount(account);
+}
+
+inline void memoryMeasure(const OdSlice &slice)
+{
+    slice.cells.measureMemory();
+    slice.ranked.measureMemory();
+    slice.stations.measureMemory();
+}
+
+// Slice order: more trips first, then lower cell
+struct OdMoreTrips
+{
+    bool operator()(const Pair<int, int> &a, const Pair<int, int> &b) const
+    {
+        return a.second > b.second || (a.second == b.second && a.first < b.first);
+    }
+};
+
+// Origin-destination matrix of the ticket log
+//
+// Every ticket with both stations set is one trip from its start to its end
+// station, whether or not a direct route joins them. Stations get dense
+// indexes on first sight and each (origin, destination) pair that occurs
+// becomes a cell, found through one hash lookup; nothing is stored for
+// pairs without trips. Kept next to the cells:
+//   - departures and arrivals per station (marginals, O(1) reads)
+//   - the cells ordered by trips, adjusted in O(1) per trip, so the top K
+//     pairs are read in O(K)
+//   - hour, day and week slices: (cell, trips) lists by cell and by trips
+//     and per-station lists for every bucket with trips. A window is
+//     covered by the coarsest slices that fit, so a month costs ~4 week
+//     and a few day/hour slices; its top K pairs are found with the
+//     threshold algorithm (walk the by-trips lists together, look the
+//     candidates up in the by-cell lists, stop once no unseen pair can
+//     beat the K-th best): skewed counts stop near the heads of the lists,
+//     flat ones fall back to adding up the window's cells.
+// Each level accumulates its current bucket in a dense per-cell array and
+// merges it into the slice when the bucket changes. Tickets are consumed
+// incrementally with sync(); the open day and week are answered from hour
+// and day slices until they close. Not thread-safe: callers serialize
+// like TicketManager.
+class OdMatrix
+{
+private:
+    IdIndex stationIndex;      // station ID -> station index
+    DynamicArray<int> stationIDs;
+    DynamicArray<int> departures; // trips per origin station index
+    DynamicArray<int> arrivals;   // trips per destination station index
+
+    HashTable<long long, int> cellOf; // (origin index, destination index) -> cell
+    DynamicArray<int> cellOrigin;     // station indexes of each cell
+    DynamicArray<int> cellDestination;
+    DynamicArray<int> cellTrips;
+
+    // Cells by trips, descending; each trip count occupies one run
+    DynamicArray<int> order;  // rank -> cell
+    DynamicArray<int> rankOf; // cell -> rank
+    IdIndex runStart;         // trips -> first rank with that many trips
+
+    IdIndex sliceOf[OD_LEVELS]; // bucket number -> slice
+    DynamicArray<OdSlice> slices[OD_LEVELS];
+
+    // Trips of each level's open bucket, merged into its slice when the
+    // bucket changes (tickets mostly arrive in time order)
+    long long pendingBucket[OD_LEVELS];
+    DynamicArray<int> pendingTrips[OD_LEVELS]; // per cell, 0 outside pendingCells
+    DynamicArray<int> pendingCells[OD_LEVELS];
+    DynamicArray<int> stationScratch; // per station: departures, arrivals
+    DynamicArray<int> scratchStations;
+
+    long long firstHour; // hour buckets holding trips
+    long long lastHour;
+    long long trips;
+    int unassigned; // tickets without a start or end station
+    int consumed;   // tickets of the store already counted
+    long long clears; // clear() calls: cells are renumbered after one
+
+    // Per-window trips by cell (zero between queries)
+    mutable DynamicArray<int> windowTrips;
+    mutable DynamicArray<int> windowCells;
+
+    static int levelGranularity(int level)
+    {
+        switch (level)
+        {
+        case 0:
+            return BUCKET_HOUR;
+        case 1:
+            return BUCKET_DAY;
+        default:
+            return BUCKET_WEEK;
+        }
+    }
+
+    static long long pairKey(int originIndex, int destinationIndex)
+    {
+        return ((long long)originIndex << 32) | (unsigned int)destinationIndex;
+    }
+
+    int indexOf(int stationID)
+    {
+        int index = stationIndex.find(stationID);
+        if (index >= 0)
+            return index;
+        index = stationIDs.size();
+        stationIndex.insert(stationID, index);
+        stationIDs.push_back(stationID);
+        departures.push_back(0);
+        arrivals.push_back(0);
+        stationScratch.push_back(0);
+        stationScratch.push_back(0);
+        return index;
+    }
+
+    // One more trip on cell: move it to the front of its run, then the run
+    // above (trips + 1) ends where it now stands
+    void bump(int cell)
+    {
+        int t = cellTrips[cell];
+        int rank = rankOf[cell];
+        int first = runStart.find(t);
+        int other = order[first];
+        order[first] = cell;
+        order[rank] = other;
+        rankOf[other] = rank;
+        rankOf[cell] = first;
+        if (first + 1 < order.size() && cellTrips[order[first + 1]] == t)
+            runStart.insert(t, first + 1);
+        else
+            runStart.remove(t);
+        cellTrips[cell] = t + 1;
+        if (!runStart.contains(t + 1))
+            runStart.insert(t + 1, first);
+    }
+
+    // Cell of a pair with one more trip (created with one trip)
+    int countTrip(int originIndex, int destinationIndex)
+    {
+        long long key = pairKey(originIndex, destinationIndex);
+        const int *found = cellOf.find(key);
+        if (found)
+        {
+            bump(*found);
+            return *found;
+        }
+        int cell = cellTrips.size();
+        cellOf.insert(key, cell);
+        cellOrigin.push_back(originIndex);
+        cellDestination.push_back(destinationIndex);
+        cellTrips.push_back(1);
+        order.push_back(cell);
+        rankOf.push_back(order.size() - 1);
+        if (!runStart.contains(1))
+            runStart.insert(1, order.size() - 1);
+        for (int level = 0; level < OD_LEVELS; level++)
+            pendingTrips[level].push_back(0);
+        windowTrips.push_back(0);
+        return cell;
+    }
+
+    OdSlice &sliceFor(int level, long long bucket)
+    {
+        int s = sliceOf[level].find((int)bucket);
+        if (s < 0)
+        {
+            s = slices[level].size();
+            sliceOf[level].insert((int)bucket, s);
+            slices[level].push_back(OdSlice());
+        }
+        return slices[level][s];
+    }
+
+    // Merge sorted additions into a sorted slice list (both by first field)
+    static void mergeCells(DynamicArray<Pair<int, int>> &into, const DynamicArray<Pair<int, int>> &add)
+    {
+        DynamicArray<Pair<int, int>> merged(into.size() + add.size());
+        merged.setMemoryAccount(into.getMemoryAccount());
+        int i = 0, j = 0;
+        while (i < into.size() || j < add.size())
+        {
+            if (j == add.size() || (i < into.size() && into[i].first < add[j].first))
+                merged.push_back(into[i++]);
+            else if (i == into.size() || add[j].first < into[i].first)
+                merged.push_back(add[j++]);
+            else
+            {
+                merged.push_back(Pair<int, int>(into[i].first, into[i].second + add[j].second));
+                i++;
+                j++;
+            }
+        }
+        into.swap(merged);
+    }
+
+    static void mergeStations(DynamicArray<OdStationCount> &into, const DynamicArray<OdStationCount> &add)
+    {
+        DynamicArray<OdStationCount> merged(into.size() + add.size());
+        merged.setMemoryAccount(into.getMemoryAccount());
+        int i = 0, j = 0;
+        while (i < into.size() || j < add.size())
+        {
+            if (j == add.size() || (i < into.size() && into[i].station < add[j].station))
+                merged.push_back(into[i++]);
+            else if (i == into.size() || add[j].station < into[i].station)
+                merged.push_back(add[j++]);
+            else
+            {
+                merged.push_back(OdStationCount(into[i].station, into[i].departures + add[j].departures,
+                                                into[i].arrivals + add[j].arrivals));
+                i++;
+                j++;
+            }
+        }
+        into.swap(merged);
+    }
+
+    // Merge the open bucket of level into its slice
+    void flushLevel(int level)
+    {
+        DynamicArray<int> &pending = pendingCells[level];
+        if (pending.empty())
+            return;
+        introSort(pending.getRawArray(), pending.size());
+        DynamicArray<Pair<int, int>> cells(pending.size());
+        for (int i = 0; i < pending.size(); i++)
+        {
+            int cell = pending[i];
+            int n = pendingTrips[level][cell];
+            cells.push_back(Pair<int, int>(cell, n));
+            pendingTrips[level][cell] = 0;
+            int o = cellOrigin[cell];
+            int d = cellDestination[cell];
+            if (stationScratch[2 * o] == 0 && stationScratch[2 * o + 1] == 0)
+                scratchStations.push_back(o);
+            stationScratch[2 * o] += n;
+            if (stationScratch[2 * d] == 0 && stationScratch[2 * d + 1] == 0)
+                scratchStations.push_back(d);
+            stationScratch[2 * d + 1] += n;
+        }
+        introSort(scratchStations.getRawArray(), scratchStations.size());
+        DynamicArray<OdStationCount> stations(scratchStations.size());
+        for (int i = 0; i < scratchStations.size(); i++)
+        {
+            int st = scratchStations[i];
+            stations.push_back(OdStationCount(st, stationScratch[2 * st], stationScratch[2 * st + 1]));
+            stationScratch[2 * st] = 0;
+            stationScratch[2 * st + 1] = 0;
+        }
+        pending.clear();
+        scratchStations.clear();
+
+        OdSlice &slice = sliceFor(level, pendingBucket[level]);
+        mergeCells(slice.cells, cells);
+        mergeStations(slice.stations, stations);
+        DynamicArray<Pair<int, int>> ranked(slice.cells);
+        introSort(ranked.getRawArray(), ranked.size(), OdMoreTrips());
+        slice.ranked.swap(ranked);
+    }
+
+    // Count one trip issued at issued into the matrix and the open buckets
+    void add(int originID, int destinationID, Timestamp issued)
+    {
+        if (originID <= 0 || destinationID <= 0)
+        {
+            unassigned++;
+            return;
+        }
+        for (int level = 0; level < OD_LEVELS; level++)
+        {
+            long long b = TimeBucketCounter::bucketOf(issued, levelGranularity(level));
+            if (b != pendingBucket[level])
+            {
+                flushLevel(level);
+                pendingBucket[level] = b;
+            }
+        }
+        long long hour = pendingBucket[0];
+        if (cellTrips.empty() || hour < firstHour)
+            firstHour = hour;
+        if (cellTrips.empty() || hour > lastHour)
+            lastHour = hour;
+
+        int o = indexOf(originID);
+        int d = indexOf(destinationID);
+        int cell = countTrip(o, d);
+        departures[o]++;
+        arrivals[d]++;
+        trips++;
+        for (int level = 0; level < OD_LEVELS; level++)
+            if (pendingTrips[level][cell]++ == 0)
+                pendingCells[level].push_back(cell);
+    }
+
+    // Keep entry if it is among the k best held so far
+    static void offer(MinHeap<Pair<int, int>> &best, int &held, int k, const Pair<int, int> &entry)
+    {
+        if (held < k)
+        {
+            best.insert(entry);
+            held++;
+        }
+        else if (best.getMin() < entry)
+        {
+            best.extractMin();
+            best.insert(entry);
+        }
+    }
+
+    // Slices covering the hours that start in [from, to), coarsest first fit
+    void windowSlices(Timestamp from, Timestamp to, DynamicArray<const OdSlice *> &out) const
+    {
+        out.clear();
+        if (cellTrips.empty())
+            return;
+        // Whole weeks around the data: no trips outside them
+        Timestamp dataStart = TimeBucketCounter::bucketStart(
+            TimeBucketCounter::bucketOf(TimeBucketCounter::bucketStart(firstHour, BUCKET_HOUR), BUCKET_WEEK),
+            BUCKET_WEEK);
+        Timestamp dataEnd = TimeBucketCounter::bucketStart(
+            TimeBucketCounter::bucketOf(TimeBucketCounter::bucketStart(lastHour, BUCKET_HOUR), BUCKET_WEEK) + 1,
+            BUCKET_WEEK);
+        Timestamp t = TimeBucketCounter::bucketStart(TimeBucketCounter::bucketOf(from, BUCKET_HOUR), BUCKET_HOUR);
+        Timestamp end = TimeBucketCounter::bucketStart(TimeBucketCounter::bucketOf(to, BUCKET_HOUR), BUCKET_HOUR);
+        if (t < dataStart)
+            t = dataStart;
+        if (end > dataEnd)
+            end = dataEnd;
+        while (t < end)
+        {
+            int level = OD_LEVELS - 1;
+            long long b = TimeBucketCounter::bucketOf(t, levelGranularity(level));
+            // Coarse buckets must fit the window and be closed
+            while (level > 0 && (TimeBucketCounter::bucketStart(b, levelGranularity(level)) != t ||
+                                 TimeBucketCounter::bucketStart(b + 1, levelGranularity(level)) > end ||
+                                 (b == pendingBucket[level] && !pendingCells[level].empty())))
+            {
+                level--;
+                b = TimeBucketCounter::bucketOf(t, levelGranularity(level));
+            }
+            int s = sliceOf[level].find((int)b);
+            if (s >= 0)
+                out.push_back(&slices[level][s]);
+            t = TimeBucketCounter::bucketStart(b + 1, levelGranularity(level));
+        }
+    }
+
+    static int findCell(const DynamicArray<Pair<int, int>> &cells, int cell)
+    {
+        int lo = 0, hi = cells.size() - 1;
+        while (lo <= hi)
+        {
+            int mid = lo + (hi - lo) / 2;
+            if (cells[mid].first == cell)
+                return cells[mid].second;
+            if (cells[mid].first < cell)
+                lo = mid + 1;
+            else
+                hi = mid - 1;
+        }
+        return 0;
+    }
+
+    static const OdStationCount *findStation(const DynamicArray<OdStationCount> &stations, int station)
+    {
+        int lo = 0, hi = stations.size() - 1;
+        while (lo <= hi)
+        {
+            int mid = lo + (hi - lo) / 2;
+            if (stations[mid].station == station)
+                return &stations[mid];
+            if (stations[mid].station < station)
+                lo = mid + 1;
+            else
+                hi = mid - 1;
+        }
+        return nullptr;
+    }
+
+    OdPair pairOf(int cell, int n) const
+    {
+        return OdPair(stationIDs[cellOrigin[cell]], stationIDs[cellDestination[cell]], n);
+    }
+
+public:
+    OdMatrix() : firstHour(0), lastHour(0), trips(0), unassigned(0), consumed(0), clears(0)
+    {
+        for (int level = 0; level < OD_LEVELS; level++)
+            pendingBucket[level] = 0;
+    }
+
+    // Count the tickets appended to the store since the last sync
+    void sync(const TicketStore &tickets)
+    {
+        if (tickets.size() < consumed)
+            clear();
+        if (tickets.size() == consumed)
+            return;
+        METRIC_TIMER("itnms_od_sync_seconds", "OdMatrix::sync calls");
+        const DynamicArray<int> &starts = tickets.startStationColumn();
+        const DynamicArray<int> &ends = tickets.endStationColumn();
+        const DynamicArray<Timestamp> &times = tickets.issueTimeColumn();
+        for (int i = consumed; i < tickets.size(); i++)
+            add(starts[i], ends[i], times[i]);
+        consumed = tickets.size();
+        flushLevel(0);
+    }
+
+    // Forget every trip (e.g. the ticket log was replaced)
+    void clear()
+    {
+        stationIndex.clear();
+        stationIDs.clear();
+        departures.clear();
+        arrivals.clear();
+        cellOf.clear();
+        cellOrigin.clear();
+        cellDestination.clear();
+        cellTrips.clear();
+        order.clear();
+        rankOf.clear();
+        runStart.clear();
+        for (int level = 0; level < OD_LEVELS; level++)
+        {
+            sliceOf[level].clear();
+            slices[level].clear();
+            pendingBucket[level] = 0;
+            pendingTrips[level].clear();
+            pendingCells[level].clear();
+        }
+        stationScratch.clear();
+        scratchStations.clear();
+        windowTrips.clear();
+        windowCells.clear();
+        firstHour = lastHour = trips = 0;
+        unassigned = consumed = 0;
+        clears++;
+    }
+
+    long long totalTrips() const { return trips; }
+    int unassignedTickets() const { return unassigned; }
+    int pairCount() const { return cellTrips.size(); }
+    int stationCount() const { return stationIDs.size(); }
+
+    // Pairs by cell number (0 .. pairCount() - 1, in order of first trip);
+    // numbers stay valid until the epoch changes
+    int cellOriginID(int cell) const { return stationIDs[cellOrigin[cell]]; }
+    int cellDestinationID(int cell) const { return stationIDs[cellDestination[cell]]; }
+    int cellTripCount(int cell) const { return cellTrips[cell]; }
+    long long epoch() const { return clears; }
+
+    // Trips from origin to destination (O(1))
+    int tripsBetween(int originID, int destinationID) const
+    {
+        int o = stationIndex.find(originID);
+        int d = stationIndex.find(destinationID);
+        if (o < 0 || d < 0)
+            return 0;
+        const int *cell = cellOf.find(pairKey(o, d));
+        return cell ? cellTrips[*cell] : 0;
+    }
+
+    // Marginals: trips starting / ending at a station (O(1))
+    int departuresFrom(int stationID) const
+    {
+        int s = stationIndex.find(stationID);
+        return s >= 0 ? departures[s] : 0;
+    }
+
+    int arrivalsAt(int stationID) const
+    {
+        int s = stationIndex.find(stationID);
+        return s >= 0 ? arrivals[s] : 0;
+    }
+
+    // The k pairs with the most trips, most first (O(k)); equal counts come
+    // in an unspecified but repeatable order
+    void topPairs(int k, DynamicArray<OdPair> &out) const
+    {
+        out.clear();
+        for (int r = 0; r < k && r < order.size(); r++)
+            out.push_back(pairOf(order[r], cellTrips[order[r]]));
+    }
+
+    // Windowed queries count the trips issued in the hours that start in
+    // [from, to) (both rounded down to the hour)
+
+    int tripsBetween(int originID, int destinationID, Timestamp from, Timestamp to) const
+    {
+        int o = stationIndex.find(originID);
+        int d = stationIndex.find(destinationID);
+        if (o < 0 || d < 0)
+            return 0;
+        const int *cell = cellOf.find(pairKey(o, d));
+        if (!cell)
+            return 0;
+        DynamicArray<const OdSlice *> window;
+        windowSlices(from, to, window);
+        int n = 0;
+        for (int i = 0; i < window.size(); i++)
+            n += findCell(window[i]->cells, *cell);
+        return n;
+    }
+
+    // Departures and arrivals of one station in the window
+    void stationTrips(int stationID, Timestamp from, Timestamp to, int &departed, int &arrived) const
+    {
+        departed = arrived = 0;
+        int s = stationIndex.find(stationID);
+        if (s < 0)
+            return;
+        DynamicArray<const OdSlice *> window;
+        windowSlices(from, to, window);
+        for (int i = 0; i < window.size(); i++)
+        {
+            const OdStationCount *c = findStation(window[i]->stations, s);
+            if (c)
+            {
+                departed += c->departures;
+                arrived += c->arrivals;
+            }
+        }
+    }
+
+    // The k pairs with the most trips in the window, most first; pairs
+    // with equal counts come in no particular order
+    void topPairs(int k, Timestamp from, Timestamp to, DynamicArray<OdPair> &out) const
+    {
+        out.clear();
+        if (k > pairCount())
+            k = pairCount(); // the heap below is sized from k
+        if (k <= 0)
+            return;
+        DynamicArray<const OdSlice *> window;
+        windowSlices(from, to, window);
+        if (window.empty())
+            return;
+        if (window.size() == 1)
+        {
+            const DynamicArray<Pair<int, int>> &ranked = window[0]->ranked;
+            for (int r = 0; r < k && r < ranked.size(); r++)
+                out.push_back(pairOf(ranked[r].first, ranked[r].second));
+            return;
+        }
+
+        // Threshold algorithm: at each depth, total every newly seen pair
+        // over the window; an unseen pair has at most the sum of the
+        // counts at this depth. A candidate costs a binary search per
+        // slice, so once the candidates would cost about a quarter of
+        // adding up the window (flat counts, no early stop), add it up.
+        // best is a min-heap of (trips, -cell).
+        int cells = 0;
+        for (int i = 0; i < window.size(); i++)
+            cells += window[i]->cells.size();
+        int budget = cells / (64 * window.size());
+        MinHeap<Pair<int, int>> best(k + 1);
+        int held = 0;
+        bool done = false;
+        for (int depth = 0; !done && windowCells.size() <= budget; depth++)
+        {
+            long long threshold = 0;
+            bool more = false;
+            for (int i = 0; i < window.size(); i++)
+            {
+                const DynamicArray<Pair<int, int>> &ranked = window[i]->ranked;
+                if (depth >= ranked.size())
+                    continue;
+                more = true;
+                threshold += ranked[depth].second;
+                int cell = ranked[depth].first;
+                if (windowTrips[cell] != 0)
+                    continue;
+                int n = 0;
+                for (int j = 0; j < window.size(); j++)
+                    n += findCell(window[j]->cells, cell);
+                windowTrips[cell] = n;
+                windowCells.push_back(cell);
+                offer(best, held, k, Pair<int, int>(n, -cell));
+            }
+            done = !more || (held == k && best.getMin().first >= threshold);
+        }
+        for (int i = 0; i < windowCells.size(); i++)
+            windowTrips[windowCells[i]] = 0;
+        windowCells.clear();
+
+        if (!done)
+        {
+            while (held > 0)
+            {
+                best.extractMin();
+                held--;
+            }
+            for (int i = 0; i < window.size(); i++)
+            {
+                const DynamicArray<Pair<int, int>> &slice = window[i]->cells;
+                for (int j = 0; j < slice.size(); j++)
+                {
+                    if (windowTrips[slice[j].first] == 0)
+                        windowCells.push_back(slice[j].first);
+                    windowTrips[slice[j].first] += slice[j].second;
+                }
+            }
+            for (int i = 0; i < windowCells.size(); i++)
+            {
+                int cell = windowCells[i];
+                offer(best, held, k, Pair<int, int>(windowTrips[cell], -cell));
+                windowTrips[cell] = 0;
+            }
+            windowCells.clear();
+        }
+
+        for (int i = 0; i < held; i++)
+            out.push_back(OdPair());
+        for (int i = held - 1; i >= 0; i--)
+        {
+            Pair<int, int> entry = best.extractMin();
+            out[i] = pairOf(-entry.second, entry.first);
+        }
+    }
+
+    // Charge the matrix to memory (slices included)
+    void setMemoryAccount(MemoryAccount *memory)
+    {
+        stationIndex.setMemoryAccount(memory);
+        stationIDs.setMemoryAccount(memory);
+        departures.setMemoryAccount(memory);
+        arrivals.setMemoryAccount(memory);
+        cellOf.setMemoryAccount(memory);
+        cellOrigin.setMemoryAccount(memory);
+        cellDestination.setMemoryAccount(memory);
+        cellTrips.setMemoryAccount(memory);
+        order.setMemoryAccount(memory);
+        rankOf.setMemoryAccount(memory);
+        runStart.setMemoryAccount(memory);
+        for (int level = 0; level < OD_LEVELS; level++)
+        {
+            sliceOf[level].setMemoryAccount(memory);
+            slices[level].setMemoryAccount(memory);
+            pendingTrips[level].setMemoryAccount(memory);
+            pendingCells[level].setMemoryAccount(memory);
+        }
+        stationScratch.setMemoryAccount(memory);
+        scratchStations.setMemoryAccount(memory);
+        windowTrips.setMemoryAccount(memory);
+        windowCells.setMemoryAccount(memory);
+    }
+
+    // Add used bytes of every container to its account (memory report)
+    void measureMemory() const
+    {
+        stationIndex.measureMemory();
+        stationIDs.measureMemory();
+        departures.measureMemory();
+        arrivals.measureMemory();
+        cellOf.measureMemory();
+        cellOrigin.measureMemory();
+        cellDestination.measureMemory();
+        cellTrips.measureMemory();
+        order.measureMemory();
+        rankOf.measureMemory();
+        runStart.measureMemory();
+        for (int level = 0; level < OD_LEVELS; level++)
+        {
+            sliceOf[level].measureMemory();
+            slices[level].measureMemory();
+            pendingTrips[level].measureMemory();
+            pendingCells[level].measureMemory();
+        }
+        stationScratch.measureMemory();
+        scratchStations.measureMemory();
+        windowTrips.measureMemory();
+        windowCells.measureMemory();
+    }
+};
+
+#endif
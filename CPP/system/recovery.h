@@ -0,0 +1,222 @@
+#ifndef RECOVERY_H
+#define RECOVERY_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include "../ds/binary_stream.h"
+#include "route_manager.h"
+#include "vehicle_manager.h"
+#include "ticket_manager.h"
+#include "history_manager.h"
+#include "snapshot.h"
+#include "write_ahead_log.h"
+
+using namespace std;
+
+// Crash recovery: latest snapshot + replay of the write-ahead log tail
+//
+// A checkpoint saves a snapshot tagged with the log's last LSN and then
+// empties the log. Recovery loads that snapshot and re-applies every log
+// record with a larger LSN, so a crash between the two steps is harmless.
+// Replay goes through the managers' normal methods with logging detached.
+class RecoveryManager
+{
+private:
+    static bool fileExists(const string &path)
+    {
+        ifstream f(path.c_str(), ios::binary);
+        return (bool)f;
+    }
+
+public:
+    // Apply one log record; false if it is malformed or cannot be applied
+    static bool apply(const WalRecord &r, RouteManager &routes, VehicleManager &vehicles,
+                      TicketManager &tickets, HistoryManager &history)
+    {
+        BinaryReader in(r.payload, r.length);
+        switch (r.type)
+        {
+        case WAL_ADD_STATION:
+        {
+            int id = in.readInt();
+            string name = in.readString();
+            string location = in.readString();
+            return in.good() && routes.addStation(Station(id, name, location));
+        }
+        case WAL_REMOVE_STATION:
+        {
+            int id = in.readInt();
+            return in.good() && routes.removeStation(id);
+        }
+        case WAL_ADD_ROUTE:
+        {
+            int id = in.readInt();
+            int start = in.readInt();
+            int end = in.readInt();
+            double distance = in.readDouble();
+            return in.good() && routes.addRoute(Route(id, start, end, distance));
+        }
+        case WAL_REMOVE_ROUTE:
+        {
+            int id = in.readInt();
+            return in.good() && routes.removeRouteById(id);
+        }
+        case WAL_STATION_PASSENGER:
+        {
+            int id = in.readInt();
+            if (in.good())
+                routes.incrementStationPassengers(id);
+            return in.good();
+        }
+        case WAL_ADD_VEHICLE:
+        {
+            int id = in.readInt();
+            string name = in.readString();
+            int capacity = in.readInt();
+            return in.good() && vehicles.addVehicle(Vehicle(id, name, capacity));
+        }
+        case WAL_REMOVE_VEHICLE:
+        {
+            int id = in.readInt();
+            if (in.good())
+                vehicles.removeVehicle(id);
+            return in.good();
+        }
+        case WAL_ENQUEUE_PASSENGER:
+        {
+            int id = in.readInt();
+            string name = in.readString();
+            int age = in.readInt();
+            if (in.good())
+                tickets.addPassengerToQueue(Passenger(id, name, age));
+            return in.good();
+        }
+        case WAL_ISSUE_TICKETS:
+        {
+            int firstID = in.readInt();
+            int n = in.readInt();
+            Timestamp issueTime = in.readInt64();
+            int perPassenger = in.readInt();
+            if (!in.good() || n < 0)
+                return false;
+            if (!perPassenger)
+            {
+                int start = in.readInt();
+                int end = in.readInt();
+                return in.good() && tickets.applyIssuedTickets(firstID, n, issueTime, nullptr, nullptr, start, end);
+            }
+            if (in.remaining() < 8LL * n)
+                return false;
+            int *starts = new int[n > 0 ? n : 1];
+            int *ends = new int[n > 0 ? n : 1];
+            in.readBytes(starts, 4LL * n);
+            in.readBytes(ends, 4LL * n);
+            bool ok = tickets.applyIssuedTickets(firstID, n, issueTime, starts, ends, 0, 0);
+            delete[] starts;
+            delete[] ends;
+            return ok;
+        }
+        case WAL_MERGE_TICKETS:
+        {
+            int n = in.readCount(28);
+            DynamicArray<TicketRecord> records(n + 1);
+            for (int i = 0; i < n && in.good(); i++)
+            {
+                TicketRecord rec;
+                rec.ticketID = in.readInt();
+                int passengerID = in.readInt();
+                int age = in.readInt();
+                string name = in.readString();
+                rec.passenger = Passenger(passengerID, name, age);
+                rec.startStationID = in.readInt();
+                rec.endStationID = in.readInt();
+                rec.issueTime = in.readInt64();
+                records.push_back(rec);
+            }
+            if (in.good())
+                tickets.applyMergedTickets(records);
+            return in.good();
+        }
+        case WAL_HISTORY_PUSH:
+        {
+            string action = in.readString();
+            if (in.good())
+                history.addAction(action);
+            return in.good();
+        }
+        case WAL_HISTORY_POP:
+            history.undo();
+            return true;
+        case WAL_HISTORY_CLEAR:
+            history.clearHistory();
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Load snapshotPath (if it exists) and replay walPath (if it exists).
+    // lastLsn receives the LSN the recovered state corresponds to; pass it
+    // to WriteAheadLog::open. Managers must not have a log attached.
+    static bool recover(const string &snapshotPath, const string &walPath, RouteManager &routes,
+                        VehicleManager &vehicles, TicketManager &tickets, HistoryManager &history,
+                        long long &lastLsn, int *replayed = nullptr)
+    {
+        lastLsn = 0;
+        if (replayed)
+            *replayed = 0;
+        if (fileExists(snapshotPath) &&
+            !SnapshotManager::load(snapshotPath, routes, vehicles, tickets, history, &lastLsn))
+            return false;
+
+        WalReader reader;
+        if (!reader.open(walPath))
+        {
+            if (fileExists(walPath))
+            {
+                cerr << "Write-ahead log " << walPath << " has an unknown format" << endl;
+                return false;
+            }
+            return true; // no log yet
+        }
+
+        streambuf *saved = cout.rdbuf(nullptr); // replayed methods print as they go
+        WalRecord r;
+        int applied = 0, failed = 0;
+        while (reader.next(r))
+        {
+            if (r.lsn <= lastLsn)
+                continue; // already in the snapshot
+            if (!apply(r, routes, vehicles, tickets, history))
+                failed++;
+            applied++;
+            lastLsn = r.lsn;
+        }
+        cout.rdbuf(saved);
+
+        if (failed > 0)
+            cerr << "Recovery: " << failed << " of " << applied << " log records could not be applied" << endl;
+        if (reader.validBytes() < reader.fileBytes())
+            cerr << "Recovery: ignored a torn record at the end of " << walPath << endl;
+        if (replayed)
+            *replayed = applied;
+        return true;
+    }
+
+    // Snapshot the current state tagged with the log's last LSN, then empty
+    // the log. The log is only truncated once the snapshot file and its
+    // rename are both on disk. No mutations may run concurrently.
+    static bool checkpoint(const string &snapshotPath, WriteAheadLog &wal, const RouteManager &routes,
+                           const VehicleManager &vehicles, const TicketManager &tickets,
+                           const HistoryManager &history)
+    {
+        if (!wal.sync())
+            return false;
+        if (!SnapshotManager::save(snapshotPath, routes, vehicles, tickets, history, wal.lastLsn()))
+            return false;
+        return wal.reset();
+    }
+};
+
+#endif
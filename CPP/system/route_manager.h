@@ -3,85 +3,200 @@
 
 #include <iostream>
 #include <string>
+#include <atomic>
+#include <mutex>
 #include "../ds/graph.h"
 #include "../ds/hashtable.h"
 #include "../ds/array.h"
+#include "../ds/sorting.h"
+#include "../ds/metrics.h"
+#include "../ds/output_sink.h"
+#include "../ds/thread_pool.h"
 #include "../models/station.h"
 #include "../models/route.h"
 #include "../models/ticket.h"
+#include "network_version.h"
+#include "load_assignment.h"
 #include "analytics.h"
+#include "write_ahead_log.h"
 
 using namespace std;
 
+// Concurrency: one writer at a time, any number of lock-free readers.
+//
+// Mutations (add/remove, bulk loads, snapshot restore, passenger counts)
+// take writeLock and change the writer's tables below. Queries (searches,
+// traversals, shortest paths, displays, analytics) never touch those
+// tables: they run on a NetworkSnapshot, an immutable NetworkVersion
+// published through RCU, and never wait for a writer.
+//
+// Publishing is lazy so bulk mutation stays O(1) per item: a mutation only
+// bumps the change count. The next query that sees unpublished changes
+// builds the new version itself if it gets writeLock with try_lock (always
+// the case when reads and writes come from one thread, so a query sees
+// every earlier mutation); if a writer holds the lock, the query reads the
+// last published version instead of waiting and asks the writer to publish
+// when its mutation is done, so readers lag by at most one mutation. Writers
+// can also publish() explicitly, e.g. at the end of a long batch.
 class RouteManager
 {
 private:
+    // Writer state: guarded by writeLock
     Graph graph;                        // Graph representing stations and routes
     DynamicArray<Station> stations;     // List of all stations (for ordered display)
     DynamicArray<Route> routes;         // List of all routes (for ordered display)
     HashTable<int, Station> stationMap; // O(1) lookup: ID -> Station
     HashTable<int, Route> routeMap;     // O(1) lookup: ID -> Route
+    WriteAheadLog *wal;                 // mutation log (nullptr = not logged)
 
-    static string toLower(const string &s)
+    // Reader state
+    mutable mutex writeLock;
+    mutable RcuPointer<NetworkVersion> published; // never null
+    atomic<long long> changes;                    // mutations so far
+    mutable atomic<long long> publishedChanges;   // change count of published
+    mutable atomic<bool> readersWaiting;          // a query was turned away
+
+    // Route loads: guarded by loadLock (never taken with writeLock held)
+    mutable LoadAssignment loadAssignment;
+    mutable mutex loadLock;
+
+    // End of a mutation; caller holds writeLock
+    void changed()
     {
-        string out = s;
-        for (int i = 0; i < (int)out.size(); i++)
-        {
-            if (out[i] >= 'A' && out[i] <= 'Z')
-                out[i] = out[i] + ('a' - 'A');
-        }
-        return out;
+        changes.fetch_add(1, memory_order_release);
+        if (readersWaiting.exchange(false, memory_order_acq_rel))
+            publishLocked();
+    }
+
+    // Copy the writer state into a new version; caller holds writeLock
+    void publishLocked() const
+    {
+        METRIC_TIMER("itnms_network_publish_seconds", "Network versions built for readers");
+        long long n = changes.load(memory_order_acquire);
+        published.publish(new NetworkVersion(n, graph, stations, routes));
+        publishedChanges.store(n, memory_order_release);
     }
 
+    // Key extractors for the sorted views (introSortByKey, mergeSortBuffered
+    // with KeyCompare, radixSortIndices)
+    static int stationPassengerKey(const Station &s) { return s.getPassengerCount(); }
+    static double routeDistanceKey(const Route &r) { return r.getDistance(); }
+
     void rebuildGraph()
     {
+        METRIC_TIMER("itnms_graph_rebuild_seconds", "Full graph rebuilds after a removal");
         graph.clear();
         // Re-add all station vertices
+        graph.reserveVertices(stations.size());
         for (int i = 0; i < stations.size(); i++)
         {
             graph.addVertex(stations[i].getID());
         }
-        // Re-add all edges
-        for (int i = 0; i < routes.size(); i++)
+        // Re-add all edges in one bulk pass (parallel on large networks)
+        int n = routes.size();
+        DynamicArray<int> from(n + 1), to(n + 1), weights(n + 1);
+        for (int i = 0; i < n; i++)
         {
-            graph.addEdge(routes[i].getStartStationID(), routes[i].getEndStationID(), (int)routes[i].getDistance());
+            from.push_back(routes[i].getStartStationID());
+            to.push_back(routes[i].getEndStationID());
+            weights.push_back((int)routes[i].getDistance());
         }
+        graph.addEdges(from.getRawArray(), to.getRawArray(), weights.getRawArray(), n, &ThreadPool::shared());
     }
 
 public:
-    RouteManager() : stationMap(100), routeMap(100) // Initialize hash tables with capacity
+    RouteManager() : stationMap(100), routeMap(100), wal(nullptr), changes(0), publishedChanges(0), readersWaiting(false) // Initialize hash tables with capacity
     {
+        MemoryTracker &memory = MemoryTracker::instance();
+        graph.setMemoryAccount(memory.account("graph.adjacency"), memory.account("graph.index"));
+        stations.setMemoryAccount(memory.account("stations"));
+        stationMap.setMemoryAccount(memory.account("stations.index"));
+        routes.setMemoryAccount(memory.account("routes"));
+        routeMap.setMemoryAccount(memory.account("routes.index"));
+        loadAssignment.setMemoryAccount(memory.account("routes.loads"));
+        publishLocked(); // readers always find a version, even before any mutation
     }
 
-    // Find station ID by name (case-insensitive); returns -1 if not found
-    int findStationIdByName(const string &name) const
+    ~RouteManager()
+    {
+        RouteManager *self = this;
+        instance.compare_exchange_strong(self, nullptr);
+    }
+
+    // Log every later mutation to log (nullptr to stop logging)
+    void attachLog(WriteAheadLog *log)
+    {
+        lock_guard<mutex> guard(writeLock);
+        wal = log;
+    }
+
+    // Add used bytes of every container to its account (memory report)
+    void measureMemory() const
     {
-        string key = toLower(name);
-        for (int i = 0; i < stations.size(); i++)
         {
-            if (toLower(stations[i].getName()) == key)
-                return stations[i].getID();
+            lock_guard<mutex> guard(writeLock);
+            graph.measureMemory();
+            stations.measureMemory();
+            stationMap.measureMemory();
+            routes.measureMemory();
+            routeMap.measureMemory();
         }
-        return -1;
+        NetworkSnapshot(published)->measureMemory(); // the version readers see now
+        lock_guard<mutex> guard(loadLock);
+        loadAssignment.measureMemory();
     }
 
-    // Get station name by ID; fallback to stringified ID if not found
-    // Using HashTable for O(1) lookup
-    string getStationNameById(int stationID) const
+    // Current network for queries; publishes pending mutations first unless
+    // a writer is busy (then the last published version, without waiting).
+    // Must not be called while holding writeLock.
+    NetworkSnapshot snapshot() const
     {
-        // Search in array since we need the actual object
-        for (int i = 0; i < stations.size(); i++)
+        if (publishedChanges.load(memory_order_acquire) != changes.load(memory_order_acquire))
         {
-            if (stations[i].getID() == stationID)
-                return stations[i].getName();
+            unique_lock<mutex> guard(writeLock, try_to_lock);
+            if (guard.owns_lock() && publishedChanges.load(memory_order_relaxed) != changes.load(memory_order_relaxed))
+                publishLocked();
+            else if (!guard.owns_lock())
+            {
+                readersWaiting.store(true, memory_order_release);
+                METRIC_COUNT("itnms_network_stale_reads_total", "Queries served from an older version while a writer held the lock");
+            }
         }
-        return "ID " + to_string(stationID);
+        return NetworkSnapshot(published);
+    }
+
+    // Publish pending mutations now (writers; blocks while another writes)
+    void publish()
+    {
+        lock_guard<mutex> guard(writeLock);
+        if (publishedChanges.load(memory_order_relaxed) != changes.load(memory_order_relaxed))
+            publishLocked();
+    }
+
+    // Mutations not yet visible to readers of the published version
+    long long unpublishedChanges() const
+    {
+        return changes.load(memory_order_acquire) - publishedChanges.load(memory_order_acquire);
+    }
+
+    // Find station ID by name (case-insensitive); returns -1 if not found
+    int findStationIdByName(const string &name) const
+    {
+        return snapshot()->findStationIdByName(name);
+    }
+
+    // Get station name by ID; fallback to stringified ID if not found
+    // O(1) via the version's slot index
+    string getStationNameById(int stationID) const
+    {
+        return snapshot()->stationName(stationID);
     }
 
     // Add a station
     // Using HashTable for O(1) duplicate check
     bool addStation(const Station &station)
     {
+        lock_guard<mutex> guard(writeLock);
         // Validate station ID
         if (station.getID() <= 0)
         {
@@ -96,9 +211,15 @@ public:
             return false;
         }
 
+        if (wal && !wal->logAddStation(station))
+        {
+            cout << "ERROR: Could not log the change; station not added" << endl;
+            return false;
+        }
         stations.push_back(station);
         stationMap.insert(station.getID(), station); // O(1) insertion into hash table
         graph.addVertex(station.getID());
+        changed();
         cout << "Station added: " << station.getName() << endl;
         return true;
     }
@@ -107,6 +228,13 @@ public:
     // Using HashTable for O(1) station existence check
     bool addRoute(const Route &route)
     {
+        METRIC_TIMER("itnms_route_add_seconds", "RouteManager::addRoute calls");
+        lock_guard<mutex> guard(writeLock);
+        if (!Route::validDistance(route.getDistance()))
+        {
+            cout << "ERROR: Route " << route.getRouteID() << ": " << Route::distanceRule() << endl;
+            return false;
+        }
         // Check if both stations exist using HashTable (O(1))
         bool startExists = stationMap.contains(route.getStartStationID());
         bool endExists = stationMap.contains(route.getEndStationID());
@@ -121,9 +249,15 @@ public:
             return false;
         }
 
+        if (wal && !wal->logAddRoute(route))
+        {
+            cout << "ERROR: Could not log the change; route not added" << endl;
+            return false;
+        }
         routes.push_back(route);
         routeMap.insert(route.getRouteID(), route); // O(1) insertion into hash table
         graph.addEdge(route.getStartStationID(), route.getEndStationID(), (int)route.getDistance());
+        changed();
         cout << "Route added: " << route.getStartStationID() << " -> " << route.getEndStationID() << endl;
         return true;
     }
@@ -132,12 +266,18 @@ public:
     // Using HashTable for O(1) removal
     bool removeStation(int stationID)
     {
-        // Remove from hash table first (O(1))
-        if (!stationMap.remove(stationID))
+        lock_guard<mutex> guard(writeLock);
+        if (!stationMap.contains(stationID))
         {
             cout << "Station not found: ID " << stationID << endl;
             return false;
         }
+        if (wal && !wal->logId(WAL_REMOVE_STATION, stationID))
+        {
+            cout << "ERROR: Could not log the change; station not removed" << endl;
+            return false;
+        }
+        stationMap.remove(stationID); // O(1)
 
         // Remove from array
         for (int i = 0; i < stations.size(); i++)
@@ -163,6 +303,7 @@ public:
         routes.swap(newRoutes);
 
         rebuildGraph();
+        changed();
         cout << "Station removed: ID " << stationID << " (connected routes pruned)" << endl;
         return true;
     }
@@ -171,12 +312,18 @@ public:
     // Using HashTable for O(1) removal
     bool removeRouteById(int routeID)
     {
-        // Remove from hash table first (O(1))
-        if (!routeMap.remove(routeID))
+        lock_guard<mutex> guard(writeLock);
+        if (!routeMap.contains(routeID))
         {
             cout << "Route not found: ID " << routeID << endl;
             return false;
         }
+        if (wal && !wal->logId(WAL_REMOVE_ROUTE, routeID))
+        {
+            cout << "ERROR: Could not log the change; route not removed" << endl;
+            return false;
+        }
+        routeMap.remove(routeID); // O(1)
 
         // Remove from array
         for (int i = 0; i < routes.size(); i++)
@@ -189,20 +336,207 @@ public:
         }
 
         rebuildGraph();
+        changed();
         cout << "Route removed: ID " << routeID << endl;
         return true;
     }
 
-    // Check if station exists
+    // Append many stations and routes in one pass, without per-item output.
+    // The caller has already validated them (IDs positive and unique, route
+    // endpoints existing here or among newStations), e.g. BulkImporter.
+    // Arrays, hash tables and adjacency lists are each sized once.
+    // If logging fails part way, only the logged prefix is applied (so the
+    // state still matches what replay would rebuild) and false is returned.
+    bool addBulk(const DynamicArray<Station> &newStations, const DynamicArray<Route> &newRoutes)
+    {
+        lock_guard<mutex> guard(writeLock);
+        int ns = newStations.size();
+        int nr = newRoutes.size();
+        bool logged = true;
+        if (wal)
+        {
+            for (int i = 0; i < ns && logged; i++)
+                if (!wal->logAddStation(newStations[i]))
+                {
+                    ns = i;
+                    nr = 0;
+                    logged = false;
+                }
+            for (int i = 0; i < nr && logged; i++)
+                if (!wal->logAddRoute(newRoutes[i]))
+                {
+                    nr = i;
+                    logged = false;
+                }
+            if (!logged)
+                cout << "ERROR: Could not log the change; only " << ns << " stations and " << nr
+                     << " routes added" << endl;
+        }
+
+        stations.reserve(stations.size() + ns);
+        stationMap.reserve(stationMap.size() + ns);
+        graph.reserveVertices(ns);
+        for (int i = 0; i < ns; i++)
+        {
+            stations.push_back(newStations[i]);
+            stationMap.insert(newStations[i].getID(), newStations[i]);
+            graph.addVertex(newStations[i].getID());
+        }
+
+        DynamicArray<int> from(nr + 1), to(nr + 1), weights(nr + 1);
+        routes.reserve(routes.size() + nr);
+        routeMap.reserve(routeMap.size() + nr);
+        for (int i = 0; i < nr; i++)
+        {
+            const Route &r = newRoutes[i];
+            routes.push_back(r);
+            routeMap.insert(r.getRouteID(), r);
+            from.push_back(r.getStartStationID());
+            to.push_back(r.getEndStationID());
+            weights.push_back((int)r.getDistance());
+        }
+        graph.addEdges(from.getRawArray(), to.getRawArray(), weights.getRawArray(), nr, &ThreadPool::shared());
+        changed();
+        return logged;
+    }
+
+    // Writer-side check (validation before a mutation): the live table, under
+    // writeLock. Query threads use snapshot()->hasRoute() instead.
+    bool routeExists(int routeID) const
+    {
+        lock_guard<mutex> guard(writeLock);
+        return routeMap.contains(routeID);
+    }
+
+    int totalStations() const { return snapshot()->stations.size(); }
+    int totalRoutes() const { return snapshot()->routes.size(); }
+
+    // The writer's tables, for code on the mutating thread (importers, the
+    // generator, writing a network image); other threads use snapshot()
+    const DynamicArray<Station> &getStations() const { return stations; }
+    const DynamicArray<Route> &getRoutes() const { return routes; }
+
+    // Serialize stations, routes and the graph's adjacency (snapshot section).
+    // Written from one version, so writers are not held up meanwhile.
+    void writeSnapshot(BinaryWriter &out) const
+    {
+        NetworkSnapshot net = snapshot();
+        const DynamicArray<Station> &stations = net->stations;
+        const DynamicArray<Route> &routes = net->routes;
+        out.writeInt(stations.size());
+        for (int i = 0; i < stations.size(); i++)
+        {
+            out.writeInt(stations[i].getID());
+            out.writeInt(stations[i].getPassengerCount());
+            out.writeString(stations[i].getName());
+            out.writeString(stations[i].getLocation());
+        }
+
+        out.writeInt(routes.size());
+        for (int i = 0; i < routes.size(); i++)
+        {
+            out.writeInt(routes[i].getRouteID());
+            out.writeInt(routes[i].getStartStationID());
+            out.writeInt(routes[i].getEndStationID());
+            out.writeDouble(routes[i].getDistance());
+        }
+
+        net->graph.writeSnapshot(out);
+    }
+
+    // Take over the state another manager read from a snapshot (loaded is
+    // left with this one's old state); lets a snapshot be decoded in full
+    // before any live state is replaced
+    void adoptSnapshot(RouteManager &loaded)
+    {
+        lock_guard<mutex> guard(writeLock);
+        graph.swap(loaded.graph);
+        stations.swap(loaded.stations);
+        routes.swap(loaded.routes);
+        stationMap.swap(loaded.stationMap);
+        routeMap.swap(loaded.routeMap);
+        changed();
+    }
+
+    // Replace every station and route (e.g. with a loaded network image).
+    // newStations/newRoutes must be valid as for addBulk. Not logged: callers
+    // checkpoint afterwards, as the importers do.
+    void replaceNetwork(const DynamicArray<Station> &newStations, const DynamicArray<Route> &newRoutes)
+    {
+        RouteManager loaded;
+        loaded.addBulk(newStations, newRoutes);
+        adoptSnapshot(loaded);
+    }
+
+    // Replace all state with a snapshot section. The graph is restored from
+    // its stored adjacency and the hash tables are sized up front, so no
+    // addStation/addRoute calls are replayed. State is untouched on failure.
+    bool readSnapshot(BinaryReader &in)
+    {
+        int stationCount = in.readCount(16);
+        DynamicArray<Station> newStations(stationCount + 1);
+        for (int i = 0; i < stationCount && in.good(); i++)
+        {
+            int id = in.readInt();
+            int passengers = in.readInt();
+            string name = in.readString();
+            string location = in.readString();
+            newStations.push_back(Station(id, name, location));
+            newStations[i].setPassengerCount(passengers);
+        }
+
+        int routeCount = in.readCount(20);
+        DynamicArray<Route> newRoutes(routeCount + 1);
+        for (int i = 0; i < routeCount && in.good(); i++)
+        {
+            int id = in.readInt();
+            int start = in.readInt();
+            int end = in.readInt();
+            double distance = in.readDouble();
+            newRoutes.push_back(Route(id, start, end, distance));
+        }
+
+        lock_guard<mutex> guard(writeLock);
+        if (!in.good() || !graph.readSnapshot(in))
+            return false;
+        if (graph.vertexCount() != stationCount)
+        {
+            rebuildGraph(); // keep the graph in step with the current stations
+            return false;
+        }
+
+        stations.swap(newStations);
+        routes.swap(newRoutes);
+
+        stationMap.clear();
+        stationMap.reserve(stations.size());
+        for (int i = 0; i < stations.size(); i++)
+            stationMap.insert(stations[i].getID(), stations[i]);
+        routeMap.clear();
+        routeMap.reserve(routes.size());
+        for (int i = 0; i < routes.size(); i++)
+            routeMap.insert(routes[i].getRouteID(), routes[i]);
+        changed();
+        return true;
+    }
+
+    // Check if station exists (writer-side, like routeExists)
     // Using HashTable for O(1) lookup
     bool stationExists(int stationID) const
     {
+        lock_guard<mutex> guard(writeLock);
         return stationMap.contains(stationID);
     }
 
     // Update passenger count at a station (increment for arrivals)
-    void incrementStationPassengers(int stationID)
+    bool incrementStationPassengers(int stationID)
     {
+        lock_guard<mutex> guard(writeLock);
+        if (wal && !wal->logId(WAL_STATION_PASSENGER, stationID))
+        {
+            cout << "ERROR: Could not log the change; passenger count not updated" << endl;
+            return false;
+        }
         for (int i = 0; i < stations.size(); i++)
         {
             if (stations[i].getID() == stationID)
@@ -211,209 +545,269 @@ public:
                 break;
             }
         }
+        changed();
+        return true;
     }
 
     // Display all stations
     void displayStations() const
     {
-        cout << "Stations:" << endl;
+        OutputSink out(cout);
+        exportStations(out, OUTPUT_TEXT);
+    }
+
+    // Write every station as text lines, CSV or JSON
+    void exportStations(OutputSink &out, OutputFormat format) const
+    {
+        NetworkSnapshot net = snapshot();
+        const DynamicArray<Station> &stations = net->stations;
+        if (format == OUTPUT_TEXT)
+        {
+            out << "Stations:\n";
+            for (int i = 0; i < stations.size(); i++)
+                stations[i].display(out);
+            return;
+        }
+        const char *const columns[] = {"id", "name", "location", "passengers"};
+        RecordWriter w(out, format, columns, 4);
         for (int i = 0; i < stations.size(); i++)
         {
-            stations[i].display();
+            w.beginRow();
+            w.field(stations[i].getID());
+            w.field(stations[i].getName());
+            w.field(stations[i].getLocation());
+            w.field(stations[i].getPassengerCount());
+            w.endRow();
         }
     }
 
     // Display stations sorted by passenger count
     void displayStationsSortedByPassengers(bool ascending = false) const
     {
+        NetworkSnapshot net = snapshot();
+        const DynamicArray<Station> &stations = net->stations;
+        OutputSink out(cout);
         if (stations.size() == 0)
         {
-            cout << "No stations available." << endl;
+            out << "No stations available.\n";
             return;
         }
 
-        // Create a copy and sort using quickSort
-        DynamicArray<Station> sorted;
-        for (int i = 0; i < stations.size(); i++)
-            sorted.push_back(stations[i]);
-
-        // Using insertion sort for simplicity with custom comparator
-        for (int i = 1; i < sorted.size(); i++)
-        {
-            Station key = sorted[i];
-            int j = i - 1;
-            if (ascending)
-            {
-                while (j >= 0 && sorted[j] > key)
-                {
-                    sorted[j + 1] = sorted[j];
-                    j--;
-                }
-            }
-            else
-            {
-                while (j >= 0 && sorted[j] < key) // descending order
-                {
-                    sorted[j + 1] = sorted[j];
-                    j--;
-                }
-            }
-            sorted[j + 1] = key;
-        }
+        // Integer key: stable radix sort of indices, stations are not copied
+        DynamicArray<int> order(stations.size());
+        radixSortIndices(stations, stationPassengerKey, order, ascending);
 
-        cout << "Stations (sorted by passenger count - " << (ascending ? "lowest" : "highest") << " first):" << endl;
-        for (int i = 0; i < sorted.size(); i++)
+        out << "Stations (sorted by passenger count - " << (ascending ? "lowest" : "highest") << " first):\n";
+        for (int i = 0; i < order.size(); i++)
         {
-            sorted[i].display();
+            stations[order[i]].display(out);
         }
     }
 
     // Display routes sorted by distance
     void displayRoutesSortedByDistance(bool ascending = true) const
     {
+        NetworkSnapshot net = snapshot();
+        const DynamicArray<Route> &routes = net->routes;
+        OutputSink out(cout);
         if (routes.size() == 0)
         {
-            cout << "No routes available." << endl;
+            out << "No routes available.\n";
             return;
         }
 
-        // Create a copy and sort
-        DynamicArray<Route> sorted;
+        // Create a copy and merge sort it (O(n log n), stable: routes of equal
+        // distance keep their stored order)
+        DynamicArray<Route> sorted(routes.size());
         for (int i = 0; i < routes.size(); i++)
             sorted.push_back(routes[i]);
 
-        // Insertion sort
-        for (int i = 1; i < sorted.size(); i++)
-        {
-            Route key = sorted[i];
-            int j = i - 1;
-            if (ascending)
-            {
-                while (j >= 0 && sorted[j] > key)
-                {
-                    sorted[j + 1] = sorted[j];
-                    j--;
-                }
-            }
-            else
-            {
-                while (j >= 0 && sorted[j] < key)
-                {
-                    sorted[j + 1] = sorted[j];
-                    j--;
-                }
-            }
-            sorted[j + 1] = key;
-        }
+        mergeSortBuffered(sorted.getRawArray(), sorted.size(),
+                          KeyCompare<double (*)(const Route &)>(routeDistanceKey, ascending));
 
-        cout << "Routes (sorted by distance - " << (ascending ? "shortest" : "longest") << " first):" << endl;
+        out << "Routes (sorted by distance - " << (ascending ? "shortest" : "longest") << " first):\n";
         for (int i = 0; i < sorted.size(); i++)
         {
-            string startName = getStationNameById(sorted[i].getStartStationID());
-            string endName = getStationNameById(sorted[i].getEndStationID());
-            cout << "Route ID: " << sorted[i].getRouteID()
-                 << ", From: " << startName
-                 << ", To: " << endName
-                 << ", Distance: " << sorted[i].getDistance() << " km" << endl;
+            sorted[i].displayWithNames(out, net->stationName(sorted[i].getStartStationID()),
+                                       net->stationName(sorted[i].getEndStationID()));
         }
     }
 
     // Display all routes with station names
     void displayRoutes() const
     {
-        cout << "Routes:" << endl;
-        for (int i = 0; i < routes.size(); i++)
-        {
-            string startName = "Unknown";
-            string endName = "Unknown";
+        OutputSink out(cout);
+        exportRoutes(out, OUTPUT_TEXT);
+    }
 
-            // Find station names
-            for (int j = 0; j < stations.size(); j++)
+    // Write every route (with station names) as text lines, CSV or JSON
+    void exportRoutes(OutputSink &out, OutputFormat format) const
+    {
+        NetworkSnapshot net = snapshot();
+        const DynamicArray<Route> &routes = net->routes;
+        if (format == OUTPUT_TEXT)
+        {
+            out << "Routes:\n";
+            for (int i = 0; i < routes.size(); i++)
             {
-                if (stations[j].getID() == routes[i].getStartStationID())
-                    startName = stations[j].getName();
-                if (stations[j].getID() == routes[i].getEndStationID())
-                    endName = stations[j].getName();
+                const Station *start = net->findStation(routes[i].getStartStationID());
+                const Station *end = net->findStation(routes[i].getEndStationID());
+                routes[i].displayWithNames(out, start ? start->getName() : "Unknown", end ? end->getName() : "Unknown");
             }
-
-            cout << "Route ID: " << routes[i].getRouteID()
-                 << ", From: " << startName
-                 << ", To: " << endName
-                 << ", Distance: " << routes[i].getDistance() << " km" << endl;
+            return;
+        }
+        const char *const columns[] = {"id", "from_id", "from", "to_id", "to", "distance_km"};
+        RecordWriter w(out, format, columns, 6);
+        for (int i = 0; i < routes.size(); i++)
+        {
+            const Route &r = routes[i];
+            w.beginRow();
+            w.field(r.getRouteID());
+            w.field(r.getStartStationID());
+            w.field(net->stationName(r.getStartStationID()));
+            w.field(r.getEndStationID());
+            w.field(net->stationName(r.getEndStationID()));
+            w.field(r.getDistance());
+            w.endRow();
         }
     }
 
     // BFS from a starting station
-    void BFS(int startID)
+    void BFS(int startID) const
     {
-        graph.setLabelProvider(getStationNameByIdStatic);
-        string startName = getStationNameById(startID);
-        cout << "BFS starting from " << startName << ":" << endl;
-        graph.BFS(startID);
+        NetworkSnapshot net = snapshot();
+        cout << "BFS starting from " << net->stationName(startID) << ":" << endl;
+        net->graph.BFS(startID, net->labels());
     }
 
     // DFS from a starting station
-    void DFS(int startID)
+    void DFS(int startID) const
     {
-        graph.setLabelProvider(getStationNameByIdStatic);
-        string startName = getStationNameById(startID);
-        cout << "DFS starting from " << startName << ":" << endl;
-        graph.DFS(startID);
+        NetworkSnapshot net = snapshot();
+        cout << "DFS starting from " << net->stationName(startID) << ":" << endl;
+        net->graph.DFS(startID, net->labels());
     }
 
     // Shortest path using Dijkstra
-    void shortestPath(int startID, int endID)
+    void shortestPath(int startID, int endID) const
     {
-        graph.setLabelProvider(getStationNameByIdStatic);
-        string startName = getStationNameById(startID);
-        string endName = getStationNameById(endID);
-        cout << "Shortest path from " << startName << " to " << endName << ":" << endl;
-        graph.Dijkstra(startID, endID);
+        METRIC_TIMER("itnms_shortest_path_seconds{variant=\"display\"}", "Shortest-path queries");
+        NetworkSnapshot net = snapshot();
+        cout << "Shortest path from " << net->stationName(startID) << " to " << net->stationName(endID) << ":" << endl;
+        net->graph.Dijkstra(startID, endID, net->labels());
+    }
+
+    // Shortest path as data: station IDs into path, returns the distance
+    // or -1 if a station is missing or unreachable. Prints nothing.
+    int findShortestPath(int startID, int endID, DynamicArray<int> &path) const
+    {
+        METRIC_TIMER("itnms_shortest_path_seconds{variant=\"heap\"}", "Shortest-path queries");
+        return snapshot()->graph.shortestPath(startID, endID, path);
+    }
+
+    // Shortest distances between station sets: out[r * targets.size() + c]
+    // from sources[r] to targets[c], -1 if missing or unreachable. One
+    // Dijkstra per source, sources spread over the shared thread pool.
+    void distanceMatrix(const DynamicArray<int> &sources, const DynamicArray<int> &targets, DynamicArray<int> &out) const
+    {
+        METRIC_TIMER("itnms_distance_matrix_seconds", "Multi-source distance-matrix queries");
+        snapshot()->graph.distanceMatrix(sources.getRawArray(), sources.size(), targets.getRawArray(), targets.size(), out,
+                                         &ThreadPool::shared());
     }
 
     // Minimum Spanning Tree
-    void minimumSpanningTree()
+    void minimumSpanningTree() const
     {
-        graph.setLabelProvider(getStationNameByIdStatic);
+        NetworkSnapshot net = snapshot();
         cout << "Minimum Spanning Tree:" << endl;
-        graph.MST();
+        net->graph.MST(net->labels());
     }
 
     // Show most crowded station based on ticket activity
-    void showMostCrowdedStation(const DynamicArray<Ticket> &tickets)
+    void showMostCrowdedStation(const TicketStore &tickets) const
     {
-        Analytics::mostCrowdedStationByTickets(stations, tickets, getStationNameByIdStatic);
+        NetworkSnapshot net = snapshot();
+        Analytics::mostCrowdedStationByTickets(net->stations, tickets, net->labels());
     }
 
     // Show busiest route
-    void showBusiestRoute(const DynamicArray<Ticket> &tickets)
+    void showBusiestRoute(const TicketStore &tickets) const
+    {
+        NetworkSnapshot net = snapshot();
+        Analytics::busiestRouteByTickets(net->routes, tickets, net->labels());
+    }
+
+    // Busiest route as data: false if there is none, else the route and its
+    // ticket count
+    bool findBusiestRoute(const TicketStore &tickets, Route &route, int &ticketCount) const
+    {
+        NetworkSnapshot net = snapshot();
+        int idx = Analytics::busiestRoute(net->routes, tickets, ticketCount);
+        if (idx < 0)
+            return false;
+        route = net->routes[idx];
+        return true;
+    }
+
+    // Show the busiest origin-destination pairs with station names
+    void showTopOdPairs(const OdMatrix &od, int topN = 10) const
+    {
+        NetworkSnapshot net = snapshot();
+        Analytics::topOriginDestinationPairs(od, topN, net->labels());
+    }
+
+    // Passengers per route when every trip of od rides its shortest path,
+    // heaviest first; routed and unrouted count the trips with and without
+    // a path. Only trips od gained since the last call are assigned.
+    void routeLoads(const OdMatrix &od, DynamicArray<RouteLoad> &out, long long &routed, long long &unrouted) const
+    {
+        NetworkSnapshot net = snapshot();
+        {
+            lock_guard<mutex> guard(loadLock);
+            loadAssignment.assign(*net, od);
+            loadAssignment.routeLoads(*net, out);
+            routed = loadAssignment.routedTrips();
+            unrouted = loadAssignment.unroutedTrips();
+        }
+        introSort(out.getRawArray(), out.size(), RouteLoadHeavier());
+    }
+
+    // Show the routes carrying the most passengers
+    void showRouteLoads(const OdMatrix &od, int topN = 10) const
     {
-        Analytics::busiestRouteByTickets(routes, tickets, getStationNameByIdStatic);
+        DynamicArray<RouteLoad> loads;
+        long long routed, unrouted;
+        routeLoads(od, loads, routed, unrouted);
+        NetworkSnapshot net = snapshot();
+        Analytics::heaviestRoutes(loads, topN, routed, unrouted, net->labels());
     }
 
     // Show traffic density prediction
-    void showTrafficDensity(const DynamicArray<Ticket> &tickets, int topN = 5)
+    void showTrafficDensity(const TicketStore &tickets, int topN = 5) const
     {
-        Analytics::trafficDensityPrediction(stations, tickets, getStationNameByIdStatic, topN);
+        NetworkSnapshot net = snapshot();
+        Analytics::trafficDensityPrediction(net->stations, tickets, net->labels(), topN);
     }
 
     // Detect cycle in network
-    bool detectCycle()
+    bool detectCycle() const
     {
-        return graph.detectCycle();
+        return snapshot()->graph.detectCycle();
     }
 
     // Search for route between two stations
     void searchRoute(int startID, int endID) const
     {
+        NetworkSnapshot net = snapshot();
+        const DynamicArray<Route> &routes = net->routes;
         bool found = false;
         for (int i = 0; i < routes.size(); i++)
         {
             if ((routes[i].getStartStationID() == startID && routes[i].getEndStationID() == endID) ||
                 (routes[i].getStartStationID() == endID && routes[i].getEndStationID() == startID))
             {
-                string startName = getStationNameById(routes[i].getStartStationID());
-                string endName = getStationNameById(routes[i].getEndStationID());
+                string startName = net->stationName(routes[i].getStartStationID());
+                string endName = net->stationName(routes[i].getEndStationID());
                 cout << "Route found!" << endl;
                 cout << "Route ID: " << routes[i].getRouteID()
                      << ", From: " << startName
@@ -428,18 +822,20 @@ public:
         }
     }
 
-    // Static helper for function pointer (workaround for no lambdas)
-    static RouteManager *instance;
+    // Static helper for plain function-pointer callers (TicketManager
+    // listings); reads a snapshot of the manager set with setInstance()
+    static atomic<RouteManager *> instance;
     static string getStationNameByIdStatic(int id)
     {
-        if (instance)
-            return instance->getStationNameById(id);
+        RouteManager *manager = instance.load(memory_order_acquire);
+        if (manager)
+            return manager->getStationNameById(id);
         return "ID " + to_string(id);
     }
-    void setInstance() { instance = this; }
+    void setInstance() { instance.store(this, memory_order_release); }
 };
 
 // Static member definition
-RouteManager *RouteManager::instance = nullptr;
+atomic<RouteManager *> RouteManager::instance(nullptr);
 
 #endif
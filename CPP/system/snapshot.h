@@ -0,0 +1,256 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include "../ds/binary_stream.h"
+#include "route_manager.h"
+#include "vehicle_manager.h"
+#include "ticket_manager.h"
+#include "history_manager.h"
+#include "write_ahead_log.h"
+#include "durable_file.h"
+
+using namespace std;
+
+// Binary snapshot of the whole network state
+//
+// Layout (all integers in host byte order, checked via byteOrder):
+//   header   magic "ITNMSNAP" | u32 version | u32 byteOrder | u32 sectionCount | u32 headerCrc
+//   section  u32 tag | u32 payloadCrc | i64 payloadLength | payload bytes
+//
+// headerCrc covers the 20 header bytes before it; payloadCrc is the CRC-32
+// of the payload. Unknown section tags are skipped so newer writers can add
+// sections; a higher major version is rejected. The optional META section
+// holds the write-ahead log LSN the snapshot is consistent with.
+
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+#define SNAPSHOT_HEADER_SIZE 24
+
+enum SnapshotSection
+{
+    SNAPSHOT_ROUTES = 0x53544E52,   // "RNTS": stations, routes, graph
+    SNAPSHOT_VEHICLES = 0x53484556, // "VEHS"
+    SNAPSHOT_TICKETS = 0x53544B54,  // "TKTS": counter, queue, ticket store
+    SNAPSHOT_HISTORY = 0x54534948,  // "HIST"
+    SNAPSHOT_META = 0x4154454D      // "META": last applied log LSN
+};
+
+class SnapshotManager
+{
+private:
+    static const char *magic() { return "ITNMSNAP"; }
+
+    // Write one section: header with placeholder CRC/length, payload, then patch
+    static void beginSection(BinaryWriter &out, unsigned int tag, long long &start)
+    {
+        out.writeUInt(tag);
+        out.writeUInt(0);
+        out.writeInt64(0);
+        start = out.size();
+    }
+
+    static void endSection(BinaryWriter &out, long long start)
+    {
+        long long length = out.size() - start;
+        out.patchUInt(start - 12, crc32(out.bytes() + start, length));
+        out.patchInt64(start - 8, length);
+    }
+
+    // Locate and verify one section's payload: 1 = found, 0 = missing,
+    // -1 = corrupt (bad checksum or truncated)
+    static int findSection(const char *bytes, long long size, unsigned int wanted,
+                           const char *&payload, long long &length)
+    {
+        BinaryReader in(bytes, size);
+        char header[8];
+        in.readBytes(header, 8);
+        in.readUInt(); // version
+        in.readUInt(); // byte order
+        unsigned int sections = in.readUInt();
+        in.readUInt(); // header CRC
+        for (unsigned int i = 0; i < sections && in.good(); i++)
+        {
+            unsigned int tag = in.readUInt();
+            unsigned int crc = in.readUInt();
+            long long n = in.readInt64();
+            if (!in.good() || n < 0 || n > in.remaining())
+                return -1;
+            const char *p = bytes + in.position();
+            if (tag == wanted)
+            {
+                if (crc32(p, n) != crc)
+                {
+                    cerr << "Snapshot section " << i << " failed its checksum" << endl;
+                    return -1;
+                }
+                payload = p;
+                length = n;
+                return 1;
+            }
+            in.skip(n);
+        }
+        return in.good() ? 0 : -1;
+    }
+
+public:
+    // Serialize every manager into out (the complete file image)
+    static void serialize(BinaryWriter &out, const RouteManager &routes, const VehicleManager &vehicles,
+                          const TicketManager &tickets, const HistoryManager &history, long long logLsn = 0)
+    {
+        out.clear();
+        out.writeBytes(magic(), 8);
+        out.writeUInt(SNAPSHOT_VERSION);
+        out.writeUInt(SNAPSHOT_BYTE_ORDER);
+        out.writeUInt(5);
+        out.writeUInt(crc32(out.bytes(), out.size()));
+
+        long long start;
+        beginSection(out, SNAPSHOT_META, start);
+        out.writeInt64(logLsn);
+        endSection(out, start);
+
+        beginSection(out, SNAPSHOT_ROUTES, start);
+        routes.writeSnapshot(out);
+        endSection(out, start);
+
+        beginSection(out, SNAPSHOT_VEHICLES, start);
+        vehicles.writeSnapshot(out);
+        endSection(out, start);
+
+        beginSection(out, SNAPSHOT_TICKETS, start);
+        tickets.writeSnapshot(out);
+        endSection(out, start);
+
+        beginSection(out, SNAPSHOT_HISTORY, start);
+        history.writeSnapshot(out);
+        endSection(out, start);
+    }
+
+    // Restore every manager from a file image. The header and all section
+    // checksums are verified before any manager is modified.
+    static bool deserialize(const char *bytes, long long size, RouteManager &routes, VehicleManager &vehicles,
+                            TicketManager &tickets, HistoryManager &history, long long *logLsn = nullptr)
+    {
+        if (size < SNAPSHOT_HEADER_SIZE || memcmp(bytes, magic(), 8) != 0)
+        {
+            cerr << "Not a snapshot file" << endl;
+            return false;
+        }
+
+        BinaryReader header(bytes + 8, SNAPSHOT_HEADER_SIZE - 8);
+        unsigned int version = header.readUInt();
+        unsigned int byteOrder = header.readUInt();
+        header.readUInt(); // section count
+        unsigned int headerCrc = header.readUInt();
+        if (crc32(bytes, SNAPSHOT_HEADER_SIZE - 4) != headerCrc)
+        {
+            cerr << "Snapshot header is corrupt" << endl;
+            return false;
+        }
+        if (version > SNAPSHOT_VERSION)
+        {
+            cerr << "Snapshot version " << version << " is newer than supported (" << SNAPSHOT_VERSION << ")" << endl;
+            return false;
+        }
+        if (byteOrder != SNAPSHOT_BYTE_ORDER)
+        {
+            cerr << "Snapshot was written on a machine with a different byte order" << endl;
+            return false;
+        }
+
+        const unsigned int tags[4] = {SNAPSHOT_ROUTES, SNAPSHOT_VEHICLES, SNAPSHOT_TICKETS, SNAPSHOT_HISTORY};
+        const char *payload[4];
+        long long length[4];
+        for (int i = 0; i < 4; i++)
+        {
+            if (findSection(bytes, size, tags[i], payload[i], length[i]) != 1)
+            {
+                cerr << "Snapshot is missing or has a corrupt section" << endl;
+                return false;
+            }
+        }
+
+        // META is optional (absent: not tied to a log)
+        long long lsn = 0;
+        const char *metaPayload;
+        long long metaLength;
+        int meta = findSection(bytes, size, SNAPSHOT_META, metaPayload, metaLength);
+        if (meta < 0)
+        {
+            cerr << "Snapshot META section is corrupt" << endl;
+            return false;
+        }
+        if (meta == 1)
+        {
+            BinaryReader metaIn(metaPayload, metaLength);
+            lsn = metaIn.readInt64();
+        }
+
+        // Decode every section into scratch managers; the live ones are only
+        // replaced once all of them have decoded
+        BinaryReader routeIn(payload[0], length[0]);
+        BinaryReader vehicleIn(payload[1], length[1]);
+        BinaryReader ticketIn(payload[2], length[2]);
+        BinaryReader historyIn(payload[3], length[3]);
+        RouteManager loadedRoutes;
+        VehicleManager loadedVehicles;
+        TicketManager loadedTickets;
+        HistoryManager loadedHistory;
+        if (!loadedRoutes.readSnapshot(routeIn) || !loadedVehicles.readSnapshot(vehicleIn) ||
+            !loadedTickets.readSnapshot(ticketIn) || !loadedHistory.readSnapshot(historyIn))
+        {
+            cerr << "Snapshot payload is malformed; nothing was restored" << endl;
+            return false;
+        }
+        routes.adoptSnapshot(loadedRoutes);
+        vehicles.adoptSnapshot(loadedVehicles);
+        tickets.adoptSnapshot(loadedTickets);
+        history.adoptSnapshot(loadedHistory);
+        if (logLsn)
+            *logLsn = lsn;
+        return true;
+    }
+
+    // Write a snapshot file: path.tmp is written and fsynced, renamed over
+    // path, then the directory is fsynced so the rename itself is durable.
+    // Only a true return makes it safe to truncate the write-ahead log.
+    static bool save(const string &path, const RouteManager &routes, const VehicleManager &vehicles,
+                     const TicketManager &tickets, const HistoryManager &history, long long logLsn = 0)
+    {
+        BinaryWriter out(1 << 20);
+        serialize(out, routes, vehicles, tickets, history, logLsn);
+
+        return DurableFile::replace(path, out.bytes(), out.size());
+    }
+
+    // Load a snapshot file, replacing the managers' state
+    static bool load(const string &path, RouteManager &routes, VehicleManager &vehicles,
+                     TicketManager &tickets, HistoryManager &history, long long *logLsn = nullptr)
+    {
+        ifstream file(path.c_str(), ios::binary | ios::ate);
+        if (!file)
+        {
+            cerr << "Cannot open " << path << endl;
+            return false;
+        }
+        long long size = (long long)file.tellg();
+        if (size <= 0)
+        {
+            cerr << "Snapshot " << path << " is empty" << endl;
+            return false;
+        }
+        char *bytes = new char[size];
+        file.seekg(0);
+        file.read(bytes, size);
+        bool ok = file.good() && deserialize(bytes, size, routes, vehicles, tickets, history, logLsn);
+        delete[] bytes;
+        return ok;
+    }
+};
+
+#endif
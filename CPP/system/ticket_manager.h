@@ -2,45 +2,224 @@
 #define TICKET_MANAGER_H
 
 #include <iostream>
+#include <atomic>
 #include "../ds/queue.h"
 #include "../ds/array.h"
+#include "../ds/pair.h"
+#include "../ds/parallel_sorting.h"
+#include "../ds/metrics.h"
+#include "../ds/output_sink.h"
 #include "../models/passenger.h"
 #include "../models/ticket.h"
+#include "ticket_store.h"
+#include "od_matrix.h"
+#include "write_ahead_log.h"
 
 using namespace std;
 
+// Result of a batch issuance (returned instead of printing per ticket)
+struct TicketBatchSummary
+{
+    int issued;          // tickets issued in this batch
+    int firstTicketID;   // ID of the first ticket (0 if none issued)
+    int lastTicketID;    // ID of the last ticket (0 if none issued)
+    int remainingQueue;  // passengers still waiting afterwards
+    Timestamp issueTime; // shared issue time of the batch
+
+    TicketBatchSummary() : issued(0), firstTicketID(0), lastTicketID(0), remainingQueue(0), issueTime(0) {}
+};
+
+// Row order of a ticket export
+enum TicketOrder
+{
+    TICKETS_BY_ID,         // issue order, as stored
+    TICKETS_BY_PASSENGER,  // passenger ID, then issue order
+    TICKETS_BY_ORIGIN,     // start station ID, then issue order
+    TICKETS_BY_DESTINATION // end station ID, then issue order
+};
+
+// Parse "by-id", "by-passenger", "by-origin" or "by-destination"; false if unknown
+inline bool parseTicketOrder(const string &name, TicketOrder &order)
+{
+    if (name == "by-id")
+        order = TICKETS_BY_ID;
+    else if (name == "by-passenger")
+        order = TICKETS_BY_PASSENGER;
+    else if (name == "by-origin")
+        order = TICKETS_BY_ORIGIN;
+    else if (name == "by-destination")
+        order = TICKETS_BY_DESTINATION;
+    else
+        return false;
+    return true;
+}
+
+// (key, row) pairs by key only: the stable sort keeps equal keys in issue order
+struct TicketRowKeyLess
+{
+    bool operator()(const Pair<int, int> &a, const Pair<int, int> &b) const { return a.first < b.first; }
+};
+
 class TicketManager
 {
 private:
     Queue<Passenger> passengerQueue;    // FIFO queue for passengers
-    DynamicArray<Ticket> ticketsIssued; // Store all issued tickets
-    int nextTicketID = 1;               // Auto-increment ticket ID
+    TicketStore ticketsIssued;          // Store all issued tickets (columnar)
+    atomic<int> nextTicketID;           // Auto-increment ticket ID (atomic)
+    WriteAheadLog *wal;                 // mutation log (nullptr = not logged)
+    mutable OdMatrix odMatrix;          // trips of ticketsIssued, caught up on read
+
+    // Dequeue n passengers and store their tickets as firstID, firstID + 1, ...
+    // (shared by live issuance and log replay)
+    void storeIssued(int n, int firstID, Timestamp issueTime, const int startIDs[], const int endIDs[],
+                     int startStationID, int endStationID)
+    {
+        ticketsIssued.reserveAdditional(n);
+        for (int i = 0; i < n; i++)
+        {
+            Passenger p = passengerQueue.dequeue();
+            int start = startIDs ? startIDs[i] : startStationID;
+            int end = endIDs ? endIDs[i] : endStationID;
+            ticketsIssued.appendFields(firstID + i, p, start, end, issueTime);
+        }
+        ticketsIssued.countIssued(issueTime, n);
+    }
+
+    TicketBatchSummary issueBatch(int maxCount, const int startIDs[], const int endIDs[],
+                                  int startStationID, int endStationID)
+    {
+        TicketBatchSummary summary;
+        int n = passengerQueue.size();
+        if (maxCount < n)
+            n = maxCount;
+        summary.issueTime = currentTimestamp();
+        if (n <= 0)
+        {
+            summary.remainingQueue = passengerQueue.size();
+            return summary;
+        }
+
+        summary.firstTicketID = allocateTicketIDs(n);
+        if (wal && !wal->logIssueTickets(summary.firstTicketID, n, summary.issueTime, startIDs, endIDs,
+                                         startStationID, endStationID))
+        {
+            cout << "ERROR: Could not log the change; no tickets issued" << endl;
+            releaseTicketIDs(summary.firstTicketID, n);
+            summary.firstTicketID = 0;
+            summary.remainingQueue = passengerQueue.size();
+            return summary;
+        }
+        storeIssued(n, summary.firstTicketID, summary.issueTime, startIDs, endIDs, startStationID, endStationID);
+        METRIC_ADD("itnms_tickets_issued_total{path=\"batch\"}", "Tickets issued", n);
+
+        summary.issued = n;
+        summary.lastTicketID = summary.firstTicketID + n - 1;
+        summary.remainingQueue = passengerQueue.size();
+        return summary;
+    }
 
 public:
+    TicketManager() : nextTicketID(1), wal(nullptr)
+    {
+        MemoryTracker &memory = MemoryTracker::instance();
+        passengerQueue.setMemoryAccount(memory.account("passengers.queue"));
+        ticketsIssued.setMemoryAccount(memory.account("tickets.log"), memory.account("tickets.index"));
+        odMatrix.setMemoryAccount(memory.account("tickets.od"));
+    }
+
+    // Log every later mutation to log (nullptr to stop logging)
+    void attachLog(WriteAheadLog *log) { wal = log; }
+
+    // Add used bytes of every container to its account (memory report)
+    void measureMemory() const
+    {
+        passengerQueue.measureMemory();
+        ticketsIssued.measureMemory();
+        odMatrix.measureMemory();
+    }
+
+    // Reserve n consecutive ticket IDs; returns the first one.
+    // Lock-free, safe to call from any thread.
+    int allocateTicketIDs(int n)
+    {
+        return nextTicketID.fetch_add(n, memory_order_relaxed);
+    }
+
+    // Give back the block [firstID, firstID + n) if it is still the last one
+    // reserved (e.g. its merge failed); false if later IDs were handed out
+    bool releaseTicketIDs(int firstID, int n)
+    {
+        int expected = firstID + n;
+        return nextTicketID.compare_exchange_strong(expected, firstID, memory_order_relaxed);
+    }
+
+    // Merge tickets issued elsewhere (e.g. a per-thread shard) into the store.
+    // Not synchronized: callers serialize merges themselves.
+    bool mergeTickets(const DynamicArray<TicketRecord> &records)
+    {
+        if (wal && !wal->logMergeTickets(records.getRawArray(), records.size()))
+        {
+            cout << "ERROR: Could not log the change; " << records.size() << " tickets not merged" << endl;
+            return false;
+        }
+        ticketsIssued.appendRecords(records.getRawArray(), records.size());
+        return true;
+    }
+
     // Add passenger to queue
-    void addPassengerToQueue(const Passenger &p)
+    bool addPassengerToQueue(const Passenger &p)
     {
+        if (wal && !wal->logEnqueuePassenger(p))
+        {
+            cout << "ERROR: Could not log the change; passenger not queued" << endl;
+            return false;
+        }
         passengerQueue.push(p);
         cout << "Passenger added to queue: " << p.getName() << endl;
+        return true;
     }
 
-    // Process next passenger in queue with route information
-    void processNextPassenger(int startStationID = 0, int endStationID = 0, const string &startName = "", const string &endName = "")
+    // Queue many passengers at once, without per-passenger output; stops at
+    // the first passenger that cannot be logged and returns false
+    bool addPassengersToQueue(const DynamicArray<Passenger> &batch)
     {
+        for (int i = 0; i < batch.size(); i++)
+        {
+            if (wal && !wal->logEnqueuePassenger(batch[i]))
+            {
+                cout << "ERROR: Could not log the change; only " << i << " passengers queued" << endl;
+                return false;
+            }
+            passengerQueue.push(batch[i]);
+        }
+        return true;
+    }
+
+    // Process next passenger in queue with route information; false if the
+    // queue is empty or the ticket could not be logged
+    bool processNextPassenger(int startStationID = 0, int endStationID = 0, const string &startName = "", const string &endName = "")
+    {
+        METRIC_TIMER("itnms_ticket_process_seconds", "TicketManager::processNextPassenger calls");
         if (passengerQueue.empty())
         {
             cout << "No passengers in queue." << endl;
-            return;
+            return false;
         }
 
         Passenger p = passengerQueue.front();
-        passengerQueue.pop();
-
-        Ticket t(nextTicketID++, p, startStationID, endStationID);
-        ticketsIssued.push_back(t);
+        int ticketID = allocateTicketIDs(1);
+        Timestamp now = currentTimestamp();
+        if (wal && !wal->logIssueTickets(ticketID, 1, now, nullptr, nullptr, startStationID, endStationID))
+        {
+            cout << "ERROR: Could not log the change; no ticket issued" << endl;
+            releaseTicketIDs(ticketID, 1);
+            return false;
+        }
+        storeIssued(1, ticketID, now, nullptr, nullptr, startStationID, endStationID);
+        METRIC_ADD("itnms_tickets_issued_total{path=\"single\"}", "Tickets issued", 1);
 
         cout << "Ticket issued for passenger: " << p.getName()
-             << " | Ticket ID: " << t.getTicketID();
+             << " | Ticket ID: " << ticketID;
         if (startStationID > 0 && endStationID > 0)
         {
             if (!startName.empty() && !endName.empty())
@@ -53,22 +232,45 @@ public:
             }
         }
         cout << endl;
+        return true;
+    }
+
+    // Issue tickets for up to maxCount queued passengers in one call, all on
+    // the same route. Storage is reserved up front, the calendar index is
+    // bumped once, and nothing is printed.
+    TicketBatchSummary issueTicketBatch(int maxCount, int startStationID = 0, int endStationID = 0)
+    {
+        return issueBatch(maxCount, nullptr, nullptr, startStationID, endStationID);
+    }
+
+    // Batch issuance with a route per passenger: startIDs[i]/endIDs[i] go
+    // to the i-th passenger dequeued (arrays must hold maxCount entries)
+    TicketBatchSummary issueTicketBatch(int maxCount, const int startIDs[], const int endIDs[])
+    {
+        return issueBatch(maxCount, startIDs, endIDs, 0, 0);
+    }
+
+    // Number of passengers waiting
+    int queueSize() const
+    {
+        return passengerQueue.size();
     }
 
     // Display all passengers waiting in queue
     void displayQueue()
     {
+        OutputSink out(cout);
         if (passengerQueue.empty())
         {
-            cout << "Passenger queue is empty." << endl;
+            out << "Passenger queue is empty.\n";
             return;
         }
 
         Queue<Passenger> tempQueue = passengerQueue; // copy to preserve original
-        cout << "Passengers in queue:" << endl;
+        out << "Passengers in queue:\n";
         while (!tempQueue.empty())
         {
-            cout << "- " << tempQueue.front().getName() << endl;
+            out << "- " << tempQueue.front().getName() << '\n';
             tempQueue.pop();
         }
     }
@@ -76,16 +278,17 @@ public:
     // Display all issued tickets
     void displayAllTickets()
     {
+        OutputSink out(cout);
         if (ticketsIssued.empty())
         {
-            cout << "No tickets issued yet." << endl;
+            out << "No tickets issued yet.\n";
             return;
         }
 
-        cout << "Issued Tickets:" << endl;
+        out << "Issued Tickets:\n";
         for (int i = 0; i < ticketsIssued.size(); i++)
         {
-            ticketsIssued[i].display();
+            ticketsIssued.get(i).display(out);
         }
     }
 
@@ -98,56 +301,213 @@ public:
     // Display tickets with station names (uses function pointer instead of std::function)
     void displayAllTicketsWithNames(string (*getStationName)(int)) const
     {
-        if (ticketsIssued.empty())
+        OutputSink out(cout);
+        exportTickets(out, OUTPUT_TEXT, getStationName);
+    }
+
+    // Store rows in the given order. The whole log is sorted at once with
+    // the parallel merge sort on the shared pool.
+    void ticketRows(TicketOrder order, DynamicArray<int> &rows) const
+    {
+        int n = ticketsIssued.size();
+        rows.clear();
+        rows.reserve(n);
+        if (order == TICKETS_BY_ID)
         {
-            cout << "No tickets issued yet." << endl;
+            for (int i = 0; i < n; i++)
+                rows.push_back(i);
             return;
         }
+        const DynamicArray<int> &keys = order == TICKETS_BY_PASSENGER ? ticketsIssued.passengerIDColumn()
+                                        : order == TICKETS_BY_ORIGIN  ? ticketsIssued.startStationColumn()
+                                                                      : ticketsIssued.endStationColumn();
+        DynamicArray<Pair<int, int>> keyed(n);
+        for (int i = 0; i < n; i++)
+            keyed.push_back(Pair<int, int>(keys[i], i));
+        parallelMergeSort(keyed.getRawArray(), n, TicketRowKeyLess());
+        for (int i = 0; i < n; i++)
+            rows.push_back(keyed[i].second);
+    }
 
-        cout << "Issued Tickets:" << endl;
-        for (int i = 0; i < ticketsIssued.size(); i++)
+    // Write every issued ticket as text lines (as displayAllTicketsWithNames),
+    // CSV or JSON, in issue order or sorted by passenger or station; rows are
+    // read straight from the ticket columns
+    void exportTickets(OutputSink &out, OutputFormat format, string (*getStationName)(int),
+                       TicketOrder order = TICKETS_BY_ID) const
+    {
+        DynamicArray<int> sorted;
+        if (order != TICKETS_BY_ID)
+            ticketRows(order, sorted);
+        const int *rowOf = order != TICKETS_BY_ID ? sorted.getRawArray() : nullptr;
+
+        if (format == OUTPUT_TEXT)
         {
-            const Ticket &t = ticketsIssued[i];
-            if (t.getStartStationID() > 0 && t.getEndStationID() > 0)
+            if (ticketsIssued.empty())
             {
-                t.displayWithNames(getStationName(t.getStartStationID()),
-                                   getStationName(t.getEndStationID()));
+                out << "No tickets issued yet.\n";
+                return;
             }
-            else
+            out << "Issued Tickets:\n";
+            for (int k = 0; k < ticketsIssued.size(); k++)
+            {
+                Ticket t = ticketsIssued.get(rowOf ? rowOf[k] : k);
+                if (t.getStartStationID() > 0 && t.getEndStationID() > 0)
+                    t.displayWithNames(out, getStationName(t.getStartStationID()), getStationName(t.getEndStationID()));
+                else
+                    t.display(out);
+            }
+            return;
+        }
+
+        const char *const columns[] = {"ticket_id", "passenger_id", "passenger", "age", "from_id", "from",
+                                       "to_id", "to", "issue_time"};
+        RecordWriter w(out, format, columns, 9);
+        const DynamicArray<int> &ids = ticketsIssued.ticketIDColumn();
+        const DynamicArray<int> &starts = ticketsIssued.startStationColumn();
+        const DynamicArray<int> &ends = ticketsIssued.endStationColumn();
+        const DynamicArray<Timestamp> &times = ticketsIssued.issueTimeColumn();
+        const DynamicArray<int> &passengers = ticketsIssued.passengerIDColumn();
+        const DynamicArray<int> &ages = ticketsIssued.passengerAgeColumn();
+        const DynamicArray<int> &names = ticketsIssued.passengerNameColumn();
+        const StringDictionary &dict = ticketsIssued.passengerNameDictionary();
+        string issued; // tickets come in time order: format each minute once
+        Timestamp issuedMinute = -1;
+        for (int k = 0; k < ids.size(); k++)
+        {
+            int i = rowOf ? rowOf[k] : k;
+            if (floorDiv(times[i], SECONDS_PER_MINUTE) != issuedMinute)
             {
-                t.display();
+                issuedMinute = floorDiv(times[i], SECONDS_PER_MINUTE);
+                issued = formatDateTime(times[i]);
             }
+            w.beginRow();
+            w.field(ids[i]);
+            w.field(passengers[i]);
+            w.field(dict.decode(names[i]));
+            w.field(ages[i]);
+            w.field(starts[i]);
+            w.field(starts[i] > 0 ? getStationName(starts[i]) : string());
+            w.field(ends[i]);
+            w.field(ends[i] > 0 ? getStationName(ends[i]) : string());
+            w.field(issued);
+            w.endRow();
         }
     }
 
     // Get all tickets (for analytics)
-    const DynamicArray<Ticket> &getAllTickets() const
+    const TicketStore &getAllTickets() const
     {
         return ticketsIssued;
     }
 
+    // Origin-destination matrix of all issued tickets; tickets issued since
+    // the last call are counted first (O(new tickets))
+    const OdMatrix &originDestination() const
+    {
+        odMatrix.sync(ticketsIssued);
+        return odMatrix;
+    }
+
     // Search ticket by ID
+    // Using the store's ID index for O(1) lookup
     void searchTicketById(int ticketID, string (*getStationName)(int)) const
     {
-        for (int i = 0; i < ticketsIssued.size(); i++)
+        int slot = ticketsIssued.findSlot(ticketID);
+        if (slot < 0)
         {
-            if (ticketsIssued[i].getTicketID() == ticketID)
-            {
-                cout << "Ticket found!" << endl;
-                const Ticket &t = ticketsIssued[i];
-                if (t.getStartStationID() > 0 && t.getEndStationID() > 0)
-                {
-                    t.displayWithNames(getStationName(t.getStartStationID()),
-                                       getStationName(t.getEndStationID()));
-                }
-                else
-                {
-                    t.display();
-                }
-                return;
-            }
+            cout << "Ticket with ID " << ticketID << " not found." << endl;
+            return;
         }
-        cout << "Ticket with ID " << ticketID << " not found." << endl;
+
+        cout << "Ticket found!" << endl;
+        Ticket t = ticketsIssued.get(slot);
+        if (t.getStartStationID() > 0 && t.getEndStationID() > 0)
+        {
+            t.displayWithNames(getStationName(t.getStartStationID()),
+                               getStationName(t.getEndStationID()));
+        }
+        else
+        {
+            t.display();
+        }
+    }
+
+    // Serialize the ID counter, waiting passengers and issued tickets
+    // (snapshot section)
+    void writeSnapshot(BinaryWriter &out) const
+    {
+        out.writeInt(nextTicketID.load());
+
+        out.writeInt(passengerQueue.size());
+        Queue<Passenger> tempQueue = passengerQueue; // copy to preserve original
+        while (!tempQueue.empty())
+        {
+            Passenger p = tempQueue.dequeue();
+            out.writeInt(p.getID());
+            out.writeInt(p.getAge());
+            out.writeString(p.getName());
+        }
+
+        ticketsIssued.writeSnapshot(out);
+    }
+
+    // Take over the ticket state another manager read from a snapshot
+    void adoptSnapshot(TicketManager &loaded)
+    {
+        passengerQueue = loaded.passengerQueue;
+        ticketsIssued.swap(loaded.ticketsIssued);
+        nextTicketID.store(loaded.nextTicketID.load());
+        odMatrix.clear();
+    }
+
+    // Replace all ticket state with a snapshot section; untouched on failure
+    bool readSnapshot(BinaryReader &in)
+    {
+        int nextID = in.readInt();
+        int waiting = in.readCount(12);
+        Queue<Passenger> loadedQueue;
+        for (int i = 0; i < waiting && in.good(); i++)
+        {
+            int id = in.readInt();
+            int age = in.readInt();
+            string name = in.readString();
+            loadedQueue.push(Passenger(id, name, age));
+        }
+        if (!in.good() || !ticketsIssued.readSnapshot(in))
+            return false;
+
+        passengerQueue = loadedQueue;
+        nextTicketID.store(nextID);
+        odMatrix.clear();
+        return true;
+    }
+
+    // Replay of a logged issuance: same passengers, IDs and issue time.
+    // Returns false if fewer than n passengers are queued.
+    bool applyIssuedTickets(int firstID, int n, Timestamp issueTime, const int startIDs[], const int endIDs[],
+                            int startStationID, int endStationID)
+    {
+        if (n < 0 || n > passengerQueue.size())
+            return false;
+        storeIssued(n, firstID, issueTime, startIDs, endIDs, startStationID, endStationID);
+        if (nextTicketID.load() < firstID + n)
+            nextTicketID.store(firstID + n);
+        return true;
+    }
+
+    // Replay of a logged merge
+    void applyMergedTickets(const DynamicArray<TicketRecord> &records)
+    {
+        ticketsIssued.appendRecords(records.getRawArray(), records.size());
+        for (int i = 0; i < records.size(); i++)
+            if (nextTicketID.load() <= records[i].ticketID)
+                nextTicketID.store(records[i].ticketID + 1);
+    }
+
+    // Gate validation: is this a ticket we issued? O(1), allocation-free
+    bool validateTicket(int ticketID) const
+    {
+        return ticketsIssued.findSlot(ticketID) >= 0;
     }
 };
 
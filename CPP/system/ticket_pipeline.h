@@ -0,0 +1,304 @@
+#ifndef TICKET_PIPELINE_H
+#define TICKET_PIPELINE_H
+
+#include <iostream>
+#include <atomic>
+#include <mutex>
+#include "../ds/array.h"
+#include "../ds/mpmc_queue.h"
+#include "../ds/thread_pool.h"
+#include "../models/passenger.h"
+#include "../models/timestamp.h"
+#include "ticket_store.h"
+#include "ticket_manager.h"
+
+using namespace std;
+
+// A gate terminal's request for one ticket
+struct IssueRequest
+{
+    Passenger passenger;
+    int startStationID;
+    int endStationID;
+
+    IssueRequest() : startStationID(0), endStationID(0) {}
+    IssueRequest(const Passenger &p, int start, int end) : passenger(p), startStationID(start), endStationID(end) {}
+};
+
+// Concurrent ticket issuing pipeline
+//
+//   gate threads --submit()--> one lock-free MPMC queue per shard, chosen
+//                              by passenger ID
+//                                   |
+//            issuing tasks on the thread pool (one per shard, queued by
+//            submit() when the shard is idle) pop requests from their own
+//            queue (stealing from the others when it is empty) and build
+//            tickets in their own shard buffer -- no shared writes on the
+//            hot path. A task gives its thread back after a bounded number
+//            of rounds, so the pipeline shares the pool with other work.
+//                                   |
+//            full shards are merged into the TicketManager store in bulk;
+//            ticket IDs are reserved at merge time, under the merge lock,
+//            so the store always receives IDs in increasing order and its
+//            ID index stays direct-mapped
+//
+// While the pipeline is running it is the only writer to the manager's
+// ticket store; stop() drains the queues and merges everything that is left.
+// A merge the manager rejects (its log write failed) keeps the shard's
+// tickets and returns their IDs; the pipeline then refuses new requests
+// and stop() returns false until a later stop() merges everything.
+//
+// Build with -pthread.
+
+// Drain rounds an issuing task runs before it requeues itself
+#define PIPELINE_TASK_ROUNDS 64
+
+class TicketPipeline
+{
+private:
+    // Per-shard state, padded so shards never share a cache line
+    struct Shard
+    {
+        MpmcQueue<IssueRequest> *queue;     // requests routed to this shard
+        DynamicArray<IssueRequest> popped;  // requests taken in one drain
+        DynamicArray<TicketRecord> pending; // issued, IDs assigned on merge
+        long long issued;
+        TicketPipeline *owner;
+        int index;
+        atomic<bool> scheduled;             // an issuing task is queued or running
+        char pad[64];
+
+        Shard() : queue(nullptr), issued(0), owner(nullptr), index(0), scheduled(false) {}
+    };
+
+    TicketManager &manager;
+    Shard *shards;
+    int numShards;
+    int mergeThreshold; // merge a shard once it holds this many tickets
+
+    mutex mergeLock;
+    atomic<bool> running;
+    atomic<bool> mergeFailed; // a merge was rejected; tickets wait in the shards
+    ThreadPool &pool;
+    TaskGroup tasks;     // issuing tasks; lives as long as the pipeline
+    mutex lifecycleLock; // start()/stop() against tasks queued by submit()
+
+    // Queue the shard's issuing task unless one is already queued or running.
+    // The running check and the queueing happen under lifecycleLock, so no
+    // task is queued once stop() has cleared running.
+    void schedule(int shard)
+    {
+        Shard &s = shards[shard];
+        atomic_thread_fence(memory_order_seq_cst); // pairs with the idle re-check in issueTask
+        bool idle = false;
+        if (s.scheduled.load(memory_order_seq_cst) || !s.scheduled.compare_exchange_strong(idle, true))
+            return;
+        lock_guard<mutex> guard(lifecycleLock);
+        if (!running.load(memory_order_relaxed))
+        {
+            s.scheduled.store(false, memory_order_seq_cst); // stopped: stop() drains the queue
+            return;
+        }
+        tasks.run(issueTask, &s);
+    }
+
+    // Not copyable
+    TicketPipeline(const TicketPipeline &);
+    TicketPipeline &operator=(const TicketPipeline &);
+
+    // Issuing task: drain and merge until every queue is empty or the round
+    // budget is spent, then go idle or requeue
+    static void issueTask(void *arg)
+    {
+        Shard &s = *(Shard *)arg;
+        TicketPipeline *self = s.owner;
+        for (int round = 0; round < PIPELINE_TASK_ROUNDS; round++)
+        {
+            int n = self->drain(s.index, 256);
+            if (s.pending.size() >= self->mergeThreshold && !self->mergeFailed.load(memory_order_acquire))
+                self->mergeShard(s.index);
+            if (n > 0)
+                continue;
+            // Go idle, then look again: a request pushed after the last drain
+            // may have seen the shard still scheduled
+            s.scheduled.store(false, memory_order_seq_cst);
+            if (self->queuedRequests() == 0)
+                return;
+            bool idle = false;
+            if (!s.scheduled.compare_exchange_strong(idle, true))
+                return; // a producer queued a new task
+        }
+        self->tasks.run(issueTask, arg);
+    }
+
+public:
+    // One shard (queue, buffer, issuing task) per worker; queueCapacity is
+    // shared out between the shards. Issuing tasks run on taskPool.
+    TicketPipeline(TicketManager &m, int workerCount, int queueCapacity = 65536, int mergeEvery = 4096,
+                   ThreadPool &taskPool = ThreadPool::shared())
+        : manager(m), numShards(workerCount > 0 ? workerCount : 1), mergeThreshold(mergeEvery), running(false),
+          mergeFailed(false), pool(taskPool), tasks(taskPool)
+    {
+        shards = new Shard[numShards];
+        int perShard = queueCapacity / numShards;
+        for (int i = 0; i < numShards; i++)
+        {
+            shards[i].queue = new MpmcQueue<IssueRequest>(perShard > 64 ? perShard : 64);
+            shards[i].owner = this;
+            shards[i].index = i;
+        }
+    }
+
+    ~TicketPipeline()
+    {
+        stop();
+        for (int i = 0; i < numShards; i++)
+            delete shards[i].queue;
+        delete[] shards;
+    }
+
+    // Queue a ticket request from any thread on the passenger's shard and,
+    // while running, wake the shard's issuing task. Lock-free unless a task
+    // has to be queued; returns false when that queue is full (caller
+    // retries or backs off) or after a failed merge (see failed()).
+    bool submit(const Passenger &p, int startStationID = 0, int endStationID = 0)
+    {
+        if (mergeFailed.load(memory_order_acquire))
+            return false;
+        int shard = (int)((unsigned int)p.getID() % (unsigned int)numShards);
+        bool queued = shards[shard].queue->tryPush(IssueRequest(p, startStationID, endStationID));
+        if (running.load(memory_order_acquire))
+            schedule(shard);
+        return queued;
+    }
+
+    // Requests waiting in all shard queues (approximate while running)
+    long long queuedRequests() const
+    {
+        long long n = 0;
+        for (int i = 0; i < numShards; i++)
+            n += (long long)shards[i].queue->approxSize();
+        return n;
+    }
+
+    // Issue up to maxCount queued requests into a shard's buffer; returns the
+    // number issued. Pops the shard's own queue first and steals from the
+    // next non-empty one when it is empty. Each shard must only be drained
+    // by one thread at a time.
+    int drain(int shard, int maxCount)
+    {
+        Shard &s = shards[shard];
+        s.popped.clear();
+        IssueRequest req;
+        for (int k = 0; k < numShards && s.popped.empty(); k++)
+        {
+            MpmcQueue<IssueRequest> &q = *shards[(shard + k) % numShards].queue;
+            while (s.popped.size() < maxCount && q.tryPop(req))
+                s.popped.push_back(req);
+        }
+
+        int n = s.popped.size();
+        if (n == 0)
+            return 0;
+
+        Timestamp now = currentTimestamp();
+        for (int i = 0; i < n; i++)
+        {
+            TicketRecord r;
+            r.passenger = s.popped[i].passenger;
+            r.startStationID = s.popped[i].startStationID;
+            r.endStationID = s.popped[i].endStationID;
+            r.issueTime = now;
+            s.pending.push_back(r);
+        }
+        s.issued += n;
+        return n;
+    }
+
+    // Number a shard's pending tickets with the next block of IDs and move
+    // them into the manager's store. Reserving the block under the merge
+    // lock keeps IDs in the store in increasing order. If the manager
+    // rejects the merge the tickets stay pending, the block is given back
+    // and the pipeline is marked failed; returns false.
+    bool mergeShard(int shard)
+    {
+        Shard &s = shards[shard];
+        int n = s.pending.size();
+        if (n == 0)
+            return true;
+        {
+            lock_guard<mutex> guard(mergeLock);
+            int firstID = manager.allocateTicketIDs(n);
+            for (int i = 0; i < n; i++)
+                s.pending[i].ticketID = firstID + i;
+            if (!manager.mergeTickets(s.pending))
+            {
+                manager.releaseTicketIDs(firstID, n);
+                mergeFailed.store(true, memory_order_release);
+                return false;
+            }
+        }
+        s.pending.clear();
+        return true;
+    }
+
+    // Start issuing on the pool: submit() queues a shard's task on demand
+    void start()
+    {
+        {
+            lock_guard<mutex> guard(lifecycleLock);
+            if (running.load(memory_order_relaxed))
+                return;
+            running.store(true, memory_order_release);
+        }
+        for (int i = 0; i < numShards; i++)
+            schedule(i); // requests submitted before start()
+    }
+
+    // Stop waking issuing tasks, wait for the queued ones (the caller helps
+    // run them), then drain and merge whatever is left. Returns false if
+    // some tickets could not be merged; they stay pending, and calling
+    // stop() again (e.g. once the log is writable) retries them.
+    bool stop()
+    {
+        {
+            // After this no submit() can queue a task, so once the queued
+            // ones finish this thread is the only drainer
+            lock_guard<mutex> guard(lifecycleLock);
+            running.store(false, memory_order_release);
+        }
+        tasks.wait();
+        // Manual drain/merge users: flush anything left over
+        bool merged = true;
+        for (int i = 0; i < numShards; i++)
+        {
+            while (drain(i, 4096) > 0)
+            {
+            }
+            if (!mergeShard(i))
+                merged = false;
+        }
+        if (merged)
+            mergeFailed.store(false, memory_order_release);
+        return merged;
+    }
+
+    // A merge was rejected and tickets are waiting in the shards
+    bool failed() const { return mergeFailed.load(memory_order_acquire); }
+
+    // Issued tickets not yet in the manager's store (exact once stopped)
+    long long unmergedTickets() const
+    {
+        long long n = 0;
+        for (int i = 0; i < numShards; i++)
+            n += shards[i].pending.size();
+        return n;
+    }
+
+    // Tickets issued by each shard so far
+    long long issuedByShard(int shard) const { return shards[shard].issued; }
+
+    int shardCount() const { return numShards; }
+};
+
+#endif
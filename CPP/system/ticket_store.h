@@ -0,0 +1,313 @@
+#ifndef TICKET_STORE_H
+#define TICKET_STORE_H
+
+#include <iostream>
+#include <string>
+#include "../ds/array.h"
+#include "../ds/string_dictionary.h"
+#include "../ds/id_index.h"
+#include "../ds/binary_stream.h"
+#include "../ds/thread_pool.h"
+#include "../models/passenger.h"
+#include "../models/ticket.h"
+#include "../models/timestamp.h"
+#include "time_buckets.h"
+
+using namespace std;
+
+// Tickets per parallel chunk when rebuilding the calendar index
+#define TICKET_PARALLEL_GRAIN 65536
+
+// One issued ticket in row form, used to hand batches of tickets between
+// threads before they are merged into a TicketStore
+struct TicketRecord
+{
+    int ticketID;
+    Passenger passenger;
+    int startStationID;
+    int endStationID;
+    Timestamp issueTime;
+
+    TicketRecord() : ticketID(0), startStationID(0), endStationID(0), issueTime(0) {}
+};
+
+// Columnar (structure-of-arrays) storage for issued tickets
+// Every ticket field lives in its own contiguous array, indexed by the
+// ticket's slot (issue order). Scans that only need a couple of fields
+// (e.g. start/end station for analytics) read just those arrays instead of
+// pulling whole Ticket objects with their strings through the cache.
+// Passenger names are dictionary-encoded, and a calendar index of issue
+// times is kept up to date for trend queries.
+class TicketStore
+{
+private:
+    // parallelReduce body of buildTimeline: runs of equal issue times in
+    // [lo, hi) are added to a per-chunk counter in one step each
+    struct TimelineCounts
+    {
+        const Timestamp *times;
+
+        void operator()(int lo, int hi, TimeBucketCounter &timeline) const
+        {
+            int runStart = lo;
+            for (int i = lo; i < hi; i++)
+            {
+                if (i + 1 == hi || times[i + 1] != times[i])
+                {
+                    timeline.add(times[i], i + 1 - runStart);
+                    runStart = i + 1;
+                }
+            }
+        }
+    };
+
+    static void mergeTimelines(TimeBucketCounter &into, const TimeBucketCounter &from) { into.merge(from); }
+
+    DynamicArray<int> ticketIDs;
+    DynamicArray<int> startStations;
+    DynamicArray<int> endStations;
+    DynamicArray<Timestamp> issueTimes;
+    DynamicArray<int> passengerIDs;
+    DynamicArray<int> passengerAges;
+    DynamicArray<int> passengerNames; // code into nameDict
+
+    StringDictionary nameDict;
+    TimeBucketCounter timeline; // tickets per minute/hour/day/week
+    IdIndex idIndex;            // ticket ID -> slot
+
+public:
+    // Pre-size every column for n tickets in total
+    void reserve(int n)
+    {
+        ticketIDs.reserve(n);
+        startStations.reserve(n);
+        endStations.reserve(n);
+        issueTimes.reserve(n);
+        passengerIDs.reserve(n);
+        passengerAges.reserve(n);
+        passengerNames.reserve(n);
+        idIndex.reserve(n);
+    }
+
+    // Make room for n more tickets; grows at least geometrically so repeated
+    // small batches stay amortized O(1) per ticket
+    void reserveAdditional(int n)
+    {
+        int want = ticketIDs.size() + n;
+        int cap = ticketIDs.getCapacity();
+        if (want > cap)
+            reserve(want > cap * 2 ? want : cap * 2);
+    }
+
+    // Append a ticket; returns its slot
+    int append(const Ticket &t)
+    {
+        int slot = appendFields(t.getTicketID(), t.getPassengerRef(), t.getStartStationID(),
+                                t.getEndStationID(), t.getIssueTime());
+        timeline.add(t.getIssueTime());
+        return slot;
+    }
+
+    // Append a ticket straight from its fields (no Ticket/Passenger copies).
+    // The calendar index is NOT updated: call countIssued once per batch.
+    int appendFields(int ticketID, const Passenger &p, int startStationID, int endStationID, Timestamp issueTime)
+    {
+        ticketIDs.push_back(ticketID);
+        startStations.push_back(startStationID);
+        endStations.push_back(endStationID);
+        issueTimes.push_back(issueTime);
+        passengerIDs.push_back(p.getID());
+        passengerAges.push_back(p.getAge());
+        passengerNames.push_back(nameDict.encode(p.getName()));
+        idIndex.insert(ticketID, ticketIDs.size() - 1);
+        return ticketIDs.size() - 1;
+    }
+
+    // Bulk append of row records (e.g. a merged per-thread shard). Runs of
+    // equal issue times are counted into the calendar index in one step.
+    void appendRecords(const TicketRecord records[], int n)
+    {
+        reserveAdditional(n);
+        int runStart = 0;
+        for (int i = 0; i < n; i++)
+        {
+            const TicketRecord &r = records[i];
+            appendFields(r.ticketID, r.passenger, r.startStationID, r.endStationID, r.issueTime);
+            if (i + 1 == n || records[i + 1].issueTime != r.issueTime)
+            {
+                countIssued(r.issueTime, i + 1 - runStart);
+                runStart = i + 1;
+            }
+        }
+    }
+
+    // Add n tickets issued at issueTime to the calendar index in one step
+    void countIssued(Timestamp issueTime, int n)
+    {
+        if (n > 0)
+            timeline.add(issueTime, n);
+    }
+
+    // Rebuild a full Ticket object for one slot (display paths)
+    Ticket get(int slot) const
+    {
+        Passenger p(passengerIDs[slot], nameDict.decode(passengerNames[slot]), passengerAges[slot]);
+        return Ticket(ticketIDs[slot], p, startStations[slot], endStations[slot], issueTimes[slot]);
+    }
+
+    // Slot holding ticketID, or -1 (O(1), no allocation)
+    int findSlot(int ticketID) const { return idIndex.find(ticketID); }
+
+    // True once out-of-order ticket IDs pushed the ID index into hash mode
+    bool indexHashed() const { return idIndex.isHashed(); }
+
+    int size() const { return ticketIDs.size(); }
+    bool empty() const { return ticketIDs.empty(); }
+
+    // Column access for scans
+    const DynamicArray<int> &ticketIDColumn() const { return ticketIDs; }
+    const DynamicArray<int> &startStationColumn() const { return startStations; }
+    const DynamicArray<int> &endStationColumn() const { return endStations; }
+    const DynamicArray<Timestamp> &issueTimeColumn() const { return issueTimes; }
+    const DynamicArray<int> &passengerIDColumn() const { return passengerIDs; }
+    const DynamicArray<int> &passengerAgeColumn() const { return passengerAges; }
+    const DynamicArray<int> &passengerNameColumn() const { return passengerNames; }
+
+    // Dictionary behind the encoded name column
+    const StringDictionary &passengerNameDictionary() const { return nameDict; }
+
+    // Issue-time calendar index
+    const TimeBucketCounter &issueTimeline() const { return timeline; }
+
+    // Calendar index computed from the issue-time column alone: ticket
+    // ranges are counted into per-chunk counters on the pool and merged.
+    // Same counters as the incrementally kept issueTimeline().
+    void buildTimeline(TimeBucketCounter &out, ThreadPool &pool) const
+    {
+        TimelineCounts body;
+        body.times = issueTimes.getRawArray();
+        TimeBucketCounter built = parallelReduce(pool, 0, issueTimes.size(), TICKET_PARALLEL_GRAIN,
+                                                 TimeBucketCounter(), body, mergeTimelines);
+        out.swap(built);
+    }
+
+    // Serialize every column plus the name dictionary (snapshot section).
+    // The ID index and calendar index are derived data and not written.
+    void writeSnapshot(BinaryWriter &out) const
+    {
+        out.writeArray(ticketIDs);
+        out.writeArray(startStations);
+        out.writeArray(endStations);
+        out.writeArray(issueTimes);
+        out.writeArray(passengerIDs);
+        out.writeArray(passengerAges);
+        out.writeArray(passengerNames);
+
+        out.writeInt(nameDict.size());
+        for (int code = 0; code < nameDict.size(); code++)
+            out.writeString(nameDict.decode(code));
+    }
+
+    // Replace the store with a snapshot section. Columns are copied in bulk,
+    // then the ID index and calendar index are rebuilt in one pass each.
+    // The store is untouched on failure.
+    bool readSnapshot(BinaryReader &in)
+    {
+        TicketStore loaded;
+        in.readArray(loaded.ticketIDs);
+        in.readArray(loaded.startStations);
+        in.readArray(loaded.endStations);
+        in.readArray(loaded.issueTimes);
+        in.readArray(loaded.passengerIDs);
+        in.readArray(loaded.passengerAges);
+        in.readArray(loaded.passengerNames);
+
+        int names = in.readCount(4);
+        for (int code = 0; code < names && in.good(); code++)
+        {
+            // Codes are handed out in order, so re-encoding restores them
+            if (loaded.nameDict.encode(in.readString()) != code)
+                return false;
+        }
+        if (!in.good())
+            return false;
+
+        int n = loaded.ticketIDs.size();
+        if (loaded.startStations.size() != n || loaded.endStations.size() != n ||
+            loaded.issueTimes.size() != n || loaded.passengerIDs.size() != n ||
+            loaded.passengerAges.size() != n || loaded.passengerNames.size() != n)
+            return false;
+        for (int i = 0; i < n; i++)
+            if (loaded.passengerNames[i] < 0 || loaded.passengerNames[i] >= names)
+                return false;
+
+        loaded.idIndex.reserve(n);
+        for (int i = 0; i < n; i++)
+            loaded.idIndex.insert(loaded.ticketIDs[i], i);
+        loaded.buildTimeline(loaded.timeline, ThreadPool::shared());
+
+        swap(loaded);
+        return true;
+    }
+
+    // Exchange contents with another store (no copies)
+    void swap(TicketStore &other)
+    {
+        ticketIDs.swap(other.ticketIDs);
+        startStations.swap(other.startStations);
+        endStations.swap(other.endStations);
+        issueTimes.swap(other.issueTimes);
+        passengerIDs.swap(other.passengerIDs);
+        passengerAges.swap(other.passengerAges);
+        passengerNames.swap(other.passengerNames);
+        nameDict.swap(other.nameDict);
+        timeline.swap(other.timeline);
+        idIndex.swap(other.idIndex);
+    }
+
+    // Charge the columns, name dictionary and calendar index to log and the
+    // ticket ID index to index
+    void setMemoryAccount(MemoryAccount *log, MemoryAccount *index)
+    {
+        ticketIDs.setMemoryAccount(log);
+        startStations.setMemoryAccount(log);
+        endStations.setMemoryAccount(log);
+        issueTimes.setMemoryAccount(log);
+        passengerIDs.setMemoryAccount(log);
+        passengerAges.setMemoryAccount(log);
+        passengerNames.setMemoryAccount(log);
+        nameDict.setMemoryAccount(log);
+        timeline.setMemoryAccount(log);
+        idIndex.setMemoryAccount(index);
+    }
+
+    void measureMemory() const
+    {
+        ticketIDs.measureMemory();
+        startStations.measureMemory();
+        endStations.measureMemory();
+        issueTimes.measureMemory();
+        passengerIDs.measureMemory();
+        passengerAges.measureMemory();
+        passengerNames.measureMemory();
+        nameDict.measureMemory();
+        timeline.measureMemory();
+        idIndex.measureMemory();
+    }
+
+    void clear()
+    {
+        ticketIDs.clear();
+        startStations.clear();
+        endStations.clear();
+        issueTimes.clear();
+        passengerIDs.clear();
+        passengerAges.clear();
+        passengerNames.clear();
+        nameDict.clear();
+        timeline.clear();
+        idIndex.clear();
+    }
+};
+
+#endif
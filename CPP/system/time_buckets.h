@@ -0,0 +1,339 @@
+#ifndef TIME_BUCKETS_H
+#define TIME_BUCKETS_H
+
+#include <iostream>
+#include "../ds/array.h"
+#include "../ds/searching.h"
+#include "../models/timestamp.h"
+
+using namespace std;
+
+// Bucket sizes supported by TimeBucketCounter
+enum TimeGranularity
+{
+    BUCKET_MINUTE = 0,
+    BUCKET_HOUR = 1,
+    BUCKET_DAY = 2,
+    BUCKET_WEEK = 3
+};
+
+#define TIME_GRANULARITIES 4
+
+// Widest dense counter array per granularity (2^22 minutes is ~8 years)
+#define TIME_BUCKET_DENSE_SLOTS (1 << 22)
+
+// Calendar index of event counts
+// Keeps one dense counter array per granularity (minute, hour, day, week),
+// each indexed by bucket number minus the first bucket seen. Recording an
+// event is four increments; a trend query reads one counter per bucket, so
+// a daily series over ten years is ~3650 reads no matter how many tickets
+// were issued. Weeks start on Monday (UTC).
+// A dense array never spans more than TIME_BUCKET_DENSE_SLOTS buckets:
+// outlier timestamps further away are counted in a small sorted sparse
+// list instead, so one bad timestamp cannot allocate years of empty slots.
+class TimeBucketCounter
+{
+private:
+    DynamicArray<int> counts[TIME_GRANULARITIES];
+    long long firstBucket[TIME_GRANULARITIES];               // bucket number of counts[g][0]
+    DynamicArray<long long> sparseBuckets[TIME_GRANULARITIES]; // sorted, outside the dense range
+    DynamicArray<int> sparseCounts[TIME_GRANULARITIES];
+    long long total;
+
+    static long long bucketSeconds(int g)
+    {
+        switch (g)
+        {
+        case BUCKET_MINUTE:
+            return SECONDS_PER_MINUTE;
+        case BUCKET_HOUR:
+            return SECONDS_PER_HOUR;
+        case BUCKET_DAY:
+            return SECONDS_PER_DAY;
+        default:
+            return SECONDS_PER_WEEK;
+        }
+    }
+
+    // 1970-01-01 was a Thursday: shift by 3 days so weeks begin on Monday
+    static long long weekOffset(int g)
+    {
+        return g == BUCKET_WEEK ? 3 * SECONDS_PER_DAY : 0;
+    }
+
+    // Index of the first sparse bucket >= b
+    int sparseLowerBound(int g, long long b) const
+    {
+        return lowerBound(sparseBuckets[g].getRawArray(), sparseBuckets[g].size(), b);
+    }
+
+    void addSparse(int g, long long b, int n)
+    {
+        DynamicArray<long long> &keys = sparseBuckets[g];
+        DynamicArray<int> &values = sparseCounts[g];
+        int i = sparseLowerBound(g, b);
+        if (i < keys.size() && keys[i] == b)
+        {
+            values[i] += n;
+            return;
+        }
+        keys.push_back(b);
+        values.push_back(n);
+        for (int k = keys.size() - 1; k > i; k--)
+        {
+            keys[k] = keys[k - 1];
+            values[k] = values[k - 1];
+        }
+        keys[i] = b;
+        values[i] = n;
+    }
+
+    // Move sparse buckets in [lo, hi] into the dense array, which now covers them
+    void absorbSparse(int g, long long lo, long long hi)
+    {
+        DynamicArray<long long> &keys = sparseBuckets[g];
+        DynamicArray<int> &values = sparseCounts[g];
+        int i = sparseLowerBound(g, lo);
+        int j = i;
+        while (j < keys.size() && keys[j] <= hi)
+        {
+            counts[g][(int)(keys[j] - firstBucket[g])] += values[j];
+            j++;
+        }
+        if (j == i)
+            return;
+        DynamicArray<long long> keptKeys(keys.size() - (j - i) + 1);
+        DynamicArray<int> keptValues(keys.size() - (j - i) + 1);
+        for (int k = 0; k < keys.size(); k++)
+        {
+            if (k == i)
+                k = j;
+            if (k == keys.size())
+                break;
+            keptKeys.push_back(keys[k]);
+            keptValues.push_back(values[k]);
+        }
+        keys.swap(keptKeys);
+        values.swap(keptValues);
+    }
+
+    // Add n to bucket b of granularity g: in the dense array when it can
+    // grow to cover b within TIME_BUCKET_DENSE_SLOTS, else in the sparse list
+    void addTo(int g, long long b, int n)
+    {
+        DynamicArray<int> &arr = counts[g];
+        unsigned long long idx = (unsigned long long)(b - firstBucket[g]);
+        if (idx < (unsigned long long)arr.size())
+        {
+            arr[(int)idx] += n; // common case: inside the dense range
+            return;
+        }
+        if (arr.empty())
+        {
+            firstBucket[g] = b;
+            arr.push_back(n);
+            if (!sparseBuckets[g].empty())
+                absorbSparse(g, b, b);
+            return;
+        }
+        long long first = firstBucket[g];
+        long long last = first + arr.size() - 1;
+        if ((b > last ? b : last) - (b < first ? b : first) >= TIME_BUCKET_DENSE_SLOTS)
+        {
+            addSparse(g, b, n);
+            return;
+        }
+        if (b < first)
+        {
+            // Out-of-order event before the first bucket: shift right
+            int shift = (int)(first - b);
+            DynamicArray<int> grown(arr.size() + shift);
+            for (int i = 0; i < shift; i++)
+                grown.push_back(0);
+            for (int i = 0; i < arr.size(); i++)
+                grown.push_back(arr[i]);
+            arr.swap(grown);
+            firstBucket[g] = b;
+            if (!sparseBuckets[g].empty())
+                absorbSparse(g, b, first - 1);
+        }
+        else if (b > last)
+        {
+            while (arr.size() <= (int)(b - first))
+                arr.push_back(0);
+            if (!sparseBuckets[g].empty())
+                absorbSparse(g, last + 1, b);
+        }
+        arr[(int)(b - firstBucket[g])] += n;
+    }
+
+public:
+    TimeBucketCounter() : total(0)
+    {
+        for (int g = 0; g < TIME_GRANULARITIES; g++)
+            firstBucket[g] = 0;
+    }
+
+    // Bucket number containing ts (clamped to +-2^62 s so the week shift
+    // cannot overflow)
+    static long long bucketOf(Timestamp ts, int g)
+    {
+        const Timestamp limit = 1LL << 62;
+        if (ts > limit)
+            ts = limit;
+        else if (ts < -limit)
+            ts = -limit;
+        return floorDiv(ts + weekOffset(g), bucketSeconds(g));
+    }
+
+    // Timestamp at which bucket b starts
+    static Timestamp bucketStart(long long b, int g)
+    {
+        return b * bucketSeconds(g) - weekOffset(g);
+    }
+
+    // Record n events at time ts
+    void add(Timestamp ts, int n = 1)
+    {
+        for (int g = 0; g < TIME_GRANULARITIES; g++)
+            addTo(g, bucketOf(ts, g), n);
+        total += n;
+    }
+
+    // Add every count of other (e.g. per-thread counters after a parallel
+    // scan); any merge order gives the same counters
+    void merge(const TimeBucketCounter &other)
+    {
+        for (int g = 0; g < TIME_GRANULARITIES; g++)
+        {
+            // Ascending bucket order: the dense array shifts at most once
+            const DynamicArray<long long> &keys = other.sparseBuckets[g];
+            const DynamicArray<int> &from = other.counts[g];
+            int k = 0;
+            for (; k < keys.size() && keys[k] < other.firstBucket[g]; k++)
+                addTo(g, keys[k], other.sparseCounts[g][k]);
+            for (int i = 0; i < from.size(); i++)
+                if (from[i] != 0)
+                    addTo(g, other.firstBucket[g] + i, from[i]);
+            for (; k < keys.size(); k++)
+                addTo(g, keys[k], other.sparseCounts[g][k]);
+        }
+        total += other.total;
+    }
+
+    // Events in bucket b
+    int count(int g, long long b) const
+    {
+        long long idx = b - firstBucket[g];
+        if (idx >= 0 && idx < counts[g].size())
+            return counts[g][(int)idx];
+        int i = sparseLowerBound(g, b);
+        return i < sparseBuckets[g].size() && sparseBuckets[g][i] == b ? sparseCounts[g][i] : 0;
+    }
+
+    // First bucket >= b that may hold events (every dense slot counts), or
+    // lastBucketOf(g) + 1; steps over the gaps around sparse outliers
+    long long nextBucket(int g, long long b) const
+    {
+        long long next = lastBucketOf(g) + 1;
+        if (!counts[g].empty() && b <= firstBucket[g] + counts[g].size() - 1)
+            next = b > firstBucket[g] ? b : firstBucket[g];
+        int i = sparseLowerBound(g, b);
+        if (i < sparseBuckets[g].size() && sparseBuckets[g][i] < next)
+            next = sparseBuckets[g][i];
+        return next;
+    }
+
+    // Events in [from, to) at minute resolution, summed over the coarsest
+    // buckets that fit
+    long long countRange(Timestamp from, Timestamp to) const
+    {
+        long long sum = 0;
+        Timestamp t = from;
+        while (t < to)
+        {
+            int g = BUCKET_WEEK;
+            // Use the largest bucket that starts at t and ends by `to`
+            while (g > BUCKET_MINUTE &&
+                   (bucketStart(bucketOf(t, g), g) != t || t + bucketSeconds(g) > to))
+                g--;
+            sum += count(g, bucketOf(t, g));
+            t = bucketStart(bucketOf(t, g), g) + bucketSeconds(g);
+        }
+        return sum;
+    }
+
+    // First/last bucket with a slot, dense or sparse (first > last when
+    // empty). Walk the range with nextBucket to skip the gaps.
+    long long firstBucketOf(int g) const
+    {
+        const DynamicArray<long long> &keys = sparseBuckets[g];
+        if (keys.empty())
+            return firstBucket[g];
+        return counts[g].empty() || keys[0] < firstBucket[g] ? keys[0] : firstBucket[g];
+    }
+
+    long long lastBucketOf(int g) const
+    {
+        const DynamicArray<long long> &keys = sparseBuckets[g];
+        long long denseLast = firstBucket[g] + counts[g].size() - 1;
+        if (keys.empty())
+            return denseLast;
+        long long sparseLast = keys[keys.size() - 1];
+        return counts[g].empty() || sparseLast > denseLast ? sparseLast : denseLast;
+    }
+
+    bool empty() const { return total == 0; }
+    long long totalEvents() const { return total; }
+
+    // Exchange contents with another counter (no copies)
+    void swap(TimeBucketCounter &other)
+    {
+        for (int g = 0; g < TIME_GRANULARITIES; g++)
+        {
+            counts[g].swap(other.counts[g]);
+            sparseBuckets[g].swap(other.sparseBuckets[g]);
+            sparseCounts[g].swap(other.sparseCounts[g]);
+            long long tmp = firstBucket[g];
+            firstBucket[g] = other.firstBucket[g];
+            other.firstBucket[g] = tmp;
+        }
+        long long tmpTotal = total;
+        total = other.total;
+        other.total = tmpTotal;
+    }
+
+    void setMemoryAccount(MemoryAccount *memory)
+    {
+        for (int g = 0; g < TIME_GRANULARITIES; g++)
+        {
+            counts[g].setMemoryAccount(memory);
+            sparseBuckets[g].setMemoryAccount(memory);
+            sparseCounts[g].setMemoryAccount(memory);
+        }
+    }
+
+    void measureMemory() const
+    {
+        for (int g = 0; g < TIME_GRANULARITIES; g++)
+        {
+            counts[g].measureMemory();
+            sparseBuckets[g].measureMemory();
+            sparseCounts[g].measureMemory();
+        }
+    }
+
+    void clear()
+    {
+        for (int g = 0; g < TIME_GRANULARITIES; g++)
+        {
+            counts[g].clear();
+            sparseBuckets[g].clear();
+            sparseCounts[g].clear();
+            firstBucket[g] = 0;
+        }
+        total = 0;
+    }
+};
+
+#endif
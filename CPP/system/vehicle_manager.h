@@ -4,7 +4,11 @@
 #include <iostream>
 #include "../ds/array.h"
 #include "../ds/hashtable.h"
+#include "../ds/sorting.h"
+#include "../ds/binary_stream.h"
+#include "../ds/output_sink.h"
 #include "../models/vehicle.h"
+#include "write_ahead_log.h"
 
 using namespace std;
 
@@ -13,9 +17,27 @@ class VehicleManager
 private:
     DynamicArray<Vehicle> vehicles;     // DynamicArray for storing vehicles (ordered display)
     HashTable<int, Vehicle> vehicleMap; // O(1) lookup: ID -> Vehicle
+    WriteAheadLog *wal;                 // mutation log (nullptr = not logged)
+
+    // Key extractor for radixSortIndices
+    static int vehicleCapacityKey(const Vehicle &v) { return v.getCapacity(); }
 
 public:
-    VehicleManager() : vehicleMap(50) {} // Initialize hash table with capacity
+    VehicleManager() : vehicleMap(50), wal(nullptr) // Initialize hash table with capacity
+    {
+        vehicles.setMemoryAccount(MemoryTracker::instance().account("vehicles"));
+        vehicleMap.setMemoryAccount(MemoryTracker::instance().account("vehicles.index"));
+    }
+
+    // Log every later mutation to log (nullptr to stop logging)
+    void attachLog(WriteAheadLog *log) { wal = log; }
+
+    // Add used bytes of every container to its account (memory report)
+    void measureMemory() const
+    {
+        vehicles.measureMemory();
+        vehicleMap.measureMemory();
+    }
 
     // Add a vehicle
     // Using HashTable for O(1) duplicate check
@@ -42,6 +64,11 @@ public:
             return false;
         }
 
+        if (wal && !wal->logAddVehicle(v))
+        {
+            cout << "ERROR: Could not log the change; vehicle not added" << endl;
+            return false;
+        }
         vehicles.push_back(v);
         vehicleMap.insert(v.getID(), v); // O(1) insertion into hash table
         cout << "Vehicle added: " << v.getName() << " | ID: " << v.getID() << endl;
@@ -50,14 +77,19 @@ public:
 
     // Remove a vehicle by ID
     // Using HashTable for O(1) removal
-    void removeVehicle(int vehicleID)
+    bool removeVehicle(int vehicleID)
     {
-        // Remove from hash table first (O(1))
-        if (!vehicleMap.remove(vehicleID))
+        if (!vehicleMap.contains(vehicleID))
         {
             cout << "Vehicle not found: ID " << vehicleID << endl;
-            return;
+            return false;
         }
+        if (wal && !wal->logId(WAL_REMOVE_VEHICLE, vehicleID))
+        {
+            cout << "ERROR: Could not log the change; vehicle not removed" << endl;
+            return false;
+        }
+        vehicleMap.remove(vehicleID); // O(1)
 
         // Remove from array
         for (int i = 0; i < vehicles.size(); i++)
@@ -66,77 +98,141 @@ public:
             {
                 vehicles.erase(i);
                 cout << "Vehicle removed: ID " << vehicleID << endl;
-                return;
+                return true;
             }
         }
+        return true;
     }
 
     // Display all vehicles
     void displayAllVehicles()
     {
-        if (vehicles.empty())
+        OutputSink out(cout);
+        exportVehicles(out, OUTPUT_TEXT);
+    }
+
+    // Write every vehicle as text lines, CSV or JSON
+    void exportVehicles(OutputSink &out, OutputFormat format) const
+    {
+        if (format == OUTPUT_TEXT)
         {
-            cout << "No vehicles available." << endl;
+            if (vehicles.empty())
+            {
+                out << "No vehicles available.\n";
+                return;
+            }
+            out << "All Vehicles:\n";
+            for (int i = 0; i < vehicles.size(); i++)
+                vehicles[i].display(out);
             return;
         }
-        cout << "All Vehicles:" << endl;
+        const char *const columns[] = {"id", "name", "capacity"};
+        RecordWriter w(out, format, columns, 3);
         for (int i = 0; i < vehicles.size(); i++)
         {
-            vehicles[i].display();
+            w.beginRow();
+            w.field(vehicles[i].getID());
+            w.field(vehicles[i].getName());
+            w.field(vehicles[i].getCapacity());
+            w.endRow();
         }
     }
 
     // Display vehicles sorted by capacity
     void displayVehiclesSortedByCapacity(bool ascending = true)
     {
+        OutputSink out(cout);
         if (vehicles.empty())
         {
-            cout << "No vehicles available." << endl;
+            out << "No vehicles available.\n";
             return;
         }
 
-        // Create a copy and sort
-        DynamicArray<Vehicle> sorted;
-        for (int i = 0; i < vehicles.size(); i++)
-            sorted.push_back(vehicles[i]);
+        // Integer key: stable radix sort of indices, vehicles are not copied
+        DynamicArray<int> order(vehicles.size());
+        radixSortIndices(vehicles, vehicleCapacityKey, order, ascending);
 
-        // Insertion sort
-        for (int i = 1; i < sorted.size(); i++)
+        out << "Vehicles (sorted by capacity - " << (ascending ? "smallest" : "largest") << " first):\n";
+        for (int i = 0; i < order.size(); i++)
         {
-            Vehicle key = sorted[i];
-            int j = i - 1;
-            if (ascending)
-            {
-                while (j >= 0 && sorted[j] > key)
-                {
-                    sorted[j + 1] = sorted[j];
-                    j--;
-                }
-            }
-            else
-            {
-                while (j >= 0 && sorted[j] < key)
-                {
-                    sorted[j + 1] = sorted[j];
-                    j--;
-                }
-            }
-            sorted[j + 1] = key;
+            vehicles[order[i]].display(out);
         }
+    }
 
-        cout << "Vehicles (sorted by capacity - " << (ascending ? "smallest" : "largest") << " first):" << endl;
-        for (int i = 0; i < sorted.size(); i++)
+    // Append many already-validated vehicles (unique positive IDs, positive
+    // capacity) without per-item output; storage is sized once. Stops at the
+    // first vehicle that cannot be logged and returns false.
+    bool addBulk(const DynamicArray<Vehicle> &newVehicles)
+    {
+        int n = newVehicles.size();
+        vehicles.reserve(vehicles.size() + n);
+        vehicleMap.reserve(vehicleMap.size() + n);
+        for (int i = 0; i < n; i++)
         {
-            sorted[i].display();
+            if (wal && !wal->logAddVehicle(newVehicles[i]))
+            {
+                cout << "ERROR: Could not log the change; only " << i << " vehicles added" << endl;
+                return false;
+            }
+            vehicles.push_back(newVehicles[i]);
+            vehicleMap.insert(newVehicles[i].getID(), newVehicles[i]);
         }
+        return true;
     }
 
+    bool vehicleExists(int vehicleID) const { return vehicleMap.contains(vehicleID); }
+
+    // Read-only access (in insertion order)
+    const DynamicArray<Vehicle> &getVehicles() const { return vehicles; }
+
     // Get total number of vehicles
     int totalVehicles() const
     {
         return vehicles.size();
     }
 
+    // Serialize all vehicles (snapshot section)
+    void writeSnapshot(BinaryWriter &out) const
+    {
+        out.writeInt(vehicles.size());
+        for (int i = 0; i < vehicles.size(); i++)
+        {
+            out.writeInt(vehicles[i].getID());
+            out.writeInt(vehicles[i].getCapacity());
+            out.writeString(vehicles[i].getName());
+        }
+    }
+
+    // Take over the vehicles another manager read from a snapshot
+    void adoptSnapshot(VehicleManager &loaded)
+    {
+        vehicles.swap(loaded.vehicles);
+        vehicleMap.swap(loaded.vehicleMap);
+    }
+
+    // Replace all vehicles with a snapshot section; untouched on failure
+    bool readSnapshot(BinaryReader &in)
+    {
+        int n = in.readCount(12);
+        DynamicArray<Vehicle> loaded(n + 1);
+        for (int i = 0; i < n && in.good(); i++)
+        {
+            int id = in.readInt();
+            int capacity = in.readInt();
+            string name = in.readString();
+            loaded.push_back(Vehicle(id, name, capacity));
+        }
+        if (!in.good())
+            return false;
+
+        vehicles.swap(loaded);
+        vehicleMap.clear();
+        vehicleMap.reserve(vehicles.size());
+        for (int i = 0; i < vehicles.size(); i++)
+            vehicleMap.insert(vehicles[i].getID(), vehicles[i]);
+        return true;
+    }
+
     // Search vehicle by ID
     void searchVehicleById(int vehicleID) const
     {
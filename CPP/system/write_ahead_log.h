@@ -0,0 +1,552 @@
+#ifndef WRITE_AHEAD_LOG_H
+#define WRITE_AHEAD_LOG_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#define WAL_FSYNC(fd) _commit(fd)
+#define WAL_TRUNCATE(fd, size) _chsize_s(fd, size)
+#define WAL_OPEN_FLAGS (O_WRONLY | O_CREAT | O_APPEND | O_BINARY)
+#else
+#include <unistd.h>
+#define WAL_FSYNC(fd) fsync(fd)
+#define WAL_TRUNCATE(fd, size) ftruncate(fd, size)
+#define WAL_OPEN_FLAGS (O_WRONLY | O_CREAT | O_APPEND)
+#endif
+#include "../ds/binary_stream.h"
+#include "../models/station.h"
+#include "../models/route.h"
+#include "../models/vehicle.h"
+#include "../models/passenger.h"
+#include "../models/timestamp.h"
+#include "ticket_store.h"
+
+using namespace std;
+
+// Append-only binary write-ahead log of mutations
+//
+// File:    magic "ITNMWAL1" | u32 version | u32 byteOrder
+// Record:  u32 length | u32 crc | i64 lsn | u32 type | payload
+//
+// length counts lsn + type + payload and crc covers the same bytes, so a
+// record torn by a crash is detected and the log is cut back to the last
+// whole record on open. LSNs (log sequence numbers) increase by one per
+// record and keep increasing across checkpoints.
+//
+// Group commit: append() only buffers a record. commit(lsn) makes it
+// durable: one caller at a time becomes the leader and writes (and, if the
+// sync mode says so, fsyncs) everything buffered by every thread; the
+// others wait for it and return without doing any I/O of their own.
+// In WAL_SYNC_BATCH mode a background flusher is woken when written records
+// are first left unsynced and fsyncs them once syncIntervalMs has passed,
+// so an idle log is never left unsynced for longer than the interval.
+
+#define WAL_VERSION 1
+#define WAL_BYTE_ORDER 0x01020304u
+#define WAL_HEADER_SIZE 16
+#define WAL_RECORD_HEADER_SIZE 8
+
+enum WalRecordType
+{
+    WAL_ADD_STATION = 1,
+    WAL_REMOVE_STATION = 2,
+    WAL_ADD_ROUTE = 3,
+    WAL_REMOVE_ROUTE = 4,
+    WAL_STATION_PASSENGER = 5,
+    WAL_ADD_VEHICLE = 6,
+    WAL_REMOVE_VEHICLE = 7,
+    WAL_ENQUEUE_PASSENGER = 8,
+    WAL_ISSUE_TICKETS = 9,
+    WAL_MERGE_TICKETS = 10,
+    WAL_HISTORY_PUSH = 11,
+    WAL_HISTORY_POP = 12,
+    WAL_HISTORY_CLEAR = 13
+};
+
+// Durability levels
+enum WalSyncMode
+{
+    WAL_SYNC_NONE,   // write() on commit, never fsync: survives a process crash only
+    WAL_SYNC_BATCH,  // write() on commit, fsync every N records or T ms
+    WAL_SYNC_ALWAYS  // write() + fsync before every commit returns
+};
+
+struct WalOptions
+{
+    WalSyncMode mode;
+    int syncEveryRecords; // WAL_SYNC_BATCH: fsync after this many records...
+    int syncIntervalMs;   // ...or once this long has passed since the last fsync
+
+    WalOptions(WalSyncMode _mode = WAL_SYNC_BATCH, int _records = 64, int _intervalMs = 10)
+        : mode(_mode), syncEveryRecords(_records), syncIntervalMs(_intervalMs) {}
+};
+
+// One decoded record; payload points into the reader's buffer
+struct WalRecord
+{
+    long long lsn;
+    unsigned int type;
+    const char *payload;
+    long long length;
+
+    WalRecord() : lsn(0), type(0), payload(nullptr), length(0) {}
+};
+
+// Sequential reader over a whole log file
+class WalReader
+{
+private:
+    char *bytes;
+    long long size;
+    long long pos;
+    bool valid; // header present and correct
+
+public:
+    WalReader() : bytes(nullptr), size(0), pos(0), valid(false) {}
+    ~WalReader() { delete[] bytes; }
+
+    // False if the file is missing or has a bad header (an empty file is fine)
+    bool open(const string &path)
+    {
+        delete[] bytes;
+        bytes = nullptr;
+        size = 0;
+        pos = 0;
+        valid = false;
+
+        ifstream file(path.c_str(), ios::binary | ios::ate);
+        if (!file)
+            return false;
+        size = (long long)file.tellg();
+        if (size == 0)
+        {
+            valid = true;
+            return true;
+        }
+        bytes = new char[size];
+        file.seekg(0);
+        file.read(bytes, size);
+        if (!file || size < WAL_HEADER_SIZE || memcmp(bytes, "ITNMWAL1", 8) != 0)
+            return false;
+        unsigned int version, byteOrder;
+        memcpy(&version, bytes + 8, 4);
+        memcpy(&byteOrder, bytes + 12, 4);
+        if (version > WAL_VERSION || byteOrder != WAL_BYTE_ORDER)
+            return false;
+        pos = WAL_HEADER_SIZE;
+        valid = true;
+        return true;
+    }
+
+    // Next whole record, or false at the end of the log or at a torn tail
+    bool next(WalRecord &r)
+    {
+        if (!valid || pos + WAL_RECORD_HEADER_SIZE > size)
+            return false;
+        unsigned int length, crc;
+        memcpy(&length, bytes + pos, 4);
+        memcpy(&crc, bytes + pos + 4, 4);
+        long long body = pos + WAL_RECORD_HEADER_SIZE;
+        if (length < 12 || (long long)length > size - body || crc32(bytes + body, length) != crc)
+            return false;
+        memcpy(&r.lsn, bytes + body, 8);
+        memcpy(&r.type, bytes + body + 8, 4);
+        r.payload = bytes + body + 12;
+        r.length = (long long)length - 12;
+        pos = body + length;
+        return true;
+    }
+
+    // Bytes up to the end of the last record returned by next()
+    long long validBytes() const { return valid ? (pos > 0 ? pos : 0) : 0; }
+    long long fileBytes() const { return size; }
+};
+
+class WriteAheadLog
+{
+private:
+    int fd;
+    string path;
+    WalOptions options;
+
+    mutex lock;
+    condition_variable flushed;
+    BinaryWriter pending; // records appended but not yet written
+    BinaryWriter writing; // batch owned by the current leader
+    int pendingRecords;
+    long long nextLsn;
+    long long writtenLsn; // handed to the OS
+    long long syncedLsn;  // fsync'ed
+    bool flushing;
+    bool failed;
+    int recordsSinceSync;
+    chrono::steady_clock::time_point lastSync;
+    thread flusher;                 // WAL_SYNC_BATCH: timed fsync of written records
+    condition_variable flusherWake; // records left unsynced, or stopping
+    bool stopping;                  // tells the flusher to exit
+
+    WriteAheadLog(const WriteAheadLog &);
+    WriteAheadLog &operator=(const WriteAheadLog &);
+
+    bool writeAll(const char *data, long long n)
+    {
+        while (n > 0)
+        {
+            long long chunk = n > (1 << 30) ? (1 << 30) : n;
+            long long written = (long long)::write(fd, data, (unsigned int)chunk);
+            if (written <= 0)
+                return false;
+            data += written;
+            n -= written;
+        }
+        return true;
+    }
+
+    // Leader: write (and maybe fsync) everything buffered. Called with lk held.
+    void flushLocked(unique_lock<mutex> &lk, bool forceSync)
+    {
+        flushing = true;
+        pending.swap(writing);
+        int batch = pendingRecords;
+        pendingRecords = 0;
+        long long batchLsn = nextLsn - 1;
+
+        bool sync = forceSync || options.mode == WAL_SYNC_ALWAYS;
+        if (options.mode == WAL_SYNC_BATCH && !sync)
+        {
+            long long ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - lastSync).count();
+            sync = recordsSinceSync + batch >= options.syncEveryRecords || ms >= options.syncIntervalMs;
+        }
+
+        lk.unlock();
+        bool ok = writeAll(writing.bytes(), writing.size());
+        if (ok && sync)
+            ok = WAL_FSYNC(fd) == 0;
+        writing.clear();
+        lk.lock();
+
+        if (!ok)
+        {
+            failed = true;
+            cerr << "Write-ahead log: write to " << path << " failed" << endl;
+        }
+        writtenLsn = batchLsn;
+        if (sync)
+        {
+            syncedLsn = batchLsn;
+            recordsSinceSync = 0;
+            lastSync = chrono::steady_clock::now();
+        }
+        else
+        {
+            if (recordsSinceSync == 0 && batch > 0)
+                flusherWake.notify_one();
+            recordsSinceSync += batch;
+        }
+        flushing = false;
+        flushed.notify_all();
+    }
+
+    // Background flusher: sleeps until written records are older than
+    // syncIntervalMs, then fsyncs them as the leader
+    static void flusherMain(WriteAheadLog *self)
+    {
+        chrono::milliseconds interval(self->options.syncIntervalMs);
+        unique_lock<mutex> lk(self->lock);
+        while (!self->stopping)
+        {
+            if (self->failed || self->syncedLsn >= self->writtenLsn)
+            {
+                self->flusherWake.wait(lk);
+                continue;
+            }
+            chrono::steady_clock::time_point now = chrono::steady_clock::now();
+            chrono::steady_clock::time_point due = self->lastSync + interval;
+            if (now < due || self->flushing) // a leader is busy: look again shortly
+            {
+                self->flusherWake.wait_until(lk, now < due ? due : now + chrono::milliseconds(1));
+                continue;
+            }
+            self->flushLocked(lk, true);
+        }
+    }
+
+public:
+    WriteAheadLog()
+        : fd(-1), pending(1 << 16), writing(1 << 16), pendingRecords(0), nextLsn(1), writtenLsn(0),
+          syncedLsn(0), flushing(false), failed(false), recordsSinceSync(0), stopping(false) {}
+
+    ~WriteAheadLog() { close(); }
+
+    // Open (or create) the log for appending. A torn last record is cut off.
+    // New records get LSNs after both the last one in the file and minLsn
+    // (the LSN stored in the snapshot the state was loaded from).
+    bool open(const string &logPath, const WalOptions &opts = WalOptions(), long long minLsn = 0)
+    {
+        close();
+        path = logPath;
+        options = opts;
+
+        long long lastLsn = minLsn;
+        long long keepBytes = 0;
+        WalReader reader;
+        if (reader.open(path))
+        {
+            WalRecord r;
+            while (reader.next(r))
+                if (r.lsn > lastLsn)
+                    lastLsn = r.lsn;
+            keepBytes = reader.validBytes();
+        }
+        else if (reader.fileBytes() > 0)
+        {
+            cerr << "Write-ahead log " << path << " has an unknown format" << endl;
+            return false;
+        }
+
+        fd = ::open(path.c_str(), WAL_OPEN_FLAGS, 0644);
+        if (fd < 0)
+        {
+            cerr << "Cannot open write-ahead log " << path << endl;
+            return false;
+        }
+        if (keepBytes < reader.fileBytes() && WAL_TRUNCATE(fd, keepBytes) != 0)
+        {
+            cerr << "Cannot truncate torn tail of " << path << endl;
+            close();
+            return false;
+        }
+        if (keepBytes == 0 && !writeHeader())
+        {
+            close();
+            return false;
+        }
+
+        nextLsn = lastLsn + 1;
+        writtenLsn = syncedLsn = lastLsn;
+        pendingRecords = 0;
+        recordsSinceSync = 0;
+        failed = false;
+        lastSync = chrono::steady_clock::now();
+        stopping = false;
+        if (options.mode == WAL_SYNC_BATCH && options.syncIntervalMs > 0)
+            flusher = thread(flusherMain, this);
+        return true;
+    }
+
+    bool writeHeader()
+    {
+        char header[WAL_HEADER_SIZE];
+        unsigned int version = WAL_VERSION, byteOrder = WAL_BYTE_ORDER;
+        memcpy(header, "ITNMWAL1", 8);
+        memcpy(header + 8, &version, 4);
+        memcpy(header + 12, &byteOrder, 4);
+        return writeAll(header, WAL_HEADER_SIZE) && WAL_FSYNC(fd) == 0;
+    }
+
+    // Stop the flusher, flush and fsync everything, then close the file
+    void close()
+    {
+        if (fd < 0)
+            return;
+        if (flusher.joinable())
+        {
+            {
+                lock_guard<mutex> guard(lock);
+                stopping = true;
+            }
+            flusherWake.notify_all();
+            flusher.join();
+        }
+        sync();
+        ::close(fd);
+        fd = -1;
+    }
+
+    bool isOpen() const { return fd >= 0; }
+
+    // Buffer one record; returns its LSN. Thread-safe.
+    long long append(unsigned int type, const BinaryWriter &payload)
+    {
+        lock_guard<mutex> guard(lock);
+        long long lsn = nextLsn++;
+        unsigned int length = (unsigned int)(12 + payload.size());
+        long long start = pending.size();
+        pending.writeUInt(length);
+        pending.writeUInt(0);
+        pending.writeInt64(lsn);
+        pending.writeUInt(type);
+        pending.writeBytes(payload.bytes(), payload.size());
+        pending.patchUInt(start + 4, crc32(pending.bytes() + start + WAL_RECORD_HEADER_SIZE, length));
+        pendingRecords++;
+        return lsn;
+    }
+
+    // Wait until record lsn is as durable as the sync mode promises
+    // (written for NONE/BATCH, fsync'ed for ALWAYS). Thread-safe.
+    bool commit(long long lsn)
+    {
+        unique_lock<mutex> lk(lock);
+        while (true)
+        {
+            long long done = options.mode == WAL_SYNC_ALWAYS ? syncedLsn : writtenLsn;
+            if (lsn <= done)
+                return !failed;
+            if (!flushing)
+                break;
+            flushed.wait(lk);
+        }
+        flushLocked(lk, false);
+        return !failed;
+    }
+
+    // Append and commit in one call
+    bool log(unsigned int type, const BinaryWriter &payload)
+    {
+        if (fd < 0)
+            return false;
+        return commit(append(type, payload));
+    }
+
+    // Write and fsync everything appended so far
+    bool sync()
+    {
+        unique_lock<mutex> lk(lock);
+        while (flushing)
+            flushed.wait(lk);
+        if (fd >= 0 && (pendingRecords > 0 || syncedLsn < writtenLsn))
+            flushLocked(lk, true);
+        return !failed;
+    }
+
+    // Drop every record (after a checkpoint has captured them). LSNs go on
+    // increasing from where they were.
+    bool reset()
+    {
+        if (!sync())
+            return false;
+        lock_guard<mutex> guard(lock);
+        if (WAL_TRUNCATE(fd, 0) != 0 || !writeHeader())
+        {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    // LSN of the last record appended
+    long long lastLsn()
+    {
+        lock_guard<mutex> guard(lock);
+        return nextLsn - 1;
+    }
+
+    const WalOptions &getOptions() const { return options; }
+
+    // ---- typed mutation records ----
+
+    bool logAddStation(const Station &s)
+    {
+        BinaryWriter p(64);
+        p.writeInt(s.getID());
+        p.writeString(s.getName());
+        p.writeString(s.getLocation());
+        return log(WAL_ADD_STATION, p);
+    }
+
+    bool logAddRoute(const Route &r)
+    {
+        BinaryWriter p(32);
+        p.writeInt(r.getRouteID());
+        p.writeInt(r.getStartStationID());
+        p.writeInt(r.getEndStationID());
+        p.writeDouble(r.getDistance());
+        return log(WAL_ADD_ROUTE, p);
+    }
+
+    bool logAddVehicle(const Vehicle &v)
+    {
+        BinaryWriter p(64);
+        p.writeInt(v.getID());
+        p.writeString(v.getName());
+        p.writeInt(v.getCapacity());
+        return log(WAL_ADD_VEHICLE, p);
+    }
+
+    bool logEnqueuePassenger(const Passenger &pass)
+    {
+        BinaryWriter p(64);
+        p.writeInt(pass.getID());
+        p.writeString(pass.getName());
+        p.writeInt(pass.getAge());
+        return log(WAL_ENQUEUE_PASSENGER, p);
+    }
+
+    // REMOVE_STATION, REMOVE_ROUTE, STATION_PASSENGER, REMOVE_VEHICLE
+    bool logId(WalRecordType type, int id)
+    {
+        BinaryWriter p(8);
+        p.writeInt(id);
+        return log(type, p);
+    }
+
+    // n tickets for the next n queued passengers, IDs firstID.., one issue
+    // time; either per-passenger routes or one shared route
+    bool logIssueTickets(int firstID, int n, Timestamp issueTime, const int startIDs[], const int endIDs[],
+                         int startStationID, int endStationID)
+    {
+        bool perPassenger = startIDs && endIDs;
+        BinaryWriter p(perPassenger ? 32 + 8LL * n : 32);
+        p.writeInt(firstID);
+        p.writeInt(n);
+        p.writeInt64(issueTime);
+        p.writeInt(perPassenger ? 1 : 0);
+        if (perPassenger)
+        {
+            p.writeBytes(startIDs, (long long)n * sizeof(int));
+            p.writeBytes(endIDs, (long long)n * sizeof(int));
+        }
+        else
+        {
+            p.writeInt(startStationID);
+            p.writeInt(endStationID);
+        }
+        return log(WAL_ISSUE_TICKETS, p);
+    }
+
+    bool logMergeTickets(const TicketRecord records[], int n)
+    {
+        BinaryWriter p(16 + 40LL * n);
+        p.writeInt(n);
+        for (int i = 0; i < n; i++)
+        {
+            p.writeInt(records[i].ticketID);
+            p.writeInt(records[i].passenger.getID());
+            p.writeInt(records[i].passenger.getAge());
+            p.writeString(records[i].passenger.getName());
+            p.writeInt(records[i].startStationID);
+            p.writeInt(records[i].endStationID);
+            p.writeInt64(records[i].issueTime);
+        }
+        return log(WAL_MERGE_TICKETS, p);
+    }
+
+    bool logHistory(WalRecordType type, const string &action = "")
+    {
+        BinaryWriter p(16 + action.size());
+        if (type == WAL_HISTORY_PUSH)
+            p.writeString(action);
+        return log(type, p);
+    }
+};
+
+#endif